@@ -0,0 +1,158 @@
+-- Autoconfig journal: commands added with AL_CommandAddJournaled record a
+-- fingerprint of what they left in the game folder once they succeed. Next
+-- configuration skips them while the fingerprint still matches, so a run that
+-- stopped halfway resumes where it failed instead of starting over.
+-- Commands without fingerprint (user choices, quick ones, mod install that is
+-- meant to repair) always run; they don't invalidate journaled commands after
+-- them, so fingerprint of those has to cover what they change.
+
+local JOURNAL_VERSION = "1"
+
+-- name -> { fingerprint = fn, after = {...} }
+local journaled = {}
+
+local function _Load()
+    local entries = {}
+    local f = io.open(GAME_AUTOCONFIG_JOURNAL_PATH, "r")
+    if not f then
+        return entries
+    end
+
+    local version
+    for line in f:lines() do
+        local key, value = line:match("^(%w+)\t(.*)$")
+        if key == "version" then
+            version = value
+        elseif key == "done" then
+            local name, fingerprint = value:match("^([^\t]+)\t(.*)$")
+            if name then
+                entries[name] = fingerprint
+            end
+        end
+    end
+    f:close()
+
+    if version ~= JOURNAL_VERSION then
+        return {}
+    end
+    return entries
+end
+
+local function _Save(entries)
+    local lines = { "version\t"..JOURNAL_VERSION }
+    for name, fingerprint in pairs(entries) do
+        lines[#lines+1] = "done\t"..name.."\t"..fingerprint
+    end
+
+    FS.DirectoryEnsure(FS.PathGetDirectory(GAME_AUTOCONFIG_JOURNAL_PATH))
+    local tmp = GAME_AUTOCONFIG_JOURNAL_PATH..".tmp"
+    local f = io.open(tmp, "w")
+    if not f then
+        return false
+    end
+    f:write(table.concat(lines, "\n"), "\n")
+    f:close()
+
+    os.remove(GAME_AUTOCONFIG_JOURNAL_PATH)
+    return os.rename(tmp, GAME_AUTOCONFIG_JOURNAL_PATH) and true or false
+end
+
+-- nil: nothing to compare against, command has to run. Previous recorded
+-- fingerprint is passed along for inputs only known while command runs.
+local function _Fingerprint(name, previous)
+    local ok, fingerprint = pcall(journaled[name].fingerprint, previous)
+    if not ok then
+        print("Journal: fingerprint of "..name.." failed: "..tostring(fingerprint))
+        return nil
+    end
+    if fingerprint == nil then
+        return nil
+    end
+    return (tostring(fingerprint):gsub("[\t\r\n]", " "))
+end
+
+-- Journaled commands depending on name, directly or not
+local function _GetDependents(name, out)
+    for other, cmd in pairs(journaled) do
+        if not out[other] then
+            for _, dep in ipairs(cmd.after) do
+                if dep == name then
+                    out[other] = true
+                    _GetDependents(other, out)
+                    break
+                end
+            end
+        end
+    end
+    return out
+end
+
+local function _Wrap(name, fn)
+    return function(...)
+        local entries = _Load()
+        if entries[name] and entries[name] == _Fingerprint(name, entries[name]) then
+            AL_print("Skipping "..name..": nothing changed since it last succeeded.")
+            return true
+        end
+
+        -- Forget it (and what was built on top of it) before running, so an
+        -- interrupted run can't leave a stale entry behind
+        entries[name] = nil
+        for dependent in pairs(_GetDependents(name, {})) do
+            entries[dependent] = nil
+        end
+        _Save(entries)
+
+        local ok = fn(...)
+        if ok then
+            local fingerprint = _Fingerprint(name)
+            if fingerprint then
+                -- Reload: other commands may have finished while this one waited
+                entries = _Load()
+                entries[name] = fingerprint
+                _Save(entries)
+            end
+        end
+        return ok
+    end
+end
+
+-- Same as AL.CommandAdd, opts.fingerprint(previous) returns string describing
+-- inputs and state the command leaves behind (nil when it can't tell)
+function AL_CommandAddJournaled(name, fn, priority, opts)
+    journaled[name] = {
+        fingerprint = opts.fingerprint,
+        after       = opts.after or {},
+    }
+    AL.CommandAdd(name, _Wrap(name, fn), priority, { after = opts.after })
+end
+
+-- Next configuration runs every command
+function AL_JournalClear()
+    os.remove(GAME_AUTOCONFIG_JOURNAL_PATH)
+end
+
+-- Fingerprint helper: sorted entry names of dir, with sizes when bSizes
+function AL_JournalDirectoryFingerprint(dir, bSizes)
+    local entries = FS.ListDir(dir, { attrs = bSizes })
+    if not entries then
+        local names = FS.IsFilePresent(dir) and FS.DirectoryList(dir)
+        if not names then
+            return nil
+        end
+        entries = {}
+        for i, entryName in ipairs(names) do
+            entries[i] = {
+                name = entryName,
+                size = bSizes and lfs.attributes(FS.PathJoin(dir, entryName), "size"),
+            }
+        end
+    end
+
+    local list = {}
+    for i, entry in ipairs(entries) do
+        list[i] = bSizes and entry.name..":"..tostring(entry.size or 0) or entry.name
+    end
+    table.sort(list)
+    return table.concat(list, "|")
+end
@@ -106,6 +106,7 @@ end
 function events.InitLauncher()
 
     print("Initialize ConfigTweaks.lua")
-    AL.CommandAdd("ConfigTweaks", _ConfigTweaks, -50) -- overwrites internal cmd
+    -- mm7.ini comes with GrayFace patch, mods go into merged Data folder
+    AL.CommandAdd("ConfigTweaks", _ConfigTweaks, -50, { after = { "MergeAndRename" } }) -- overwrites internal cmd
 
 end
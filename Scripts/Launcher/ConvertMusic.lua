@@ -30,6 +30,12 @@ end
 function events.InitLauncher()
 
     print("Initialize ConvertMusic.lua")
-    AL.CommandAdd("ConvertMusic", _ConvertMusic, -70)
+    AL_CommandAddJournaled("ConvertMusic", _ConvertMusic, -70, {
+        -- Renames MP3s MergeAndRename verifies
+        after       = { "MergeAndRename" },
+        fingerprint = function()
+            return AL_JournalDirectoryFingerprint(FS.PathJoin(GAME_DESTINATION_PATH, "Music"), true)
+        end,
+    })
 
 end
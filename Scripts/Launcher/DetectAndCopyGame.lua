@@ -73,6 +73,13 @@ MM7_COPY_FILES = {
     "VIC32.DLL",
 }
 
+-- Always real copies in "link" install mode (patterns): launcher changes
+-- these after copy (ConvertMusic, INI tweaks), hardlink would change source
+MM7_COPY_ALWAYS = {
+    "^Music/",
+    "%.ini$",
+}
+
 -- Build detection list that expects WAV instead of MP3
 local function _BuildDetectList(copyList)
     local detectList = {}
@@ -88,8 +95,64 @@ end
 
 local MM7_DETECT_FILES = _BuildDetectList(MM7_COPY_FILES)
 
+-- Extra Steam libraries (other drives) listed in libraryfolders.vdf
+local function _GetSteamLibraryRoots()
+    local roots = {}
+    local vdfs  = {}
+
+    if OS_NAME == "Windows" then
+        vdfs[#vdfs+1] = (os.getenv("PROGRAMFILES(X86)") or "C:\\Program Files (x86)")..
+            "\\Steam\\steamapps\\libraryfolders.vdf"
+    else
+        local homePath = os.getenv("HOME") or ""
+        vdfs[#vdfs+1] = homePath.."/.local/share/Steam/steamapps/libraryfolders.vdf"
+        vdfs[#vdfs+1] = homePath.."/.steam/steam/steamapps/libraryfolders.vdf"
+    end
+
+    for _, vdf in ipairs(vdfs) do
+        local f = io.open(vdf, "r")
+        if f then
+            for escaped in f:read("*a"):gmatch('"path"%s+"(.-)"') do
+                local path = escaped:gsub("\\\\", "\\")
+                roots[#roots+1] = FS.PathJoin(path, "steamapps", "common")
+            end
+            f:close()
+        end
+    end
+
+    return roots
+end
+
+-- Native breadth-first search over likely install roots, last match is cached
+local function _ScanForGame(listOfFilesToCheck)
+    if not (AL and AL.FindGame) then
+        return nil
+    end
+
+    local roots = {}
+    for _, root in ipairs(GAME_SCAN_ROOTS) do
+        roots[#roots+1] = root
+    end
+    for _, root in ipairs(_GetSteamLibraryRoots()) do
+        roots[#roots+1] = root
+    end
+
+    FS.DirectoryEnsure(FS.PathGetDirectory(GAME_SCAN_CACHE_PATH))
+
+    AL_print("Searching for game installations…")
+    return AL.FindGame(roots, {
+        exe     = GAME_EXECUTABLE_NAME,
+        files   = listOfFilesToCheck,
+        exclude = GAME_SCAN_EXCLUDE,
+        depth   = GAME_SCAN_DEPTH,
+        threads = GAME_SCAN_THREADS,
+        cache   = GAME_SCAN_CACHE_PATH,
+    })
+end
+
 -- Public functions:
-function AL_DetectGame(searchFolder, bIgnoreWav)
+-- bScan: search drives and libraries too (slow, autoconfig only)
+function AL_DetectGame(searchFolder, bIgnoreWav, bScan)
 
     AL_print("Detecting game...")
 
@@ -130,21 +193,268 @@ function AL_DetectGame(searchFolder, bIgnoreWav)
         end
     end
 
+    -- 3) Search wine prefixes, game libraries and drives
+    if bScan and not searchFolder then
+        local root = _ScanForGame(listOfFilesToCheck)
+        if root then
+            print("Found valid installation at "..root)
+            return root, "external"
+        end
+    end
+
     return nil, "notfound"
 end
 
+-- Detection cache: resolved file names with size and mtime, one stat each to revalidate
+local DETECT_CACHE_VERSION = "1"
+
+-- AL_DetectGame normalizes the list in place, so key on normalized names
+local function _GetDetectCacheListKey()
+    local list = {}
+    for i, rel in ipairs(MM7_DETECT_FILES) do
+        list[i] = FS.PathNormalize(rel)
+    end
+    return table.concat(list, "|")
+end
+
+local function _GetDetectCacheFiles(root)
+    local files = {}
+    local index = FS.PathIndex(root)
+    for _, rel in ipairs(MM7_DETECT_FILES) do
+        local path = FS.PathResolveIndexed(index, root, FS.PathNormalize(rel))
+        if not path then
+            files = nil
+            break
+        end
+        files[#files+1] = path
+    end
+    if index then
+        index:close()
+    end
+    return files
+end
+
+-- Same files as watcher reports them: relative to game folder, '/', lowercase
+local detectCacheWatched = nil
+
+local function _SetDetectCacheWatched(files)
+    local root = GAME_DESTINATION_PATH..OS_FILE_SEPARATOR
+    detectCacheWatched = {}
+    for _, path in ipairs(files) do
+        if path:sub(1, #root) == root then
+            detectCacheWatched[#detectCacheWatched+1] = (path:sub(#root + 1):gsub("\\", "/")):lower()
+        end
+    end
+end
+
+function AL_DetectCacheInvalidate()
+    os.remove(GAME_DETECT_CACHE_PATH)
+    detectCacheWatched = nil
+end
+
+function AL_DetectCacheSave(root, how)
+    local files = _GetDetectCacheFiles(root)
+    if not files then
+        return false
+    end
+
+    -- Mod manifest is tracked even when missing, so installing the mod invalidates
+    files[#files+1] = FS.PathJoin(GAME_DESTINATION_PATH, "Scripts", "manifest.lua")
+
+    local lines = {
+        "version\t"..DETECT_CACHE_VERSION,
+        "list\t".._GetDetectCacheListKey(),
+        "root\t"..root,
+        "how\t"..how,
+        "mod\t"..(GAME_MOD_VERSION_STR or ""),
+    }
+    for _, path in ipairs(files) do
+        local attr = lfs.attributes(path)
+        if attr then
+            lines[#lines+1] = string.format("file\t%s\t%d\t%d",
+                path, attr.size, attr.modification)
+        else
+            lines[#lines+1] = "file\t"..path.."\t-1\t-1"
+        end
+    end
+
+    _SetDetectCacheWatched(files)
+
+    FS.DirectoryEnsure(FS.PathGetDirectory(GAME_DETECT_CACHE_PATH))
+    local tmp = GAME_DETECT_CACHE_PATH..".tmp"
+    local f = io.open(tmp, "w")
+    if not f then
+        return false
+    end
+    f:write(table.concat(lines, "\n"), "\n")
+    f:close()
+
+    os.remove(GAME_DETECT_CACHE_PATH)
+    return os.rename(tmp, GAME_DETECT_CACHE_PATH) and true or false
+end
+
+-- Returns root, how and mod version string when nothing changed since last save
+function AL_DetectCacheLoad()
+    local f = io.open(GAME_DETECT_CACHE_PATH, "r")
+    if not f then
+        return nil
+    end
+
+    local cache = {}
+    local files = {}
+    local valid = true
+    for line in f:lines() do
+        local key, value = line:match("^(%w+)\t(.*)$")
+        if key == "file" then
+            local path, size, mtime = value:match("^(.*)\t(%-?%d+)\t(%-?%d+)$")
+            local attr = path and lfs.attributes(path)
+            if not path then
+                valid = false
+            elseif size == "-1" then
+                valid = attr == nil
+            else
+                valid = attr ~= nil and
+                    attr.size == tonumber(size) and attr.modification == tonumber(mtime)
+            end
+            if not valid then
+                print("Detection cache is stale: "..tostring(path))
+                break
+            end
+            files[#files+1] = path
+        elseif key then
+            cache[key] = value
+        end
+    end
+    f:close()
+
+    if not valid or cache.version ~= DETECT_CACHE_VERSION or
+        cache.list ~= _GetDetectCacheListKey() or not cache.root then
+        return nil
+    end
+    _SetDetectCacheWatched(files)
+    return cache.root, cache.how, cache.mod
+end
+
+-- Path is a file or a directory everything below may have changed in, "" is everything
+function events.FilesChanged(paths)
+    if not detectCacheWatched then
+        return
+    end
+    for _, changed in ipairs(paths) do
+        local prefix = changed:lower().."/"
+        for _, watched in ipairs(detectCacheWatched) do
+            if changed == "" or watched == changed:lower() or
+                watched:sub(1, #prefix) == prefix then
+                print("Game files changed ("..watched.."), detection cache dropped")
+                AL_DetectCacheInvalidate()
+                return
+            end
+        end
+    end
+end
+
 -- Static functions
+local function _GetInstallMode()
+    local ini = AL.INILoad(INI_PATH_MOD)
+    if ini == nil then
+        return GAME_INSTALL_MODE
+    end
+    local mode = AL.INIGet(ini, "Settings", "InstallMode")
+    AL.INIClose(ini)
+
+    return (mode == "link" or mode == "copy") and mode or GAME_INSTALL_MODE
+end
+
+local function _GetCopyAlwaysFiles(list)
+    local result = {}
+    for _, rel in ipairs(list) do
+        local path = rel:gsub("\\", "/")
+        for _, pattern in ipairs(MM7_COPY_ALWAYS) do
+            if path:match(pattern) then
+                result[#result+1] = rel
+                break
+            end
+        end
+    end
+    return result
+end
+
+-- Bytes copying will write to dst; linked files take no space unless they
+-- have to fall back to copy across filesystems
+local function _GetCopyBytes(src, dst)
+    local bShared = _GetInstallMode() == "link" and
+        lfs.attributes(src, "dev") == lfs.attributes(dst, "dev")
+    local always = {}
+    for _, rel in ipairs(_GetCopyAlwaysFiles(MM7_COPY_FILES)) do
+        always[rel] = true
+    end
+
+    -- Files are replaced through temp file and rename, so a file that's
+    -- already there only needs what it grows by, plus room for one temp copy
+    local bDstExists = lfs.attributes(dst, "mode") == "directory"
+    local index      = FS.PathIndex(src)
+    local dstIndex   = bDstExists and FS.PathIndex(dst)
+    local total      = 0
+    local headroom   = 0
+    for _, rel in ipairs(MM7_COPY_FILES) do
+        if not bShared or always[rel] then
+            local path    = FS.PathResolveIndexed(index, src, rel)
+            local srcAttr = path and lfs.attributes(path)
+            local size    = (srcAttr and srcAttr.size) or 0
+            local dstPath = bDstExists and FS.PathResolveIndexed(dstIndex, dst, rel)
+            local dstAttr = dstPath and lfs.attributes(dstPath)
+
+            -- Hardlink of the source frees nothing when replaced
+            if dstAttr and dstAttr.mode == "file" and
+               not (srcAttr and srcAttr.dev == dstAttr.dev and srcAttr.ino == dstAttr.ino and srcAttr.ino ~= 0) then
+                total    = total + math.max(size - dstAttr.size, 0)
+                headroom = math.max(headroom, math.min(size, dstAttr.size))
+            else
+                total = total + size
+            end
+        end
+    end
+    if index then
+        index:close()
+    end
+    if dstIndex then
+        dstIndex:close()
+    end
+    return total + headroom
+end
+
 local function _CopyGameFiles(src, dst)
+    local bLink = _GetInstallMode() == "link"
+
     AL_print("Copying game from '"..src.."…")
+    if bLink then
+        AL_print("Install mode: link (game files are shared with source where possible)")
+    end
     FS.DirectoryEnsure(dst)
-    FS.FilesCopy(src, dst, MM7_COPY_FILES)
+
+    local ok = FS.FilesCopy(src, dst, MM7_COPY_FILES, {
+        threads  = GAME_COPY_THREADS,
+        link     = bLink,
+        copy     = _GetCopyAlwaysFiles(MM7_COPY_FILES),
+        progress = function(rel, copied, method, done, total)
+            AL_print(string.format("[%d/%d] %s %s", done, total,
+                copied and (method == "copy" and "Copied" or "Linked ("..method..")") or "Failed", rel))
+        end
+    })
+    if not ok then
+        AL_print("Copy failed.")
+        return false
+    end
 
     AL_print("Copy succeeded.")
     return true
 end
 
+-- Where last successful run took the game from (this session)
+local copiedFrom = nil
+
 local function _DetectAndCopyGame(searchFolder)
-    local src, how = AL_DetectGame(searchFolder, true)
+    local src, how = AL_DetectGame(searchFolder, true, true)
     if not src then
         AL_print("Failed to find the game!")
 
@@ -166,19 +476,78 @@ local function _DetectAndCopyGame(searchFolder)
         return false
     end
 
+    copiedFrom = nil
     if how == "local" then
         AL_print("No copy needed - game verified in destination folder.")
+        if not AL_Preflight(src, 0) then
+            return false
+        end
+        copiedFrom = { root = src, how = how }
         return true
     end
 
+    FS.DirectoryEnsure(GAME_DESTINATION_PATH)
+    if not AL_Preflight(src, _GetCopyBytes(src, GAME_DESTINATION_PATH)) then
+        return false
+    end
+
     AL_print("Fetching game from: "..src)
     sleep(1) -- give that ui time to close
 
-    return _CopyGameFiles(src, GAME_DESTINATION_PATH)
+    if not _CopyGameFiles(src, GAME_DESTINATION_PATH) then
+        return false
+    end
+    copiedFrom = { root = src, how = how }
+    return true
+end
+
+-- Journal: source and install mode it was copied with, every copied file
+-- still in destination with size and mtime (Localisation only adds loc.*
+-- files next to them), music as MP3 or converted WAV
+local function _FingerprintCopiedGame(previous)
+    local root, how
+    if copiedFrom then
+        root, how = copiedFrom.root, copiedFrom.how
+    elseif previous then
+        root, how = previous:match("^source:(.-)|how:(%a+)|")
+    end
+    if not root then
+        return nil
+    end
+    -- Gone source would make detection pick another one
+    if how == "external" and not FS.PathResolveCaseInsensitive(root, GAME_EXECUTABLE_NAME) then
+        return nil
+    end
+
+    local index = FS.PathIndex(GAME_DESTINATION_PATH)
+    local list  = { "source:"..root, "how:"..how, "mode:".._GetInstallMode() }
+    for _, rel in ipairs(MM7_COPY_FILES) do
+        rel = FS.PathNormalize(rel)
+        local path = FS.PathResolveIndexed(index, GAME_DESTINATION_PATH, rel)
+        if rel:match("%.mp3$") then
+            path = path or FS.PathResolveIndexed(index, GAME_DESTINATION_PATH, (rel:gsub("%.mp3$", ".wav")))
+            list[#list+1] = path and rel
+        else
+            local attr = path and lfs.attributes(path)
+            list[#list+1] = attr and string.format("%s:%d:%d", rel, attr.size, attr.modification)
+            path = attr and path
+        end
+        if not path then
+            list = nil
+            break
+        end
+    end
+    if index then
+        index:close()
+    end
+    return list and table.concat(list, "|")
 end
 
 -- Global callbacks
 function events.InitLauncher()
     print("Initialize DetectAndCopyGame.lua")
-    AL.CommandAdd("DetectAndCopyGame", _DetectAndCopyGame, -100)
+    AL_CommandAddJournaled("DetectAndCopyGame", _DetectAndCopyGame, -100, {
+        after       = {},
+        fingerprint = _FingerprintCopiedGame,
+    })
 end
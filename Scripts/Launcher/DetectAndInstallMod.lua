@@ -46,28 +46,22 @@ end
 
 local function InstallMod(destinationFolder)
 
-    local archivesDir   = FS.PathJoin("Data", "Launcher", "Archives")
-    local patchZipName  = "_grayfacePatch257.zip"
-    local modZipName    = "_mod.zip"
-    local patchZip      = FS.PathResolveCaseInsensitive(archivesDir, patchZipName)
-    local modZip        = FS.PathResolveCaseInsensitive(archivesDir, modZipName)
-
-    if not patchZip then
-        AL_print('Failed to find archive: ' .. FS.PathJoin(archivesDir, patchZipName))
-        return false
-    end
-    if not modZip then
-        AL_print('Failed to find archive: ' .. FS.PathJoin(archivesDir, modZipName))
-        return false
+    -- resolve all first, nothing gets extracted if any archive is missing
+    local archives = {}
+    for _, name in ipairs(MOD_ARCHIVE_FILES) do
+        local zip = FS.PathResolveCaseInsensitive(MOD_ARCHIVES_PATH, name)
+        if not zip then
+            AL_print('Failed to find archive: ' .. FS.PathJoin(MOD_ARCHIVES_PATH, name))
+            return false
+        end
+        archives[#archives+1] = zip
     end
 
-    if not AL.ArchiveExtract(patchZip, destinationFolder) then
-        AL_print("Failed to extract _grayfacePatch257")
-        return false
-    end
-    if not AL.ArchiveExtract(modZip, destinationFolder) then
-        AL_print("Failed to extract _mod.zip")
-        return false
+    for i, zip in ipairs(archives) do
+        if not AL.ArchiveExtract(zip, destinationFolder) then
+            AL_print("Failed to extract " .. MOD_ARCHIVE_FILES[i])
+            return false
+        end
     end
 
     return true
@@ -92,9 +86,20 @@ local function _DetectAndInstallMod()
     return true
 end
 
+-- Re-read mod version when manifest (or anything above it) changes
+function events.FilesChanged(paths)
+    for _, changed in ipairs(paths) do
+        local path = changed:lower()
+        if path == "" or path == "scripts" or path == "scripts/manifest.lua" then
+            AL_DetectMod(GAME_DESTINATION_PATH, true)
+            return
+        end
+    end
+end
+
 function events.InitLauncher()
 
     print("Initialize DetectAndInstallMod.lua")
-    AL.CommandAdd("DetectAndInstallMod", _DetectAndInstallMod, -90) 
+    AL.CommandAdd("DetectAndInstallMod", _DetectAndInstallMod, -90, { after = { "DetectAndCopyGame" } })
 
 end
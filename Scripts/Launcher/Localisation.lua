@@ -231,6 +231,6 @@ end
 function events.InitLauncher()
 
     print("Initialize Localisation.lua")
-    AL.CommandAdd("Localisation", _Localisation, -40) -- overwrites internal cmd
+    AL.CommandAdd("Localisation", _Localisation, -40, { after = { "MergeAndRename", "ConfigTweaks" } }) -- overwrites internal cmd
 
 end
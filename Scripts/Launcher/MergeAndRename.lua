@@ -145,14 +145,54 @@ local function ProcessFiles(base_dir, wanted_names)
     end
 end
 
+-- Native: one directory pass, renames never clobber, merges stay in kernel
+local NORMALIZE_MESSAGES = {
+    rename      = "Renamed '%s' to '%s'",
+    merge       = "Merged contents from '%s' -> '%s'",
+    overwrite   = "Overwrote '%s' with '%s' and removed the duplicate",
+    create      = "Created missing folder '%s'",
+    missing     = "File '%s' is missing.",
+}
+
+local function ProcessNative(base_dir)
+
+    local _, actions = AL.NormalizeCase(base_dir, {
+        folders = folderNames,
+        files   = fileNames,
+    })
+
+    for _, a in ipairs(actions) do
+        local msg
+        if a.action == "overwrite" then
+            msg = NORMALIZE_MESSAGES.overwrite:format(a.to, a.from)
+        elseif a.from then
+            msg = NORMALIZE_MESSAGES[a.action]:format(a.from, a.to)
+        else
+            msg = NORMALIZE_MESSAGES[a.action]:format(a.to)
+        end
+
+        if a.action == "missing" then
+            AL_print(msg)
+        elseif a.ok then
+            print(msg)
+        else
+            AL_print(("Error: %s of '%s' -> '%s' failed"):format(a.action, a.from or "", a.to))
+        end
+    end
+end
+
 -------------------------------------------------------------------------------
 local function _MergeAndRename()
 
     AL_print("Merging/Renaming files...")
 
     -- Run the processing function
-    ProcessFolders(GAME_DESTINATION_PATH, folderNames)
-    ProcessFiles(GAME_DESTINATION_PATH, fileNames)
+    if AL and AL.NormalizeCase then
+        ProcessNative(GAME_DESTINATION_PATH)
+    else
+        ProcessFolders(GAME_DESTINATION_PATH, folderNames)
+        ProcessFiles(GAME_DESTINATION_PATH, fileNames)
+    end
 
     AL_VerifyGameFiles(GAME_DESTINATION_PATH, MM7_COPY_FILES)
 
@@ -164,6 +204,12 @@ end
 function events.InitLauncher()
 
     print("Initialize MergeAndRename.lua")
-    AL.CommandAdd("MergeAndRename", _MergeAndRename, -80) 
+    AL_CommandAddJournaled("MergeAndRename", _MergeAndRename, -80, {
+        after       = { "DetectAndInstallMod" },
+        -- Only names at top of game folder get normalized
+        fingerprint = function()
+            return AL_JournalDirectoryFingerprint(GAME_DESTINATION_PATH)
+        end,
+    })
 
 end
@@ -69,20 +69,50 @@ local function _CopyRule(m, rule)
 
     FS.DirectoryEnsure(FS.PathGetDirectory(dstAbs))
 
-    local r = io.open(srcAbs, "rb")
-    if not r then
+    -- Through object store: reinstall/toggle is a link, not a copy
+    local method = AL.ObjectStoreInstall(srcAbs, dstAbs)
+    if method then
+        print(string.format(
+            "[ModManager] Linked %-32s -> %s (%s)",
+            srcRel, dstRel, method
+        ))
+        return
+    end
+
+    -- Destination may be hardlinked (object store, link install mode), so it's
+    -- never written in place: copy goes to temp file renamed over it
+    if not FS.IsFilePresent(srcAbs) then
         print("[ModManager] source missing: " .. srcRel)
         return
     end
-    local w = io.open(dstAbs, "wb")
-    if not w then
+    if AL and AL.FileCopy then
+        if not AL.FileCopy(srcAbs, dstAbs) then
+            print("[ModManager] cannot write: " .. dstRel)
+            return
+        end
+    else
+        local tmp = dstAbs .. ".tmp"
+        local r = io.open(srcAbs, "rb")
+        local w = r and io.open(tmp, "wb")
+        if not w then
+            if r then r:close() end
+            print("[ModManager] cannot write: " .. dstRel)
+            return
+        end
+        while true do
+            local chunk = r:read(1024 * 1024)
+            if not chunk then break end
+            w:write(chunk)
+        end
         r:close()
-        print("[ModManager] cannot write: " .. dstRel)
-        return
+        w:close()
+        os.remove(dstAbs)
+        if not os.rename(tmp, dstAbs) then
+            os.remove(tmp)
+            print("[ModManager] cannot write: " .. dstRel)
+            return
+        end
     end
-    w:write(r:read("*all"))
-    r:close()
-    w:close()
     print(string.format(
         "[ModManager] Copied %-32s -> %s",
         srcRel, dstRel
@@ -113,6 +113,35 @@ local function _GetOptionsTable()
                     AL.INIClose(ini)
                 end
             },
+            {
+                title       = "Game Install Mode:",
+                id          = "installmode",
+                type        = UIWIDGET.RADIO,
+                optTitle    = {
+                    "Copy",
+                    "Link (saves disk space)"
+                },
+                default     = (function()
+                    local ini    = AL.INILoad(INI_PATH_MOD)
+                    local retStr = AL.INIGet(ini, "Settings", "InstallMode")
+                    AL.INIClose(ini)
+
+                    if retStr == nil or retStr == "" then
+                        retStr = GAME_INSTALL_MODE
+                    end
+
+                    return retStr == "link" and 1 or 0
+                end)(),
+                callback    = function(t)
+
+                    local ini = AL.INILoad(INI_PATH_MOD)
+                    if ini ~= nil then
+                        AL.INISet(ini, "Settings", "InstallMode", tonumber(t.value) == 1 and "link" or "copy")
+                        AL.INISave(ini, INI_PATH_MOD)
+                    end
+                    AL.INIClose(ini)
+                end
+            },
             {
                 title       = "Window Mode:",
                 id          = "windowmode",
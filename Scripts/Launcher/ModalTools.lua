@@ -3,6 +3,8 @@
 local TOOLENUM = {
     NULL            = 0,
     AUTOCONFIG      = 1,
+    ROLLBACK        = 2,
+    VERIFY          = 3,
     MAX
 }
 
@@ -14,9 +16,43 @@ local _ToolsTable = {
         title       = "Autoconfig",
         description = "Re-launches the automatic configuration wizard, letting you fine-tune performance, graphics, and gameplay settings in one guided flow.",
         onClick     = function()
+            -- Asked for explicitly: every step runs again, nothing is resumed
+            -- and game is searched for even if last scan found nothing
+            AL_JournalClear()
+            os.remove(GAME_SCAN_CACHE_PATH)
             AL.UICall(UIEVENT.MODAL_CLOSE)
             AL.UICall(UIEVENT.AUTOCONFIG)
         end
+    },
+    {
+        id          = TOOLENUM.ROLLBACK,
+        iconPath    = "Data/Launcher/tool-manual.png",
+        iconDarkPath= "Data/Launcher/tool-manual_dark.png",
+        title       = "Undo Last Update",
+        description = "Restores files replaced by the most recent update from its snapshot. Use it if the update broke something.",
+        onClick     = function()
+            AL.UICall(UIEVENT.MODAL_CLOSE)
+            local restored, err = AL.UpdateRollback()
+            if restored then
+                AL.UICall(
+                    UIEVENT.MODAL_MESSAGE,
+                    "Rollback successful!\n\nRestored files: "..restored
+                )
+            else
+                AL.UICall(UIEVENT.MODAL_MESSAGE, "Rollback failed: "..tostring(err))
+            end
+        end
+    },
+    {
+        id          = TOOLENUM.VERIFY,
+        iconPath    = "Data/Launcher/tool-manual.png",
+        iconDarkPath= "Data/Launcher/tool-manual_dark.png",
+        title       = "Verify Files",
+        description = "Checks every mod file against the update manifest and reports missing, damaged and unknown files. Repair downloads only the damaged ones.",
+        onClick     = function()
+            AL.UICall(UIEVENT.MODAL_CLOSE)
+            AL.UICall(UIEVENT.MODAL_VERIFY)
+        end
     }
 }
 
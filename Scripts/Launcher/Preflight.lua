@@ -0,0 +1,89 @@
+-- Autoconfig preflight: estimates how much gets written to the game folder
+-- (copy, archive extraction, music conversion) and fails before any of it
+-- starts if it won't fit.
+
+local MB = 1024 * 1024
+
+-- Used when MP3 can't be parsed: 16-bit stereo 44.1kHz vs typical 128kbps
+local MP3_TO_WAV_RATIO = 11
+
+local function _FileSize(path)
+    return (path and lfs.attributes(path, "size")) or 0
+end
+
+local function _GetArchiveBytes()
+    local total = 0
+    for _, name in ipairs(MOD_ARCHIVE_FILES) do
+        local zip = FS.PathResolveCaseInsensitive(MOD_ARCHIVES_PATH, name)
+        if zip then
+            total = total + (AL.ArchiveSize(zip) or _FileSize(zip))
+        end
+    end
+    return total
+end
+
+-- Same tracks ConvertMusic picks, minus ones already converted in dst
+local function _GetMusicBytes(src, dst)
+    local srcMusic = FS.PathResolveCaseInsensitive(src, "Music")
+    local files    = srcMusic and FS.DirectoryList(srcMusic)
+    if not files then
+        return 0
+    end
+
+    local converted = {}
+    local dstMusic  = FS.PathResolveCaseInsensitive(dst, "Music")
+    for _, fileName in ipairs(dstMusic and FS.DirectoryList(dstMusic) or {}) do
+        converted[fileName:lower()] = true
+    end
+
+    local total = 0
+    for _, fileName in ipairs(files) do
+        if fileName:match("^%d+%.mp3$") then
+            local wavName = fileName:gsub("%.mp3$", ".wav")
+            if not converted[wavName:lower()] then
+                local mp3 = FS.PathJoin(srcMusic, fileName)
+                total = total + (AL.MP3ToWAVSize(mp3) or _FileSize(mp3) * MP3_TO_WAV_RATIO)
+            end
+        end
+    end
+    return total
+end
+
+-- src: game folder being installed from (may be destination itself)
+-- copyBytes: what copying from src will write to destination
+function AL_Preflight(src, copyBytes)
+    local dst = GAME_DESTINATION_PATH
+    FS.DirectoryEnsure(dst)
+
+    local extractBytes = _GetArchiveBytes()
+    local musicBytes   = _GetMusicBytes(src, dst)
+    local needBytes    = copyBytes + extractBytes + musicBytes
+
+    local freeBytes = AL.DiskSpace(dst)
+    if not freeBytes then
+        print("Preflight: can't query free space of "..dst..", skipping")
+        return true
+    end
+
+    AL_print(string.format("Preflight: %.1f MB needed (copy %.1f, extract %.1f, music %.1f), %.1f MB free",
+        needBytes / MB, copyBytes / MB, extractBytes / MB, musicBytes / MB, freeBytes / MB))
+
+    if needBytes + PREFLIGHT_MARGIN_BYTES > freeBytes then
+        AL_print(string.format("Not enough disk space: free up at least %.1f MB and try again.",
+            (needBytes + PREFLIGHT_MARGIN_BYTES - freeBytes) / MB))
+        return false
+    end
+
+    if PREFLIGHT_BENCHMARK_BYTES > 0 then
+        local speed = AL.WriteBenchmark(dst, PREFLIGHT_BENCHMARK_BYTES)
+        if speed and speed > 0 then
+            AL_print(string.format("Write speed %.1f MB/s, estimated time: %d s",
+                speed / MB, math.ceil(needBytes / speed)))
+        else
+            AL_print("Failed to write test file into "..dst)
+            return false
+        end
+    end
+
+    return true
+end
@@ -23,7 +23,8 @@ UIEVENT = {
     MODAL_MODS          = 14, -- Modal: Mod Manager
     MODAL_TOOLS         = 15, -- Modal: External App/Command launcher
     MODAL_UPDATER       = 16, -- Modal: Auto Update
-    MAX                 = 17
+    MODAL_VERIFY        = 17, -- Modal: Verify/repair mod files
+    MAX                 = 18
 }
 
 UIWIDGET = {
@@ -94,6 +95,29 @@ URL_UPDATER_ROOT              = "https://mightandmagicmod.com/updater/"
 URL_UPDATER_LAUNCHER_MANIFEST = "https://mightandmagicmod.com/updater/al_manifest.json"
 URL_UPDATER_MOD_MANIFEST      = "https://mightandmagicmod.com/updater/mod_manifest.json"
 
+-- Updater transfer settings
+UPDATER_CONNECTIONS     = 4     -- parallel downloads (1..16)
+UPDATER_RETRIES         = 3     -- retries per file (0..8), with exponential backoff up to 8s
+UPDATER_CHECK_INTERVAL  = 21600 -- background update check period, seconds (0 = blocking check on start)
+
+-- Game copy settings
+GAME_COPY_THREADS       = 4     -- parallel file copies (1..16)
+GAME_INSTALL_MODE       = "copy" -- "copy" or "link" (hardlink/reflink game files, mod.ini overrides)
+
+-- Autoconfig preflight (free space check and write speed for ETA)
+PREFLIGHT_MARGIN_BYTES    = 64 * 1024 * 1024 -- kept free on top of estimate
+PREFLIGHT_BENCHMARK_BYTES = 16 * 1024 * 1024 -- written and synced once, 0 = skip
+
+-- Game install scanner (runs when none of GAME_EXECUTABLE_FOLDERS has the game)
+GAME_SCAN_DEPTH         = 5     -- directory levels below each root
+GAME_SCAN_THREADS       = 4
+GAME_SCAN_ROOTS         = GAME_SCAN_ROOTS or {}
+GAME_SCAN_EXCLUDE       = {
+    "Windows", "System32", "SysWOW64", "$Recycle.Bin", "System Volume Information",
+    "ProgramData", "dosdevices", "compatdata", "shadercache", "downloading",
+    "proc", "sys", "dev", "usr", "lib", "node_modules",
+}
+
 -- OS Separator
 if OS_NAME == "Windows" then 
     OS_FILE_SEPARATOR = '\\'
@@ -132,6 +156,36 @@ elseif OS_NAME == "Linux" then
     }
 end
 
+-- Roots for install scanner: wine prefixes, game libraries and mounted drives
+-- (Steam library folders from libraryfolders.vdf are added on scan)
+if OS_NAME == "Windows" then
+    GAME_SCAN_ROOTS = {
+        os.getenv("PROGRAMFILES(X86)") or "C:\\Program Files (x86)",
+        os.getenv("PROGRAMFILES") or "C:\\Program Files",
+        (os.getenv("SYSTEMDRIVE") or "C:") .. "\\Games",
+        (os.getenv("SYSTEMDRIVE") or "C:") .. "\\GOG Games",
+    }
+    for letter in ("DEFGHIJKLMNOPQRSTUVWXYZ"):gmatch(".") do
+        table.insert(GAME_SCAN_ROOTS, letter..":\\")
+    end
+elseif OS_NAME == "Linux" then
+    local homePath  = os.getenv("HOME") or ""
+    local userName  = os.getenv("USER") or ""
+    GAME_SCAN_ROOTS = {
+        homePath.."/.wine/drive_c",
+        homePath.."/Games",
+        homePath.."/GOG Games",
+        homePath.."/.local/share/Steam/steamapps/common",
+        homePath.."/.steam/steam/steamapps/common",
+        homePath.."/.var/app/com.valvesoftware.Steam/.local/share/Steam/steamapps/common",
+        homePath.."/.config/heroic",
+        homePath.."/.local/share/lutris",
+        "/media/"..userName,
+        "/run/media/"..userName,
+        "/mnt",
+    }
+end
+
 -- Mods
 MOD_ROOT_FOLDER = (GAME_DESTINATION_PATH .. OS_FILE_SEPARATOR ..
                 table.concat({ "Data", "Launcher", "Mods" }, OS_FILE_SEPARATOR))
@@ -139,6 +193,22 @@ MOD_ROOT_FOLDER = (GAME_DESTINATION_PATH .. OS_FILE_SEPARATOR ..
 -- Common files
 INI_PATH_MM7            = GAME_DESTINATION_PATH..OS_FILE_SEPARATOR.."mm7.ini"
 INI_PATH_MOD            = GAME_DESTINATION_PATH..OS_FILE_SEPARATOR.."mod.ini"
+-- Runtime state (caches, journal, object store, downloads) is kept in one
+-- folder outside of every manifest root (relative to launcher, same folder as
+-- AMBERLAUNCHER_STATE_DIR in core)
+LAUNCHER_STATE_PATH     = "LauncherState"
+GAME_SCAN_CACHE_PATH    = LAUNCHER_STATE_PATH..OS_FILE_SEPARATOR.."gamescan.cache"
+GAME_DETECT_CACHE_PATH  = LAUNCHER_STATE_PATH..OS_FILE_SEPARATOR.."detect.cache"
+GAME_AUTOCONFIG_JOURNAL_PATH = LAUNCHER_STATE_PATH..OS_FILE_SEPARATOR.."autoconfig.journal"
+-- Launcher's own files aren't watched, relative to game folder and '/' separated
+GAME_WATCH_EXCLUDE      = { "Data/Launcher", "LauncherState" }
+
+-- Archives extracted by DetectAndInstallMod, in order (relative to launcher)
+MOD_ARCHIVES_PATH       = table.concat({ "Data", "Launcher", "Archives" }, OS_FILE_SEPARATOR)
+MOD_ARCHIVE_FILES       = {
+    "_grayfacePatch257.zip",
+    "_mod.zip",
+}
 
 -- Generate the combinations of base paths and game folder names
 for _, basePath in ipairs(GAME_BASE_PATHS) do
@@ -12,6 +12,8 @@ fs.OS_FILE_SEPARATOR = OS_FILE_SEPARATOR
 
 local lfs = lfs  -- lfs is already available globally
 
+local FILE_COPY_CHUNK_SIZE = 1024 * 1024
+
 -------------------------------------------------------------------------------
 -- Path functions
 -------------------------------------------------------------------------------
@@ -51,8 +53,28 @@ function fs.PathResolveCaseInsensitive(base_dir, relative_path)
     return actFile and fs.PathJoin(current, actFile) or false
 end
 
+-- Scans tree once for case-insensitive lookups, nil if native index is missing
+function fs.PathIndex(root)
+    if AL and AL.PathIndex then
+        return AL.PathIndex(root)
+    end
+    return nil
+end
+
+-- Same as PathResolveCaseInsensitive, but through index when there's one
+function fs.PathResolveIndexed(index, base_dir, relative_path)
+    if index then
+        return index:resolve(relative_path) or false
+    end
+    return fs.PathResolveCaseInsensitive(base_dir, relative_path)
+end
+
 -- Recursive delete (file or directory)
 function fs.PathDelete(path)
+    if AL and AL.RemoveTree then
+        return AL.RemoveTree(path)
+    end
+
     local attr = lfs.attributes(path)
     if not attr then return false end
 
@@ -100,9 +122,24 @@ function fs.CurrentDir()
     return lfs.currentdir() or ""
 end
 
+-- Native listing: one pass, attributes without a path lookup per entry
+function fs.ListDir(dir, opts)
+    if AL and AL.ListDir then
+        return AL.ListDir(dir, opts)
+    end
+    return nil
+end
+
 function fs.DirectoryList(dir)
     local listing = {}
     local target = (dir == "" or dir == nil) and "." or dir
+    local entries = fs.ListDir(target)
+    if entries then
+        for i, entry in ipairs(entries) do
+            listing[i] = entry.name
+        end
+        return listing
+    end
     for entry in lfs.dir(target) do
         if entry ~= "." and entry ~= ".." then
             listing[#listing+1] = entry
@@ -146,6 +183,17 @@ end
 function fs.FilesList(dir)
     local files = {}
     local target = (dir == "" or dir == nil) and "." or dir
+    local entries = fs.ListDir(target)
+    if entries then
+        for _, entry in ipairs(entries) do
+            -- Symlinks are reported as such, lfs would have followed them
+            if entry.type == "file" or (entry.type == "other" and
+                lfs.attributes(fs.PathJoin(target, entry.name), "mode") == "file") then
+                files[#files+1] = entry.name
+            end
+        end
+        return files
+    end
     for entry in lfs.dir(target) do
         if entry ~= "." and entry ~= ".." then
             local full = fs.PathJoin(target, entry)
@@ -160,11 +208,15 @@ end
 
 function fs.FilesCheck(dst, fileList)
     local missing = {}
+    local index   = fs.PathIndex(dst)
     for _, rel in ipairs(fileList) do
-        if not fs.PathResolveCaseInsensitive(dst, rel) then
+        if not fs.PathResolveIndexed(index, dst, rel) then
             missing[#missing+1] = rel
         end
     end
+    if index then
+        index:close()
+    end
     if #missing == 0 then
         return true
     end
@@ -175,8 +227,8 @@ function fs.FilesCheck(dst, fileList)
     return false
 end
 
-function fs.FileCopy(srcRoot, dstRoot, rel)
-    local src = fs.PathResolveCaseInsensitive(srcRoot, rel)
+function fs.FileCopy(srcRoot, dstRoot, rel, index)
+    local src = fs.PathResolveIndexed(index, srcRoot, rel)
     if not src then
         print("Error: Source file not found: "..rel)
         return false
@@ -186,33 +238,79 @@ function fs.FileCopy(srcRoot, dstRoot, rel)
 
     fs.DirectoryEnsure(destDir)
 
+    if AL and AL.FileCopy then
+        if not AL.FileCopy(src, dest) then
+            print("Error: Failed to copy: "..rel)
+            return false
+        end
+        print("Copied: "..rel)
+        return true
+    end
+
     local r = io.open(src,  "rb"); if not r then return false end
     local w = io.open(dest, "wb"); if not w then r:close(); return false end
 
-    w:write(r:read("*all"))
+    -- LODs are hundreds of MB, never hold whole file
+    while true do
+        local chunk = r:read(FILE_COPY_CHUNK_SIZE)
+        if not chunk then break end
+        w:write(chunk)
+    end
     r:close(); w:close()
     print("Copied: "..rel)
     return true
 end
 
-function fs.FilesCopy(srcRoot, dstRoot, list)
-    for _, rel in ipairs(list) do
-        fs.FileCopy(srcRoot, dstRoot, rel)
+-- opts: {threads = N, progress = function(rel, ok, method, done, total)}
+function fs.FilesCopy(srcRoot, dstRoot, list, opts)
+    opts = opts or {}
+
+    if AL and AL.FilesCopy then
+        local ok, failed = AL.FilesCopy(srcRoot, dstRoot, list, opts)
+        for _, rel in ipairs(failed) do
+            print("Error: Failed to copy: "..rel)
+        end
+        print("File copying completed.")
+        return ok
+    end
+
+    local index  = fs.PathIndex(srcRoot)
+    local result = true
+    for i, rel in ipairs(list) do
+        local ok = fs.FileCopy(srcRoot, dstRoot, rel, index)
+        result = result and ok
+        if opts.progress then
+            opts.progress(rel, ok, ok and "copy" or "none", i, #list)
+        end
+    end
+    if index then
+        index:close()
     end
     print("File copying completed.")
+    return result
 end
 
--- Move contents of one directory into another (includes hidden files)
+-- Move contents of one directory into another (includes hidden files),
+-- src_dir itself stays. Native version merges existing subdirectories.
 function fs.FilesMove(src_dir, dst_dir)
+    local native = AL and AL.MoveTree
+
     fs.DirectoryEnsure(dst_dir)
     for entry in lfs.dir(src_dir) do
         if entry ~= "." and entry ~= ".." then
             local from = fs.PathJoin(src_dir, entry)
             local to   = fs.PathJoin(dst_dir, entry)
-            local ok, err = os.rename(from, to)
-            if not ok then
-                io.stderr:write("Move failed: "..tostring(err).."\n")
-                return false
+            if native then
+                if not AL.MoveTree(from, to) then
+                    io.stderr:write("Move failed: "..from.." -> "..to.."\n")
+                    return false
+                end
+            else
+                local ok, err = os.rename(from, to)
+                if not ok then
+                    io.stderr:write("Move failed: "..tostring(err).."\n")
+                    return false
+                end
             end
         end
     end
@@ -86,10 +86,33 @@ function OnAppInit()
     end
 end
 
+-- Changes below game folder arrive as events.FilesChanged(paths)
+local function _WatchGameFolder()
+    if AL.WatchFiles and FS.IsFilePresent(GAME_DESTINATION_PATH) then
+        local ok, how = AL.WatchFiles(GAME_DESTINATION_PATH, GAME_WATCH_EXCLUDE)
+        print("Watching game folder: "..tostring(ok and how))
+    end
+end
+
 function OnPostAppInit()
 
     print("Post App Init")
+    _WatchGameFolder()
+
+    -- Nothing changed since last successful detection -> skip the full scan
+    local cachedSrc, cachedHow, cachedMod = AL_DetectCacheLoad()
+    if cachedSrc then
+        print("Game detected from cache ("..cachedHow.."): "..cachedSrc)
+        if cachedMod ~= "" then
+            local maj, min, pat  = AL_ParseVersion(cachedMod)
+            GAME_MOD_VERSION_STR = cachedMod
+            GAME_MOD_VERSION     = maj * 2^24 + min * 2^12 + pat
+        end
+        print("MOD VERSION: "..tostring(GAME_MOD_VERSION))
+        return
+    end
 
+    -- No drive scan on startup, autoconfig runs it
     local src, how = AL_DetectGame(nil, false) -- "."
     if not src then
         AL.UICall(UIEVENT.AUTOCONFIG)
@@ -99,6 +122,8 @@ function OnPostAppInit()
     -- Set GAME_MOD_VERSION during check (second argument)
     AL_DetectMod(GAME_DESTINATION_PATH, true)
     print("MOD VERSION: "..tostring(GAME_MOD_VERSION))
+
+    AL_DetectCacheSave(src, how)
 end
 
 function OnAppDestroy()
@@ -113,27 +138,26 @@ end
 
 function OnAppConfigure()
 
-    local configSuccessful = true
+    local configSuccessful
 
     FS.DirectoryEnsure(GAME_DESTINATION_PATH)
+    AL_DetectCacheInvalidate()
+    _WatchGameFolder()
 
-    -- Execute all available commands
+    -- Execute all available commands (already sorted by priority)
     local commandTable = AL.GetTableOfCommands()
-    table.sort(commandTable, function(a, b)
-        return a.priority < b.priority
-    end)
     print("List of commands: ")
     for _, cmd in ipairs(commandTable) do
-        print("\t* "..cmd.name.." ["..cmd.priority.."]")
+        print("\t* "..cmd.name.." ["..cmd.priority.."]"..
+            (cmd.after and " after: "..table.concat(cmd.after, ", ") or ""))
     end
 
-    -- Execute all commands
+    -- Execute all commands, independent ones overlap their native work
     AL_print("Configuration start...")
-    for _, cmd in ipairs(commandTable) do
-        if not AL.CommandCall(cmd.name) then
-            configSuccessful = false
-            break
-        end
+    local failedCommand
+    configSuccessful, failedCommand = AL.CommandRunAll()
+    if failedCommand then
+        print("Configuration stopped at: "..failedCommand)
     end
     --AL.CommandCall("DetectAndCopyGame")
 
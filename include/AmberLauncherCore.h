@@ -34,6 +34,17 @@ AmberLauncher_Play(struct AppCore* pApp);
 extern CAPI void
 AmberLauncher_Update(struct AppCore* pApp, CBOOL bIsPostUpdate);
 
+/**
+ * @brief       Delivers changes seen by AL.WatchFiles() watcher to Lua as
+ *              events.FilesChanged(paths). Call periodically from thread
+ *              that owns Lua state.
+ *
+ * @param       pApp
+ * @return      size_t Number of changed paths (0: event wasn't fired)
+ */
+extern CAPI size_t
+AmberLauncher_ProcessFileChanges(struct AppCore *pApp);
+
 extern CAPI void
 AmberLauncher_ExecuteLua(struct AppCore *pApp, const char *sCommand);
 
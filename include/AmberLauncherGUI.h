@@ -13,6 +13,9 @@
 
 struct AppCore;
 struct SObserver;
+struct SObjectStore;
+struct SSnapshot;
+struct SHashCache;
 
 /******************************************************************************
  * MACROS
@@ -87,6 +90,7 @@ typedef enum
     UIEVENT_MODAL_MODS,
     UIEVENT_MODAL_TOOLS,
     UIEVENT_MODAL_UPDATER,
+    UIEVENT_MODAL_VERIFY,
     UIEVENT_MAX
 } EUIEventType;
 
@@ -97,6 +101,19 @@ typedef enum
     LOC_MAX
 } ELocTier;
 
+typedef enum
+{
+    UPDATER_JOB_QUEUED,
+    UPDATER_JOB_RUNNING,
+    UPDATER_JOB_SKIPPED,
+    UPDATER_JOB_RESTORED,
+    UPDATER_JOB_DONE,
+    UPDATER_JOB_FAILED,
+    UPDATER_JOB_VERIFIED,
+    UPDATER_JOB_MISSING,
+    UPDATER_JOB_CORRUPT
+} EUpdaterJobState;
+
 /******************************************************************************
  * VARIABLES
  ******************************************************************************/
@@ -203,6 +220,7 @@ typedef struct _AppGUIWidgets
     PopUp              *pPopupCore;
     PopUp              *pPopupMod;
     View               *pLocaleView;
+    Button             *pButtonUpdate;      /* sidebar, update badge */
 } AppGUIWidgets;
 
 typedef struct _AppGUIElementDB
@@ -233,6 +251,11 @@ typedef struct _AppGUI
     unsigned int        dPage;
     unsigned int        dPageMax;
 
+    struct _InetUpdaterSession *pUpdaterSession;
+    struct _InetUpdaterCheckTask *pUpdaterCheck;    /* NULL if no check is running */
+    struct _InetUpdaterRunTask *pUpdaterRun;        /* NULL if no update/verify is running */
+    bool_t              bUnattended;                /* "--update": quit once update is over */
+
     EPanelType          eCurrentPanel;
     EUIEventType        eCurrentUIEvent;
 } AppGUI;
@@ -260,6 +283,7 @@ typedef struct _InetUpdaterFile
     String             *path;
     String             *sha256;
     uint32_t            size;
+    uint32_t            packed;     /* size of "<path>.deflate", 0 if absent */
 } InetUpdaterFile;
 
 typedef struct _InetUpdaterJSONData
@@ -272,6 +296,107 @@ typedef struct _InetUpdaterJSONData
 
 DeclSt(InetUpdaterFile);
 
+/******************************************************************************
+ * STRUCTS (UPDATER)
+ ******************************************************************************/
+
+typedef struct _InetUpdaterJob
+{
+    const char_t       *sPath;
+    const char_t       *sSHA256;
+    String             *sURL;
+
+    uint32_t            dSize;
+    uint32_t            dPackedSize;
+    uint32_t            dTransferSize;  /* bytes over the wire */
+    uint32_t            dBytesDone;
+    uint32_t            dResumedAt;
+    uint32_t            dAttempts;
+    uint32_t            eLink;          /* ESObjectLink when restored */
+    uint64_t            dHashUs;        /* metrics, touched by owning worker only */
+    uint64_t            dDownloadUs;
+    uint64_t            dWriteUs;
+    uint64_t            dTotalUs;
+    EUpdaterJobState    eState;
+    bool_t              bForceDownload;
+    bool_t              bReported;
+} InetUpdaterJob;
+
+/* Shared between GUI thread and download workers, guarded by pMutex */
+typedef struct _InetUpdaterScheduler
+{
+    InetUpdaterJob     *pJobs;
+    Mutex              *pMutex;
+    struct SObjectStore *pObjectStore;  /* NULL if unavailable, thread-safe */
+    struct SSnapshot   *pSnapshot;      /* NULL if unavailable, thread-safe */
+    struct SHashCache  *pHashCache;     /* NULL if unavailable, thread-safe */
+
+    uint32_t            dNumJobs;
+    uint32_t            dMaxJobs;
+    uint32_t            dNextJob;
+    uint32_t            dFinishedJobs;
+    uint32_t            dMaxRetries;
+    uint64_t            dBytesTotal;
+    uint64_t            dBytesDone;
+    bool_t              bCancelled;     /* workers take no more jobs */
+} InetUpdaterScheduler;
+
+/* Last fetched manifest, revalidated with conditional GET */
+typedef struct _InetUpdaterManifestCache
+{
+    String                  *sManifestURL;  /* as configured (json) */
+    String                  *sSourceURL;    /* actually fetched (bin or json) */
+    String                  *sETag;
+    String                  *sLastModified;
+    InetUpdaterJSONData     *pData;
+    bool_t                  bNotModified;   /* last fetch answered with 304 */
+} InetUpdaterManifestCache;
+
+/* Lives as long as AppGUI, shared by update check and update */
+typedef struct _InetUpdaterSession
+{
+    InetUpdaterManifestCache tLauncher;
+    InetUpdaterManifestCache tMod;
+} InetUpdaterSession;
+
+/* Background update check. Worker thread owns everything but pApp */
+typedef struct _InetUpdaterCheckTask
+{
+    AppGUI                  *pApp;          /* NULL once AppGUI is gone */
+    InetUpdaterSession      *pSession;
+    String                  *sLauncherURL;
+    String                  *sModURL;
+    String                  *sIniPath;
+    int32_t                 dLauncherVersion;
+    int32_t                 dModVersion;
+    uint32_t                dInterval;
+    bool_t                  bUpdateAvailable;
+} InetUpdaterCheckTask;
+
+/* Update, verify or repair run. Worker pool runs in osapp task thread,
+ * GUI thread reports progress and takes over once workers are joined */
+typedef struct _InetUpdaterRunTask
+{
+    AppGUI                  *pApp;          /* NULL once AppGUI is gone */
+    InetUpdaterScheduler    tScheduler;
+    uint32_t                (*cbWorker)(InetUpdaterScheduler *pScheduler);
+    void                    (*cbEnd)(struct _InetUpdaterRunTask *pTask, uint32_t dFailed);
+    uint32_t                dConnections;
+    uint64_t                dWallUs;
+    bool_t                  bRepair;
+    bool_t                  bFinished;      /* workers joined, guarded by tScheduler.pMutex */
+} InetUpdaterRunTask;
+
+/* Directory walk looking for files that aren't in manifest */
+typedef struct _InetUpdaterExtraScan
+{
+    AppGUI                  *pApp;
+    const char_t            **pPaths;       /* manifest paths, sorted */
+    uint32_t                dNumPaths;
+    const char_t            *sDir;
+    uint32_t                dExtra;
+} InetUpdaterExtraScan;
+
 /******************************************************************************
  * HEADER DECLARATIONS
  ******************************************************************************/
@@ -433,6 +558,16 @@ Panel_GetModalTools(AppGUI *pApp);
 extern Panel *
 Panel_GetModalUpdater(AppGUI *pApp);
 
+/**
+ * @relatedalso Panel
+ * @brief       Shows game file verification window
+ *
+ * @param       pApp
+ * @return      Panel*
+ */
+extern Panel *
+Panel_GetModalVerify(AppGUI *pApp);
+
 /**
  * @relatedalso Internet
  * @brief       Initialises amber laucnher related inet data
@@ -452,15 +587,49 @@ AutoUpdate_CheckForUpdates(AppGUI *pApp);
 
 /**
  * @relatedalso Internet
- * @brief       Executes update session
+ * @brief       Starts background update check if it's due (see
+ *              UPDATER_CHECK_INTERVAL). Result is cached in mod.ini and
+ *              shown on sidebar update button once check finishes.
+ *
+ * @param       pApp
+ * @return      bool_t TRUE if last cached check found an update
+ */
+extern bool_t
+AutoUpdate_ScheduleCheck(AppGUI *pApp);
+
+/**
+ * @relatedalso Internet
+ * @brief       Starts update session in background. Progress goes to
+ *              updater modal, which closes once update succeeds.
  *
  * @param       pApp
  * @param       bForceDownload
- * @return      bool_t TRUE On success
+ * @return      bool_t TRUE if update was started
  */
 extern bool_t
 AutoUpdate_Update(AppGUI *pApp, bool_t bForceDownload);
 
+/**
+ * @relatedalso Internet
+ * @brief       Starts verifying mod files against mod manifest (size, then
+ *              sha256) in background, reports missing, corrupt and extra files
+ *
+ * @param       pApp
+ * @param       bRepair Re-downloads missing and corrupt files
+ * @return      bool_t TRUE if verification was started
+ */
+extern bool_t
+AutoUpdate_Verify(AppGUI *pApp, bool_t bRepair);
+
+/**
+ * @relatedalso Internet
+ * @brief       Releases updater session (cached manifests)
+ *
+ * @param       pApp
+ */
+extern void
+AutoUpdate_Finish(AppGUI *pApp);
+
 /******************************************************************************
  * HEADER CALLBACK DECLARATIONS
  ******************************************************************************/
@@ -595,6 +764,16 @@ Callback_OnButtonModalTools(AppGUI *pApp, Event *e);
 extern void
 Callback_OnButtonModalUpdater(AppGUI *pApp, Event *e);
 
+/**
+ * @relatedalso Callback
+ * @brief       Handles verify window buttons (verify, repair, close)
+ *
+ * @param       pApp
+ * @param       e
+ */
+extern void
+Callback_OnButtonModalVerify(AppGUI *pApp, Event *e);
+
 /**
  * @relatedalso Async
  * @brief       Schedules task thread to replace main panel
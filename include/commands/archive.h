@@ -20,4 +20,12 @@ SCommand_Callback_Archive(const struct SCommand* pSelf, const struct SCommandArg
 extern CAPI int
 LUA_ArchiveExtract(struct lua_State* L);
 
+/**
+ * @relatedalso             Commands
+ * @brief                   Lua: AL.ArchiveSize(zip) -> bytes, files | nil.
+ *                          Uncompressed size from central directory.
+ */
+extern CAPI int
+LUA_ArchiveSize(struct lua_State* L);
+
 #endif
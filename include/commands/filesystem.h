@@ -0,0 +1,134 @@
+#ifndef __AMBER_LAUNCHER_COMMAND_FILESYSTEM_H
+#define __AMBER_LAUNCHER_COMMAND_FILESYSTEM_H
+
+#include <core/common.h>
+
+struct lua_State;
+
+/**
+ * @relatedalso             Commands
+ * @brief                   Registers "PathIndex" metatable
+ *
+ * @param L
+ * @return int
+ */
+extern CAPI int
+LUA_REGISTER_PathIndex(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.PathIndex(root): scans root once, returns index
+ *                          with :resolve(rel), :count() and :close(), or nil
+ *                          if root can't be read
+ */
+extern CAPI int
+LUA_PathIndex(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   index:resolve(rel): case-insensitive lookup,
+ *                          returns "<root><sep><path as on disk>" or nil
+ */
+extern CAPI int
+LUA_PathIndexResolve(struct lua_State* L);
+
+extern CAPI int
+LUA_PathIndexCount(struct lua_State* L);
+
+extern CAPI int
+LUA_PathIndexClose(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.FileCopy(src, dst): copies file without loading
+ *                          it into memory, keeps mtime. Returns true and method
+ *                          ("reflink", "copy") or false.
+ */
+extern CAPI int
+LUA_FileCopy(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.FilesCopy(srcRoot, dstRoot, list, {threads=N,
+ *                          link=bool, copy={...},
+ *                          progress=function(rel, ok, method, done, total)})
+ *                          copies listed files on worker pool, names are
+ *                          resolved case-insensitively. With link, files not
+ *                          listed in copy may be hardlinked. Returns true if
+ *                          all files were copied, and table of failed ones.
+ */
+extern CAPI int
+LUA_FilesCopy(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.RemoveTree(path): deletes file or directory
+ *                          tree, returns true if nothing was left behind
+ */
+extern CAPI int
+LUA_RemoveTree(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.MoveTree(src, dst): moves file or directory,
+ *                          merging into existing directories (copy + delete
+ *                          across filesystems). Returns boolean.
+ */
+extern CAPI int
+LUA_MoveTree(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.FindGame(roots, {exe=, files={...}, exclude={...},
+ *                          depth=, threads=, cache=}) searches roots for game
+ *                          directory, returns its path or nil
+ */
+extern CAPI int
+LUA_FindGame(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.NormalizeCase(root, {folders={...}, files={...}})
+ *                          renames entries of root to listed spelling, extra
+ *                          variants are merged into (folders) or replace
+ *                          (files) canonical one, missing folders are created.
+ *                          Returns true if nothing failed, and list of
+ *                          {action=, from=, to=, ok=} where action is
+ *                          "rename", "merge", "overwrite", "create" or
+ *                          "missing" (file, ok is false, doesn't count as
+ *                          failure).
+ */
+extern CAPI int
+LUA_NormalizeCase(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.ListDir(path, {recursive=bool, attrs=bool})
+ *                          lists directory in one pass, returns array of
+ *                          {name=, type=} ("file", "directory", "other";
+ *                          names relative to path with '/'), with size and
+ *                          mtime (seconds) when attrs is set. Symlinks are
+ *                          "other" and never followed. nil if path can't be
+ *                          read.
+ */
+extern CAPI int
+LUA_ListDir(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.DiskSpace(path) -> free, total (bytes) of
+ *                          filesystem holding path, nil on failure.
+ */
+extern CAPI int
+LUA_DiskSpace(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.WriteBenchmark(dir, [bytes]) writes and syncs
+ *                          temporary file in dir, returns bytes per second,
+ *                          nil if it couldn't be written. File is removed.
+ */
+extern CAPI int
+LUA_WriteBenchmark(struct lua_State* L);
+
+#endif
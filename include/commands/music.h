@@ -21,4 +21,12 @@ SCommand_Callback_ConvertMusic(const struct SCommand* pSelf, const struct SComma
 extern CAPI int
 LUA_ConvertMP3ToWAV(struct lua_State* L);
 
+/**
+ * @relatedalso             Commands
+ * @brief                   Lua: AL.MP3ToWAVSize(path) -> bytes | nil.
+ *                          Size of *.wav ConvertMP3ToWAV would produce.
+ */
+extern CAPI int
+LUA_MP3ToWAVSize(struct lua_State* L);
+
 #endif
@@ -0,0 +1,56 @@
+#ifndef __AMBER_LAUNCHER_COMMAND_OBJSTORE_H
+#define __AMBER_LAUNCHER_COMMAND_OBJSTORE_H
+
+#include <core/common.h>
+
+struct lua_State;
+struct SObjectStore;
+
+/**
+ * @relatedalso             Commands
+ * @brief                   Makes object store available to Lua bindings
+ *                          (kept in Lua registry, owned by AppCore)
+ *
+ * @param L
+ * @param pStore            Can be NULL (store unavailable)
+ */
+extern CAPI void
+LUA_REGISTER_ObjectStore(struct lua_State* L, struct SObjectStore* pStore);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   Returns object store registered with Lua state
+ *
+ * @param L
+ * @return struct SObjectStore* NULL if unavailable
+ */
+extern CAPI struct SObjectStore*
+LUA_GetObjectStore(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.ObjectStoreInstall(src, dst): puts src into
+ *                          object store and links it to dst.
+ *                          Returns "reflink"/"hardlink"/"copy" or nil.
+ */
+extern CAPI int
+LUA_ObjectStoreInstall(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.ObjectStoreImport(path): puts file into object
+ *                          store, returns its sha256 or nil
+ */
+extern CAPI int
+LUA_ObjectStoreImport(struct lua_State* L);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.UpdateRollback(): restores files replaced by
+ *                          last update from its snapshot.
+ *                          Returns number of restored files or nil, error.
+ */
+extern CAPI int
+LUA_UpdateRollback(struct lua_State* L);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef __AMBER_LAUNCHER_COMMAND_UPDMETRICS_H
+#define __AMBER_LAUNCHER_COMMAND_UPDMETRICS_H
+
+#include <core/common.h>
+
+struct lua_State;
+struct SUpdaterMetrics;
+
+/**
+ * @relatedalso             Commands
+ * @brief                   Makes updater metrics available to Lua bindings
+ *                          (kept in Lua registry, owned by AppCore)
+ *
+ * @param L
+ * @param pMetrics          Can be NULL
+ */
+extern CAPI void
+LUA_REGISTER_UpdaterMetrics(struct lua_State* L, struct SUpdaterMetrics* pMetrics);
+
+/**
+ * @relatedalso             Commands
+ * @brief                   AL.UpdaterMetrics(): returns table describing last
+ *                          update/verify session (times in seconds, rates in
+ *                          bytes/s, per file entries in "files") or nil if
+ *                          there was none yet
+ */
+extern CAPI int
+LUA_UpdaterMetrics(struct lua_State* L);
+
+#endif
@@ -9,6 +9,8 @@
 
  struct SLuaState;
  struct SSubject;
+ struct SObjectStore;
+ struct SUpdaterMetrics;
 
  /******************************************************************************
   * STRUCTS
@@ -30,6 +32,9 @@ struct AppCore
     struct SSubject* pOnUserEventNotifier;
     UICallback cbUIEvent;
     char *sLaunchCmd;
+    struct SObjectStore* pObjectStore;
+    struct SUpdaterMetrics* pUpdaterMetrics;
+    struct SFSWatch* pFSWatch;
 };
 
 /******************************************************************************
@@ -0,0 +1,79 @@
+#ifndef SCOMMANDGRAPH_H_
+#define SCOMMANDGRAPH_H_
+
+#include <core/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * FORWARD DECLARATIONS
+ ******************************************************************************/
+
+struct lua_State;
+struct SCommandList;
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SCOMMANDGRAPH_MAX_WORKERS       4
+/** Main thread polls finished work while nothing else can run */
+#define SCOMMANDGRAPH_POLL_MS           5
+
+/******************************************************************************
+ * TYPEDEFS
+ ******************************************************************************/
+
+/** Runs on worker thread: must not touch Lua, owns (and frees) pData */
+typedef CBOOL (*FCommandGraphWork)(void *pData);
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SCommandGraph
+ * @brief       Runs every command once its dependencies (SCommand.pAfter)
+ *              succeeded, ready commands start in priority order. Commands
+ *              without SCOMMAND_FLAG_AFTER wait for all commands of lower
+ *              priority. Lua commands run as coroutines on calling thread, so
+ *              Lua state is only ever used by one thread; while one waits for
+ *              SCommandGraph_LuaAwait work others may run. After a failure
+ *              nothing new starts, running commands are finished.
+ *              Unknown dependency names are ignored, cycles fail before
+ *              anything runs.
+ *
+ * @param       L           Main Lua state
+ * @param       pList       Commands are copied, list may change while running
+ * @param       sFailed     Receives name of first failed command, can be NULL
+ * @return      CBOOL Every command succeeded
+ */
+extern CAPI CBOOL
+SCommandGraph_Run(
+    struct lua_State *L,
+    struct SCommandList *pList,
+    const char **sFailed);
+
+/**
+ * @relatedalso SCommandGraph
+ * @brief       For Lua bindings: when called from command coroutine of
+ *              SCommandGraph_Run, cbWork goes to worker thread and coroutine
+ *              yields until it's done; anywhere else it runs right away.
+ *              Either way Lua caller gets boolean result.
+ *              Use as: return SCommandGraph_LuaAwait(L, cbWork, pData);
+ *
+ * @param       L
+ * @param       cbWork
+ * @param       pData       Must not reference Lua values
+ * @return      int Number of Lua results, or lua_yield()
+ */
+extern CAPI int
+SCommandGraph_LuaAwait(struct lua_State *L, FCommandGraphWork cbWork, void *pData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
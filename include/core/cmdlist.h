@@ -0,0 +1,114 @@
+#ifndef SCOMMANDLIST_H_
+#define SCOMMANDLIST_H_
+
+#include <core/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * FORWARD DECLARATIONS
+ ******************************************************************************/
+
+struct SCommand;
+typedef struct SCommandList SCommandList;
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SCOMMANDLIST_MIN_BUCKETS        64
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SCommandList
+ * @brief       Creates empty list. Commands are kept sorted by priority
+ *              (equal ones in order they were added) and indexed by name.
+ *
+ * @param       dReserve    Expected number of commands
+ * @return      SCommandList* NULL on allocation failure
+ */
+extern CAPI SCommandList*
+SCommandList_new(size_t dReserve);
+
+/**
+ * @relatedalso SCommandList
+ * @brief       Frees list, names and dependencies of its commands.
+ *              Lua references are left to caller.
+ *
+ * @param       pList
+ */
+extern CAPI void
+SCommandList_delete(SCommandList **pList);
+
+/**
+ * @relatedalso SCommandList
+ * @brief       Adds copy of command at its priority position, list owns copy
+ *              of sName and takes over pAfter
+ *
+ * @param       pList
+ * @param       pCommand
+ * @return      SCommand* Stored command, NULL if name is taken or on failure
+ */
+extern CAPI struct SCommand*
+SCommandList_Add(SCommandList *pList, const struct SCommand *pCommand);
+
+/**
+ * @relatedalso SCommandList
+ * @brief       Changes priority and moves command to its new position
+ *
+ * @param       pList
+ * @param       pCommand    Must be stored in pList
+ * @param       dPriority
+ * @return      SCommand* Command at its new address
+ */
+extern CAPI struct SCommand*
+SCommandList_SetPriority(SCommandList *pList, struct SCommand *pCommand, int dPriority);
+
+/**
+ * @relatedalso SCommandList
+ * @brief       Hashed lookup by name
+ *
+ * @param       pList
+ * @param       sName
+ * @return      long Position in priority order, -1 if there's no such command
+ */
+extern CAPI long
+SCommandList_IndexOf(const SCommandList *pList, const char *sName);
+
+/**
+ * @relatedalso SCommandList
+ * @brief       Same as SCommandList_Get(pList, SCommandList_IndexOf(...))
+ *
+ * @param       pList
+ * @param       sName
+ * @return      SCommand* NULL if there's no such command
+ */
+extern CAPI struct SCommand*
+SCommandList_Find(SCommandList *pList, const char *sName);
+
+/**
+ * @relatedalso SCommandList
+ * @brief       Returns command at position in priority order. Pointers stay
+ *              valid until next SCommandList_Add or SCommandList_SetPriority,
+ *              commands are contiguous (&Get(0)[i] == Get(i)).
+ *
+ * @param       pList
+ * @param       dIndex
+ * @return      SCommand* NULL when out of range
+ */
+extern CAPI struct SCommand*
+SCommandList_Get(SCommandList *pList, size_t dIndex);
+
+extern CAPI size_t
+SCommandList_GetSize(const SCommandList *pList);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -27,6 +27,7 @@ typedef struct SCommand SCommand;
 #define SCOMMAND_FLAG_POSTINIT          0x02 /**< Process this command at the end of function */
 #define SCOMMAND_FLAG_CLEANUP           0x04 /**< Processes inside CEngine_delete */
 #define SCOMMAND_FLAG_LUA               0x08 /**< Created using lua */
+#define SCOMMAND_FLAG_AFTER             0x10 /**< Dependencies declared in pAfter (otherwise: all commands of lower priority) */
 
 /******************************************************************************
  * STRUCTS
@@ -66,6 +67,8 @@ struct SCommand
     int8            dNumArgs;       /**< Number of arguments inside SCommandArg */
     int             dLuaRef;        /**< Lua Reference */
     int             dPriority;      /**< Priority (for internal sorting) */
+    char**          pAfter;         /**< Names of commands that must finish first */
+    uint32          dAfterCount;    /**< Number of names inside pAfter */
 };
 
 /******************************************************************************
@@ -122,6 +125,28 @@ SCommand_IsFlagSet(const SCommand* pCommand, unsigned int dFlag);
 extern CAPI void
 SCommand_ClearFlag(SCommand* pCommand, unsigned int dFlag);
 
+/**
+ * @relatedalso SCommand
+ * @brief       Replaces dependencies (names are copied) and sets
+ *              SCOMMAND_FLAG_AFTER
+ * 
+ * @param       pCommand 
+ * @param       pNames 
+ * @param       dCount      0 means no dependencies at all
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SCommand_SetAfter(SCommand* pCommand, const char* const* pNames, uint32 dCount);
+
+/**
+ * @relatedalso SCommand
+ * @brief       Frees dependencies, command goes back to priority order
+ * 
+ * @param       pCommand 
+ */
+extern CAPI void
+SCommand_ClearAfter(SCommand* pCommand);
+
 /**
  * @relatedalso SCommandArg
  * @brief       Makes CCommandArg with intValue = 0;
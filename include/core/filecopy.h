@@ -0,0 +1,120 @@
+#ifndef SFILECOPY_H_
+#define SFILECOPY_H_
+
+#include <core/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/** File is written next to destination first and moved over it once complete */
+#define SFILECOPY_TMP_SUFFIX            ".altmp"
+#define SFILECOPY_MAX_THREADS           16
+/** How often batch copy reports finished files to caller */
+#define SFILECOPY_POLL_MS               20
+
+/******************************************************************************
+ * ENUMS
+ ******************************************************************************/
+
+typedef enum ESFileCopy
+{
+    SFILECOPY_NONE,             /*!< Failed */
+    SFILECOPY_REFLINK,          /*!< Copy-on-write clone */
+    SFILECOPY_HARDLINK,         /*!< Same inode as source */
+    SFILECOPY_COPY,             /*!< Full copy */
+    SFILECOPY_MAX
+
+} ESFileCopy;
+
+extern const char* ESFileCopyStrings[];
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SFileCopyResult
+{
+    const char      *sRelPath;      /**< as requested */
+    ESFileCopy      eResult;
+    uint64          dSize;
+} SFileCopyResult;
+
+/******************************************************************************
+ * TYPEDEFS
+ ******************************************************************************/
+
+/** Called on thread that runs batch, in order files finish */
+typedef void (*FSFileCopyProgress)(const SFileCopyResult *pResult,
+    size_t dDone, size_t dTotal, void *pUserData);
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SFileCopy
+ * @brief       Copies single file, cheapest way first: reflink, in-kernel
+ *              copy, chunked read/write. Destination is replaced atomically,
+ *              modification time is taken from source. Parent directory of
+ *              destination must exist.
+ *
+ * @param       sSrcPath
+ * @param       sDstPath
+ * @return      ESFileCopy SFILECOPY_NONE on failure
+ */
+extern CAPI ESFileCopy
+SFileCopy_File(const char *sSrcPath, const char *sDstPath);
+
+/**
+ * @relatedalso SFileCopy
+ * @brief       Same as SFileCopy_File, but hardlinks file when it can't be
+ *              cloned and both paths are on same filesystem. Only for files
+ *              nobody writes to in place: writes through link change source.
+ *
+ * @param       sSrcPath
+ * @param       sDstPath
+ * @return      ESFileCopy SFILECOPY_NONE on failure
+ */
+extern CAPI ESFileCopy
+SFileCopy_Link(const char *sSrcPath, const char *sDstPath);
+
+/**
+ * @relatedalso SFileCopy
+ * @brief       Copies list of files from one root to another on worker pool.
+ *              Source names are resolved case-insensitively (single scan of
+ *              source root), destination gets them as they are on disk.
+ *              Largest files start first so small ones fill in around them.
+ *
+ * @param       sSrcRoot
+ * @param       sDstRoot
+ * @param       pRelPaths
+ * @param       pLinkable   Per file: may be hardlinked (SFileCopy_Link),
+ *                          NULL copies everything
+ * @param       dCount
+ * @param       dThreads    Clamped to 1..SFILECOPY_MAX_THREADS
+ * @param       cbProgress  Can be NULL
+ * @param       pUserData
+ * @return      size_t Number of files that failed (missing ones included)
+ */
+extern CAPI size_t
+SFileCopy_Batch(
+    const char          *sSrcRoot,
+    const char          *sDstRoot,
+    const char * const  *pRelPaths,
+    const CBOOL         *pLinkable,
+    size_t              dCount,
+    uint32              dThreads,
+    FSFileCopyProgress  cbProgress,
+    void                *pUserData
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
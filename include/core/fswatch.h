@@ -0,0 +1,90 @@
+#ifndef SFSWATCH_H_
+#define SFSWATCH_H_
+
+#include <core/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/** Fallback rescans whole tree this often */
+#define SFSWATCH_POLL_INTERVAL_MS       2000
+/** How long watcher thread may take to notice it's being stopped */
+#define SFSWATCH_WAIT_MS                250
+/** Past this many undelivered paths only "everything changed" is reported */
+#define SFSWATCH_MAX_PENDING            1024
+#define SFSWATCH_MAX_DEPTH              16
+
+/******************************************************************************
+ * TYPEDEFS
+ ******************************************************************************/
+
+typedef struct SFSWatch SFSWatch;
+
+/** sRelPath uses '/', "" means anything in tree may have changed */
+typedef void (*FSFSWatchChange)(const char *sRelPath, void *pUserData);
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SFSWatch
+ * @brief       Starts watcher thread for directory tree. Uses inotify or
+ *              ReadDirectoryChangesW where available, otherwise compares size
+ *              and mtime of every entry each SFSWATCH_POLL_INTERVAL_MS.
+ *              Symlinks aren't followed.
+ *
+ * @param       sRoot
+ * @param       pExclude        Relative paths ('/' separated, case-insensitive)
+ *                              neither watched nor reported, with everything
+ *                              below them. Can be NULL.
+ * @param       dExcludeCount
+ * @return      SFSWatch* NULL if root can't be read
+ */
+extern CAPI SFSWatch*
+SFSWatch_Start(const char *sRoot, const char * const *pExclude, size_t dExcludeCount);
+
+/**
+ * @relatedalso SFSWatch
+ * @brief       Hands over changes collected since last call, each path once
+ *
+ * @param       pWatch
+ * @param       cbChange    Called on calling thread
+ * @param       pUserData
+ * @return      size_t Number of paths reported
+ */
+extern CAPI size_t
+SFSWatch_Drain(SFSWatch *pWatch, FSFSWatchChange cbChange, void *pUserData);
+
+/**
+ * @relatedalso SFSWatch
+ * @brief       Whether changes come from kernel (CFALSE: polling)
+ *
+ * @param       pWatch
+ * @return      CBOOL
+ */
+extern CAPI CBOOL
+SFSWatch_IsNative(const SFSWatch *pWatch);
+
+extern CAPI const char*
+SFSWatch_GetRoot(const SFSWatch *pWatch);
+
+/**
+ * @relatedalso SFSWatch
+ * @brief       Stops thread and frees watcher, undelivered changes are lost
+ *
+ * @param       pWatch
+ */
+extern CAPI void
+SFSWatch_Stop(SFSWatch **pWatch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
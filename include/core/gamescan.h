@@ -0,0 +1,72 @@
+#ifndef SGAMESCAN_H_
+#define SGAMESCAN_H_
+
+#include <core/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SGAMESCAN_MAX_THREADS           16
+/** Idle workers poll queue while others are still listing directories */
+#define SGAMESCAN_POLL_MS               5
+/** Cached miss skips scanning for a day, game installed meanwhile needs rescan */
+#define SGAMESCAN_MISS_TTL_S            (24.0 * 60.0 * 60.0)
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SGameScanOptions
+{
+    const char * const  *pRoots;
+    size_t              dRootCount;
+    const char          *sExecutable;       /**< file name, case-insensitive */
+    const char * const  *pRequired;         /**< paths that must exist next to executable */
+    size_t              dRequiredCount;
+    const char * const  *pExclude;          /**< directory names never entered, case-insensitive */
+    size_t              dExcludeCount;
+    uint32              dMaxDepth;          /**< directory levels below root */
+    uint32              dThreads;
+    const char          *sCachePath;        /**< last match or miss, NULL disables cache */
+} SGameScanOptions;
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SGameScan
+ * @brief       Searches roots breadth-first on worker pool for directory with
+ *              executable and all required files, stops at first match.
+ *              Hidden directories and symlinks below roots aren't entered.
+ *              Cached match is returned without scan while it's still valid,
+ *              cached miss for SGAMESCAN_MISS_TTL_S. Removing cache file
+ *              forces new scan.
+ *
+ * @param       pOptions
+ * @return      char* Directory (malloc'd, caller frees), NULL if not found
+ */
+extern CAPI char*
+SGameScan_Find(const SGameScanOptions *pOptions);
+
+/**
+ * @relatedalso SGameScan
+ * @brief       Checks single directory the same way scan does
+ *
+ * @param       pOptions    Only executable and required files are used
+ * @param       sDirectory
+ * @return      CBOOL
+ */
+extern CAPI CBOOL
+SGameScan_IsValid(const SGameScanOptions *pOptions, const char *sDirectory);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
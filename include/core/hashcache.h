@@ -0,0 +1,90 @@
+#ifndef SHASHCACHE_H_
+#define SHASHCACHE_H_
+
+#include <core/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * FORWARD DECLARATIONS
+ ******************************************************************************/
+
+typedef struct SHashCache SHashCache;
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SHASHCACHE_SHA256_HEX_SIZE      64
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SHashCache
+ * @brief       Loads sha256 cache (path, size, mtime -> sha256) from file.
+ *              Missing or unreadable file results in empty cache.
+ *
+ * @param       sCachePath
+ * @return      SHashCache* NULL on allocation failure
+ */
+extern CAPI SHashCache*
+SHashCache_Load(const char *sCachePath);
+
+/**
+ * @relatedalso SHashCache
+ * @brief       Writes cache back (atomically). Only entries looked up since
+ *              load are kept, so removed files don't pile up.
+ *
+ * @param       pCache
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SHashCache_Save(SHashCache *pCache);
+
+/**
+ * @relatedalso SHashCache
+ * @brief       Returns sha256 of file, hashing it only if its size or mtime
+ *              differ from cached entry. Thread-safe.
+ *
+ * @param       pCache
+ * @param       sPath
+ * @param       sHexOut     SHASHCACHE_SHA256_HEX_SIZE + 1 bytes
+ * @param       dSizeOut    Can be NULL
+ * @return      CBOOL CFALSE if file can't be read
+ */
+extern CAPI CBOOL
+SHashCache_HashFile(
+    SHashCache *pCache,
+    const char *sPath,
+    char *sHexOut,
+    uint64 *dSizeOut);
+
+/**
+ * @relatedalso SHashCache
+ * @brief       Returns number of lookups served from cache and hashed files
+ *
+ * @param       pCache
+ * @param       dHits
+ * @param       dMisses
+ */
+extern CAPI void
+SHashCache_GetStats(SHashCache *pCache, uint32 *dHits, uint32 *dMisses);
+
+/**
+ * @relatedalso SHashCache
+ * @brief       Frees cache (without saving)
+ *
+ * @param       pCache
+ */
+extern CAPI void
+SHashCache_delete(SHashCache **pCache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -16,6 +16,11 @@ extern void
 luaL_traceback(lua_State *L, lua_State *L1, const char *msg, int level);
 #endif
 
+/* lua_resume for every supported version (signature changed in 5.2 and 5.4),
+ * results or yielded values are left on top of L's stack */
+extern int
+luainc_resume(lua_State *L, lua_State *from, int narg);
+
 /******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -0,0 +1,132 @@
+#ifndef SMANIFEST_H_
+#define SMANIFEST_H_
+
+#include <core/common.h>
+#include <core/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Binary manifest layout (all integers little-endian)
+ *
+ *  header: "ALMB" | u16 version | u16 flags | u32 body size (uncompressed)
+ *  body:   str schema | str generated | i32 version | i32 build | u32 count
+ *          count * (str path | 32 bytes sha256 | u32 size | u32 packed size)
+ *  str:    u16 length | bytes (no terminator)
+ *
+ *  With SMANIFEST_FLAG_DEFLATE the body is a zlib stream.
+ *  Files with packed size > 0 are also published as "<path>.deflate"
+ *  (zlib stream of the file contents).
+ */
+#define SMANIFEST_MAGIC                 "ALMB"
+#define SMANIFEST_VERSION               1
+#define SMANIFEST_HEADER_SIZE           12
+#define SMANIFEST_FLAG_DEFLATE          0x0001
+#define SMANIFEST_SHA256_HEX_SIZE       64
+#define SMANIFEST_PACKED_SUFFIX         ".deflate"
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SManifestFile
+{
+    char            *sPath;
+    char            sSHA256[SMANIFEST_SHA256_HEX_SIZE + 1];
+    uint32          dSize;
+    uint32          dPackedSize;    /**< 0 if there is no .deflate payload */
+} SManifestFile;
+
+typedef struct SManifest
+{
+    char            *sSchema;
+    char            *sGenerated;
+    int32           dVersion;
+    int32           dBuild;
+    SVector         tFiles;         /**< SManifestFile */
+} SManifest;
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SManifest
+ * @brief       Allocates empty manifest
+ *
+ * @return      SManifest*
+ */
+extern CAPI SManifest*
+SManifest_new(void);
+
+/**
+ * @relatedalso SManifest
+ * @brief       Destroys manifest and all of its file entries
+ *
+ * @param       pManifest
+ */
+extern CAPI void
+SManifest_delete(SManifest **pManifest);
+
+/**
+ * @relatedalso SManifest
+ * @brief       Appends (copies) file entry
+ *
+ * @param       pManifest
+ * @param       sPath
+ * @param       sSHA256     Hex string
+ * @param       dSize
+ * @param       dPackedSize
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SManifest_AddFile(
+    SManifest *pManifest,
+    const char *sPath,
+    const char *sSHA256,
+    uint32 dSize,
+    uint32 dPackedSize);
+
+/**
+ * @relatedalso SManifest
+ * @brief       Returns number of file entries
+ *
+ * @param       pManifest
+ * @return      size_t
+ */
+extern CAPI size_t
+SManifest_GetFileCount(const SManifest *pManifest);
+
+/**
+ * @relatedalso SManifest
+ * @brief       Returns file entry at given index
+ *
+ * @param       pManifest
+ * @param       dIndex
+ * @return      const SManifestFile*
+ */
+extern CAPI const SManifestFile*
+SManifest_GetFile(SManifest *pManifest, size_t dIndex);
+
+/**
+ * @relatedalso SManifest
+ * @brief       Parses binary manifest (inflates body if needed)
+ *
+ * @param       pData
+ * @param       dSize
+ * @return      SManifest* NULL on malformed input
+ */
+extern CAPI SManifest*
+SManifest_ReadBinary(const void *pData, size_t dSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef SOBJSTORE_H_
+#define SOBJSTORE_H_
+
+#include <core/common.h>
+#include <core/opsys.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * FORWARD DECLARATIONS
+ ******************************************************************************/
+
+typedef struct SObjectStore SObjectStore;
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Content-addressed store layout
+ *
+ *  <root>/<sha[0..1]>/<sha>    object (file contents with that sha256)
+ *  <root>/hashcache            sha256 cache of objects (see SHashCache)
+ *  <root>/archives             archive entry -> sha256 index
+ *
+ *  Files are materialized from store by reflink, hardlink or plain copy,
+ *  whichever filesystem supports first. Files are put into store by reflink
+ *  or copy only, so object never shares inode with its source (except
+ *  SObjectStore_ImportLinked, for files that are only ever replaced).
+ */
+#define SOBJSTORE_DEFAULT_ROOT          AMBERLAUNCHER_STATE_DIR "/objects"
+#define SOBJSTORE_HASHCACHE_NAME        "hashcache"
+#define SOBJSTORE_ARCHIVES_NAME         "archives"
+#define SOBJSTORE_SHA256_HEX_SIZE       64
+
+/******************************************************************************
+ * ENUMS
+ ******************************************************************************/
+
+typedef enum ESObjectLink
+{
+    SOBJSTORE_LINK_NONE,        /*!< Failed */
+    SOBJSTORE_LINK_REFLINK,     /*!< Copy-on-write clone */
+    SOBJSTORE_LINK_HARDLINK,    /*!< Same inode as object */
+    SOBJSTORE_LINK_COPY,        /*!< Full copy */
+    SOBJSTORE_LINK_MAX
+
+} ESObjectLink;
+
+extern const char* ESObjectLinkStrings[];
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Opens (creates) object store and loads its indices
+ *
+ * @param       sRoot
+ * @return      SObjectStore* NULL on failure
+ */
+extern CAPI SObjectStore*
+SObjectStore_Open(const char *sRoot);
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Saves indices and frees store
+ *
+ * @param       pStore
+ */
+extern CAPI void
+SObjectStore_Close(SObjectStore **pStore);
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Checks that object exists and still has its sha256 (hardlinked
+ *              objects can be modified in place). Corrupted object is removed.
+ *              Thread-safe.
+ *
+ * @param       pStore
+ * @param       sSHA256
+ * @return      CBOOL
+ */
+extern CAPI CBOOL
+SObjectStore_Has(SObjectStore *pStore, const char *sSHA256);
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Puts file contents into store (reflink or copy, never
+ *              hardlink). Thread-safe.
+ *
+ * @param       pStore
+ * @param       sPath
+ * @param       sKnownSHA256    Verified sha256 of file, NULL to hash it
+ * @param       sSHA256Out      SOBJSTORE_SHA256_HEX_SIZE + 1 bytes, can be NULL
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SObjectStore_Import(
+    SObjectStore *pStore,
+    const char *sPath,
+    const char *sKnownSHA256,
+    char *sSHA256Out);
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Same as SObjectStore_Import, but hardlinks file into store when
+ *              reflink isn't available. Only for files that are replaced by
+ *              rename and never written in place (update snapshots), object
+ *              would change along with them otherwise. Thread-safe.
+ *
+ * @param       pStore
+ * @param       sPath
+ * @param       sKnownSHA256    Verified sha256 of file, NULL to hash it
+ * @param       sSHA256Out      SOBJSTORE_SHA256_HEX_SIZE + 1 bytes, can be NULL
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SObjectStore_ImportLinked(
+    SObjectStore *pStore,
+    const char *sPath,
+    const char *sKnownSHA256,
+    char *sSHA256Out);
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Removes every object that is neither listed in pKeep nor
+ *              referenced by archive index. Must not run while store is
+ *              used by other threads.
+ *
+ * @param       pStore
+ * @param       pKeep       sha256 (hex, lowercase) of objects to keep
+ * @param       dNumKeep
+ * @return      uint32 Number of removed objects
+ */
+extern CAPI uint32
+SObjectStore_Collect(SObjectStore *pStore, const char * const *pKeep, size_t dNumKeep);
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Materializes object at sDstPath (replacing it atomically),
+ *              creates missing parent directories. Thread-safe.
+ *
+ * @param       pStore
+ * @param       sSHA256
+ * @param       sDstPath
+ * @return      ESObjectLink SOBJSTORE_LINK_NONE if object is missing or
+ *              destination can't be written
+ */
+extern CAPI ESObjectLink
+SObjectStore_Install(SObjectStore *pStore, const char *sSHA256, const char *sDstPath);
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Looks up sha256 of previously extracted archive entry
+ *
+ * @param       pStore
+ * @param       sKey        Entry identity (archive, name, crc32, size)
+ * @param       sSHA256Out  SOBJSTORE_SHA256_HEX_SIZE + 1 bytes
+ * @return      CBOOL CTRUE if found
+ */
+extern CAPI CBOOL
+SObjectStore_ArchiveLookup(SObjectStore *pStore, const char *sKey, char *sSHA256Out);
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Records sha256 of extracted archive entry
+ *
+ * @param       pStore
+ * @param       sKey
+ * @param       sSHA256
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SObjectStore_ArchiveRemember(SObjectStore *pStore, const char *sKey, const char *sSHA256);
+
+/**
+ * @relatedalso SObjectStore
+ * @brief       Returns store root folder
+ *
+ * @param       pStore
+ * @return      const char*
+ */
+extern CAPI const char*
+SObjectStore_GetRoot(const SObjectStore *pStore);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
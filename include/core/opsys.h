@@ -3,6 +3,7 @@
 
 #include <core/common.h>
 #include <stddef.h>
+#include <stdio.h>
 
 /******************************************************************************
  * PREPROCESSOR
@@ -12,6 +13,33 @@
 #define MAX_LINE_LENGTH         1024
 #define SYSTEM_CMD_BUFFER_SIZE  1024
 
+/** Runtime state (caches, object store, downloads), relative to launcher
+ *  folder. Outside of every manifest root, so it's never distributed. */
+#define AMBERLAUNCHER_STATE_DIR "LauncherState"
+
+/******************************************************************************
+ * TYPEDEFS
+ ******************************************************************************/
+
+typedef enum EDirEntryType
+{
+    DIRENTRY_FILE,
+    DIRENTRY_DIRECTORY,
+    DIRENTRY_OTHER          /**< symlinks, devices, etc. */
+} EDirEntryType;
+
+typedef struct SDirEntryInfo
+{
+    const char      *sName;
+    EDirEntryType   eType;
+    uint64          dSize;          /**< 0 unless requested */
+    int64           dModTime;       /**< nanoseconds since epoch, 0 unless requested */
+} SDirEntryInfo;
+
+/* Return CFALSE to stop iteration */
+typedef CBOOL (*FDirEntryCallback)(const char *sName, EDirEntryType eType, void *pUserData);
+typedef CBOOL (*FDirEntryInfoCallback)(const SDirEntryInfo *pEntry, void *pUserData);
+
 /******************************************************************************
  * HEADER FUNCTION DECLARATIONS
  ******************************************************************************/
@@ -82,6 +110,27 @@ AmberLauncher_IsRunningUnderWine(void);
 extern CAPI unsigned long
 AmberLauncher_GetThreadID(void);
 
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Monotonic clock for measuring intervals, unrelated to wall time
+ *
+ * @return      uint64 Nanoseconds
+ */
+extern CAPI uint64
+AmberLauncher_GetMonotonicTime(void);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Space on filesystem holding sPath (which must exist)
+ *
+ * @param       sPath
+ * @param       dFree       Available to unprivileged user, can be NULL
+ * @param       dTotal      Can be NULL
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+AmberLauncher_DiskSpace(const char *sPath, uint64 *dFree, uint64 *dTotal);
+
 /**
  * @relatedalso AmberLauncher
  * @brief       Default OS-Specific system information dump
@@ -124,6 +173,206 @@ AmberLauncher_GetRegistryKey(const char* sValueName, uint32* pValueData);
 extern CAPI int
 AmberLauncher_RunSystemCommand(const char *sCmd);
 
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Atomically moves file over destination (replaces existing one)
+ *
+ * @param       sSrcPath
+ * @param       sDstPath
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+AmberLauncher_FileReplace(const char *sSrcPath, const char *sDstPath);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Renames file or directory, never replaces existing destination.
+ *              Changing only case of name works on case-insensitive
+ *              filesystems too.
+ *
+ * @param       sSrcPath
+ * @param       sDstPath
+ * @return      CBOOL CFALSE if destination exists or rename failed
+ */
+extern CAPI CBOOL
+AmberLauncher_FileRename(const char *sSrcPath, const char *sDstPath);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Flushes stdio buffers and commits file contents to disk
+ *
+ * @param       pFile
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+AmberLauncher_FileSync(FILE *pFile);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       fseek with 64-bit offset (long is 32-bit on Windows)
+ *
+ * @param       pFile
+ * @param       dOffset
+ * @param       dOrigin     SEEK_SET, SEEK_CUR or SEEK_END
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+AmberLauncher_FileSeek(FILE *pFile, int64 dOffset, int dOrigin);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       ftell with 64-bit result (long is 32-bit on Windows)
+ *
+ * @param       pFile
+ * @return      int64 Position, -1 on failure
+ */
+extern CAPI int64
+AmberLauncher_FileTell(FILE *pFile);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Returns size and modification time (nanoseconds since epoch,
+ *              actual precision depends on filesystem)
+ *
+ * @param       sPath
+ * @param       dSize       Can be NULL
+ * @param       dModTime    Can be NULL
+ * @return      CBOOL CFALSE if file doesn't exist
+ */
+extern CAPI CBOOL
+AmberLauncher_FileStat(const char *sPath, uint64 *dSize, int64 *dModTime);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Sets modification time (nanoseconds since epoch, same as
+ *              AmberLauncher_FileStat returns)
+ *
+ * @param       sPath
+ * @param       dModTime
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+AmberLauncher_FileSetModTime(const char *sPath, int64 dModTime);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Identifies file or directory path (or symlink on it) leads to:
+ *              device and inode, volume serial and file index on Windows.
+ *              Same pair means same file.
+ *
+ * @param       sPath
+ * @param       dDevice
+ * @param       dInode
+ * @param       bDirectory  Can be NULL
+ * @return      CBOOL CFALSE if path or its target doesn't exist
+ */
+extern CAPI CBOOL
+AmberLauncher_FileIdentity(const char *sPath, uint64 *dDevice, uint64 *dInode, CBOOL *bDirectory);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Calls cbEntry for every entry of directory (except "." and
+ *              "..") in native order, same as find(1) would visit them
+ *
+ * @param       sPath
+ * @param       cbEntry
+ * @param       pUserData
+ * @return      CBOOL CFALSE if directory can't be read or iteration stopped
+ */
+extern CAPI CBOOL
+AmberLauncher_DirIterate(const char *sPath, FDirEntryCallback cbEntry, void *pUserData);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Same as AmberLauncher_DirIterate, with size and modification
+ *              time of every entry when bStat is set. Entries are stat'ed
+ *              relative to open directory (no path lookups), on Windows
+ *              attributes come with listing itself.
+ *
+ * @param       sPath
+ * @param       bStat
+ * @param       cbEntry
+ * @param       pUserData
+ * @return      CBOOL CFALSE if directory can't be read or iteration stopped
+ */
+extern CAPI CBOOL
+AmberLauncher_DirIterateInfo(
+    const char *sPath, CBOOL bStat, FDirEntryInfoCallback cbEntry, void *pUserData);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Creates directory along with all missing parents
+ *
+ * @param       sPath
+ * @return      CBOOL CTRUE if directory exists afterwards
+ */
+extern CAPI CBOOL
+AmberLauncher_DirCreate(const char *sPath);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Creates hardlink sDstPath pointing to sSrcPath.
+ *              Fails if destination exists or is on another filesystem.
+ *
+ * @param       sSrcPath
+ * @param       sDstPath
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+AmberLauncher_FileLink(const char *sSrcPath, const char *sDstPath);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Creates sDstPath as copy-on-write clone of sSrcPath (reflink),
+ *              no data is copied. Fails if filesystem doesn't support it or
+ *              destination exists.
+ *
+ * @param       sSrcPath
+ * @param       sDstPath
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+AmberLauncher_FileClone(const char *sSrcPath, const char *sDstPath);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Copies file contents (in kernel where possible), overwrites
+ *              destination. Keeps source's modification time, memory use
+ *              doesn't depend on file size.
+ *
+ * @param       sSrcPath
+ * @param       sDstPath
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+AmberLauncher_FileCopy(const char *sSrcPath, const char *sDstPath);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Deletes file or whole directory tree. Symlinks are removed,
+ *              not followed.
+ *
+ * @param       sPath
+ * @return      CBOOL CFALSE if path doesn't exist or something was left behind
+ */
+extern CAPI CBOOL
+AmberLauncher_TreeRemove(const char *sPath);
+
+/**
+ * @relatedalso AmberLauncher
+ * @brief       Moves file or directory tree to sDstPath. Directories are
+ *              merged into existing ones (files replace files), across
+ *              filesystems contents are copied and source deleted.
+ *              Replaced files are swapped by rename, never written in place.
+ *              Source is gone afterwards unless something failed.
+ *
+ * @param       sSrcPath
+ * @param       sDstPath
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+AmberLauncher_TreeMove(const char *sSrcPath, const char *sDstPath);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,165 @@
+#ifndef SPARTFILE_H_
+#define SPARTFILE_H_
+
+#include <core/common.h>
+#include <core/opsys.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * FORWARD DECLARATIONS
+ ******************************************************************************/
+
+typedef struct SPartFile SPartFile;
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Temporary files of download of <path> live in state directory:
+ *        "<SPARTFILE_DIR>/<hash of path><suffix>", journal records full path.
+ *        When state directory is on another device than destination, they
+ *        are kept next to it ("<path><suffix>") so commit is a plain rename.
+ */
+#define SPARTFILE_DIR                   AMBERLAUNCHER_STATE_DIR "/parts"
+#define SPARTFILE_SUFFIX                ".part"
+#define SPARTFILE_SPOOL_SUFFIX          ".part.z"
+#define SPARTFILE_JOURNAL_SUFFIX        ".part.journal"
+#define SPARTFILE_SHA256_HEX_SIZE       64
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Opens part file (see SPARTFILE_DIR) for a streamed download
+ *              of sPath.
+ *              Data is hashed incrementally while being written, so the
+ *              destination never has to be held in memory.
+ *              If a journal of an interrupted download for the same
+ *              path/sha256/size exists, the download resumes at the
+ *              journaled offset with restored hash state.
+ *              With dPackedSize > 0 written data is a zlib stream, which is
+ *              inflated on the fly (inflater state is journaled as well).
+ *
+ * @param       sPath           Final destination of the file
+ * @param       sSHA256         Expected sha256 (hex, lowercase) of inflated data
+ * @param       dExpectedSize   Expected size in bytes of inflated data
+ * @param       dPackedSize     Size of zlib stream, 0 for plain download
+ * @return      SPartFile*      NULL on failure
+ */
+extern CAPI SPartFile*
+SPartFile_Open(
+    const char *sPath,
+    const char *sSHA256,
+    uint64 dExpectedSize,
+    uint64 dPackedSize);
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Appends chunk to temporary file and feeds it into the hash
+ *              (packed downloads inflate the chunk first)
+ *
+ * @param       pPart
+ * @param       pData
+ * @param       dSize
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SPartFile_Write(SPartFile *pPart, const void *pData, size_t dSize);
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Flushes written data to disk and records offset and hash state
+ *              in journal next to part file, so download can be resumed later
+ *
+ * @param       pPart
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SPartFile_Checkpoint(SPartFile *pPart);
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Returns amount of bytes already received (next download offset).
+ *              For packed downloads this is offset within the zlib stream.
+ *
+ * @param       pPart
+ * @return      uint64
+ */
+extern CAPI uint64
+SPartFile_GetOffset(const SPartFile *pPart);
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Returns path a third party should write received data to
+ *              after SPartFile_Release (part file, or its ".part.z" twin
+ *              for packed downloads)
+ *
+ * @param       pPart
+ * @return      const char*
+ */
+extern CAPI const char*
+SPartFile_GetSpoolPath(const SPartFile *pPart);
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Drops everything written so far and closes temporary file, so
+ *              it can be written by a third party (e.g. file stream).
+ *
+ * @param       pPart
+ */
+extern CAPI void
+SPartFile_Release(SPartFile *pPart);
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Picks up spool file after SPartFile_Release and hashes
+ *              its contents (fixed size buffer). Packed spool is inflated
+ *              into part file and removed.
+ *
+ * @param       pPart
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SPartFile_Reload(SPartFile *pPart);
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Verifies size and sha256, then renames temporary file over
+ *              destination. Frees pPart in any case.
+ *
+ * @param       pPart
+ * @return      CBOOL TRUE if file is verified and in place
+ */
+extern CAPI CBOOL
+SPartFile_Commit(SPartFile **pPart);
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Suspends download: checkpoints received data (kept for resume)
+ *              and frees pPart
+ *
+ * @param       pPart
+ */
+extern CAPI void
+SPartFile_Close(SPartFile **pPart);
+
+/**
+ * @relatedalso SPartFile
+ * @brief       Removes leftovers (.part, .part.z and journal) of download of sPath
+ *
+ * @param       sPath           Final destination of the file
+ */
+extern CAPI void
+SPartFile_Discard(const char *sPath);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef SPATHINDEX_H_
+#define SPATHINDEX_H_
+
+#include <core/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * FORWARD DECLARATIONS
+ ******************************************************************************/
+
+typedef struct SPathIndex SPathIndex;
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#ifdef _WIN32
+#define SPATHINDEX_SEPARATOR            '\\'
+#else
+#define SPATHINDEX_SEPARATOR            '/'
+#endif
+
+/** Symlink loops are detected by device/inode, this only guards against deep trees */
+#define SPATHINDEX_MAX_DEPTH            32
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SPathIndex
+ * @brief       Scans directory tree once and indexes every entry by its
+ *              lowercase relative path. Symlinked directories are entered
+ *              unless they lead back to one of their parents.
+ *
+ * @param       sRoot
+ * @return      SPathIndex* NULL if root can't be read
+ */
+extern CAPI SPathIndex*
+SPathIndex_Build(const char *sRoot);
+
+/**
+ * @relatedalso SPathIndex
+ * @brief       Case-insensitive lookup. Both '/' and '\\' separate components,
+ *              empty and "." components are ignored.
+ *
+ * @param       pIndex
+ * @param       sRelPath
+ * @return      const char* Relative path as it is on disk (native separators),
+ *              NULL if there's no such entry
+ */
+extern CAPI const char*
+SPathIndex_Resolve(const SPathIndex *pIndex, const char *sRelPath);
+
+/**
+ * @relatedalso SPathIndex
+ * @brief       Returns root index was built from
+ *
+ * @param       pIndex
+ * @return      const char*
+ */
+extern CAPI const char*
+SPathIndex_GetRoot(const SPathIndex *pIndex);
+
+/**
+ * @relatedalso SPathIndex
+ * @brief       Returns number of indexed entries (files and directories)
+ *
+ * @param       pIndex
+ * @return      size_t
+ */
+extern CAPI size_t
+SPathIndex_GetCount(const SPathIndex *pIndex);
+
+/**
+ * @relatedalso SPathIndex
+ * @brief       Destroys index
+ *
+ * @param       pIndex
+ */
+extern CAPI void
+SPathIndex_delete(SPathIndex **pIndex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef SSNAPSHOT_H_
+#define SSNAPSHOT_H_
+
+#include <core/common.h>
+#include <core/opsys.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * FORWARD DECLARATIONS
+ ******************************************************************************/
+
+typedef struct SSnapshot SSnapshot;
+struct SObjectStore;
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Update snapshot: "<root>/<yyyymmdd-hhmmss>-<nn>.snap"
+ *
+ *  header: "ALSS 1"
+ *  lines:  "<sha256> <path>"   file content is kept in object store
+ *          "- <path>"          file didn't exist (rollback removes it)
+ *
+ *  Snapshotting a file is a reflink or hardlink into object store, so it costs
+ *  next to nothing where filesystem supports either (plain copy elsewhere).
+ *  Updates replace files by rename, so linked object keeps old contents.
+ */
+#define SSNAPSHOT_DEFAULT_ROOT          AMBERLAUNCHER_STATE_DIR "/snapshots"
+#define SSNAPSHOT_SUFFIX                ".snap"
+#define SSNAPSHOT_MAX_KEPT              3
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SSnapshot
+ * @brief       Starts collecting new snapshot
+ *
+ * @param       pStore      Object store holding snapshotted contents
+ * @param       sRoot       Snapshot folder
+ * @return      SSnapshot*  NULL on failure
+ */
+extern CAPI SSnapshot*
+SSnapshot_Begin(struct SObjectStore *pStore, const char *sRoot);
+
+/**
+ * @relatedalso SSnapshot
+ * @brief       Records current state of file that is about to be overwritten.
+ *              Only first call per path counts. Thread-safe.
+ *
+ * @param       pSnapshot
+ * @param       sPath
+ * @param       sKnownSHA256    sha256 of current contents, NULL to hash it
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SSnapshot_AddFile(SSnapshot *pSnapshot, const char *sPath, const char *sKnownSHA256);
+
+/**
+ * @relatedalso SSnapshot
+ * @brief       Writes snapshot (if it has any files), prunes old snapshots
+ *              beyond SSNAPSHOT_MAX_KEPT and frees pSnapshot
+ *
+ * @param       pSnapshot
+ * @param       dNumFilesOut    Can be NULL
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SSnapshot_End(SSnapshot **pSnapshot, uint32 *dNumFilesOut);
+
+/**
+ * @relatedalso SSnapshot
+ * @brief       Removes objects from store that no kept snapshot, archive index
+ *              or pKeep refers to. Does nothing if some snapshot can't be read.
+ *              Must not run while store is used by other threads.
+ *
+ * @param       pStore
+ * @param       sRoot
+ * @param       pKeep           sha256 of extra objects to keep, can be NULL
+ * @param       dNumKeep
+ * @param       dNumRemovedOut  Can be NULL
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SSnapshot_Collect(
+    struct SObjectStore *pStore,
+    const char *sRoot,
+    const char * const *pKeep,
+    size_t dNumKeep,
+    uint32 *dNumRemovedOut);
+
+/**
+ * @relatedalso SSnapshot
+ * @brief       Restores files from latest snapshot and removes it
+ *
+ * @param       pStore
+ * @param       sRoot
+ * @param       dNumFilesOut    Can be NULL
+ * @return      CBOOL CFALSE if there's no snapshot or some file can't be restored
+ *              (snapshot is kept then)
+ */
+extern CAPI CBOOL
+SSnapshot_RollbackLatest(struct SObjectStore *pStore, const char *sRoot, uint32 *dNumFilesOut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
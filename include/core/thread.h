@@ -0,0 +1,106 @@
+#ifndef STHREAD_H_
+#define STHREAD_H_
+
+#include <core/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * FORWARD DECLARATIONS
+ ******************************************************************************/
+
+typedef struct SThread SThread;
+typedef struct SMutex SMutex;
+
+/******************************************************************************
+ * TYPEDEFS
+ ******************************************************************************/
+
+typedef uint32 (*SThreadFunc)(void *pData);
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SThread
+ * @brief       Starts native thread running cbFunc(pData)
+ *
+ * @param       cbFunc
+ * @param       pData
+ * @return      SThread* NULL on failure
+ */
+extern CAPI SThread*
+SThread_Create(SThreadFunc cbFunc, void *pData);
+
+/**
+ * @relatedalso SThread
+ * @brief       Waits for thread to finish and frees it
+ *
+ * @param       pThread
+ * @return      uint32 Value returned by thread function
+ */
+extern CAPI uint32
+SThread_Join(SThread **pThread);
+
+/**
+ * @relatedalso SThread
+ * @brief       Returns number of logical processors (at least 1)
+ *
+ * @return      uint32
+ */
+extern CAPI uint32
+SThread_GetProcessorCount(void);
+
+/**
+ * @relatedalso SThread
+ * @brief       Suspends calling thread
+ *
+ * @param       dMilliseconds
+ */
+extern CAPI void
+SThread_Sleep(uint32 dMilliseconds);
+
+/**
+ * @relatedalso SMutex
+ * @brief       Creates non-recursive mutex
+ *
+ * @return      SMutex* NULL on failure
+ */
+extern CAPI SMutex*
+SMutex_Create(void);
+
+/**
+ * @relatedalso SMutex
+ * @brief       Locks mutex
+ *
+ * @param       pMutex
+ */
+extern CAPI void
+SMutex_Lock(SMutex *pMutex);
+
+/**
+ * @relatedalso SMutex
+ * @brief       Unlocks mutex
+ *
+ * @param       pMutex
+ */
+extern CAPI void
+SMutex_Unlock(SMutex *pMutex);
+
+/**
+ * @relatedalso SMutex
+ * @brief       Destroys mutex
+ *
+ * @param       pMutex
+ */
+extern CAPI void
+SMutex_Destroy(SMutex **pMutex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
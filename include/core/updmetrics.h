@@ -0,0 +1,154 @@
+#ifndef SUPDMETRICS_H_
+#define SUPDMETRICS_H_
+
+#include <core/common.h>
+#include <core/opsys.h>
+#include <core/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Metrics log: one JSON object per updater session and line.
+ *        Log is moved to "<log>.old" once it grows past SUPDMETRICS_LOG_MAX_SIZE.
+ */
+#define SUPDMETRICS_DEFAULT_LOG         AMBERLAUNCHER_STATE_DIR "/updater.metrics"
+#define SUPDMETRICS_OLD_SUFFIX          ".old"
+#define SUPDMETRICS_LOG_MAX_SIZE        (1u << 20)
+#define SUPDMETRICS_OPERATION_SIZE      16
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SUpdaterFileMetrics
+{
+    char            *sPath;
+    const char      *sResult;       /**< static string, e.g. "downloaded" */
+    uint64          dSize;
+    uint64          dBytes;         /**< transferred in this session */
+    uint32          dAttempts;
+    uint64          dHashUs;
+    uint64          dDownloadUs;
+    uint64          dWriteUs;
+    uint64          dTotalUs;
+} SUpdaterFileMetrics;
+
+typedef struct SUpdaterMetrics
+{
+    char            sOperation[SUPDMETRICS_OPERATION_SIZE];
+    int64           dStartTime;     /**< unix time */
+    uint64          dWallUs;
+    uint32          dConnections;
+
+    uint64          dBytes;
+    uint64          dHashUs;        /**< summed over workers */
+    uint64          dDownloadUs;
+    uint64          dWriteUs;
+    uint32          dRetries;
+
+    uint32          dHashCacheHits;
+    uint32          dHashCacheMisses;
+    uint32          dObjectStoreHits;
+    uint32          dManifestFetches;
+    uint32          dManifestCacheHits; /**< answered with 304 */
+
+    SVector         tFiles;         /**< SUpdaterFileMetrics */
+} SUpdaterMetrics;
+
+/******************************************************************************
+ * HEADER FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @relatedalso SUpdaterMetrics
+ * @brief       Allocates empty metrics
+ *
+ * @return      SUpdaterMetrics*
+ */
+extern CAPI SUpdaterMetrics*
+SUpdaterMetrics_new(void);
+
+/**
+ * @relatedalso SUpdaterMetrics
+ * @brief       Destroys metrics and their file entries
+ *
+ * @param       pMetrics
+ */
+extern CAPI void
+SUpdaterMetrics_delete(SUpdaterMetrics **pMetrics);
+
+/**
+ * @relatedalso SUpdaterMetrics
+ * @brief       Drops previous session and starts a new one
+ *
+ * @param       pMetrics
+ * @param       sOperation  "update", "verify", "repair"
+ */
+extern CAPI void
+SUpdaterMetrics_Reset(SUpdaterMetrics *pMetrics, const char *sOperation);
+
+/**
+ * @relatedalso SUpdaterMetrics
+ * @brief       Appends (copies) file entry and adds it to session totals
+ *
+ * @param       pMetrics
+ * @param       pFile
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SUpdaterMetrics_AddFile(SUpdaterMetrics *pMetrics, const SUpdaterFileMetrics *pFile);
+
+/**
+ * @relatedalso SUpdaterMetrics
+ * @brief       Returns number of file entries
+ *
+ * @param       pMetrics
+ * @return      size_t
+ */
+extern CAPI size_t
+SUpdaterMetrics_GetFileCount(const SUpdaterMetrics *pMetrics);
+
+/**
+ * @relatedalso SUpdaterMetrics
+ * @brief       Returns file entry at given index
+ *
+ * @param       pMetrics
+ * @param       dIndex
+ * @return      const SUpdaterFileMetrics*
+ */
+extern CAPI const SUpdaterFileMetrics*
+SUpdaterMetrics_GetFile(SUpdaterMetrics *pMetrics, size_t dIndex);
+
+/**
+ * @relatedalso SUpdaterMetrics
+ * @brief       Bytes per second over given time, 0 if there's no time
+ *
+ * @param       dBytes
+ * @param       dMicroseconds
+ * @return      double
+ */
+extern CAPI double
+SUpdaterMetrics_Rate(uint64 dBytes, uint64 dMicroseconds);
+
+/**
+ * @relatedalso SUpdaterMetrics
+ * @brief       Appends session as single JSON line to log
+ *
+ * @param       pMetrics
+ * @param       sLogPath
+ * @return      CBOOL Success
+ */
+extern CAPI CBOOL
+SUpdaterMetrics_AppendLog(SUpdaterMetrics *pMetrics, const char *sLogPath);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
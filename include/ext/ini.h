@@ -18,7 +18,9 @@ const char* ini_get(ini_t *ini, const char *section, const char *key);
 int         ini_sget(ini_t *ini, const char *section, const char *key, const char *scanfmt, void *dst);
 
 /* amber launcher */
+ini_t*      ini_create(void);
 int         ini_set(ini_t *ini, const char *section, const char *key, const char *value);
+int         ini_put(ini_t *ini, const char *section, const char *key, const char *value);
 int         ini_save(ini_t *ini, const char *filename);
 
 
@@ -13,14 +13,22 @@
 #include <core/vector.h>
 #include <core/appcore.h>
 #include <core/command.h>
+#include <core/cmdgraph.h>
+#include <core/cmdlist.h>
 #include <core/luainc.h>
 #include <core/luastate.h>
 #include <core/opsys.h>
+#include <core/objstore.h>
+#include <core/updmetrics.h>
+#include <core/fswatch.h>
 
 #include <commands/archive.h>
 #include <commands/config.h>
 #include <commands/regedit.h>
 #include <commands/music.h>
+#include <commands/objstore.h>
+#include <commands/updmetrics.h>
+#include <commands/filesystem.h>
 
 #include <ext/sha256.h>
 
@@ -65,16 +73,7 @@ static const size_t SVector_DefaultCommandCallbacks_Size =
     sizeof(SVector_DefaultCommandCallbacks) / sizeof(SVector_DefaultCommandCallbacks[0]);
 
 #define SVECTOR_MAX_COMMANDS 32
-static SVector tConfigureCommandList;
-
-static int 
-_predicate(const void* pElement, const void* pCtx)
-{
-    SCommand* pObject = (SCommand*)pElement;
-    const char* sName = (const char*)pCtx;
-    const int dResult = strcmp(pObject->sName, sName);
-    return dResult == 0;
-}
+static SCommandList *pConfigureCommandList = NULL;
 
 static CBOOL
 _SCommand_Callback_LuaCall(const SCommand* pSelf, const SCommandArg* pArgs, const unsigned int dNumArgs)
@@ -117,11 +116,10 @@ _SCommand_Callback_LuaCall(const SCommand* pSelf, const SCommandArg* pArgs, cons
     return bResult;
 }
 
-static CBOOL
+static SCommand*
 _SCommand_AddToList(const char* sName, CommandFunc cbCmdFunction, void* pOwner, int dLuaRef, int dPriority)
 {
-    long dSVecFoundIndex;
-
+    SCommand* pObj;
     SCommand tCommand;
     tCommand.sName          = sName;
     tCommand.dFlags         = dLuaRef > 0 ? SCOMMAND_FLAG_LUA : SCOMMAND_FLAG_NULL;
@@ -130,40 +128,89 @@ _SCommand_AddToList(const char* sName, CommandFunc cbCmdFunction, void* pOwner,
     tCommand.dNumArgs       = 0;
     tCommand.pOwner         = pOwner;
     tCommand.cbExecuteFunc  = cbCmdFunction;
+    tCommand.pAfter         = NULL;
+    tCommand.dAfterCount    = 0;
 
-    /* Overwrite existing */
-    dSVecFoundIndex = SVector_FindByPredicate(&tConfigureCommandList, _predicate, sName);
-    if (dSVecFoundIndex != -1)
+    /* Overwrite existing (dependencies are caller's business) */
+    pObj = SCommandList_Find(pConfigureCommandList, sName);
+    if (pObj)
     {
-        SCommand* pObj  = (SCommand*)SVector_Get(&tConfigureCommandList, (size_t)dSVecFoundIndex);
-        pObj->dFlags    = tCommand.dFlags;
+        pObj->dFlags    = tCommand.dFlags | (pObj->dFlags & SCOMMAND_FLAG_AFTER);
         pObj->dLuaRef   = tCommand.dLuaRef;
-        pObj->dPriority = tCommand.dPriority;
 
         if (SCommand_IsFlagSet(pObj, SCOMMAND_FLAG_LUA))
         {
             pObj->cbExecuteFunc = _SCommand_Callback_LuaCall;
         }
 
-        return CTRUE;
+        return SCommandList_SetPriority(pConfigureCommandList, pObj, dPriority);
     }
 
-    /* Add new element */
-    SVector_PushBack(&tConfigureCommandList, &tCommand);
+    /* Add new element, list keeps its own copy of name */
+    return SCommandList_Add(pConfigureCommandList, &tCommand);
+}
+
+/* Names stay referenced by table at dIndex until SCommand_SetAfter copies them */
+static CBOOL
+_LUA_CommandSetAfter(struct lua_State* L, SCommand* pCommand, int dIndex)
+{
+    const char  **pNames;
+    uint32      dCount;
+    uint32      i;
+    CBOOL       bResult;
+
+    dCount = (uint32)lua_rawlen(L, dIndex);
+    pNames = (const char**)calloc(dCount > 0 ? dCount : 1, sizeof(const char*));
+    if (!pNames)
+    {
+        return CFALSE;
+    }
 
-    return CTRUE;
+    for (i = 0; i < dCount; i++)
+    {
+        lua_rawgeti(L, dIndex, (lua_Integer)(i + 1));
+        pNames[i] = lua_type(L, -1) == LUA_TSTRING ? lua_tostring(L, -1) : NULL;
+        lua_pop(L, 1);
+        if (!pNames[i])
+        {
+            free(pNames);
+            return (CBOOL)luaL_error(L, "CommandAdd: 'after' must be list of command names");
+        }
+    }
+
+    bResult = SCommand_SetAfter(pCommand, pNames, dCount);
+    free(pNames);
+
+    return bResult;
 }
 
+/* AL.CommandAdd(name, func, [priority], [{priority=, after={names}}]) */
 static int
 _LUA_CommandAdd(struct lua_State* L)
 {
     int dPriority           = 0;
     int dLuaFuncRef         = 0;
+    int dOptions            = 0;
+    SCommand* pObj;
     void* pAppCore          = NULL; /*!< AppCore */
     const char* sCmdName    = luaL_checkstring(L, 1);
 
     luaL_checktype(L, 2, LUA_TFUNCTION);
-    dPriority = (int)luaL_optinteger(L, 3, 0);
+    if (lua_istable(L, 3))
+    {
+        dOptions = 3;
+    }
+    else
+    {
+        dPriority = (int)luaL_optinteger(L, 3, 0);
+        dOptions = lua_istable(L, 4) ? 4 : 0;
+    }
+    if (dOptions)
+    {
+        lua_getfield(L, dOptions, "priority");
+        dPriority = lua_isnumber(L, -1) ? (int)lua_tointeger(L, -1) : dPriority;
+        lua_pop(L, 1);
+    }
 
     lua_pushvalue(L, 2);
     dLuaFuncRef = luaL_ref(L, LUA_REGISTRYINDEX);
@@ -172,32 +219,63 @@ _LUA_CommandAdd(struct lua_State* L)
     pAppCore = lua_touserdata(L, -1);
     lua_pop(L, 1);
 
-    _SCommand_AddToList(sCmdName, _SCommand_Callback_LuaCall, pAppCore, dLuaFuncRef, dPriority);
+    pObj = _SCommand_AddToList(sCmdName, _SCommand_Callback_LuaCall, pAppCore, dLuaFuncRef, dPriority);
+    if (!pObj)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, dLuaFuncRef);
+        return luaL_error(L, "CommandAdd: failed to add command %s", sCmdName);
+    }
+
+    /* Re-adding without 'after' goes back to priority order too */
+    SCommand_ClearAfter(pObj);
+    if (dOptions)
+    {
+        lua_getfield(L, dOptions, "after");
+        if (lua_istable(L, -1))
+        {
+            _LUA_CommandSetAfter(L, pObj, lua_gettop(L));
+        }
+        lua_pop(L, 1);
+    }
 
     return 0;
 }
 
+/* Already in priority order */
 static int 
 _LUA_GetTableOfCommands(struct lua_State* L)
 {
-    int dLuaIndex = 1;
+    const size_t dCount = SCommandList_GetSize(pConfigureCommandList);
+    size_t i;
 
-    lua_newtable(L);
+    lua_createtable(L, (int)dCount, 0);
 
-    SVector_ForEach(&tConfigureCommandList)
+    for (i = 0; i < dCount; i++)
     {
-        SVector_InitIterator(SCommand, &tConfigureCommandList);
+        const SCommand* pObj = SCommandList_Get(pConfigureCommandList, i);
 
         lua_newtable(L);
 
-        lua_pushstring(L, SVECTOR_ITERATOR->sName);
+        lua_pushstring(L, pObj->sName);
         lua_setfield(L, -2, "name");
 
-        lua_pushinteger(L, SVECTOR_ITERATOR->dPriority);
+        lua_pushinteger(L, pObj->dPriority);
         lua_setfield(L, -2, "priority");
 
-        lua_rawseti(L, -2, dLuaIndex);
-        dLuaIndex++;
+        if (SCommand_IsFlagSet(pObj, SCOMMAND_FLAG_AFTER))
+        {
+            uint32 k;
+
+            lua_createtable(L, (int)pObj->dAfterCount, 0);
+            for (k = 0; k < pObj->dAfterCount; k++)
+            {
+                lua_pushstring(L, pObj->pAfter[k]);
+                lua_rawseti(L, -2, (lua_Integer)(k + 1));
+            }
+            lua_setfield(L, -2, "after");
+        }
+
+        lua_rawseti(L, -2, (lua_Integer)(i + 1));
     }
 
     return 1;
@@ -443,14 +521,12 @@ _LUA_EventCall(lua_State* L)
 static int
 _LUA_CommandCall(struct lua_State* L)
 {
-    long dSVecFoundIndex     = 0;
     const char      *sKey    = luaL_checkstring(L, 1);
+    SCommand        *pObj    = SCommandList_Find(pConfigureCommandList, sKey);
     CBOOL           bResult  = CTRUE;
 
-    dSVecFoundIndex = SVector_FindByPredicate(&tConfigureCommandList, _predicate, sKey);
-    if (dSVecFoundIndex != -1)
+    if (pObj)
     {
-        SCommand* pObj = (SCommand*)SVector_Get(&tConfigureCommandList, (size_t)dSVecFoundIndex);
         SCommandArg pArg = SCommandArg_MakeVoid(L);
         bResult = pObj->cbExecuteFunc(pObj, &pArg, 1);
         printf("Calling [%s]: %s\n", sKey, bResult ? "success!" : "fail.");
@@ -465,6 +541,25 @@ _LUA_CommandCall(struct lua_State* L)
     return 1;
 }
 
+/* AL.CommandRunAll() -> ok, name of failed command */
+static int
+_LUA_CommandRunAll(struct lua_State* L)
+{
+    const char  *sFailed = NULL;
+    CBOOL       bResult;
+
+    bResult = SCommandGraph_Run(L, pConfigureCommandList, &sFailed);
+
+    lua_pushboolean(L, (int)bResult);
+    if (sFailed)
+    {
+        lua_pushstring(L, sFailed);
+        return 2;
+    }
+
+    return 1;
+}
+
 static int
 _LUA_SetLaunchCommand(lua_State* L)
 {
@@ -510,12 +605,80 @@ _LUA_SystemCall(struct lua_State* L)
     return 1;
 }
 
+/* AL.WatchFiles(root, exclude): replaces current watch, AL.WatchFiles()
+ * stops it. exclude lists relative paths left out of watch.
+ * Returns true and "native" or "poll", or false. */
+static int
+_LUA_WatchFiles(lua_State* L)
+{
+    const char  *sRoot      = luaL_optstring(L, 1, NULL);
+    AppCore     *pAppCore   = NULL;
+    const char  **pExclude  = NULL;
+    size_t      dExclude    = 0;
+    size_t      i;
+
+    /* AppCore struct */
+    lua_getfield(L, LUA_REGISTRYINDEX, STR_AL_APPCORE);
+    pAppCore = lua_touserdata(L, -1);
+    lua_pop(L, 1);
+
+    /* Same root: keep watcher and whatever it collected so far */
+    if (!sRoot || !pAppCore->pFSWatch ||
+        strcmp(SFSWatch_GetRoot(pAppCore->pFSWatch), sRoot) != 0)
+    {
+        SFSWatch_Stop(&pAppCore->pFSWatch);
+        if (!sRoot)
+        {
+            lua_pushboolean(L, 1);
+            return 1;
+        }
+
+        if (lua_istable(L, 2))
+        {
+            dExclude = (size_t)lua_rawlen(L, 2);
+            pExclude = (const char**)calloc(dExclude > 0 ? dExclude : 1, sizeof(const char*));
+            for (i = 0; pExclude && i < dExclude; ++i)
+            {
+                lua_rawgeti(L, 2, (lua_Integer)(i + 1));
+                pExclude[i] = lua_type(L, -1) == LUA_TSTRING ? lua_tostring(L, -1) : NULL;
+                lua_pop(L, 1);
+            }
+        }
+
+        /* Watcher copies exclusions, strings only have to live through call */
+        pAppCore->pFSWatch = SFSWatch_Start(sRoot, pExclude, pExclude ? dExclude : 0);
+        free(pExclude);
+    }
+
+    if (!pAppCore->pFSWatch)
+    {
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    lua_pushboolean(L, 1);
+    lua_pushstring(L, SFSWatch_IsNative(pAppCore->pFSWatch) ? "native" : "poll");
+
+    return 2;
+}
+
+/* Collects drained paths into table on top of stack */
+static void
+_AmberLauncher_OnFileChanged(const char *sRelPath, void *pUserData)
+{
+    lua_State *L = (lua_State*)pUserData;
+
+    lua_pushstring(L, sRelPath);
+    lua_rawseti(L, -2, (lua_Integer)lua_rawlen(L, -2) + 1);
+}
+
 static const 
 luaL_Reg AL[] = 
 {
     {"SystemCall",                  _LUA_SystemCall             },
     {"CommandAdd",                  _LUA_CommandAdd             },
     {"CommandCall",                 _LUA_CommandCall            },
+    {"CommandRunAll",               _LUA_CommandRunAll          },
     {"GetTableOfCommands",          _LUA_GetTableOfCommands     },
     {"EventCall",                   _LUA_EventCall              },
     {"UICall",                      _LUA_UICall                 },
@@ -525,14 +688,41 @@ luaL_Reg AL[] =
     {"GetRegistryKey",              LUA_GetRegistryKey          },
     {"ConvertMP3ToWAV",             LUA_ConvertMP3ToWAV         },
     {"ArchiveExtract",              LUA_ArchiveExtract          },
+    {"ArchiveSize",                 LUA_ArchiveSize             },
+    {"MP3ToWAVSize",                LUA_MP3ToWAVSize            },
     {"INILoad",                     LUA_INILoad                 },
     {"INISave",                     LUA_INISave                 },
     {"INIClose",                    LUA_INIClose                },
     {"INIGet",                      LUA_INIGet                  },
     {"INISet",                      LUA_INISet                  },
+    {"ObjectStoreInstall",          LUA_ObjectStoreInstall      },
+    {"ObjectStoreImport",           LUA_ObjectStoreImport       },
+    {"UpdateRollback",              LUA_UpdateRollback          },
+    {"UpdaterMetrics",              LUA_UpdaterMetrics          },
+    {"PathIndex",                   LUA_PathIndex               },
+    {"FileCopy",                    LUA_FileCopy                },
+    {"FilesCopy",                   LUA_FilesCopy               },
+    {"RemoveTree",                  LUA_RemoveTree              },
+    {"MoveTree",                    LUA_MoveTree                },
+    {"FindGame",                    LUA_FindGame                },
+    {"NormalizeCase",               LUA_NormalizeCase           },
+    {"ListDir",                     LUA_ListDir                 },
+    {"DiskSpace",                   LUA_DiskSpace               },
+    {"WriteBenchmark",              LUA_WriteBenchmark          },
+    {"WatchFiles",                  _LUA_WatchFiles             },
     {NULL, NULL}
 };
 
+/* Caches and logs are written into state folder without creating it first */
+static void
+_AmberLauncher_InitState(void)
+{
+    if (!AmberLauncher_DirCreate(AMBERLAUNCHER_STATE_DIR))
+    {
+        fprintf(stderr, "Failed to create %s\n", AMBERLAUNCHER_STATE_DIR);
+    }
+}
+
 static void
 _SHA256toHex(const unsigned char *sDigestIn, char *sHexOut)
 {
@@ -583,10 +773,19 @@ AmberLauncher_Start(AppCore* pAppCore)
     lua_setfield(pAppCore->pLuaState->pState, LUA_REGISTRYINDEX, STR_AL_APPCORE);
 
     LUA_REGISTER_INIConfig(pAppCore->pLuaState->pState);
+    LUA_REGISTER_PathIndex(pAppCore->pLuaState->pState);
+
+    /* Content-addressed store (updater, mod install rules, archives) */
+    _AmberLauncher_InitState();
+    pAppCore->pObjectStore = SObjectStore_Open(SOBJSTORE_DEFAULT_ROOT);
+    LUA_REGISTER_ObjectStore(pAppCore->pLuaState->pState, pAppCore->pObjectStore);
+
+    /* Filled by updater sessions, read by AL.UpdaterMetrics() */
+    pAppCore->pUpdaterMetrics = SUpdaterMetrics_new();
+    LUA_REGISTER_UpdaterMetrics(pAppCore->pLuaState->pState, pAppCore->pUpdaterMetrics);
 
     /* Command database */
-    SVector_Init(&tConfigureCommandList, sizeof(SCommand));
-    SVector_Reserve(&tConfigureCommandList, SVECTOR_MAX_COMMANDS);
+    pConfigureCommandList = SCommandList_new(SVECTOR_MAX_COMMANDS);
     for (i = 0; i < SVector_DefaultCommandCallbacks_Size; i++)
     {
         _SCommand_AddToList(
@@ -605,20 +804,25 @@ AmberLauncher_Start(AppCore* pAppCore)
 CAPI void
 AmberLauncher_End(AppCore* pAppCore)
 {
+    size_t i;
+
+    /* Nobody left to receive changes */
+    SFSWatch_Stop(&pAppCore->pFSWatch);
+
     /* Lua stuff */
     SLuaState_CallEvent(pAppCore->pLuaState, ELuaFunctionEventTypeStrings[SLUA_EVENT_DESTROY]);
     SLuaState_CallReferencedFunction(pAppCore->pLuaState, SLUA_FUNC_APPDESTROY,NULL);
-    SVector_ForEach(&tConfigureCommandList)
+    for (i = 0; i < SCommandList_GetSize(pConfigureCommandList); i++)
     {
-        SVector_InitIterator(SCommand, &tConfigureCommandList);
-        if (SCommand_IsFlagSet(SVECTOR_ITERATOR, SCOMMAND_FLAG_LUA))
+        const SCommand* pObj = SCommandList_Get(pConfigureCommandList, i);
+        if (SCommand_IsFlagSet(pObj, SCOMMAND_FLAG_LUA))
         {
-            luaL_unref(pAppCore->pLuaState->pState, LUA_REGISTRYINDEX, SVECTOR_ITERATOR->dLuaRef);
+            luaL_unref(pAppCore->pLuaState->pState, LUA_REGISTRYINDEX, pObj->dLuaRef);
         }
     }
 
     /* Other shit */
-    SVector_Cleanup(&tConfigureCommandList);
+    SCommandList_delete(&pConfigureCommandList);
     SLuaState_CallReferencedFunction(pAppCore->pLuaState, SLUA_FUNC_POST_APPDESTROY,NULL);
 }
 
@@ -723,6 +927,32 @@ AmberLauncher_Update(struct AppCore* pAppCore, CBOOL bIsPostUpdate)
     );
 }
 
+CAPI size_t
+AmberLauncher_ProcessFileChanges(AppCore *pApp)
+{
+    lua_State   *L;
+    SVar        tPaths;
+    size_t      dCount;
+
+    if (!pApp->pFSWatch)
+    {
+        return 0;
+    }
+
+    L = pApp->pLuaState->pState;
+    lua_newtable(L);
+    dCount = SFSWatch_Drain(pApp->pFSWatch, _AmberLauncher_OnFileChanged, L);
+    if (dCount > 0)
+    {
+        SVAR_LUAREF(tPaths, L, -1);
+        SLuaState_CallEventArgs(pApp->pLuaState, "FilesChanged", &tPaths, 1);
+        luaL_unref(L, LUA_REGISTRYINDEX, SVAR_GET_LUAREF(tPaths));
+    }
+    lua_pop(L, 1);
+
+    return dCount;
+}
+
 CAPI void
 AmberLauncher_ExecuteLua(AppCore *pApp, const char *sCommand)
 {
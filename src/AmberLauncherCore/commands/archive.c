@@ -2,6 +2,11 @@
 #include <commands/archive.h>
 
 #include <core/command.h>
+#include <core/objstore.h>
+#include <core/filecopy.h>
+#include <core/opsys.h>
+#include <core/cmdgraph.h>
+#include <commands/objstore.h>
 
 #include <ext/miniz.h>
 
@@ -9,6 +14,7 @@
 #include <lauxlib.h>
 
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #ifdef _WIN32
@@ -75,12 +81,69 @@ _join_paths(const char *path1, const char *path2, char *output, size_t size)
     snprintf(output, size, "%s/%s", path1, path2);
 }
 
+/* 
+ * Entry goes through object store: known entries (same archive, name, crc32
+ * and size) are linked without decompression, new ones are extracted into
+ * store once and linked from there.
+ */
 static CBOOL
-_ExtractArchive(const char* sArchivePath, const char* sExtractPath)
+_ExtractEntryViaStore(
+    SObjectStore *pStore,
+    mz_zip_archive *pZip,
+    int dIndex,
+    const mz_zip_archive_file_stat *pStat,
+    const char *sArchivePath,
+    const char *sFilePath)
+{
+    char            sKey[MAX_PATH_LEN * 2];
+    char            sTmpPath[MAX_PATH_LEN];
+    char            sSHA256[SOBJSTORE_SHA256_HEX_SIZE + 1];
+    ESObjectLink    eLink;
+
+    snprintf(sKey, sizeof(sKey), "%s|%s|%08lx|%llu",
+        sArchivePath,
+        pStat->m_filename,
+        (unsigned long)pStat->m_crc32,
+        (unsigned long long)pStat->m_uncomp_size);
+
+    if (SObjectStore_ArchiveLookup(pStore, sKey, sSHA256))
+    {
+        eLink = SObjectStore_Install(pStore, sSHA256, sFilePath);
+        if (eLink != SOBJSTORE_LINK_NONE)
+        {
+            printf("Extracted (%s): %s\n", ESObjectLinkStrings[eLink], sFilePath);
+            return CTRUE;
+        }
+    }
+
+    _join_paths(SObjectStore_GetRoot(pStore), "extract.tmp", sTmpPath, sizeof(sTmpPath));
+    if (!mz_zip_reader_extract_to_file(pZip, (mz_uint)dIndex, sTmpPath, 0) ||
+        !SObjectStore_Import(pStore, sTmpPath, NULL, sSHA256))
+    {
+        remove(sTmpPath);
+        return CFALSE;
+    }
+    remove(sTmpPath);
+
+    SObjectStore_ArchiveRemember(pStore, sKey, sSHA256);
+    eLink = SObjectStore_Install(pStore, sSHA256, sFilePath);
+    if (eLink == SOBJSTORE_LINK_NONE)
+    {
+        return CFALSE;
+    }
+
+    printf("Extracted: %s\n", sFilePath);
+
+    return CTRUE;
+}
+
+static CBOOL
+_ExtractArchive(const char* sArchivePath, const char* sExtractPath, SObjectStore *pStore)
 {
     int dFileCount;
     int i;
     char file_path[MAX_PATH_LEN];
+    char tmp_path[MAX_PATH_LEN + 8];
     mz_zip_archive tZipArchive;
     memset(&tZipArchive, 0, sizeof(tZipArchive));
 
@@ -145,8 +208,18 @@ _ExtractArchive(const char* sArchivePath, const char* sExtractPath)
             *last_slash = '/';
         }
 
-        /* Extract the file to the target path */
-        if (!mz_zip_reader_extract_to_file(&tZipArchive, i, file_path, 0)) {
+        if (pStore && 
+            _ExtractEntryViaStore(pStore, &tZipArchive, i, &file_stat, sArchivePath, file_path))
+        {
+            continue;
+        }
+
+        /* Extract next to target and move it over: target may be hardlink
+         * to original game file, which must stay untouched */
+        snprintf(tmp_path, sizeof(tmp_path), "%s%s", file_path, SFILECOPY_TMP_SUFFIX);
+        if (!mz_zip_reader_extract_to_file(&tZipArchive, i, tmp_path, 0) ||
+            !AmberLauncher_FileReplace(tmp_path, file_path)) {
+            remove(tmp_path);
             fprintf(stderr, "Failed to extract file: %s\n", file_path);
         } else {
             printf("Extracted: %s\n", file_path);
@@ -170,7 +243,28 @@ SCommand_Callback_Archive(const SCommand* pSelf, const SCommandArg* pArgs, const
     UNUSED(pArgs);
     UNUSED(dNumArgs);
 
-    bResult = _ExtractArchive(zip_filename, extract_path);
+    bResult = _ExtractArchive(zip_filename, extract_path, NULL);
+
+    return bResult;
+}
+
+/* Paths are copied: extraction may outlive Lua call (command graph) */
+typedef struct archive_extract_work_t
+{
+    char            *sZipPath;
+    char            *sExtractPath;
+    SObjectStore    *pStore;
+} archive_extract_work_t;
+
+static CBOOL
+_ArchiveExtract_Work(void *pData)
+{
+    archive_extract_work_t *pWork = (archive_extract_work_t*)pData;
+    CBOOL bResult;
+
+    bResult = _ExtractArchive(pWork->sZipPath, pWork->sExtractPath, pWork->pStore);
+
+    free(pWork);
 
     return bResult;
 }
@@ -180,11 +274,59 @@ LUA_ArchiveExtract(struct lua_State* L)
 {
     const char* sZipPath        = luaL_checkstring(L, 1);
     const char* sExtractPath    = luaL_checkstring(L, 2);
-    CBOOL bResult;
+    size_t dZipLen              = strlen(sZipPath) + 1;
+    size_t dExtractLen          = strlen(sExtractPath) + 1;
+    archive_extract_work_t *pWork;
+
+    /* One block: struct followed by both strings */
+    pWork = (archive_extract_work_t*)malloc(sizeof(archive_extract_work_t) + dZipLen + dExtractLen);
+    if (!pWork)
+    {
+        lua_pushboolean(L, CFALSE);
+        return 1;
+    }
+    pWork->sZipPath     = (char*)(pWork + 1);
+    pWork->sExtractPath = pWork->sZipPath + dZipLen;
+    pWork->pStore       = LUA_GetObjectStore(L);
+    memcpy(pWork->sZipPath, sZipPath, dZipLen);
+    memcpy(pWork->sExtractPath, sExtractPath, dExtractLen);
+
+    return SCommandGraph_LuaAwait(L, _ArchiveExtract_Work, pWork);
+}
+
+CAPI int
+LUA_ArchiveSize(struct lua_State* L)
+{
+    const char* sZipPath = luaL_checkstring(L, 1);
+    mz_zip_archive tZip;
+    mz_zip_archive_file_stat tStat;
+    mz_uint i, dNumFiles;
+    uint64 dTotal       = 0;
+    lua_Integer dCount  = 0;
+
+    /* Central directory only, nothing gets decompressed */
+    memset(&tZip, 0, sizeof(tZip));
+    if (!mz_zip_reader_init_file(&tZip, sZipPath, 0))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    dNumFiles = mz_zip_reader_get_num_files(&tZip);
+    for (i = 0; i < dNumFiles; i++)
+    {
+        if (!mz_zip_reader_file_stat(&tZip, i, &tStat) || tStat.m_is_directory)
+        {
+            continue;
+        }
+        dTotal += (uint64)tStat.m_uncomp_size;
+        dCount++;
+    }
 
-    bResult = _ExtractArchive(sZipPath, sExtractPath);
+    mz_zip_reader_end(&tZip);
 
-    lua_pushboolean(L, bResult);
+    lua_pushinteger(L, (lua_Integer)dTotal);
+    lua_pushinteger(L, dCount);
 
-    return 1;
+    return 2;
 }
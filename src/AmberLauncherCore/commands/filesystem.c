@@ -0,0 +1,926 @@
+#include <commands/filesystem.h>
+
+#include <core/pathindex.h>
+#include <core/filecopy.h>
+#include <core/gamescan.h>
+#include <core/opsys.h>
+#include <core/vector.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+
+static const char* STR_AL_PATHINDEX = "PathIndex";
+
+/* Disks rarely get faster past few parallel streams */
+#define LUA_FILESCOPY_DEFAULT_THREADS   4
+#define LUA_FINDGAME_DEFAULT_THREADS    4
+#define LUA_FINDGAME_DEFAULT_DEPTH      5
+#define LUA_NORMALIZECASE_PATH_MAX      4096
+#define LUA_LISTDIR_MAX_DEPTH           32
+/* Long enough to get past drive write cache, short enough to not be noticed */
+#define LUA_WRITEBENCHMARK_DEFAULT_BYTES    (16 * 1024 * 1024)
+#define LUA_WRITEBENCHMARK_BLOCK            (1024 * 1024)
+#define LUA_WRITEBENCHMARK_NAME             ".albench"
+
+typedef struct lua_pathindex_t
+{
+    SPathIndex *pIndex;
+} lua_pathindex_t;
+
+/* Directory entry that case-insensitively matches one of wanted names */
+typedef struct lua_normalizecase_entry_t
+{
+    char            sName[256];
+    EDirEntryType   eType;
+    size_t          dWanted;    /* index into folders, then files */
+} lua_normalizecase_entry_t;
+
+typedef struct lua_normalizecase_t
+{
+    const char  **pFolders;
+    size_t      dFolderCount;
+    const char  **pFiles;
+    size_t      dFileCount;
+    SVector     tEntries;
+} lua_normalizecase_t;
+
+/* Listed entry, relative path uses '/' */
+typedef struct lua_listdir_entry_t
+{
+    char            *sRelPath;
+    EDirEntryType   eType;
+    uint64          dSize;
+    int64           dModTime;
+    uint32          dDepth;
+} lua_listdir_entry_t;
+
+typedef struct lua_listdir_t
+{
+    SVector         tEntries;       /* lua_listdir_entry_t, also BFS queue */
+    const char      *sRelDir;
+    uint32          dDepth;
+} lua_listdir_t;
+
+static const char* LUA_LISTDIR_TYPES[] =
+{
+    "file",
+    "directory",
+    "other"
+};
+
+typedef struct lua_filescopy_t
+{
+    lua_State   *L;
+    int         dProgress;  /* stack index of callback, 0 if none */
+    int         dFailed;    /* stack index of failed table */
+} lua_filescopy_t;
+
+static void
+_LUA_FilesCopy_Progress(const SFileCopyResult *pResult, size_t dDone, size_t dTotal, void *pUserData)
+{
+    lua_filescopy_t *pProgress  = (lua_filescopy_t*)pUserData;
+    lua_State       *L          = pProgress->L;
+    const CBOOL     bSuccess    = pResult->eResult != SFILECOPY_NONE;
+
+    if (!bSuccess && pResult->sRelPath)
+    {
+        lua_pushstring(L, pResult->sRelPath);
+        lua_rawseti(L, pProgress->dFailed, (lua_Integer)lua_rawlen(L, pProgress->dFailed) + 1);
+    }
+
+    if (!pProgress->dProgress)
+    {
+        return;
+    }
+
+    /* Error in callback must not unwind past running copy */
+    lua_pushvalue(L, pProgress->dProgress);
+    lua_pushstring(L, pResult->sRelPath);
+    lua_pushboolean(L, bSuccess);
+    lua_pushstring(L, ESFileCopyStrings[pResult->eResult]);
+    lua_pushinteger(L, (lua_Integer)dDone);
+    lua_pushinteger(L, (lua_Integer)dTotal);
+    if (lua_pcall(L, 5, 0, 0) != LUA_OK)
+    {
+        fprintf(stderr, "AL.FilesCopy: progress callback failed: %s\n", lua_tostring(L, -1));
+        lua_pop(L, 1);
+    }
+}
+
+/* Case-insensitive, '/' and '\\' are same */
+static CBOOL
+_LUA_FilesCopy_IsListed(lua_State *L, int dList, const char *sRelPath)
+{
+    const char  *sEntry;
+    const char  *a;
+    const char  *b;
+    lua_Integer i;
+    lua_Integer dCount;
+
+    if (!dList)
+    {
+        return CFALSE;
+    }
+
+    dCount = (lua_Integer)lua_rawlen(L, dList);
+    for (i = 1; i <= dCount; ++i)
+    {
+        lua_rawgeti(L, dList, i);
+        sEntry = lua_type(L, -1) == LUA_TSTRING ? lua_tostring(L, -1) : NULL;
+        lua_pop(L, 1);
+
+        for (a = sRelPath, b = sEntry; b && *a && *b; ++a, ++b)
+        {
+            const int cA = *a == '\\' ? '/' : tolower((unsigned char)*a);
+            const int cB = *b == '\\' ? '/' : tolower((unsigned char)*b);
+
+            if (cA != cB)
+            {
+                break;
+            }
+        }
+        if (b && *a == '\0' && *b == '\0')
+        {
+            return CTRUE;
+        }
+    }
+
+    return CFALSE;
+}
+
+/* Array of strings at index (non-strings become NULL), NULL if not table.
+ * Strings stay valid while table is on stack. */
+static const char**
+_LUA_GetStringList(lua_State *L, int dIndex, size_t *dCount)
+{
+    const char  **pList;
+    size_t      i;
+
+    *dCount = 0;
+    if (!lua_istable(L, dIndex))
+    {
+        return NULL;
+    }
+
+    *dCount = (size_t)lua_rawlen(L, dIndex);
+    pList   = (const char**)calloc(*dCount > 0 ? *dCount : 1, sizeof(const char*));
+    if (!pList)
+    {
+        *dCount = 0;
+        return NULL;
+    }
+
+    for (i = 0; i < *dCount; ++i)
+    {
+        lua_rawgeti(L, dIndex, (lua_Integer)(i + 1));
+        pList[i] = lua_type(L, -1) == LUA_TSTRING ? lua_tostring(L, -1) : NULL;
+        lua_pop(L, 1);
+    }
+
+    return pList;
+}
+
+static CBOOL
+_LUA_StrEqualNoCase(const char *a, const char *b)
+{
+    for (; *a && *b; ++a, ++b)
+    {
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b))
+        {
+            return CFALSE;
+        }
+    }
+
+    return *a == *b ? CTRUE : CFALSE;
+}
+
+static CBOOL
+_LUA_NormalizeCase_Entry(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    lua_normalizecase_t         *pWork = (lua_normalizecase_t*)pUserData;
+    lua_normalizecase_entry_t   tEntry;
+    const char                  **pNames;
+    size_t                      dCount;
+    size_t                      dOffset;
+    size_t                      dLength;
+    size_t                      i;
+
+    if (eType == DIRENTRY_DIRECTORY)
+    {
+        pNames  = pWork->pFolders;
+        dCount  = pWork->dFolderCount;
+        dOffset = 0;
+    }
+    else if (eType == DIRENTRY_FILE)
+    {
+        pNames  = pWork->pFiles;
+        dCount  = pWork->dFileCount;
+        dOffset = pWork->dFolderCount;
+    }
+    else
+    {
+        return CTRUE;
+    }
+
+    dLength = strlen(sName);
+    if (dLength >= sizeof(tEntry.sName))
+    {
+        return CTRUE;
+    }
+
+    for (i = 0; i < dCount; ++i)
+    {
+        if (pNames[i] && _LUA_StrEqualNoCase(sName, pNames[i]))
+        {
+            memcpy(tEntry.sName, sName, dLength + 1);
+            tEntry.eType    = eType;
+            tEntry.dWanted  = dOffset + i;
+            SVector_PushBack(&pWork->tEntries, &tEntry);
+            break;
+        }
+    }
+
+    return CTRUE;
+}
+
+/* Appends {action=, from=, to=, ok=} to table at dActions */
+static void
+_LUA_NormalizeCase_Push(
+    lua_State *L, int dActions,
+    const char *sAction, const char *sFrom, const char *sTo, CBOOL bSuccess)
+{
+    lua_newtable(L);
+    lua_pushstring(L, sAction);
+    lua_setfield(L, -2, "action");
+    if (sFrom)
+    {
+        lua_pushstring(L, sFrom);
+        lua_setfield(L, -2, "from");
+    }
+    lua_pushstring(L, sTo);
+    lua_setfield(L, -2, "to");
+    lua_pushboolean(L, bSuccess);
+    lua_setfield(L, -2, "ok");
+    lua_rawseti(L, dActions, (lua_Integer)lua_rawlen(L, dActions) + 1);
+}
+
+/* Fixes case of one wanted name using entries found for it */
+static CBOOL
+_LUA_NormalizeCase_Apply(
+    lua_State *L, int dActions, lua_normalizecase_t *pWork,
+    const char *sRoot, const char *sCorrect, size_t dWanted, CBOOL bFolder)
+{
+    lua_normalizecase_entry_t   *pEntry;
+    char                        sSrcPath[LUA_NORMALIZECASE_PATH_MAX];
+    char                        sDstPath[LUA_NORMALIZECASE_PATH_MAX];
+    CBOOL                       bExact   = CFALSE;
+    CBOOL                       bResult  = CTRUE;
+    CBOOL                       bSuccess;
+    size_t                      i;
+
+    snprintf(sDstPath, sizeof(sDstPath), "%s%c%s", sRoot, SPATHINDEX_SEPARATOR, sCorrect);
+
+    for (i = 0; i < SVector_GetSize(&pWork->tEntries); ++i)
+    {
+        pEntry = (lua_normalizecase_entry_t*)SVector_Get(&pWork->tEntries, i);
+        if (pEntry->dWanted == dWanted && strcmp(pEntry->sName, sCorrect) == 0)
+        {
+            bExact = CTRUE;
+        }
+    }
+
+    for (i = 0; i < SVector_GetSize(&pWork->tEntries); ++i)
+    {
+        pEntry = (lua_normalizecase_entry_t*)SVector_Get(&pWork->tEntries, i);
+        if (pEntry->dWanted != dWanted || strcmp(pEntry->sName, sCorrect) == 0)
+        {
+            continue;
+        }
+        snprintf(sSrcPath, sizeof(sSrcPath), "%s%c%s", sRoot, SPATHINDEX_SEPARATOR, pEntry->sName);
+
+        /* First variant just gets renamed, unless something took the name */
+        if (!bExact && AmberLauncher_FileRename(sSrcPath, sDstPath))
+        {
+            _LUA_NormalizeCase_Push(L, dActions, "rename", pEntry->sName, sCorrect, CTRUE);
+            bExact = CTRUE;
+            continue;
+        }
+        bExact = CTRUE;
+
+        /* Rest is merged (folders) or replaces canonical file, data is copied
+         * only when rename isn't possible: to temp file moved over canonical
+         * one, which may be hardlinked and mustn't be written in place */
+        if (bFolder)
+        {
+            bSuccess = AmberLauncher_TreeMove(sSrcPath, sDstPath);
+        }
+        else
+        {
+            bSuccess = AmberLauncher_FileReplace(sSrcPath, sDstPath) ||
+                (SFileCopy_File(sSrcPath, sDstPath) != SFILECOPY_NONE && remove(sSrcPath) == 0);
+        }
+        _LUA_NormalizeCase_Push(L, dActions, bFolder ? "merge" : "overwrite",
+            pEntry->sName, sCorrect, bSuccess);
+        bResult = bResult && bSuccess;
+    }
+
+    if (!bExact)
+    {
+        if (bFolder)
+        {
+            bSuccess = AmberLauncher_DirCreate(sDstPath);
+            _LUA_NormalizeCase_Push(L, dActions, "create", NULL, sCorrect, bSuccess);
+            bResult = bResult && bSuccess;
+        }
+        else
+        {
+            _LUA_NormalizeCase_Push(L, dActions, "missing", NULL, sCorrect, CFALSE);
+        }
+    }
+
+    return bResult;
+}
+
+static CBOOL
+_LUA_ListDir_Entry(const SDirEntryInfo *pInfo, void *pUserData)
+{
+    lua_listdir_t       *pList  = (lua_listdir_t*)pUserData;
+    const size_t        dDir    = strlen(pList->sRelDir);
+    const size_t        dName   = strlen(pInfo->sName);
+    lua_listdir_entry_t tEntry;
+
+    tEntry.sRelPath = (char*)malloc(dDir + dName + 2);
+    if (!tEntry.sRelPath)
+    {
+        return CFALSE;
+    }
+    if (dDir > 0)
+    {
+        memcpy(tEntry.sRelPath, pList->sRelDir, dDir);
+        tEntry.sRelPath[dDir] = '/';
+        memcpy(tEntry.sRelPath + dDir + 1, pInfo->sName, dName + 1);
+    }
+    else
+    {
+        memcpy(tEntry.sRelPath, pInfo->sName, dName + 1);
+    }
+
+    tEntry.eType    = pInfo->eType;
+    tEntry.dSize    = pInfo->dSize;
+    tEntry.dModTime = pInfo->dModTime;
+    tEntry.dDepth   = pList->dDepth;
+    SVector_PushBack(&pList->tEntries, &tEntry);
+
+    return CTRUE;
+}
+
+CAPI int
+LUA_REGISTER_PathIndex(struct lua_State* L)
+{
+    luaL_newmetatable(L, STR_AL_PATHINDEX);
+
+    /* Set __gc metamethod */
+    lua_pushstring(L, "__gc");
+    lua_pushcfunction(L, LUA_PathIndexClose);
+    lua_settable(L, -3);
+
+    /* Set __index metamethod for method access */
+    lua_pushstring(L, "__index");
+    lua_newtable(L);
+
+    lua_pushstring(L, "resolve");
+    lua_pushcfunction(L, LUA_PathIndexResolve);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "count");
+    lua_pushcfunction(L, LUA_PathIndexCount);
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "close");
+    lua_pushcfunction(L, LUA_PathIndexClose);
+    lua_settable(L, -3);
+
+    lua_settable(L, -3);
+
+    lua_pop(L, 1);
+
+    return 1;
+}
+
+CAPI int
+LUA_PathIndex(struct lua_State* L)
+{
+    const char      *sRoot = luaL_checkstring(L, 1);
+    SPathIndex      *pIndex;
+    lua_pathindex_t *pUserData;
+
+    pIndex = SPathIndex_Build(sRoot);
+    if (!pIndex)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    pUserData = (lua_pathindex_t*)lua_newuserdata(L, sizeof(lua_pathindex_t));
+    pUserData->pIndex = pIndex;
+
+    luaL_getmetatable(L, STR_AL_PATHINDEX);
+    lua_setmetatable(L, -2);
+
+    return 1;
+}
+
+CAPI int
+LUA_PathIndexResolve(struct lua_State* L)
+{
+    lua_pathindex_t *pUserData  = (lua_pathindex_t*)luaL_checkudata(L, 1, STR_AL_PATHINDEX);
+    const char      *sRelPath   = luaL_checkstring(L, 2);
+    const char      *sPath      = SPathIndex_Resolve(pUserData->pIndex, sRelPath);
+    char            sSeparator[2];
+
+    if (!sPath)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    sSeparator[0] = SPATHINDEX_SEPARATOR;
+    sSeparator[1] = '\0';
+
+    lua_pushstring(L, SPathIndex_GetRoot(pUserData->pIndex));
+    lua_pushstring(L, sSeparator);
+    lua_pushstring(L, sPath);
+    lua_concat(L, 3);
+
+    return 1;
+}
+
+CAPI int
+LUA_PathIndexCount(struct lua_State* L)
+{
+    lua_pathindex_t *pUserData = (lua_pathindex_t*)luaL_checkudata(L, 1, STR_AL_PATHINDEX);
+
+    lua_pushinteger(L, (lua_Integer)SPathIndex_GetCount(pUserData->pIndex));
+
+    return 1;
+}
+
+CAPI int
+LUA_PathIndexClose(struct lua_State* L)
+{
+    lua_pathindex_t *pUserData = (lua_pathindex_t*)luaL_checkudata(L, 1, STR_AL_PATHINDEX);
+
+    SPathIndex_delete(&pUserData->pIndex);
+
+    return 0;
+}
+
+CAPI int
+LUA_FileCopy(struct lua_State* L)
+{
+    const char  *sSrcPath   = luaL_checkstring(L, 1);
+    const char  *sDstPath   = luaL_checkstring(L, 2);
+    ESFileCopy  eResult     = SFileCopy_File(sSrcPath, sDstPath);
+
+    if (eResult == SFILECOPY_NONE)
+    {
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    lua_pushboolean(L, 1);
+    lua_pushstring(L, ESFileCopyStrings[eResult]);
+
+    return 2;
+}
+
+CAPI int
+LUA_FilesCopy(struct lua_State* L)
+{
+    const char      *sSrcRoot   = luaL_checkstring(L, 1);
+    const char      *sDstRoot   = luaL_checkstring(L, 2);
+    const char      **pRelPaths;
+    CBOOL           *pLinkable;
+    size_t          dCount;
+    size_t          dFailed;
+    size_t          i;
+    uint32          dThreads    = LUA_FILESCOPY_DEFAULT_THREADS;
+    CBOOL           bLink       = CFALSE;
+    int             dCopyOnly   = 0;
+    lua_filescopy_t tProgress;
+
+    luaL_checktype(L, 3, LUA_TTABLE);
+    lua_settop(L, 4);
+
+    tProgress.L         = L;
+    tProgress.dProgress = 0;
+
+    if (lua_istable(L, 4))
+    {
+        lua_getfield(L, 4, "threads");
+        if (lua_isnumber(L, -1) && lua_tointeger(L, -1) > 0)
+        {
+            dThreads = (uint32)lua_tointeger(L, -1);
+        }
+        lua_pop(L, 1);
+
+        lua_getfield(L, 4, "link");
+        bLink = lua_toboolean(L, -1) ? CTRUE : CFALSE;
+        lua_pop(L, 1);
+
+        /* Both stay on stack (index 5 and 6) for duration of copy */
+        lua_getfield(L, 4, "copy");
+        dCopyOnly = lua_istable(L, -1) ? lua_gettop(L) : 0;
+
+        lua_getfield(L, 4, "progress");
+        if (lua_isfunction(L, -1))
+        {
+            tProgress.dProgress = lua_gettop(L);
+        }
+    }
+
+    lua_newtable(L);
+    tProgress.dFailed = lua_gettop(L);
+
+    /* Strings stay alive as long as list is on stack */
+    dCount      = (size_t)lua_rawlen(L, 3);
+    pRelPaths   = (const char**)calloc(dCount > 0 ? dCount : 1, sizeof(const char*));
+    pLinkable   = (CBOOL*)calloc(dCount > 0 ? dCount : 1, sizeof(CBOOL));
+    if (!pRelPaths || !pLinkable)
+    {
+        free(pRelPaths);
+        free(pLinkable);
+        return luaL_error(L, "AL.FilesCopy: out of memory");
+    }
+    for (i = 0; i < dCount; ++i)
+    {
+        lua_rawgeti(L, 3, (lua_Integer)(i + 1));
+        pRelPaths[i] = lua_type(L, -1) == LUA_TSTRING ? lua_tostring(L, -1) : NULL;
+        lua_pop(L, 1);
+
+        pLinkable[i] = bLink && pRelPaths[i] &&
+            !_LUA_FilesCopy_IsListed(L, dCopyOnly, pRelPaths[i]);
+    }
+
+    dFailed = SFileCopy_Batch(sSrcRoot, sDstRoot, pRelPaths, pLinkable, dCount, dThreads,
+        _LUA_FilesCopy_Progress, &tProgress);
+    free(pRelPaths);
+    free(pLinkable);
+
+    lua_pushboolean(L, dFailed == 0);
+    lua_pushvalue(L, tProgress.dFailed);
+
+    return 2;
+}
+
+CAPI int
+LUA_RemoveTree(struct lua_State* L)
+{
+    const char *sPath = luaL_checkstring(L, 1);
+
+    lua_pushboolean(L, AmberLauncher_TreeRemove(sPath));
+
+    return 1;
+}
+
+CAPI int
+LUA_MoveTree(struct lua_State* L)
+{
+    const char *sSrcPath = luaL_checkstring(L, 1);
+    const char *sDstPath = luaL_checkstring(L, 2);
+
+    lua_pushboolean(L, AmberLauncher_TreeMove(sSrcPath, sDstPath));
+
+    return 1;
+}
+
+CAPI int
+LUA_FindGame(struct lua_State* L)
+{
+    SGameScanOptions    tOptions;
+    const char          **pRoots;
+    const char          **pRequired = NULL;
+    const char          **pExclude  = NULL;
+    char                *sFound;
+
+    luaL_checktype(L, 1, LUA_TTABLE);
+    lua_settop(L, 2);
+
+    memset(&tOptions, 0, sizeof(tOptions));
+    tOptions.sExecutable    = "mm7.exe";
+    tOptions.dMaxDepth      = LUA_FINDGAME_DEFAULT_DEPTH;
+    tOptions.dThreads       = LUA_FINDGAME_DEFAULT_THREADS;
+
+    pRoots = _LUA_GetStringList(L, 1, &tOptions.dRootCount);
+    tOptions.pRoots = pRoots;
+
+    /* Option values stay on stack (index 3..6) during scan */
+    if (lua_istable(L, 2))
+    {
+        lua_getfield(L, 2, "exe");
+        if (lua_type(L, -1) == LUA_TSTRING)
+        {
+            tOptions.sExecutable = lua_tostring(L, -1);
+        }
+
+        lua_getfield(L, 2, "files");
+        pRequired = _LUA_GetStringList(L, -1, &tOptions.dRequiredCount);
+        tOptions.pRequired = pRequired;
+
+        lua_getfield(L, 2, "exclude");
+        pExclude = _LUA_GetStringList(L, -1, &tOptions.dExcludeCount);
+        tOptions.pExclude = pExclude;
+
+        lua_getfield(L, 2, "cache");
+        if (lua_type(L, -1) == LUA_TSTRING)
+        {
+            tOptions.sCachePath = lua_tostring(L, -1);
+        }
+
+        lua_getfield(L, 2, "depth");
+        if (lua_isnumber(L, -1) && lua_tointeger(L, -1) >= 0)
+        {
+            tOptions.dMaxDepth = (uint32)lua_tointeger(L, -1);
+        }
+        lua_pop(L, 1);
+
+        lua_getfield(L, 2, "threads");
+        if (lua_isnumber(L, -1) && lua_tointeger(L, -1) > 0)
+        {
+            tOptions.dThreads = (uint32)lua_tointeger(L, -1);
+        }
+        lua_pop(L, 1);
+    }
+
+    sFound = SGameScan_Find(&tOptions);
+    free((void*)pRoots);
+    free((void*)pRequired);
+    free((void*)pExclude);
+
+    if (!sFound)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushstring(L, sFound);
+    free(sFound);
+
+    return 1;
+}
+
+CAPI int
+LUA_NormalizeCase(struct lua_State* L)
+{
+    const char          *sRoot  = luaL_checkstring(L, 1);
+    lua_normalizecase_t tWork;
+    CBOOL               bResult = CTRUE;
+    int                 dActions;
+    size_t              i;
+
+    lua_settop(L, 2);
+
+    memset(&tWork, 0, sizeof(tWork));
+
+    /* Lists stay on stack (index 3 and 4) so their strings stay valid */
+    if (lua_istable(L, 2))
+    {
+        lua_getfield(L, 2, "folders");
+        tWork.pFolders = _LUA_GetStringList(L, -1, &tWork.dFolderCount);
+
+        lua_getfield(L, 2, "files");
+        tWork.pFiles = _LUA_GetStringList(L, -1, &tWork.dFileCount);
+    }
+
+    lua_newtable(L);
+    dActions = lua_gettop(L);
+
+    /* One pass over directory, only entries matching wanted names are kept */
+    SVector_Init(&tWork.tEntries, sizeof(lua_normalizecase_entry_t));
+    if (!AmberLauncher_DirIterate(sRoot, _LUA_NormalizeCase_Entry, &tWork))
+    {
+        bResult = CFALSE;
+    }
+    else
+    {
+        for (i = 0; i < tWork.dFolderCount; ++i)
+        {
+            if (tWork.pFolders[i] && !_LUA_NormalizeCase_Apply(L, dActions, &tWork,
+                sRoot, tWork.pFolders[i], i, CTRUE))
+            {
+                bResult = CFALSE;
+            }
+        }
+        for (i = 0; i < tWork.dFileCount; ++i)
+        {
+            if (tWork.pFiles[i] && !_LUA_NormalizeCase_Apply(L, dActions, &tWork,
+                sRoot, tWork.pFiles[i], tWork.dFolderCount + i, CFALSE))
+            {
+                bResult = CFALSE;
+            }
+        }
+    }
+
+    SVector_Cleanup(&tWork.tEntries);
+    free((void*)tWork.pFolders);
+    free((void*)tWork.pFiles);
+
+    lua_pushboolean(L, bResult);
+    lua_pushvalue(L, dActions);
+
+    return 2;
+}
+
+CAPI int
+LUA_ListDir(struct lua_State* L)
+{
+    const char          *sRoot      = luaL_checkstring(L, 1);
+    CBOOL               bRecursive  = CFALSE;
+    CBOOL               bAttrs      = CFALSE;
+    lua_listdir_t       tList;
+    lua_listdir_entry_t *pEntry;
+    char                *sPath;
+    size_t              dRoot;
+    size_t              dCount;
+    size_t              i;
+
+    if (lua_istable(L, 2))
+    {
+        lua_getfield(L, 2, "recursive");
+        bRecursive = lua_toboolean(L, -1) ? CTRUE : CFALSE;
+        lua_pop(L, 1);
+
+        lua_getfield(L, 2, "attrs");
+        bAttrs = lua_toboolean(L, -1) ? CTRUE : CFALSE;
+        lua_pop(L, 1);
+    }
+
+    SVector_Init(&tList.tEntries, sizeof(lua_listdir_entry_t));
+    tList.sRelDir   = "";
+    tList.dDepth    = 0;
+
+    if (!AmberLauncher_DirIterateInfo(sRoot, bAttrs, _LUA_ListDir_Entry, &tList))
+    {
+        SVector_ForEach(&tList.tEntries)
+        {
+            SVector_InitIterator(lua_listdir_entry_t, &tList.tEntries);
+            free(SVECTOR_ITERATOR->sRelPath);
+        }
+        SVector_Cleanup(&tList.tEntries);
+        lua_pushnil(L);
+        return 1;
+    }
+
+    /* Entries double as breadth-first queue: subdirectories get listed as
+     * they are reached, their contents appended behind */
+    dRoot = strlen(sRoot);
+    for (i = 0; bRecursive && i < SVector_GetSize(&tList.tEntries); ++i)
+    {
+        pEntry = (lua_listdir_entry_t*)SVector_Get(&tList.tEntries, i);
+        if (pEntry->eType != DIRENTRY_DIRECTORY || pEntry->dDepth >= LUA_LISTDIR_MAX_DEPTH)
+        {
+            continue;
+        }
+
+        sPath = (char*)malloc(dRoot + strlen(pEntry->sRelPath) + 2);
+        if (!sPath)
+        {
+            break;
+        }
+        sprintf(sPath, "%s%c%s", sRoot, SPATHINDEX_SEPARATOR, pEntry->sRelPath);
+
+        /* pEntry may move while appending, its string doesn't */
+        tList.sRelDir   = pEntry->sRelPath;
+        tList.dDepth    = pEntry->dDepth + 1;
+        AmberLauncher_DirIterateInfo(sPath, bAttrs, _LUA_ListDir_Entry, &tList);
+        free(sPath);
+    }
+
+    dCount = SVector_GetSize(&tList.tEntries);
+    lua_createtable(L, dCount > INT_MAX ? INT_MAX : (int)dCount, 0);
+    for (i = 0; i < dCount; ++i)
+    {
+        pEntry = (lua_listdir_entry_t*)SVector_Get(&tList.tEntries, i);
+
+        lua_createtable(L, 0, bAttrs ? 4 : 2);
+        lua_pushstring(L, pEntry->sRelPath);
+        lua_setfield(L, -2, "name");
+        lua_pushstring(L, LUA_LISTDIR_TYPES[pEntry->eType]);
+        lua_setfield(L, -2, "type");
+        if (bAttrs)
+        {
+            lua_pushinteger(L, (lua_Integer)pEntry->dSize);
+            lua_setfield(L, -2, "size");
+            lua_pushinteger(L, (lua_Integer)(pEntry->dModTime / 1000000000));
+            lua_setfield(L, -2, "mtime");
+        }
+        lua_rawseti(L, -2, (lua_Integer)(i + 1));
+
+        free(pEntry->sRelPath);
+    }
+    SVector_Cleanup(&tList.tEntries);
+
+    return 1;
+}
+
+CAPI int
+LUA_DiskSpace(struct lua_State* L)
+{
+    const char  *sPath = luaL_checkstring(L, 1);
+    uint64      dFree;
+    uint64      dTotal;
+
+    if (!AmberLauncher_DiskSpace(sPath, &dFree, &dTotal))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushinteger(L, (lua_Integer)dFree);
+    lua_pushinteger(L, (lua_Integer)dTotal);
+
+    return 2;
+}
+
+CAPI int
+LUA_WriteBenchmark(struct lua_State* L)
+{
+    const char  *sDir   = luaL_checkstring(L, 1);
+    lua_Integer dBytes  = luaL_optinteger(L, 2, LUA_WRITEBENCHMARK_DEFAULT_BYTES);
+    char        *sPath;
+    char        *pBlock;
+    FILE        *pFile;
+    uint64      dStart;
+    uint64      dElapsed;
+    lua_Integer dWritten = 0;
+    size_t      dChunk;
+    CBOOL       bSuccess;
+
+    if (dBytes <= 0)
+    {
+        dBytes = LUA_WRITEBENCHMARK_DEFAULT_BYTES;
+    }
+
+    sPath   = (char*)malloc(strlen(sDir) + sizeof(LUA_WRITEBENCHMARK_NAME) + sizeof(SFILECOPY_TMP_SUFFIX) + 1);
+    pBlock  = (char*)malloc(LUA_WRITEBENCHMARK_BLOCK);
+    if (!sPath || !pBlock)
+    {
+        free(sPath);
+        free(pBlock);
+        lua_pushnil(L);
+        return 1;
+    }
+    sprintf(sPath, "%s%c%s%s", sDir, SPATHINDEX_SEPARATOR, LUA_WRITEBENCHMARK_NAME, SFILECOPY_TMP_SUFFIX);
+    /* Non-zero so nothing along the way can treat it as sparse */
+    memset(pBlock, 0xA5, LUA_WRITEBENCHMARK_BLOCK);
+
+    pFile = fopen(sPath, "wb");
+    if (!pFile)
+    {
+        free(sPath);
+        free(pBlock);
+        lua_pushnil(L);
+        return 1;
+    }
+
+    /* Sync is part of measurement, otherwise it's page cache speed */
+    dStart      = AmberLauncher_GetMonotonicTime();
+    bSuccess    = CTRUE;
+    while (dWritten < dBytes)
+    {
+        dChunk = (size_t)(dBytes - dWritten) < LUA_WRITEBENCHMARK_BLOCK ?
+            (size_t)(dBytes - dWritten) : LUA_WRITEBENCHMARK_BLOCK;
+        if (fwrite(pBlock, 1, dChunk, pFile) != dChunk)
+        {
+            bSuccess = CFALSE;
+            break;
+        }
+        dWritten += (lua_Integer)dChunk;
+    }
+    if (bSuccess && !AmberLauncher_FileSync(pFile))
+    {
+        bSuccess = CFALSE;
+    }
+    dElapsed = AmberLauncher_GetMonotonicTime() - dStart;
+
+    fclose(pFile);
+    remove(sPath);
+    free(sPath);
+    free(pBlock);
+
+    if (!bSuccess)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushnumber(L, (lua_Number)dWritten * 1e9 / (lua_Number)(dElapsed ? dElapsed : 1));
+
+    return 1;
+}
@@ -1,6 +1,7 @@
 #include <commands/music.h>
 
 #include <core/command.h>
+#include <core/cmdgraph.h>
 
 #include <lua.h>
 #include <lauxlib.h>
@@ -361,16 +362,97 @@ SCommand_Callback_ConvertMusic(const SCommand* pSelf, const SCommandArg* pArgs,
     _test();
 }
 
+/* Path is copied: conversion may outlive Lua call (command graph) */
+static CBOOL
+_ConvertMP3ToWAV_Work(void *pData)
+{
+    CBOOL bResult = _ConvertMP3ToWAV((const char*)pData);
+
+    free(pData);
+
+    return bResult;
+}
+
 int
 LUA_ConvertMP3ToWAV(struct lua_State* L)
+{
+    const char* sPath   = luaL_checkstring(L, 1);
+    size_t dPathLen     = strlen(sPath) + 1;
+    char* sPathCopy     = (char*)malloc(dPathLen);
+
+    if (!sPathCopy)
+    {
+        lua_pushboolean(L, CFALSE);
+        return 1;
+    }
+    memcpy(sPathCopy, sPath, dPathLen);
+
+    return SCommandGraph_LuaAwait(L, _ConvertMP3ToWAV_Work, sPathCopy);
+}
+
+
+CAPI int
+LUA_MP3ToWAVSize(struct lua_State* L)
 {
     const char* sPath = luaL_checkstring(L, 1);
-    CBOOL bResult;
+    FILE *pFile;
+    unsigned char *pData;
+    long dSize;
+    size_t dRead, dPos;
+    mp3dec_t tDecoder;
+    mp3dec_frame_info_t tInfo;
+    int dSamples;
+    int dChannels = 0;
+    uint64 dTotalSamples = 0;
+
+    pFile = fopen(sPath, "rb");
+    if (!pFile)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
 
-    bResult = _ConvertMP3ToWAV(sPath);
+    fseek(pFile, 0, SEEK_END);
+    dSize = ftell(pFile);
+    rewind(pFile);
 
-    lua_pushboolean(L, (CBOOL)bResult);
+    pData = dSize > 0 ? (unsigned char *)malloc((size_t)dSize) : NULL;
+    if (!pData)
+    {
+        fclose(pFile);
+        lua_pushnil(L);
+        return 1;
+    }
+
+    dRead = fread(pData, 1, (size_t)dSize, pFile);
+    fclose(pFile);
+
+    /* NULL pcm makes minimp3 parse frame headers without decoding */
+    mp3dec_init(&tDecoder);
+    dPos = 0;
+    while (dPos < dRead)
+    {
+        dSamples = mp3dec_decode_frame(&tDecoder, pData + dPos, (int)(dRead - dPos), NULL, &tInfo);
+        if (tInfo.frame_bytes == 0)
+        {
+            break;
+        }
+        dPos += (size_t)tInfo.frame_bytes;
+
+        if (dSamples > 0)
+        {
+            if (dChannels == 0)
+            {
+                dChannels = tInfo.channels;
+            }
+            dTotalSamples += (uint64)dSamples;
+        }
+    }
+
+    free(pData);
+
+    /* Same layout as _ConvertMP3ToWAV writes: 16-bit PCM */
+    lua_pushinteger(L, (lua_Integer)(sizeof(WAVHeader) + dTotalSamples * (uint64)dChannels * sizeof(short)));
 
     return 1;
 }
-
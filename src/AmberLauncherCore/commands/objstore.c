@@ -0,0 +1,99 @@
+#include <commands/objstore.h>
+
+#include <core/objstore.h>
+#include <core/snapshot.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+
+static const char* STR_AL_OBJSTORE = "AL.ObjectStore";
+
+CAPI void
+LUA_REGISTER_ObjectStore(struct lua_State* L, struct SObjectStore* pStore)
+{
+    lua_pushlightuserdata(L, (void*)pStore);
+    lua_setfield(L, LUA_REGISTRYINDEX, STR_AL_OBJSTORE);
+}
+
+CAPI struct SObjectStore*
+LUA_GetObjectStore(struct lua_State* L)
+{
+    SObjectStore *pStore;
+
+    lua_getfield(L, LUA_REGISTRYINDEX, STR_AL_OBJSTORE);
+    pStore = (SObjectStore*)lua_touserdata(L, -1);
+    lua_pop(L, 1);
+
+    return pStore;
+}
+
+CAPI int
+LUA_ObjectStoreInstall(struct lua_State* L)
+{
+    const char*     sSrcPath = luaL_checkstring(L, 1);
+    const char*     sDstPath = luaL_checkstring(L, 2);
+    SObjectStore*   pStore   = LUA_GetObjectStore(L);
+    char            sSHA256[SOBJSTORE_SHA256_HEX_SIZE + 1];
+    ESObjectLink    eLink;
+
+    if (!pStore || !SObjectStore_Import(pStore, sSrcPath, NULL, sSHA256))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    eLink = SObjectStore_Install(pStore, sSHA256, sDstPath);
+    if (eLink == SOBJSTORE_LINK_NONE)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushstring(L, ESObjectLinkStrings[eLink]);
+
+    return 1;
+}
+
+CAPI int
+LUA_ObjectStoreImport(struct lua_State* L)
+{
+    const char*     sPath   = luaL_checkstring(L, 1);
+    SObjectStore*   pStore  = LUA_GetObjectStore(L);
+    char            sSHA256[SOBJSTORE_SHA256_HEX_SIZE + 1];
+
+    if (!pStore || !SObjectStore_Import(pStore, sPath, NULL, sSHA256))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushstring(L, sSHA256);
+
+    return 1;
+}
+
+CAPI int
+LUA_UpdateRollback(struct lua_State* L)
+{
+    SObjectStore*   pStore  = LUA_GetObjectStore(L);
+    uint32          dNumFiles;
+
+    if (!pStore)
+    {
+        lua_pushnil(L);
+        lua_pushstring(L, "Object store is unavailable");
+        return 2;
+    }
+
+    if (!SSnapshot_RollbackLatest(pStore, SSNAPSHOT_DEFAULT_ROOT, &dNumFiles))
+    {
+        lua_pushnil(L);
+        lua_pushstring(L, dNumFiles > 0 ?
+            "Some files could not be restored" : "No update snapshot to roll back");
+        return 2;
+    }
+
+    lua_pushinteger(L, (lua_Integer)dNumFiles);
+
+    return 1;
+}
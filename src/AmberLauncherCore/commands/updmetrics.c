@@ -0,0 +1,96 @@
+#include <commands/updmetrics.h>
+
+#include <core/updmetrics.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+
+static const char* STR_AL_UPDMETRICS = "AL.UpdaterMetrics";
+
+static void
+_LUA_SetNumber(struct lua_State* L, const char *sKey, double dValue)
+{
+    lua_pushnumber(L, (lua_Number)dValue);
+    lua_setfield(L, -2, sKey);
+}
+
+static void
+_LUA_SetSeconds(struct lua_State* L, const char *sKey, uint64 dMicroseconds)
+{
+    _LUA_SetNumber(L, sKey, (double)dMicroseconds / 1000000.0);
+}
+
+CAPI void
+LUA_REGISTER_UpdaterMetrics(struct lua_State* L, struct SUpdaterMetrics* pMetrics)
+{
+    lua_pushlightuserdata(L, (void*)pMetrics);
+    lua_setfield(L, LUA_REGISTRYINDEX, STR_AL_UPDMETRICS);
+}
+
+CAPI int
+LUA_UpdaterMetrics(struct lua_State* L)
+{
+    SUpdaterMetrics *pMetrics;
+    uint32          dLookups;
+    size_t          dIndex;
+    size_t          dNumFiles;
+
+    lua_getfield(L, LUA_REGISTRYINDEX, STR_AL_UPDMETRICS);
+    pMetrics = (SUpdaterMetrics*)lua_touserdata(L, -1);
+    lua_pop(L, 1);
+
+    if (!pMetrics || pMetrics->sOperation[0] == '\0')
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    dLookups = pMetrics->dHashCacheHits + pMetrics->dHashCacheMisses;
+
+    lua_newtable(L);
+
+    lua_pushstring(L, pMetrics->sOperation);
+    lua_setfield(L, -2, "operation");
+    _LUA_SetNumber(L,  "start",             (double)pMetrics->dStartTime);
+    _LUA_SetSeconds(L, "wall",              pMetrics->dWallUs);
+    _LUA_SetNumber(L,  "connections",       pMetrics->dConnections);
+    _LUA_SetNumber(L,  "bytes",             (double)pMetrics->dBytes);
+    _LUA_SetNumber(L,  "bps",               SUpdaterMetrics_Rate(pMetrics->dBytes, pMetrics->dWallUs));
+    _LUA_SetSeconds(L, "hash",              pMetrics->dHashUs);
+    _LUA_SetSeconds(L, "download",          pMetrics->dDownloadUs);
+    _LUA_SetSeconds(L, "write",             pMetrics->dWriteUs);
+    _LUA_SetNumber(L,  "retries",           pMetrics->dRetries);
+    _LUA_SetNumber(L,  "hashcache_hits",    pMetrics->dHashCacheHits);
+    _LUA_SetNumber(L,  "hashcache_misses",  pMetrics->dHashCacheMisses);
+    _LUA_SetNumber(L,  "hashcache_hit_rate",
+        dLookups > 0 ? (double)pMetrics->dHashCacheHits / (double)dLookups : 0.0);
+    _LUA_SetNumber(L,  "objstore_hits",     pMetrics->dObjectStoreHits);
+    _LUA_SetNumber(L,  "manifest_fetches",  pMetrics->dManifestFetches);
+    _LUA_SetNumber(L,  "manifest_cache_hits", pMetrics->dManifestCacheHits);
+
+    dNumFiles = SUpdaterMetrics_GetFileCount(pMetrics);
+    lua_createtable(L, (int)dNumFiles, 0);
+    for (dIndex = 0; dIndex < dNumFiles; ++dIndex)
+    {
+        const SUpdaterFileMetrics *pFile = SUpdaterMetrics_GetFile(pMetrics, dIndex);
+
+        lua_createtable(L, 0, 10);
+        lua_pushstring(L, pFile->sPath);
+        lua_setfield(L, -2, "path");
+        lua_pushstring(L, pFile->sResult);
+        lua_setfield(L, -2, "result");
+        _LUA_SetNumber(L,  "size",      (double)pFile->dSize);
+        _LUA_SetNumber(L,  "bytes",     (double)pFile->dBytes);
+        _LUA_SetNumber(L,  "attempts",  pFile->dAttempts);
+        _LUA_SetNumber(L,  "bps",       SUpdaterMetrics_Rate(pFile->dBytes, pFile->dDownloadUs));
+        _LUA_SetSeconds(L, "hash",      pFile->dHashUs);
+        _LUA_SetSeconds(L, "download",  pFile->dDownloadUs);
+        _LUA_SetSeconds(L, "write",     pFile->dWriteUs);
+        _LUA_SetSeconds(L, "total",     pFile->dTotalUs);
+
+        lua_rawseti(L, -2, (int)dIndex + 1);
+    }
+    lua_setfield(L, -2, "files");
+
+    return 1;
+}
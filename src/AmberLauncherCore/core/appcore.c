@@ -2,6 +2,9 @@
 #include <core/appcore.h>
 #include <core/luastate.h>
 #include <core/observer.h>
+#include <core/objstore.h>
+#include <core/updmetrics.h>
+#include <core/fswatch.h>
 
 #include <stddef.h>
 #include <stdlib.h>
@@ -38,6 +41,9 @@ AppCore_init(AppCore *pAppCore)
         pAppCore->pLuaState             = SLuaState_new();
         pAppCore->pOnUserEventNotifier  = SSubject_new();
         pAppCore->sLaunchCmd            = NULL;
+        pAppCore->pObjectStore          = NULL;
+        pAppCore->pUpdaterMetrics       = NULL;
+        pAppCore->pFSWatch              = NULL;
 
         AppCore_SetLaunchCommand(pAppCore, AppCore_GetDefaultLaunchCommand());
 
@@ -63,6 +69,9 @@ AppCore_free(AppCore** pAppCore)
 
     SLuaState_delete(&(*pAppCore)->pLuaState);
     SSubject_delete(&(*pAppCore)->pOnUserEventNotifier);
+    SObjectStore_Close(&(*pAppCore)->pObjectStore);
+    SUpdaterMetrics_delete(&(*pAppCore)->pUpdaterMetrics);
+    SFSWatch_Stop(&(*pAppCore)->pFSWatch);
 
     free((*pAppCore)->sLaunchCmd);
 
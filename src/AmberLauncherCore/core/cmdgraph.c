@@ -0,0 +1,587 @@
+#include <core/cmdgraph.h>
+#include <core/cmdlist.h>
+#include <core/command.h>
+#include <core/luainc.h>
+#include <core/thread.h>
+#include <core/vector.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SCOMMANDGRAPH_NONE              ((size_t)-1)
+
+static const char* STR_AL_COMMANDGRAPH = "AL.CommandGraph";
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef enum ECommandGraphState
+{
+    COMMANDGRAPH_BLOCKED = 0,                   /**< dependencies unfinished */
+    COMMANDGRAPH_READY,
+    COMMANDGRAPH_WAITING,                       /**< worker runs its work */
+    COMMANDGRAPH_YIELDED,                       /**< plain coroutine.yield() */
+    COMMANDGRAPH_DONE,
+    COMMANDGRAPH_FAILED
+} ECommandGraphState;
+
+typedef struct SCommandGraphNode
+{
+    SCommand            tCommand;               /**< copy, list may grow while running */
+    size_t              *pDeps;
+    size_t              dDepCount;
+    size_t              dPending;               /**< unfinished dependencies */
+    ECommandGraphState  eState;
+    lua_State           *pThread;
+    int                 dThreadRef;
+} SCommandGraphNode;
+
+typedef struct SCommandGraphJob
+{
+    FCommandGraphWork   cbWork;
+    void                *pData;
+    size_t              dNode;
+    CBOOL               bResult;
+} SCommandGraphJob;
+
+typedef struct SCommandGraph
+{
+    lua_State           *L;
+    SCommandGraphNode   *pNodes;
+    size_t              dCount;
+    size_t              dCurrent;               /**< node being resumed */
+    CBOOL               bSubmitted;             /**< current node handed work over */
+    const char          *sFailed;
+    SMutex              *pMutex;
+    SVector             tQueue;                 /**< SCommandGraphJob, FIFO from dHead */
+    size_t              dHead;
+    SVector             tDone;                  /**< SCommandGraphJob */
+    SThread             *pWorkers[SCOMMANDGRAPH_MAX_WORKERS];
+    uint32              dWorkers;
+    CBOOL               bStop;
+} SCommandGraph;
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static CBOOL
+_SCommandGraph_Resolve(SCommandGraph *pGraph, const SCommandList *pList);
+
+static size_t
+_SCommandGraph_NextReady(const SCommandGraph *pGraph);
+
+static void
+_SCommandGraph_Start(SCommandGraph *pGraph, size_t dNode);
+
+static void
+_SCommandGraph_Resume(SCommandGraph *pGraph, size_t dNode, int dNumArgs);
+
+static void
+_SCommandGraph_Finish(SCommandGraph *pGraph, size_t dNode, CBOOL bResult);
+
+static size_t
+_SCommandGraph_DrainDone(SCommandGraph *pGraph);
+
+static CBOOL
+_SCommandGraph_StartWorkers(SCommandGraph *pGraph);
+
+static uint32
+_SCommandGraph_Worker_Main(void *pData);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI CBOOL
+SCommandGraph_Run(
+    struct lua_State *L,
+    struct SCommandList *pList,
+    const char **sFailed)
+{
+    SCommandGraph   tGraph;
+    CBOOL           bBusy;
+    CBOOL           bProgress;
+    CBOOL           bResult = CFALSE;
+    const size_t    dCount  = SCommandList_GetSize(pList);
+    size_t          dActive;
+    size_t          dNode;
+    size_t          i;
+
+    if (sFailed)
+    {
+        *sFailed = NULL;
+    }
+    if (!L || !pList)
+    {
+        return CFALSE;
+    }
+
+    /* Coroutines of running graph would be resumed by wrong one */
+    lua_getfield(L, LUA_REGISTRYINDEX, STR_AL_COMMANDGRAPH);
+    bBusy = lua_touserdata(L, -1) != NULL;
+    lua_pop(L, 1);
+    if (bBusy)
+    {
+        fprintf(stderr, "SCommandGraph_Run() -> commands are already running.\n");
+        return CFALSE;
+    }
+
+    memset(&tGraph, 0, sizeof(tGraph));
+    tGraph.L        = L;
+    tGraph.dCount   = dCount;
+    tGraph.dCurrent = SCOMMANDGRAPH_NONE;
+    tGraph.pNodes   = (SCommandGraphNode*)calloc(dCount > 0 ? dCount : 1, sizeof(SCommandGraphNode));
+    tGraph.pMutex   = SMutex_Create();
+    SVector_Init(&tGraph.tQueue, sizeof(SCommandGraphJob));
+    SVector_Init(&tGraph.tDone, sizeof(SCommandGraphJob));
+
+    if (tGraph.pNodes && tGraph.pMutex)
+    {
+        for (i = 0; i < dCount; ++i)
+        {
+            tGraph.pNodes[i].tCommand   = *SCommandList_Get(pList, i);
+            tGraph.pNodes[i].dThreadRef = LUA_NOREF;
+        }
+        bResult = _SCommandGraph_Resolve(&tGraph, pList);
+    }
+
+    if (bResult)
+    {
+        lua_pushlightuserdata(L, (void*)&tGraph);
+        lua_setfield(L, LUA_REGISTRYINDEX, STR_AL_COMMANDGRAPH);
+
+        for (;;)
+        {
+            /* Finished work first, those commands started earlier */
+            bProgress = _SCommandGraph_DrainDone(&tGraph) > 0;
+
+            for (i = 0; i < dCount; ++i)
+            {
+                if (tGraph.pNodes[i].eState == COMMANDGRAPH_YIELDED)
+                {
+                    _SCommandGraph_Resume(&tGraph, i, 0);
+                    bProgress = CTRUE;
+                }
+            }
+
+            dNode = tGraph.sFailed ? SCOMMANDGRAPH_NONE : _SCommandGraph_NextReady(&tGraph);
+            if (dNode != SCOMMANDGRAPH_NONE)
+            {
+                _SCommandGraph_Start(&tGraph, dNode);
+                bProgress = CTRUE;
+            }
+
+            if (bProgress)
+            {
+                continue;
+            }
+
+            dActive = 0;
+            for (i = 0; i < dCount; ++i)
+            {
+                dActive += tGraph.pNodes[i].eState == COMMANDGRAPH_WAITING ? 1 : 0;
+            }
+            if (dActive == 0)
+            {
+                break;
+            }
+            SThread_Sleep(SCOMMANDGRAPH_POLL_MS);
+        }
+
+        lua_pushnil(L);
+        lua_setfield(L, LUA_REGISTRYINDEX, STR_AL_COMMANDGRAPH);
+
+        /* Commands behind failed one never leave BLOCKED/READY */
+        for (i = 0; i < dCount; ++i)
+        {
+            bResult = bResult && tGraph.pNodes[i].eState == COMMANDGRAPH_DONE;
+        }
+    }
+
+    if (tGraph.pMutex)
+    {
+        SMutex_Lock(tGraph.pMutex);
+        tGraph.bStop = CTRUE;
+        SMutex_Unlock(tGraph.pMutex);
+    }
+    for (i = 0; i < tGraph.dWorkers; ++i)
+    {
+        SThread_Join(&tGraph.pWorkers[i]);
+    }
+
+    for (i = 0; tGraph.pNodes && i < dCount; ++i)
+    {
+        if (tGraph.pNodes[i].dThreadRef != LUA_NOREF)
+        {
+            luaL_unref(L, LUA_REGISTRYINDEX, tGraph.pNodes[i].dThreadRef);
+        }
+        free(tGraph.pNodes[i].pDeps);
+    }
+    free(tGraph.pNodes);
+    SVector_Cleanup(&tGraph.tQueue);
+    SVector_Cleanup(&tGraph.tDone);
+    SMutex_Destroy(&tGraph.pMutex);
+
+    if (sFailed)
+    {
+        *sFailed = tGraph.sFailed;
+    }
+
+    return bResult;
+}
+
+CAPI int
+SCommandGraph_LuaAwait(struct lua_State *L, FCommandGraphWork cbWork, void *pData)
+{
+    SCommandGraph       *pGraph;
+    SCommandGraphJob    tJob;
+    CBOOL               bYield;
+
+    lua_getfield(L, LUA_REGISTRYINDEX, STR_AL_COMMANDGRAPH);
+    pGraph = (SCommandGraph*)lua_touserdata(L, -1);
+    lua_pop(L, 1);
+
+    /* Only coroutine graph is resuming right now may yield back to it */
+    bYield = pGraph && pGraph->dCurrent != SCOMMANDGRAPH_NONE && !pGraph->bSubmitted &&
+        pGraph->pNodes[pGraph->dCurrent].pThread == L;
+#if LUA_VERSION_NUM >= 503
+    bYield = bYield && lua_isyieldable(L);
+#endif
+
+    if (bYield && _SCommandGraph_StartWorkers(pGraph))
+    {
+        tJob.cbWork     = cbWork;
+        tJob.pData      = pData;
+        tJob.dNode      = pGraph->dCurrent;
+        tJob.bResult    = CFALSE;
+
+        SMutex_Lock(pGraph->pMutex);
+        SVector_PushBack(&pGraph->tQueue, &tJob);
+        SMutex_Unlock(pGraph->pMutex);
+
+        pGraph->bSubmitted = CTRUE;
+
+        /* Resumed with result by SCommandGraph_Run */
+        return lua_yield(L, 0);
+    }
+
+    lua_pushboolean(L, cbWork(pData) ? 1 : 0);
+
+    return 1;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+/* Nodes are in list order, so list positions are node indices */
+static CBOOL
+_SCommandGraph_Resolve(SCommandGraph *pGraph, const SCommandList *pList)
+{
+    SCommandGraphNode   *pNode;
+    size_t              *pPending;
+    size_t              dSorted = 0;
+    size_t              dCapacity;
+    long                dDep;
+    size_t              i;
+    size_t              j;
+    size_t              k;
+
+    for (i = 0; i < pGraph->dCount; ++i)
+    {
+        pNode       = &pGraph->pNodes[i];
+        dCapacity   = SCommand_IsFlagSet(&pNode->tCommand, SCOMMAND_FLAG_AFTER) ?
+            pNode->tCommand.dAfterCount : pGraph->dCount;
+        pNode->pDeps = (size_t*)malloc((dCapacity > 0 ? dCapacity : 1) * sizeof(size_t));
+        if (!pNode->pDeps)
+        {
+            return CFALSE;
+        }
+
+        if (SCommand_IsFlagSet(&pNode->tCommand, SCOMMAND_FLAG_AFTER))
+        {
+            for (k = 0; k < pNode->tCommand.dAfterCount; ++k)
+            {
+                dDep = SCommandList_IndexOf(pList, pNode->tCommand.pAfter[k]);
+                if (dDep >= 0 && (size_t)dDep != i)
+                {
+                    pNode->pDeps[pNode->dDepCount++] = (size_t)dDep;
+                }
+                else
+                {
+                    printf("Command [%s]: unknown dependency '%s' ignored\n",
+                        pNode->tCommand.sName, pNode->tCommand.pAfter[k]);
+                }
+            }
+        }
+        else
+        {
+            /* Undeclared: same order sorted list used to give */
+            for (j = 0; j < i && pGraph->pNodes[j].tCommand.dPriority < pNode->tCommand.dPriority; ++j)
+            {
+                pNode->pDeps[pNode->dDepCount++] = j;
+            }
+        }
+
+        pNode->dPending = pNode->dDepCount;
+        pNode->eState   = pNode->dPending > 0 ? COMMANDGRAPH_BLOCKED : COMMANDGRAPH_READY;
+    }
+
+    /* Dry run: whatever never gets ready is part of (or behind) cycle */
+    pPending = (size_t*)malloc((pGraph->dCount > 0 ? pGraph->dCount : 1) * sizeof(size_t));
+    if (!pPending)
+    {
+        return CFALSE;
+    }
+    for (i = 0; i < pGraph->dCount; ++i)
+    {
+        pPending[i] = pGraph->pNodes[i].dPending;
+    }
+    for (;;)
+    {
+        for (i = 0; i < pGraph->dCount; ++i)
+        {
+            if (pPending[i] == 0)
+            {
+                break;
+            }
+        }
+        if (i == pGraph->dCount)
+        {
+            break;
+        }
+
+        pPending[i] = SCOMMANDGRAPH_NONE;
+        dSorted++;
+        for (j = 0; j < pGraph->dCount; ++j)
+        {
+            for (k = 0; k < pGraph->pNodes[j].dDepCount; ++k)
+            {
+                if (pGraph->pNodes[j].pDeps[k] == i && pPending[j] != SCOMMANDGRAPH_NONE)
+                {
+                    pPending[j]--;
+                }
+            }
+        }
+    }
+
+    if (dSorted < pGraph->dCount)
+    {
+        for (i = 0; i < pGraph->dCount; ++i)
+        {
+            if (pPending[i] != SCOMMANDGRAPH_NONE)
+            {
+                fprintf(stderr, "Command [%s]: dependency cycle\n", pGraph->pNodes[i].tCommand.sName);
+            }
+        }
+    }
+    free(pPending);
+
+    return dSorted == pGraph->dCount;
+}
+
+/* List is sorted by priority, first ready node is the one to start */
+static size_t
+_SCommandGraph_NextReady(const SCommandGraph *pGraph)
+{
+    size_t i;
+
+    for (i = 0; i < pGraph->dCount; ++i)
+    {
+        if (pGraph->pNodes[i].eState == COMMANDGRAPH_READY)
+        {
+            return i;
+        }
+    }
+
+    return SCOMMANDGRAPH_NONE;
+}
+
+static void
+_SCommandGraph_Start(SCommandGraph *pGraph, size_t dNode)
+{
+    SCommandGraphNode   *pNode = &pGraph->pNodes[dNode];
+    SCommandArg         tArg;
+
+    /* Native commands are quick and run right here */
+    if (!SCommand_IsFlagSet(&pNode->tCommand, SCOMMAND_FLAG_LUA))
+    {
+        tArg = SCommandArg_MakeVoid(pGraph->L);
+        _SCommandGraph_Finish(pGraph, dNode,
+            pNode->tCommand.cbExecuteFunc(&pNode->tCommand, &tArg, 1));
+        return;
+    }
+
+    pNode->pThread      = lua_newthread(pGraph->L);
+    pNode->dThreadRef   = luaL_ref(pGraph->L, LUA_REGISTRYINDEX);
+    lua_rawgeti(pNode->pThread, LUA_REGISTRYINDEX, pNode->tCommand.dLuaRef);
+
+    _SCommandGraph_Resume(pGraph, dNode, 0);
+}
+
+static void
+_SCommandGraph_Resume(SCommandGraph *pGraph, size_t dNode, int dNumArgs)
+{
+    SCommandGraphNode   *pNode = &pGraph->pNodes[dNode];
+    lua_State           *pThread = pNode->pThread;
+    CBOOL               bResult;
+    int                 dStatus;
+
+    pGraph->dCurrent    = dNode;
+    pGraph->bSubmitted  = CFALSE;
+    dStatus             = luainc_resume(pThread, pGraph->L, dNumArgs);
+    pGraph->dCurrent    = SCOMMANDGRAPH_NONE;
+
+    if (dStatus == LUA_YIELD)
+    {
+        /* Resume takes its values from top, nothing below is needed */
+        lua_settop(pThread, 0);
+        pNode->eState = pGraph->bSubmitted ? COMMANDGRAPH_WAITING : COMMANDGRAPH_YIELDED;
+        return;
+    }
+
+    if (dStatus == LUA_OK)
+    {
+        /* Handle 'bool' return from lua call */
+        bResult = (CBOOL)(lua_gettop(pThread) > 0 && lua_isboolean(pThread, 1) && lua_toboolean(pThread, 1));
+        lua_settop(pThread, 0);
+    }
+    else
+    {
+        fprintf
+        (
+            stderr,
+            "Error calling Lua command '%s': %s\n", pNode->tCommand.sName,
+            lua_tostring(pThread, -1)
+        );
+        bResult = CFALSE;
+    }
+
+    _SCommandGraph_Finish(pGraph, dNode, bResult);
+}
+
+static void
+_SCommandGraph_Finish(SCommandGraph *pGraph, size_t dNode, CBOOL bResult)
+{
+    SCommandGraphNode   *pDependent;
+    size_t              i;
+    size_t              k;
+
+    pGraph->pNodes[dNode].eState = bResult ? COMMANDGRAPH_DONE : COMMANDGRAPH_FAILED;
+    printf("Calling [%s]: %s\n", pGraph->pNodes[dNode].tCommand.sName, bResult ? "success!" : "fail.");
+
+    if (!bResult)
+    {
+        if (!pGraph->sFailed)
+        {
+            pGraph->sFailed = pGraph->pNodes[dNode].tCommand.sName;
+        }
+        return;
+    }
+
+    for (i = 0; i < pGraph->dCount; ++i)
+    {
+        pDependent = &pGraph->pNodes[i];
+        for (k = 0; k < pDependent->dDepCount && pDependent->eState == COMMANDGRAPH_BLOCKED; ++k)
+        {
+            if (pDependent->pDeps[k] == dNode && --pDependent->dPending == 0)
+            {
+                pDependent->eState = COMMANDGRAPH_READY;
+            }
+        }
+    }
+}
+
+static size_t
+_SCommandGraph_DrainDone(SCommandGraph *pGraph)
+{
+    SCommandGraphJob    tJob;
+    size_t              dDrained = 0;
+
+    for (;;)
+    {
+        SMutex_Lock(pGraph->pMutex);
+        if (SVector_GetSize(&pGraph->tDone) == 0)
+        {
+            SMutex_Unlock(pGraph->pMutex);
+            break;
+        }
+        tJob = *(SCommandGraphJob*)SVector_Get(&pGraph->tDone, SVector_GetSize(&pGraph->tDone) - 1);
+        SVector_PopBack(&pGraph->tDone);
+        SMutex_Unlock(pGraph->pMutex);
+
+        /* Becomes result of binding that yielded */
+        lua_pushboolean(pGraph->pNodes[tJob.dNode].pThread, tJob.bResult ? 1 : 0);
+        _SCommandGraph_Resume(pGraph, tJob.dNode, 1);
+        dDrained++;
+    }
+
+    return dDrained;
+}
+
+static CBOOL
+_SCommandGraph_StartWorkers(SCommandGraph *pGraph)
+{
+    uint32 dThreads;
+    uint32 i;
+
+    if (pGraph->dWorkers > 0)
+    {
+        return CTRUE;
+    }
+
+    /* Two even on single core: work is mostly disk bound */
+    dThreads = SThread_GetProcessorCount();
+    dThreads = dThreads < 2 ? 2 :
+        (dThreads > SCOMMANDGRAPH_MAX_WORKERS ? SCOMMANDGRAPH_MAX_WORKERS : dThreads);
+    for (i = 0; i < dThreads; ++i)
+    {
+        pGraph->pWorkers[pGraph->dWorkers] = SThread_Create(_SCommandGraph_Worker_Main, pGraph);
+        pGraph->dWorkers += pGraph->pWorkers[pGraph->dWorkers] ? 1 : 0;
+    }
+
+    /* No threads at all: caller runs work itself */
+    return pGraph->dWorkers > 0;
+}
+
+static uint32
+_SCommandGraph_Worker_Main(void *pData)
+{
+    SCommandGraph       *pGraph = (SCommandGraph*)pData;
+    SCommandGraphJob    tJob;
+
+    for (;;)
+    {
+        SMutex_Lock(pGraph->pMutex);
+        if (pGraph->dHead >= SVector_GetSize(&pGraph->tQueue))
+        {
+            SVector_Clear(&pGraph->tQueue);
+            pGraph->dHead = 0;
+            if (pGraph->bStop)
+            {
+                SMutex_Unlock(pGraph->pMutex);
+                break;
+            }
+            SMutex_Unlock(pGraph->pMutex);
+            SThread_Sleep(SCOMMANDGRAPH_POLL_MS);
+            continue;
+        }
+        tJob = *(SCommandGraphJob*)SVector_Get(&pGraph->tQueue, pGraph->dHead++);
+        SMutex_Unlock(pGraph->pMutex);
+
+        tJob.bResult = tJob.cbWork(tJob.pData);
+
+        SMutex_Lock(pGraph->pMutex);
+        SVector_PushBack(&pGraph->tDone, &tJob);
+        SMutex_Unlock(pGraph->pMutex);
+    }
+
+    return 0;
+}
@@ -0,0 +1,302 @@
+#include <core/cmdlist.h>
+#include <core/command.h>
+#include <core/vector.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SCOMMANDLIST_NONE               ((size_t)-1)
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+struct SCommandList
+{
+    SVector         tCommands;      /**< SCommand, sorted by dPriority */
+
+    /* Open addressing index: command position + 1, 0 marks empty bucket */
+    size_t          *pBuckets;
+    size_t          dNumBuckets;
+};
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static uint32
+_SCommandList_HashString(const char *sString);
+
+static size_t
+_SCommandList_Find(const SCommandList *pList, const char *sName);
+
+static CBOOL
+_SCommandList_Reindex(SCommandList *pList, size_t dCount);
+
+static size_t
+_SCommandList_GetInsertPosition(const SCommandList *pList, int dPriority);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SCommandList*
+SCommandList_new(size_t dReserve)
+{
+    SCommandList *pList = (SCommandList*)calloc(1, sizeof(SCommandList));
+
+    if (!IS_VALID(pList))
+    {
+        fprintf(stderr, "SCommandList_new() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    SVector_Init(&pList->tCommands, sizeof(SCommand));
+    if (dReserve > 0)
+    {
+        SVector_Reserve(&pList->tCommands, dReserve);
+    }
+    if (!_SCommandList_Reindex(pList, dReserve))
+    {
+        SCommandList_delete(&pList);
+        return NULL;
+    }
+
+    return pList;
+}
+
+CAPI void
+SCommandList_delete(SCommandList **pList)
+{
+    if (!pList || !*pList)
+    {
+        return;
+    }
+
+    SVector_ForEach(&(*pList)->tCommands)
+    {
+        SVector_InitIterator(SCommand, &(*pList)->tCommands);
+        SCommand_ClearAfter(SVECTOR_ITERATOR);
+        free((char*)SVECTOR_ITERATOR->sName);
+    }
+    SVector_Cleanup(&(*pList)->tCommands);
+    free((*pList)->pBuckets);
+    free(*pList);
+
+    *pList = NULL;
+}
+
+CAPI SCommand*
+SCommandList_Add(SCommandList *pList, const SCommand *pCommand)
+{
+    SCommand    tCommand;
+    size_t      dPosition;
+    char        *sName;
+
+    if (!pList || !pCommand || !pCommand->sName ||
+        _SCommandList_Find(pList, pCommand->sName) != SCOMMANDLIST_NONE)
+    {
+        return NULL;
+    }
+
+    sName = (char*)malloc(strlen(pCommand->sName) + 1);
+    if (!sName)
+    {
+        return NULL;
+    }
+    strcpy(sName, pCommand->sName);
+
+    /* Index is grown first, so nothing has to be undone past this point */
+    if (!_SCommandList_Reindex(pList, SVector_GetSize(&pList->tCommands) + 1))
+    {
+        free(sName);
+        return NULL;
+    }
+
+    tCommand        = *pCommand;
+    tCommand.sName  = sName;
+    dPosition       = _SCommandList_GetInsertPosition(pList, tCommand.dPriority);
+    SVector_Insert(&pList->tCommands, dPosition, &tCommand);
+    _SCommandList_Reindex(pList, SVector_GetSize(&pList->tCommands));
+
+    return (SCommand*)SVector_Get(&pList->tCommands, dPosition);
+}
+
+CAPI SCommand*
+SCommandList_SetPriority(SCommandList *pList, SCommand *pCommand, int dPriority)
+{
+    SCommand    tCommand;
+    size_t      dPosition;
+
+    if (!pList || !pCommand)
+    {
+        return NULL;
+    }
+    if (pCommand->dPriority == dPriority)
+    {
+        return pCommand;
+    }
+
+    tCommand            = *pCommand;
+    tCommand.dPriority  = dPriority;
+    SVector_Erase(&pList->tCommands, (size_t)(pCommand - (SCommand*)pList->tCommands.pData));
+
+    dPosition = _SCommandList_GetInsertPosition(pList, dPriority);
+    SVector_Insert(&pList->tCommands, dPosition, &tCommand);
+    _SCommandList_Reindex(pList, SVector_GetSize(&pList->tCommands));
+
+    return (SCommand*)SVector_Get(&pList->tCommands, dPosition);
+}
+
+CAPI long
+SCommandList_IndexOf(const SCommandList *pList, const char *sName)
+{
+    size_t dIndex;
+
+    if (!pList || !sName)
+    {
+        return -1;
+    }
+
+    dIndex = _SCommandList_Find(pList, sName);
+    return dIndex == SCOMMANDLIST_NONE ? -1 : (long)dIndex;
+}
+
+CAPI SCommand*
+SCommandList_Find(SCommandList *pList, const char *sName)
+{
+    const long dIndex = SCommandList_IndexOf(pList, sName);
+
+    return dIndex < 0 ? NULL : (SCommand*)SVector_Get(&pList->tCommands, (size_t)dIndex);
+}
+
+CAPI SCommand*
+SCommandList_Get(SCommandList *pList, size_t dIndex)
+{
+    if (!pList || dIndex >= SVector_GetSize(&pList->tCommands))
+    {
+        return NULL;
+    }
+
+    return (SCommand*)SVector_Get(&pList->tCommands, dIndex);
+}
+
+CAPI size_t
+SCommandList_GetSize(const SCommandList *pList)
+{
+    return pList ? SVector_GetSize(&pList->tCommands) : 0;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static uint32
+_SCommandList_HashString(const char *sString)
+{
+    /* FNV-1a */
+    uint32 dHash = 2166136261u;
+
+    while (*sString)
+    {
+        dHash ^= (unsigned char)*sString++;
+        dHash *= 16777619u;
+    }
+
+    return dHash;
+}
+
+static size_t
+_SCommandList_Find(const SCommandList *pList, const char *sName)
+{
+    const SCommand  *pCommands  = (const SCommand*)pList->tCommands.pData;
+    const size_t    dMask       = pList->dNumBuckets - 1;
+    size_t          dBucket     = _SCommandList_HashString(sName) & dMask;
+
+    while (pList->pBuckets[dBucket] != 0)
+    {
+        const size_t dIndex = pList->pBuckets[dBucket] - 1;
+
+        if (strcmp(pCommands[dIndex].sName, sName) == 0)
+        {
+            return dIndex;
+        }
+        dBucket = (dBucket + 1) & dMask;
+    }
+
+    return SCOMMANDLIST_NONE;
+}
+
+/* Positions shift on every insert, list is short so index is simply rebuilt */
+static CBOOL
+_SCommandList_Reindex(SCommandList *pList, size_t dCount)
+{
+    const SCommand  *pCommands  = (const SCommand*)pList->tCommands.pData;
+    size_t          dNumBuckets = pList->dNumBuckets > 0 ? pList->dNumBuckets : SCOMMANDLIST_MIN_BUCKETS;
+    size_t          dIndex;
+
+    /* At most half full */
+    while (dCount * 2 > dNumBuckets)
+    {
+        dNumBuckets *= 2;
+    }
+
+    if (dNumBuckets != pList->dNumBuckets)
+    {
+        size_t *pBuckets = (size_t*)calloc(dNumBuckets, sizeof(size_t));
+        if (!pBuckets)
+        {
+            return CFALSE;
+        }
+        free(pList->pBuckets);
+        pList->pBuckets     = pBuckets;
+        pList->dNumBuckets  = dNumBuckets;
+    }
+    else
+    {
+        memset(pList->pBuckets, 0, dNumBuckets * sizeof(size_t));
+    }
+
+    for (dIndex = 0; dIndex < SVector_GetSize(&pList->tCommands); ++dIndex)
+    {
+        size_t dBucket = _SCommandList_HashString(pCommands[dIndex].sName) & (dNumBuckets - 1);
+
+        while (pList->pBuckets[dBucket] != 0)
+        {
+            dBucket = (dBucket + 1) & (dNumBuckets - 1);
+        }
+        pList->pBuckets[dBucket] = dIndex + 1;
+    }
+
+    return CTRUE;
+}
+
+/* After every command of same or lower priority */
+static size_t
+_SCommandList_GetInsertPosition(const SCommandList *pList, int dPriority)
+{
+    const SCommand  *pCommands  = (const SCommand*)pList->tCommands.pData;
+    size_t          dLow        = 0;
+    size_t          dHigh       = SVector_GetSize(&pList->tCommands);
+
+    while (dLow < dHigh)
+    {
+        const size_t dMid = dLow + (dHigh - dLow) / 2;
+
+        if (pCommands[dMid].dPriority <= dPriority)
+        {
+            dLow = dMid + 1;
+        }
+        else
+        {
+            dHigh = dMid;
+        }
+    }
+
+    return dLow;
+}
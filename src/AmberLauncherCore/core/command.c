@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <lua.h>
 
@@ -43,6 +44,8 @@ SCommand_new(void)
     pCommand->dNumArgs        = 0;
     pCommand->dLuaRef         = 0;
     pCommand->dPriority       = 0;
+    pCommand->pAfter          = NULL;
+    pCommand->dAfterCount     = 0;
 
     return pCommand;
 }
@@ -60,6 +63,7 @@ SCommand_delete(SCommand** pCommand)
         return CFALSE;
     }
 
+    SCommand_ClearAfter(*pCommand);
     free(*pCommand);
     *pCommand = NULL;
 
@@ -92,6 +96,69 @@ SCommand_ClearFlag(SCommand* pCommand, unsigned int dFlag)
     }
 }
 
+CAPI CBOOL
+SCommand_SetAfter(SCommand* pCommand, const char* const* pNames, uint32 dCount)
+{
+    char**  pAfter = NULL;
+    uint32  i;
+
+    if (!IS_VALID(pCommand) || (dCount > 0 && !IS_VALID(pNames)))
+    {
+        return CFALSE;
+    }
+
+    if (dCount > 0)
+    {
+        pAfter = (char**)calloc(dCount, sizeof(char*));
+        if (!IS_VALID(pAfter))
+        {
+            return CFALSE;
+        }
+        for (i = 0; i < dCount; i++)
+        {
+            pAfter[i] = (char*)malloc(strlen(pNames[i]) + 1);
+            if (!IS_VALID(pAfter[i]))
+            {
+                while (i > 0)
+                {
+                    free(pAfter[--i]);
+                }
+                free(pAfter);
+                return CFALSE;
+            }
+            strcpy(pAfter[i], pNames[i]);
+        }
+    }
+
+    SCommand_ClearAfter(pCommand);
+    pCommand->pAfter        = pAfter;
+    pCommand->dAfterCount   = dCount;
+    pCommand->dFlags       |= SCOMMAND_FLAG_AFTER;
+
+    return CTRUE;
+}
+
+CAPI void
+SCommand_ClearAfter(SCommand* pCommand)
+{
+    uint32 i;
+
+    if (!IS_VALID(pCommand))
+    {
+        return;
+    }
+
+    for (i = 0; i < pCommand->dAfterCount; i++)
+    {
+        free(pCommand->pAfter[i]);
+    }
+    free(pCommand->pAfter);
+
+    pCommand->pAfter        = NULL;
+    pCommand->dAfterCount   = 0;
+    pCommand->dFlags       &= ~(uint32)SCOMMAND_FLAG_AFTER;
+}
+
 CAPI SCommandArg 
 SCommandArg_MakeNull(void) 
 {
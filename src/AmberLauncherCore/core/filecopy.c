@@ -0,0 +1,364 @@
+#include <core/filecopy.h>
+#include <core/opsys.h>
+#include <core/pathindex.h>
+#include <core/thread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char* ESFileCopyStrings[] = {
+    "none",
+    "reflink",
+    "hardlink",
+    "copy",
+    NULL
+};
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SFileCopyJob
+{
+    char            *sSrcPath;      /**< NULL if source is missing */
+    char            *sDstPath;
+    CBOOL           bLinkable;
+    SFileCopyResult tResult;
+} SFileCopyJob;
+
+typedef struct SFileCopyOrder
+{
+    uint64          dSize;
+    size_t          dJob;
+} SFileCopyOrder;
+
+typedef struct SFileCopyWork
+{
+    SFileCopyJob    *pJobs;
+    SFileCopyOrder  *pOrder;        /**< largest first */
+    size_t          *pDone;         /**< job indices, as they finish */
+    size_t          dCount;
+    size_t          dNext;
+    size_t          dDone;
+    SMutex          *pMutex;
+} SFileCopyWork;
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static ESFileCopy
+_SFileCopy_Install(const char *sSrcPath, const char *sDstPath, CBOOL bLinkable);
+
+static uint32
+_SFileCopy_Worker_Main(void *pData);
+
+static int
+_SFileCopy_CompareSize(const void *pA, const void *pB);
+
+static char*
+_SFileCopy_Join(const char *sRoot, const char *sPath);
+
+static void
+_SFileCopy_EnsureParent(const char *sPath);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI ESFileCopy
+SFileCopy_File(const char *sSrcPath, const char *sDstPath)
+{
+    return _SFileCopy_Install(sSrcPath, sDstPath, CFALSE);
+}
+
+CAPI ESFileCopy
+SFileCopy_Link(const char *sSrcPath, const char *sDstPath)
+{
+    return _SFileCopy_Install(sSrcPath, sDstPath, CTRUE);
+}
+
+CAPI size_t
+SFileCopy_Batch(
+    const char          *sSrcRoot,
+    const char          *sDstRoot,
+    const char * const  *pRelPaths,
+    const CBOOL         *pLinkable,
+    size_t              dCount,
+    uint32              dThreads,
+    FSFileCopyProgress  cbProgress,
+    void                *pUserData)
+{
+    SFileCopyWork   tWork;
+    SPathIndex      *pIndex;
+    SThread         *pWorkers[SFILECOPY_MAX_THREADS];
+    const char      *sActual;
+    size_t          dReported = 0;
+    size_t          dDone;
+    size_t          dFailed = 0;
+    size_t          dStarted = 0;
+    size_t          i;
+
+    if (!sSrcRoot || !sDstRoot || (!pRelPaths && dCount > 0))
+    {
+        return dCount;
+    }
+    if (dCount == 0)
+    {
+        return 0;
+    }
+
+    memset(&tWork, 0, sizeof(tWork));
+    tWork.dCount    = dCount;
+    tWork.pJobs     = (SFileCopyJob*)calloc(dCount, sizeof(SFileCopyJob));
+    tWork.pOrder    = (SFileCopyOrder*)calloc(dCount, sizeof(SFileCopyOrder));
+    tWork.pDone     = (size_t*)calloc(dCount, sizeof(size_t));
+    tWork.pMutex    = SMutex_Create();
+
+    if (!tWork.pJobs || !tWork.pOrder || !tWork.pDone || !tWork.pMutex)
+    {
+        fprintf(stderr, "SFileCopy_Batch() -> Failed to allocate memory.\n");
+        free(tWork.pJobs);
+        free(tWork.pOrder);
+        free(tWork.pDone);
+        SMutex_Destroy(&tWork.pMutex);
+        return dCount;
+    }
+
+    /* One scan of source resolves every name */
+    pIndex = SPathIndex_Build(sSrcRoot);
+    for (i = 0; i < dCount; ++i)
+    {
+        SFileCopyJob *pJob = &tWork.pJobs[i];
+
+        pJob->tResult.sRelPath  = pRelPaths[i];
+        pJob->tResult.eResult   = SFILECOPY_NONE;
+        pJob->bLinkable         = pLinkable ? pLinkable[i] : CFALSE;
+        tWork.pOrder[i].dJob    = i;
+
+        sActual = pIndex && pRelPaths[i] ? SPathIndex_Resolve(pIndex, pRelPaths[i]) : NULL;
+        if (!sActual)
+        {
+            continue;
+        }
+
+        pJob->sSrcPath = _SFileCopy_Join(sSrcRoot, sActual);
+        pJob->sDstPath = _SFileCopy_Join(sDstRoot, sActual);
+        if (!pJob->sSrcPath || !pJob->sDstPath ||
+            !AmberLauncher_FileStat(pJob->sSrcPath, &pJob->tResult.dSize, NULL))
+        {
+            free(pJob->sSrcPath);
+            free(pJob->sDstPath);
+            pJob->sSrcPath = NULL;
+            pJob->sDstPath = NULL;
+            continue;
+        }
+        tWork.pOrder[i].dSize = pJob->tResult.dSize;
+    }
+    SPathIndex_delete(&pIndex);
+
+    /* Big files stream on some workers while others get through small ones */
+    qsort(tWork.pOrder, dCount, sizeof(SFileCopyOrder), _SFileCopy_CompareSize);
+
+    dThreads = dThreads < 1 ? 1 : (dThreads > SFILECOPY_MAX_THREADS ? SFILECOPY_MAX_THREADS : dThreads);
+    if ((size_t)dThreads > dCount)
+    {
+        dThreads = (uint32)dCount;
+    }
+    for (i = 0; i < dThreads; ++i)
+    {
+        pWorkers[i] = SThread_Create(_SFileCopy_Worker_Main, &tWork);
+        dStarted += pWorkers[i] ? 1 : 0;
+    }
+
+    /* No threads at all: copy here */
+    if (dStarted == 0)
+    {
+        _SFileCopy_Worker_Main(&tWork);
+    }
+
+    while (dReported < dCount)
+    {
+        SMutex_Lock(tWork.pMutex);
+        dDone = tWork.dDone;
+        SMutex_Unlock(tWork.pMutex);
+
+        if (dDone == dReported)
+        {
+            SThread_Sleep(SFILECOPY_POLL_MS);
+            continue;
+        }
+
+        /* Entries below dDone are final, workers only append */
+        for (; dReported < dDone; ++dReported)
+        {
+            const SFileCopyResult *pResult = &tWork.pJobs[tWork.pDone[dReported]].tResult;
+
+            dFailed += pResult->eResult == SFILECOPY_NONE ? 1 : 0;
+            if (cbProgress)
+            {
+                cbProgress(pResult, dReported + 1, dCount, pUserData);
+            }
+        }
+    }
+
+    for (i = 0; i < dThreads; ++i)
+    {
+        SThread_Join(&pWorkers[i]);
+    }
+
+    for (i = 0; i < dCount; ++i)
+    {
+        free(tWork.pJobs[i].sSrcPath);
+        free(tWork.pJobs[i].sDstPath);
+    }
+    free(tWork.pJobs);
+    free(tWork.pOrder);
+    free(tWork.pDone);
+    SMutex_Destroy(&tWork.pMutex);
+
+    return dFailed;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+/* Cheapest first; reflink is always safe, blocks get copied once written */
+static ESFileCopy
+_SFileCopy_Install(const char *sSrcPath, const char *sDstPath, CBOOL bLinkable)
+{
+    ESFileCopy  eResult = SFILECOPY_NONE;
+    int64       dModTime;
+    char        *sTmpPath;
+
+    if (!sSrcPath || !sDstPath || !AmberLauncher_FileStat(sSrcPath, NULL, &dModTime))
+    {
+        return SFILECOPY_NONE;
+    }
+
+    sTmpPath = (char*)malloc(strlen(sDstPath) + strlen(SFILECOPY_TMP_SUFFIX) + 1);
+    if (!sTmpPath)
+    {
+        return SFILECOPY_NONE;
+    }
+    strcpy(sTmpPath, sDstPath);
+    strcat(sTmpPath, SFILECOPY_TMP_SUFFIX);
+    remove(sTmpPath);
+
+    /* Clone gets its own mtime, link and plain copy keep source's */
+    if (AmberLauncher_FileClone(sSrcPath, sTmpPath))
+    {
+        AmberLauncher_FileSetModTime(sTmpPath, dModTime);
+        eResult = SFILECOPY_REFLINK;
+    }
+    else if (bLinkable && AmberLauncher_FileLink(sSrcPath, sTmpPath))
+    {
+        eResult = SFILECOPY_HARDLINK;
+    }
+    else if (AmberLauncher_FileCopy(sSrcPath, sTmpPath))
+    {
+        eResult = SFILECOPY_COPY;
+    }
+
+    if (eResult != SFILECOPY_NONE && !AmberLauncher_FileReplace(sTmpPath, sDstPath))
+    {
+        eResult = SFILECOPY_NONE;
+    }
+
+    /* Renaming link over another link of same inode leaves both in place */
+    remove(sTmpPath);
+
+    free(sTmpPath);
+
+    return eResult;
+}
+
+static uint32
+_SFileCopy_Worker_Main(void *pData)
+{
+    SFileCopyWork   *pWork = (SFileCopyWork*)pData;
+    SFileCopyJob    *pJob;
+    size_t          dJob;
+
+    for (;;)
+    {
+        SMutex_Lock(pWork->pMutex);
+        if (pWork->dNext >= pWork->dCount)
+        {
+            SMutex_Unlock(pWork->pMutex);
+            break;
+        }
+        dJob = pWork->pOrder[pWork->dNext++].dJob;
+        SMutex_Unlock(pWork->pMutex);
+
+        pJob = &pWork->pJobs[dJob];
+        if (pJob->sSrcPath)
+        {
+            _SFileCopy_EnsureParent(pJob->sDstPath);
+            pJob->tResult.eResult = _SFileCopy_Install(pJob->sSrcPath, pJob->sDstPath, pJob->bLinkable);
+        }
+
+        SMutex_Lock(pWork->pMutex);
+        pWork->pDone[pWork->dDone++] = dJob;
+        SMutex_Unlock(pWork->pMutex);
+    }
+
+    return 0;
+}
+
+static int
+_SFileCopy_CompareSize(const void *pA, const void *pB)
+{
+    const SFileCopyOrder *pOrderA = (const SFileCopyOrder*)pA;
+    const SFileCopyOrder *pOrderB = (const SFileCopyOrder*)pB;
+
+    if (pOrderA->dSize != pOrderB->dSize)
+    {
+        return pOrderA->dSize > pOrderB->dSize ? -1 : 1;
+    }
+
+    /* Keeps list order among equal sizes */
+    return pOrderA->dJob < pOrderB->dJob ? -1 : (pOrderA->dJob > pOrderB->dJob ? 1 : 0);
+}
+
+static char*
+_SFileCopy_Join(const char *sRoot, const char *sPath)
+{
+    const size_t    dRootLength = strlen(sRoot);
+    char            *sResult    = (char*)malloc(dRootLength + strlen(sPath) + 2);
+
+    if (!sResult)
+    {
+        return NULL;
+    }
+
+    memcpy(sResult, sRoot, dRootLength);
+    sResult[dRootLength] = SPATHINDEX_SEPARATOR;
+    strcpy(sResult + dRootLength + 1, sPath);
+
+    return sResult;
+}
+
+static void
+_SFileCopy_EnsureParent(const char *sPath)
+{
+    char *sParent = (char*)malloc(strlen(sPath) + 1);
+    char *pSeparator;
+
+    if (!sParent)
+    {
+        return;
+    }
+
+    strcpy(sParent, sPath);
+    pSeparator = strrchr(sParent, SPATHINDEX_SEPARATOR);
+    if (pSeparator && pSeparator != sParent)
+    {
+        *pSeparator = '\0';
+        AmberLauncher_DirCreate(sParent);
+    }
+
+    free(sParent);
+}
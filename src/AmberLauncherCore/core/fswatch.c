@@ -0,0 +1,919 @@
+#define _GNU_SOURCE
+#include <core/fswatch.h>
+#include <core/opsys.h>
+#include <core/thread.h>
+#include <core/vector.h>
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define SFSWATCH_INOTIFY_MASK \
+    (IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | \
+     IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+#elif defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+
+#define SFSWATCH_NOTIFY_FILTER \
+    (FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | \
+     FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE)
+#endif
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+/** Polling snapshot entry, sorted by sRelPath */
+typedef struct SFSWatchEntry
+{
+    char            *sRelPath;
+    uint64          dSize;
+    int64           dModTime;
+} SFSWatchEntry;
+
+/** inotify watch descriptor and directory it belongs to */
+typedef struct SFSWatchDir
+{
+    int             dWatch;
+    char            *sRelPath;
+} SFSWatchDir;
+
+typedef struct SFSWatchList
+{
+    SFSWatch        *pWatch;
+    const char      *sRelDir;
+    SVector         *pEntries;      /**< SFSWatchEntry, NULL: directories only */
+    SVector         tChildren;      /**< char*, subdirectories to descend into */
+} SFSWatchList;
+
+struct SFSWatch
+{
+    char            *sRoot;
+    char            **pExclude;     /**< relative, '/' separated */
+    size_t          dExcludeCount;
+    SThread         *pThread;
+    SMutex          *pMutex;
+    SVector         tPending;       /**< char*, guarded by pMutex */
+    CBOOL           bOverflow;      /**< guarded by pMutex */
+    CBOOL           bStop;          /**< guarded by pMutex */
+    CBOOL           bNative;
+    int             dNotify;
+    SVector         tDirs;          /**< SFSWatchDir, watcher thread only */
+    SVector         tSnapshot;      /**< SFSWatchEntry, watcher thread only */
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE          hDirectory;
+    HANDLE          hEvent;
+#endif
+};
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static uint32
+_SFSWatch_Poll_Main(void *pData);
+
+static CBOOL
+_SFSWatch_IsStopping(SFSWatch *pWatch);
+
+static CBOOL
+_SFSWatch_IsExcluded(const SFSWatch *pWatch, const char *sRelPath);
+
+static void
+_SFSWatch_Push(SFSWatch *pWatch, const char *sRelDir, const char *sName);
+
+static char*
+_SFSWatch_Join(const char *sDir, const char *sName, char cSeparator);
+
+static CBOOL
+_SFSWatch_OnEntry(const char *sName, EDirEntryType eType, void *pUserData);
+
+static CBOOL
+_SFSWatch_List(SFSWatch *pWatch, const char *sRelDir, SVector *pEntries, SVector *pChildren);
+
+static void
+_SFSWatch_Snapshot(SFSWatch *pWatch, SVector *pSnapshot);
+
+static void
+_SFSWatch_SnapshotFree(SVector *pSnapshot);
+
+static int
+_SFSWatch_SnapshotCompare(const void *pA, const void *pB);
+
+#if defined(__linux__)
+static uint32
+_SFSWatch_Notify_Main(void *pData);
+
+static CBOOL
+_SFSWatch_NotifyAdd(SFSWatch *pWatch, const char *sRelDir, uint32 dDepth);
+
+static SFSWatchDir*
+_SFSWatch_NotifyFind(SFSWatch *pWatch, int dWatch);
+#elif defined(_WIN32) || defined(_WIN64)
+static uint32
+_SFSWatch_Directory_Main(void *pData);
+#endif
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SFSWatch*
+SFSWatch_Start(const char *sRoot, const char * const *pExclude, size_t dExcludeCount)
+{
+    SFSWatch    *pWatch;
+    size_t      dLength;
+    size_t      i;
+
+    if (!sRoot || !AmberLauncher_DirIterate(sRoot, _SFSWatch_OnEntry, NULL))
+    {
+        return NULL;
+    }
+
+    pWatch = (SFSWatch*)calloc(1, sizeof(SFSWatch));
+    if (!pWatch)
+    {
+        return NULL;
+    }
+
+    /* Trailing separator would end up in every reported path */
+    dLength = strlen(sRoot);
+    while (dLength > 1 && (sRoot[dLength - 1] == '/' || sRoot[dLength - 1] == '\\'))
+    {
+        dLength--;
+    }
+    pWatch->sRoot   = (char*)malloc(dLength + 1);
+    pWatch->pMutex  = SMutex_Create();
+    pWatch->dNotify = -1;
+#if defined(_WIN32) || defined(_WIN64)
+    pWatch->hDirectory = INVALID_HANDLE_VALUE;
+#endif
+    SVector_Init(&pWatch->tPending, sizeof(char*));
+    SVector_Init(&pWatch->tDirs, sizeof(SFSWatchDir));
+    SVector_Init(&pWatch->tSnapshot, sizeof(SFSWatchEntry));
+    if (!pWatch->sRoot || !pWatch->pMutex)
+    {
+        SFSWatch_Stop(&pWatch);
+        return NULL;
+    }
+    memcpy(pWatch->sRoot, sRoot, dLength);
+    pWatch->sRoot[dLength] = '\0';
+
+    if (pExclude && dExcludeCount > 0)
+    {
+        pWatch->pExclude = (char**)calloc(dExcludeCount, sizeof(char*));
+        if (!pWatch->pExclude)
+        {
+            SFSWatch_Stop(&pWatch);
+            return NULL;
+        }
+        for (i = 0; i < dExcludeCount; ++i)
+        {
+            if (pExclude[i] && (pWatch->pExclude[pWatch->dExcludeCount] = _SFSWatch_Join(pExclude[i], "", '/')))
+            {
+                pWatch->dExcludeCount++;
+            }
+        }
+    }
+
+#if defined(__linux__)
+    /* Out of watches (fs.inotify.max_user_watches) falls back to polling */
+    pWatch->dNotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (pWatch->dNotify >= 0 && _SFSWatch_NotifyAdd(pWatch, "", 0))
+    {
+        pWatch->bNative = CTRUE;
+        pWatch->pThread = SThread_Create(_SFSWatch_Notify_Main, pWatch);
+    }
+    else if (pWatch->dNotify >= 0)
+    {
+        fprintf(stderr, "SFSWatch: inotify unavailable for '%s', polling instead\n", sRoot);
+        close(pWatch->dNotify);
+        pWatch->dNotify = -1;
+    }
+#elif defined(_WIN32) || defined(_WIN64)
+    /* Whole tree with one handle, subdirectories need no bookkeeping */
+    pWatch->hDirectory = CreateFileA(pWatch->sRoot, FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    pWatch->hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (pWatch->hDirectory != INVALID_HANDLE_VALUE && pWatch->hEvent)
+    {
+        pWatch->bNative = CTRUE;
+        pWatch->pThread = SThread_Create(_SFSWatch_Directory_Main, pWatch);
+    }
+    else
+    {
+        fprintf(stderr, "SFSWatch: ReadDirectoryChangesW unavailable for '%s', polling instead\n", sRoot);
+    }
+#endif
+
+    if (!pWatch->bNative)
+    {
+        _SFSWatch_Snapshot(pWatch, &pWatch->tSnapshot);
+        pWatch->pThread = SThread_Create(_SFSWatch_Poll_Main, pWatch);
+    }
+
+    if (!pWatch->pThread)
+    {
+        SFSWatch_Stop(&pWatch);
+        return NULL;
+    }
+
+    return pWatch;
+}
+
+CAPI size_t
+SFSWatch_Drain(SFSWatch *pWatch, FSFSWatchChange cbChange, void *pUserData)
+{
+    SVector tPending;
+    CBOOL   bOverflow;
+    size_t  dCount;
+    size_t  i;
+
+    if (!pWatch || !cbChange)
+    {
+        return 0;
+    }
+
+    /* Callbacks run unlocked, watcher keeps collecting into fresh list */
+    SMutex_Lock(pWatch->pMutex);
+    tPending            = pWatch->tPending;
+    bOverflow           = pWatch->bOverflow;
+    pWatch->bOverflow   = CFALSE;
+    SVector_Init(&pWatch->tPending, sizeof(char*));
+    SMutex_Unlock(pWatch->pMutex);
+
+    dCount = bOverflow ? 1 : SVector_GetSize(&tPending);
+    if (bOverflow)
+    {
+        cbChange("", pUserData);
+    }
+
+    for (i = 0; i < SVector_GetSize(&tPending); ++i)
+    {
+        char *sRelPath = *(char**)SVector_Get(&tPending, i);
+
+        if (!bOverflow)
+        {
+            cbChange(sRelPath, pUserData);
+        }
+        free(sRelPath);
+    }
+    SVector_Cleanup(&tPending);
+
+    return dCount;
+}
+
+CAPI CBOOL
+SFSWatch_IsNative(const SFSWatch *pWatch)
+{
+    return pWatch ? pWatch->bNative : CFALSE;
+}
+
+CAPI const char*
+SFSWatch_GetRoot(const SFSWatch *pWatch)
+{
+    return pWatch ? pWatch->sRoot : NULL;
+}
+
+CAPI void
+SFSWatch_Stop(SFSWatch **pWatch)
+{
+    SFSWatch    *pThis;
+    size_t      i;
+
+    if (!pWatch || !*pWatch)
+    {
+        return;
+    }
+    pThis = *pWatch;
+
+    if (pThis->pThread)
+    {
+        SMutex_Lock(pThis->pMutex);
+        pThis->bStop = CTRUE;
+        SMutex_Unlock(pThis->pMutex);
+        SThread_Join(&pThis->pThread);
+    }
+
+#if defined(__linux__)
+    if (pThis->dNotify >= 0)
+    {
+        close(pThis->dNotify);
+    }
+#elif defined(_WIN32) || defined(_WIN64)
+    if (pThis->hDirectory != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(pThis->hDirectory);
+    }
+    if (pThis->hEvent)
+    {
+        CloseHandle(pThis->hEvent);
+    }
+#endif
+
+    for (i = 0; i < SVector_GetSize(&pThis->tPending); ++i)
+    {
+        free(*(char**)SVector_Get(&pThis->tPending, i));
+    }
+    for (i = 0; i < SVector_GetSize(&pThis->tDirs); ++i)
+    {
+        free(((SFSWatchDir*)SVector_Get(&pThis->tDirs, i))->sRelPath);
+    }
+    for (i = 0; i < pThis->dExcludeCount; ++i)
+    {
+        free(pThis->pExclude[i]);
+    }
+    free(pThis->pExclude);
+    SVector_Cleanup(&pThis->tPending);
+    SVector_Cleanup(&pThis->tDirs);
+    _SFSWatch_SnapshotFree(&pThis->tSnapshot);
+
+    SMutex_Destroy(&pThis->pMutex);
+    free(pThis->sRoot);
+    free(pThis);
+    *pWatch = NULL;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static uint32
+_SFSWatch_Poll_Main(void *pData)
+{
+    SFSWatch        *pWatch = (SFSWatch*)pData;
+    SVector         tCurrent;
+    SFSWatchEntry   *pOld;
+    SFSWatchEntry   *pNew;
+    uint32          dWaited;
+    size_t          dOldCount;
+    size_t          dNewCount;
+    size_t          i;
+    size_t          j;
+    int             dOrder;
+
+    for (;;)
+    {
+        for (dWaited = 0; dWaited < SFSWATCH_POLL_INTERVAL_MS; dWaited += SFSWATCH_WAIT_MS)
+        {
+            if (_SFSWatch_IsStopping(pWatch))
+            {
+                return 0;
+            }
+            SThread_Sleep(SFSWATCH_WAIT_MS);
+        }
+
+        SVector_Init(&tCurrent, sizeof(SFSWatchEntry));
+        _SFSWatch_Snapshot(pWatch, &tCurrent);
+
+        /* Both sorted: walk them side by side, past the end of one list
+         * everything left in the other one changed */
+        i           = 0;
+        j           = 0;
+        dOldCount   = SVector_GetSize(&pWatch->tSnapshot);
+        dNewCount   = SVector_GetSize(&tCurrent);
+        while (i < dOldCount || j < dNewCount)
+        {
+            if (j >= dNewCount)
+            {
+                pOld = (SFSWatchEntry*)SVector_Get(&pWatch->tSnapshot, i++);
+                _SFSWatch_Push(pWatch, "", pOld->sRelPath);
+                continue;
+            }
+            if (i >= dOldCount)
+            {
+                pNew = (SFSWatchEntry*)SVector_Get(&tCurrent, j++);
+                _SFSWatch_Push(pWatch, "", pNew->sRelPath);
+                continue;
+            }
+
+            pOld    = (SFSWatchEntry*)SVector_Get(&pWatch->tSnapshot, i);
+            pNew    = (SFSWatchEntry*)SVector_Get(&tCurrent, j);
+            dOrder  = strcmp(pOld->sRelPath, pNew->sRelPath);
+
+            if (dOrder < 0)
+            {
+                _SFSWatch_Push(pWatch, "", pOld->sRelPath);
+                i++;
+            }
+            else if (dOrder > 0)
+            {
+                _SFSWatch_Push(pWatch, "", pNew->sRelPath);
+                j++;
+            }
+            else
+            {
+                if (pOld->dSize != pNew->dSize || pOld->dModTime != pNew->dModTime)
+                {
+                    _SFSWatch_Push(pWatch, "", pNew->sRelPath);
+                }
+                i++;
+                j++;
+            }
+        }
+
+        _SFSWatch_SnapshotFree(&pWatch->tSnapshot);
+        pWatch->tSnapshot = tCurrent;
+    }
+}
+
+static CBOOL
+_SFSWatch_IsStopping(SFSWatch *pWatch)
+{
+    CBOOL bStop;
+
+    SMutex_Lock(pWatch->pMutex);
+    bStop = pWatch->bStop;
+    SMutex_Unlock(pWatch->pMutex);
+
+    return bStop;
+}
+
+/* Case-insensitive, excluded directory covers everything below it */
+static CBOOL
+_SFSWatch_IsExcluded(const SFSWatch *pWatch, const char *sRelPath)
+{
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < pWatch->dExcludeCount; ++i)
+    {
+        const char *sExclude = pWatch->pExclude[i];
+
+        for (j = 0; sExclude[j] && tolower((unsigned char)sExclude[j]) ==
+            tolower((unsigned char)sRelPath[j]); ++j)
+        {
+        }
+        if (j > 0 && !sExclude[j] && (!sRelPath[j] || sRelPath[j] == '/'))
+        {
+            return CTRUE;
+        }
+    }
+
+    return CFALSE;
+}
+
+static void
+_SFSWatch_Push(SFSWatch *pWatch, const char *sRelDir, const char *sName)
+{
+    char    *sRelPath = _SFSWatch_Join(sRelDir, sName, '/');
+    size_t  i;
+
+    if (!sRelPath)
+    {
+        SMutex_Lock(pWatch->pMutex);
+        pWatch->bOverflow = CTRUE;
+        SMutex_Unlock(pWatch->pMutex);
+        return;
+    }
+    if (_SFSWatch_IsExcluded(pWatch, sRelPath))
+    {
+        free(sRelPath);
+        return;
+    }
+
+    SMutex_Lock(pWatch->pMutex);
+    for (i = 0; i < SVector_GetSize(&pWatch->tPending); ++i)
+    {
+        if (strcmp(*(char**)SVector_Get(&pWatch->tPending, i), sRelPath) == 0)
+        {
+            break;
+        }
+    }
+    if (pWatch->bOverflow || i < SVector_GetSize(&pWatch->tPending))
+    {
+        free(sRelPath);
+    }
+    else if (SVector_GetSize(&pWatch->tPending) >= SFSWATCH_MAX_PENDING)
+    {
+        pWatch->bOverflow = CTRUE;
+        free(sRelPath);
+    }
+    else
+    {
+        SVector_PushBack(&pWatch->tPending, &sRelPath);
+    }
+    SMutex_Unlock(pWatch->pMutex);
+}
+
+/* "" directory gives just the name */
+static char*
+_SFSWatch_Join(const char *sDir, const char *sName, char cSeparator)
+{
+    const size_t    dDirLength  = strlen(sDir);
+    const size_t    dNameLength = strlen(sName);
+    char            *sPath      = (char*)malloc(dDirLength + dNameLength + 2);
+
+    if (!sPath)
+    {
+        return NULL;
+    }
+
+    if (dDirLength == 0 || dNameLength == 0)
+    {
+        memcpy(sPath, dDirLength ? sDir : sName, (dDirLength ? dDirLength : dNameLength) + 1);
+        return sPath;
+    }
+
+    memcpy(sPath, sDir, dDirLength);
+    sPath[dDirLength] = cSeparator;
+    memcpy(sPath + dDirLength + 1, sName, dNameLength + 1);
+
+    return sPath;
+}
+
+static CBOOL
+_SFSWatch_OnEntry(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    SFSWatchList    *pList = (SFSWatchList*)pUserData;
+    SFSWatchEntry   tEntry;
+    char            *sPath;
+
+    /* NULL: only checking whether directory can be read */
+    if (!pList || eType == DIRENTRY_OTHER)
+    {
+        return CTRUE;
+    }
+
+    memset(&tEntry, 0, sizeof(tEntry));
+    tEntry.sRelPath = _SFSWatch_Join(pList->sRelDir, sName, '/');
+    if (!tEntry.sRelPath || _SFSWatch_IsExcluded(pList->pWatch, tEntry.sRelPath))
+    {
+        free(tEntry.sRelPath);
+        return CTRUE;
+    }
+
+    if (eType == DIRENTRY_DIRECTORY)
+    {
+        sPath = _SFSWatch_Join(tEntry.sRelPath, "", '/');
+        if (sPath)
+        {
+            SVector_PushBack(&pList->tChildren, &sPath);
+        }
+    }
+
+    if (!pList->pEntries)
+    {
+        free(tEntry.sRelPath);
+        return CTRUE;
+    }
+
+    /* Directories only matter for appearing and disappearing */
+    if (eType == DIRENTRY_FILE)
+    {
+        sPath = _SFSWatch_Join(pList->pWatch->sRoot, tEntry.sRelPath, '/');
+        if (sPath)
+        {
+            AmberLauncher_FileStat(sPath, &tEntry.dSize, &tEntry.dModTime);
+            free(sPath);
+        }
+    }
+    SVector_PushBack(pList->pEntries, &tEntry);
+
+    return CTRUE;
+}
+
+/* Lists one directory, subdirectories go to pChildren (caller frees) */
+static CBOOL
+_SFSWatch_List(SFSWatch *pWatch, const char *sRelDir, SVector *pEntries, SVector *pChildren)
+{
+    SFSWatchList    tList;
+    char            *sPath;
+    CBOOL           bResult;
+
+    sPath = _SFSWatch_Join(pWatch->sRoot, sRelDir, '/');
+    if (!sPath)
+    {
+        return CFALSE;
+    }
+
+    tList.pWatch    = pWatch;
+    tList.sRelDir   = sRelDir;
+    tList.pEntries  = pEntries;
+    SVector_Init(&tList.tChildren, sizeof(char*));
+
+    bResult     = AmberLauncher_DirIterate(sPath, _SFSWatch_OnEntry, &tList);
+    *pChildren  = tList.tChildren;
+    free(sPath);
+
+    return bResult;
+}
+
+static void
+_SFSWatch_Snapshot(SFSWatch *pWatch, SVector *pSnapshot)
+{
+    SVector tQueue;
+    SVector tChildren;
+    size_t  dHead = 0;
+    size_t  i;
+    char    *sRelDir;
+    char    *sRoot = NULL;
+    uint32  dDepth;
+
+    /* Breadth-first, depth is number of '/' in relative path */
+    SVector_Init(&tQueue, sizeof(char*));
+    sRoot = _SFSWatch_Join("", "", '/');
+    if (sRoot)
+    {
+        SVector_PushBack(&tQueue, &sRoot);
+    }
+
+    while (dHead < SVector_GetSize(&tQueue))
+    {
+        sRelDir = *(char**)SVector_Get(&tQueue, dHead++);
+        _SFSWatch_List(pWatch, sRelDir, pSnapshot, &tChildren);
+
+        for (dDepth = sRelDir[0] ? 1 : 0, i = 0; sRelDir[i]; ++i)
+        {
+            dDepth += sRelDir[i] == '/' ? 1 : 0;
+        }
+
+        for (i = 0; i < SVector_GetSize(&tChildren); ++i)
+        {
+            char *sChild = *(char**)SVector_Get(&tChildren, i);
+
+            if (dDepth < SFSWATCH_MAX_DEPTH)
+            {
+                SVector_PushBack(&tQueue, &sChild);
+            }
+            else
+            {
+                free(sChild);
+            }
+        }
+        SVector_Cleanup(&tChildren);
+    }
+
+    for (i = 0; i < SVector_GetSize(&tQueue); ++i)
+    {
+        free(*(char**)SVector_Get(&tQueue, i));
+    }
+    SVector_Cleanup(&tQueue);
+
+    if (SVector_GetSize(pSnapshot) > 1)
+    {
+        qsort(SVector_Get(pSnapshot, 0), SVector_GetSize(pSnapshot),
+            sizeof(SFSWatchEntry), _SFSWatch_SnapshotCompare);
+    }
+}
+
+static void
+_SFSWatch_SnapshotFree(SVector *pSnapshot)
+{
+    size_t i;
+
+    for (i = 0; i < SVector_GetSize(pSnapshot); ++i)
+    {
+        free(((SFSWatchEntry*)SVector_Get(pSnapshot, i))->sRelPath);
+    }
+    SVector_Cleanup(pSnapshot);
+}
+
+static int
+_SFSWatch_SnapshotCompare(const void *pA, const void *pB)
+{
+    return strcmp(((const SFSWatchEntry*)pA)->sRelPath, ((const SFSWatchEntry*)pB)->sRelPath);
+}
+
+#if defined(__linux__)
+static uint32
+_SFSWatch_Notify_Main(void *pData)
+{
+    /* Buffer must be aligned for struct inotify_event */
+    union
+    {
+        struct inotify_event    tEvent;
+        char                    sBuffer[16 * 1024];
+    } uBuffer;
+    SFSWatch                    *pWatch = (SFSWatch*)pData;
+    const struct inotify_event  *pEvent;
+    struct pollfd               tPoll;
+    SFSWatchDir                 *pDir;
+    ssize_t                     dRead;
+    ssize_t                     dOffset;
+    char                        *sRelPath;
+    uint32                      dDepth;
+    size_t                      i;
+
+    tPoll.fd        = pWatch->dNotify;
+    tPoll.events    = POLLIN;
+
+    while (!_SFSWatch_IsStopping(pWatch))
+    {
+        if (poll(&tPoll, 1, SFSWATCH_WAIT_MS) <= 0)
+        {
+            continue;
+        }
+
+        while ((dRead = read(pWatch->dNotify, uBuffer.sBuffer, sizeof(uBuffer.sBuffer))) > 0)
+        {
+            for (dOffset = 0; dOffset < dRead;
+                dOffset += (ssize_t)(sizeof(struct inotify_event) + pEvent->len))
+            {
+                pEvent = (const struct inotify_event*)(uBuffer.sBuffer + dOffset);
+
+                /* Kernel queue overflowed: changes were lost */
+                if (pEvent->mask & IN_Q_OVERFLOW)
+                {
+                    SMutex_Lock(pWatch->pMutex);
+                    pWatch->bOverflow = CTRUE;
+                    SMutex_Unlock(pWatch->pMutex);
+                    continue;
+                }
+
+                pDir = _SFSWatch_NotifyFind(pWatch, pEvent->wd);
+                if (!pDir)
+                {
+                    continue;
+                }
+
+                if (pEvent->mask & IN_IGNORED)
+                {
+                    free(pDir->sRelPath);
+                    SVector_Erase(&pWatch->tDirs,
+                        (size_t)(pDir - (SFSWatchDir*)SVector_Get(&pWatch->tDirs, 0)));
+                    continue;
+                }
+
+                _SFSWatch_Push(pWatch, pDir->sRelPath, pEvent->len ? pEvent->name : "");
+
+                /* New directory (created or moved in) needs its own watches */
+                if ((pEvent->mask & IN_ISDIR) && (pEvent->mask & (IN_CREATE | IN_MOVED_TO)) &&
+                    (sRelPath = _SFSWatch_Join(pDir->sRelPath, pEvent->name, '/')) != NULL)
+                {
+                    for (dDepth = 1, i = 0; sRelPath[i]; ++i)
+                    {
+                        dDepth += sRelPath[i] == '/' ? 1 : 0;
+                    }
+                    _SFSWatch_NotifyAdd(pWatch, sRelPath, dDepth);
+                    free(sRelPath);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* CFALSE only when kernel is out of watches, unreadable directories are skipped */
+static CBOOL
+_SFSWatch_NotifyAdd(SFSWatch *pWatch, const char *sRelDir, uint32 dDepth)
+{
+    SFSWatchDir tDir;
+    SFSWatchDir *pExisting;
+    SVector     tChildren;
+    char        *sPath;
+    CBOOL       bResult = CTRUE;
+    size_t      i;
+
+    /* Created or moved in below excluded directory */
+    if (_SFSWatch_IsExcluded(pWatch, sRelDir))
+    {
+        return CTRUE;
+    }
+
+    sPath = _SFSWatch_Join(pWatch->sRoot, sRelDir, '/');
+    if (!sPath)
+    {
+        return CTRUE;
+    }
+
+    tDir.dWatch = inotify_add_watch(pWatch->dNotify, sPath, SFSWATCH_INOTIFY_MASK);
+    free(sPath);
+    if (tDir.dWatch < 0)
+    {
+        return errno == ENOSPC ? CFALSE : CTRUE;
+    }
+
+    /* Same directory again (moved back in): watch descriptor is reused */
+    tDir.sRelPath = _SFSWatch_Join(sRelDir, "", '/');
+    pExisting = _SFSWatch_NotifyFind(pWatch, tDir.dWatch);
+    if (pExisting)
+    {
+        free(pExisting->sRelPath);
+        pExisting->sRelPath = tDir.sRelPath;
+    }
+    else if (tDir.sRelPath)
+    {
+        SVector_PushBack(&pWatch->tDirs, &tDir);
+    }
+
+    _SFSWatch_List(pWatch, sRelDir, NULL, &tChildren);
+    for (i = 0; i < SVector_GetSize(&tChildren); ++i)
+    {
+        char *sChild = *(char**)SVector_Get(&tChildren, i);
+
+        if (bResult && dDepth < SFSWATCH_MAX_DEPTH)
+        {
+            bResult = _SFSWatch_NotifyAdd(pWatch, sChild, dDepth + 1);
+        }
+        free(sChild);
+    }
+    SVector_Cleanup(&tChildren);
+
+    return bResult;
+}
+
+static SFSWatchDir*
+_SFSWatch_NotifyFind(SFSWatch *pWatch, int dWatch)
+{
+    size_t i;
+
+    for (i = 0; i < SVector_GetSize(&pWatch->tDirs); ++i)
+    {
+        SFSWatchDir *pDir = (SFSWatchDir*)SVector_Get(&pWatch->tDirs, i);
+
+        if (pDir->dWatch == dWatch)
+        {
+            return pDir;
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+#if defined(_WIN32) || defined(_WIN64)
+static uint32
+_SFSWatch_Directory_Main(void *pData)
+{
+    /* Buffer must be DWORD aligned for FILE_NOTIFY_INFORMATION */
+    DWORD                           uBuffer[64 * 1024 / sizeof(DWORD)];
+    SFSWatch                        *pWatch = (SFSWatch*)pData;
+    const FILE_NOTIFY_INFORMATION   *pInfo;
+    OVERLAPPED                      tOverlapped;
+    DWORD                           dRead;
+    char                            sRelPath[MAX_PATH * 2];
+    int                             dLength;
+    int                             i;
+
+    while (!_SFSWatch_IsStopping(pWatch))
+    {
+        memset(&tOverlapped, 0, sizeof(tOverlapped));
+        tOverlapped.hEvent = pWatch->hEvent;
+        ResetEvent(pWatch->hEvent);
+
+        /* Watched directory itself is gone */
+        if (!ReadDirectoryChangesW(pWatch->hDirectory, uBuffer, sizeof(uBuffer), TRUE,
+            SFSWATCH_NOTIFY_FILTER, NULL, &tOverlapped, NULL))
+        {
+            SMutex_Lock(pWatch->pMutex);
+            pWatch->bOverflow = CTRUE;
+            SMutex_Unlock(pWatch->pMutex);
+            break;
+        }
+
+        while (WaitForSingleObject(pWatch->hEvent, SFSWATCH_WAIT_MS) == WAIT_TIMEOUT)
+        {
+            if (_SFSWatch_IsStopping(pWatch))
+            {
+                CancelIo(pWatch->hDirectory);
+                GetOverlappedResult(pWatch->hDirectory, &tOverlapped, &dRead, TRUE);
+                return 0;
+            }
+        }
+
+        /* Nothing returned: buffer overflowed and changes were lost */
+        if (!GetOverlappedResult(pWatch->hDirectory, &tOverlapped, &dRead, FALSE) || dRead == 0)
+        {
+            SMutex_Lock(pWatch->pMutex);
+            pWatch->bOverflow = CTRUE;
+            SMutex_Unlock(pWatch->pMutex);
+            continue;
+        }
+
+        for (pInfo = (const FILE_NOTIFY_INFORMATION*)uBuffer; ;
+            pInfo = (const FILE_NOTIFY_INFORMATION*)((const char*)pInfo + pInfo->NextEntryOffset))
+        {
+            /* Same code page as ANSI calls in opsys.win.c */
+            dLength = WideCharToMultiByte(CP_ACP, 0, pInfo->FileName,
+                (int)(pInfo->FileNameLength / sizeof(WCHAR)),
+                sRelPath, (int)sizeof(sRelPath) - 1, NULL, NULL);
+            if (dLength > 0)
+            {
+                sRelPath[dLength] = '\0';
+                for (i = 0; i < dLength; ++i)
+                {
+                    sRelPath[i] = sRelPath[i] == '\\' ? '/' : sRelPath[i];
+                }
+                _SFSWatch_Push(pWatch, "", sRelPath);
+            }
+
+            if (pInfo->NextEntryOffset == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    return 0;
+}
+#endif
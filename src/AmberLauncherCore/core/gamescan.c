@@ -0,0 +1,429 @@
+#include <core/gamescan.h>
+#include <core/opsys.h>
+#include <core/pathindex.h>
+#include <core/thread.h>
+#include <core/vector.h>
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SGameScanDir
+{
+    char            *sPath;
+    uint32          dDepth;
+} SGameScanDir;
+
+typedef struct SGameScanWork
+{
+    const SGameScanOptions  *pOptions;
+    SVector                 tQueue;         /**< SGameScanDir, FIFO from dHead */
+    size_t                  dHead;
+    uint32                  dActive;        /**< workers listing directory */
+    char                    *sFound;
+    SMutex                  *pMutex;
+} SGameScanWork;
+
+typedef struct SGameScanList
+{
+    const SGameScanOptions  *pOptions;
+    const char              *sPath;
+    uint32                  dDepth;
+    CBOOL                   bExecutable;
+    SVector                 tChildren;      /**< SGameScanDir */
+} SGameScanList;
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static uint32
+_SGameScan_Worker_Main(void *pData);
+
+static CBOOL
+_SGameScan_OnEntry(const char *sName, EDirEntryType eType, void *pUserData);
+
+static CBOOL
+_SGameScan_IsExcluded(const SGameScanOptions *pOptions, const char *sName);
+
+static CBOOL
+_SGameScan_EqualNoCase(const char *sA, const char *sB);
+
+static char*
+_SGameScan_Join(const char *sRoot, const char *sName);
+
+static char*
+_SGameScan_CacheRead(const char *sCachePath, CBOOL *bMiss);
+
+static void
+_SGameScan_CacheWrite(const char *sCachePath, const char *sDirectory);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI char*
+SGameScan_Find(const SGameScanOptions *pOptions)
+{
+    SGameScanWork   tWork;
+    SGameScanDir    tDir;
+    SThread         *pWorkers[SGAMESCAN_MAX_THREADS];
+    uint32          dThreads;
+    uint32          dStarted = 0;
+    size_t          dLength;
+    size_t          i;
+    size_t          j;
+    char            *sCached;
+    CBOOL           bMiss;
+
+    if (!pOptions || !pOptions->sExecutable)
+    {
+        return NULL;
+    }
+
+    sCached = _SGameScan_CacheRead(pOptions->sCachePath, &bMiss);
+    if (sCached && SGameScan_IsValid(pOptions, sCached))
+    {
+        return sCached;
+    }
+    free(sCached);
+    if (bMiss)
+    {
+        return NULL;
+    }
+
+    memset(&tWork, 0, sizeof(tWork));
+    tWork.pOptions  = pOptions;
+    tWork.pMutex    = SMutex_Create();
+    if (!tWork.pMutex)
+    {
+        return NULL;
+    }
+    SVector_Init(&tWork.tQueue, sizeof(SGameScanDir));
+
+    /* Roots nested in other roots would be listed twice */
+    for (i = 0; i < pOptions->dRootCount; ++i)
+    {
+        const char  *sRoot = pOptions->pRoots[i];
+        CBOOL       bNested = CFALSE;
+
+        if (!sRoot || !AmberLauncher_FileStat(sRoot, NULL, NULL))
+        {
+            continue;
+        }
+
+        for (j = 0; j < pOptions->dRootCount && !bNested; ++j)
+        {
+            const char *sOther = pOptions->pRoots[j];
+
+            dLength = sOther ? strlen(sOther) : 0;
+            while (dLength > 1 && (sOther[dLength - 1] == '/' || sOther[dLength - 1] == '\\'))
+            {
+                --dLength;
+            }
+            bNested = j != i && dLength > 0 && strlen(sRoot) > dLength &&
+                strncmp(sRoot, sOther, dLength) == 0 &&
+                (sRoot[dLength] == '/' || sRoot[dLength] == '\\');
+        }
+        if (bNested)
+        {
+            continue;
+        }
+
+        tDir.sPath  = _SGameScan_Join(sRoot, NULL);
+        tDir.dDepth = 0;
+        if (tDir.sPath)
+        {
+            SVector_PushBack(&tWork.tQueue, &tDir);
+        }
+    }
+
+    dThreads = pOptions->dThreads < 1 ? 1 :
+        (pOptions->dThreads > SGAMESCAN_MAX_THREADS ? SGAMESCAN_MAX_THREADS : pOptions->dThreads);
+    for (i = 0; i < dThreads; ++i)
+    {
+        pWorkers[i] = SThread_Create(_SGameScan_Worker_Main, &tWork);
+        dStarted += pWorkers[i] ? 1 : 0;
+    }
+    for (i = 0; i < dThreads; ++i)
+    {
+        SThread_Join(&pWorkers[i]);
+    }
+
+    /* No threads at all: scan here */
+    if (dStarted == 0)
+    {
+        _SGameScan_Worker_Main(&tWork);
+    }
+
+    SVector_ForEach(&tWork.tQueue)
+    {
+        SVector_InitIterator(SGameScanDir, &tWork.tQueue);
+        free(SVECTOR_ITERATOR->sPath);
+    }
+    SVector_Cleanup(&tWork.tQueue);
+    SMutex_Destroy(&tWork.pMutex);
+
+    _SGameScan_CacheWrite(pOptions->sCachePath, tWork.sFound);
+
+    return tWork.sFound;
+}
+
+CAPI CBOOL
+SGameScan_IsValid(const SGameScanOptions *pOptions, const char *sDirectory)
+{
+    SPathIndex  *pIndex;
+    CBOOL       bResult;
+    size_t      i;
+
+    if (!pOptions || !pOptions->sExecutable || !sDirectory)
+    {
+        return CFALSE;
+    }
+
+    pIndex  = SPathIndex_Build(sDirectory);
+    bResult = pIndex && SPathIndex_Resolve(pIndex, pOptions->sExecutable) != NULL;
+    for (i = 0; bResult && i < pOptions->dRequiredCount; ++i)
+    {
+        bResult = pOptions->pRequired[i] &&
+            SPathIndex_Resolve(pIndex, pOptions->pRequired[i]) != NULL;
+    }
+    SPathIndex_delete(&pIndex);
+
+    return bResult;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static uint32
+_SGameScan_Worker_Main(void *pData)
+{
+    SGameScanWork   *pWork = (SGameScanWork*)pData;
+    SGameScanList   tList;
+    SGameScanDir    tDir;
+    CBOOL           bValid;
+
+    tList.pOptions = pWork->pOptions;
+    SVector_Init(&tList.tChildren, sizeof(SGameScanDir));
+
+    for (;;)
+    {
+        SMutex_Lock(pWork->pMutex);
+        if (pWork->sFound ||
+            (pWork->dHead >= SVector_GetSize(&pWork->tQueue) && pWork->dActive == 0))
+        {
+            SMutex_Unlock(pWork->pMutex);
+            break;
+        }
+        if (pWork->dHead >= SVector_GetSize(&pWork->tQueue))
+        {
+            /* Others may still add directories */
+            SMutex_Unlock(pWork->pMutex);
+            SThread_Sleep(SGAMESCAN_POLL_MS);
+            continue;
+        }
+        tDir = *(SGameScanDir*)SVector_Get(&pWork->tQueue, pWork->dHead++);
+        pWork->dActive++;
+        SMutex_Unlock(pWork->pMutex);
+
+        tList.sPath         = tDir.sPath;
+        tList.dDepth        = tDir.dDepth;
+        tList.bExecutable   = CFALSE;
+        SVector_Clear(&tList.tChildren);
+        AmberLauncher_DirIterate(tDir.sPath, _SGameScan_OnEntry, &tList);
+
+        bValid = tList.bExecutable && SGameScan_IsValid(pWork->pOptions, tDir.sPath);
+
+        SMutex_Lock(pWork->pMutex);
+        if (bValid && !pWork->sFound)
+        {
+            pWork->sFound = _SGameScan_Join(tDir.sPath, NULL);
+        }
+        SVector_ForEach(&tList.tChildren)
+        {
+            SVector_InitIterator(SGameScanDir, &tList.tChildren);
+            SVector_PushBack(&pWork->tQueue, SVECTOR_ITERATOR);
+        }
+        pWork->dActive--;
+        SMutex_Unlock(pWork->pMutex);
+    }
+
+    SVector_Cleanup(&tList.tChildren);
+
+    return 0;
+}
+
+static CBOOL
+_SGameScan_OnEntry(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    SGameScanList   *pList = (SGameScanList*)pUserData;
+    SGameScanDir    tChild;
+
+    if (eType == DIRENTRY_FILE)
+    {
+        if (_SGameScan_EqualNoCase(sName, pList->pOptions->sExecutable))
+        {
+            pList->bExecutable = CTRUE;
+        }
+        return CTRUE;
+    }
+
+    /* Symlinks come as DIRENTRY_OTHER: wine's dosdevices would loop */
+    if (eType != DIRENTRY_DIRECTORY || sName[0] == '.' ||
+        pList->dDepth >= pList->pOptions->dMaxDepth ||
+        _SGameScan_IsExcluded(pList->pOptions, sName))
+    {
+        return CTRUE;
+    }
+
+    tChild.sPath    = _SGameScan_Join(pList->sPath, sName);
+    tChild.dDepth   = pList->dDepth + 1;
+    if (tChild.sPath)
+    {
+        SVector_PushBack(&pList->tChildren, &tChild);
+    }
+
+    return CTRUE;
+}
+
+static CBOOL
+_SGameScan_IsExcluded(const SGameScanOptions *pOptions, const char *sName)
+{
+    size_t i;
+
+    for (i = 0; i < pOptions->dExcludeCount; ++i)
+    {
+        if (pOptions->pExclude[i] && _SGameScan_EqualNoCase(sName, pOptions->pExclude[i]))
+        {
+            return CTRUE;
+        }
+    }
+
+    return CFALSE;
+}
+
+static CBOOL
+_SGameScan_EqualNoCase(const char *sA, const char *sB)
+{
+    while (*sA && *sB && tolower((unsigned char)*sA) == tolower((unsigned char)*sB))
+    {
+        ++sA;
+        ++sB;
+    }
+
+    return *sA == '\0' && *sB == '\0';
+}
+
+/* sName NULL: copy of sRoot without trailing separators */
+static char*
+_SGameScan_Join(const char *sRoot, const char *sName)
+{
+    size_t  dRootLength = strlen(sRoot);
+    char    *sResult;
+
+    while (dRootLength > 1 && (sRoot[dRootLength - 1] == '/' || sRoot[dRootLength - 1] == '\\'))
+    {
+        --dRootLength;
+    }
+
+    sResult = (char*)malloc(dRootLength + (sName ? strlen(sName) + 1 : 0) + 1);
+    if (!sResult)
+    {
+        return NULL;
+    }
+
+    memcpy(sResult, sRoot, dRootLength);
+    sResult[dRootLength] = '\0';
+    if (sName)
+    {
+        sResult[dRootLength] = SPATHINDEX_SEPARATOR;
+        strcpy(sResult + dRootLength + 1, sName);
+    }
+
+    return sResult;
+}
+
+/* First line is match, empty one is miss followed by time it was recorded */
+static char*
+_SGameScan_CacheRead(const char *sCachePath, CBOOL *bMiss)
+{
+    FILE    *pFile;
+    char    sLine[4096];
+    size_t  dLength;
+    double  dTime;
+    double  dAge;
+
+    *bMiss = CFALSE;
+    if (!sCachePath || !(pFile = fopen(sCachePath, "r")))
+    {
+        return NULL;
+    }
+
+    if (!fgets(sLine, sizeof(sLine), pFile))
+    {
+        fclose(pFile);
+        return NULL;
+    }
+
+    dLength = strlen(sLine);
+    while (dLength > 0 && (sLine[dLength - 1] == '\n' || sLine[dLength - 1] == '\r'))
+    {
+        sLine[--dLength] = '\0';
+    }
+
+    if (dLength == 0)
+    {
+        dAge    = fscanf(pFile, "%lf", &dTime) == 1 ? difftime(time(NULL), (time_t)dTime) : -1.0;
+        *bMiss  = dAge >= 0.0 && dAge < SGAMESCAN_MISS_TTL_S;
+    }
+    fclose(pFile);
+
+    return dLength > 0 ? _SGameScan_Join(sLine, NULL) : NULL;
+}
+
+static void
+_SGameScan_CacheWrite(const char *sCachePath, const char *sDirectory)
+{
+    FILE    *pFile;
+    char    *sTmpPath;
+
+    if (!sCachePath)
+    {
+        return;
+    }
+
+    sTmpPath = (char*)malloc(strlen(sCachePath) + 5);
+    if (!sTmpPath)
+    {
+        return;
+    }
+    strcpy(sTmpPath, sCachePath);
+    strcat(sTmpPath, ".tmp");
+
+    pFile = fopen(sTmpPath, "w");
+    if (pFile)
+    {
+        if (sDirectory)
+        {
+            fprintf(pFile, "%s\n", sDirectory);
+        }
+        else
+        {
+            fprintf(pFile, "\n%.0f\n", (double)time(NULL));
+        }
+        if (fclose(pFile) != 0 || !AmberLauncher_FileReplace(sTmpPath, sCachePath))
+        {
+            remove(sTmpPath);
+        }
+    }
+
+    free(sTmpPath);
+}
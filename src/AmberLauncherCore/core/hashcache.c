@@ -0,0 +1,494 @@
+#include <core/hashcache.h>
+#include <core/opsys.h>
+#include <core/thread.h>
+
+#include <ext/sha256.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SHASHCACHE_HEADER               "ALHC 1"
+#define SHASHCACHE_BUFFER_SIZE          65536
+#define SHASHCACHE_LINE_SIZE            4096
+#define SHASHCACHE_MIN_BUCKETS          64
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SHashCacheEntry
+{
+    char            *sPath;
+    char            sSHA256[SHASHCACHE_SHA256_HEX_SIZE + 1];
+    uint64          dSize;
+    int64           dModTime;
+    CBOOL           bUsed;
+} SHashCacheEntry;
+
+struct SHashCache
+{
+    char            *sCachePath;
+    SMutex          *pMutex;
+
+    SHashCacheEntry *pEntries;
+    size_t          dNumEntries;
+    size_t          dMaxEntries;
+
+    /* Open addressing index: entry index + 1, 0 marks empty bucket */
+    size_t          *pBuckets;
+    size_t          dNumBuckets;
+
+    uint32          dHits;
+    uint32          dMisses;
+};
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static uint32
+_SHashCache_HashString(const char *sString);
+
+static SHashCacheEntry*
+_SHashCache_Find(SHashCache *pCache, const char *sPath);
+
+static CBOOL
+_SHashCache_Insert(
+    SHashCache *pCache,
+    const char *sPath,
+    const char *sSHA256,
+    uint64 dSize,
+    int64 dModTime,
+    CBOOL bUsed);
+
+static CBOOL
+_SHashCache_Rehash(SHashCache *pCache, size_t dNumBuckets);
+
+static CBOOL
+_SHashCache_Digest(const char *sPath, char *sHexOut);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SHashCache*
+SHashCache_Load(const char *sCachePath)
+{
+    SHashCache  *pCache;
+    FILE        *pFile;
+    char        *sLine;
+
+    if (!sCachePath)
+    {
+        return NULL;
+    }
+
+    pCache = (SHashCache*)calloc(1, sizeof(SHashCache));
+    if (!IS_VALID(pCache))
+    {
+        fprintf(stderr, "SHashCache_Load() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    pCache->sCachePath  = (char*)malloc(strlen(sCachePath) + 1);
+    pCache->pMutex      = SMutex_Create();
+    sLine               = (char*)malloc(SHASHCACHE_LINE_SIZE);
+    if (!pCache->sCachePath || !pCache->pMutex || !sLine ||
+        !_SHashCache_Rehash(pCache, SHASHCACHE_MIN_BUCKETS))
+    {
+        free(sLine);
+        SHashCache_delete(&pCache);
+        return NULL;
+    }
+    strcpy(pCache->sCachePath, sCachePath);
+
+    pFile = fopen(sCachePath, "r");
+    if (!pFile)
+    {
+        free(sLine);
+        return pCache;
+    }
+
+    /* "<sha256> <size> <mtime> <path>" per line */
+    if (fgets(sLine, SHASHCACHE_LINE_SIZE, pFile) &&
+        strncmp(sLine, SHASHCACHE_HEADER, strlen(SHASHCACHE_HEADER)) == 0)
+    {
+        while (fgets(sLine, SHASHCACHE_LINE_SIZE, pFile))
+        {
+            char                sSHA256[SHASHCACHE_SHA256_HEX_SIZE + 1];
+            unsigned long long  dSize;
+            long long           dModTime;
+            int                 dPathOffset = 0;
+            size_t              dLength;
+
+            if (sscanf(sLine, "%64s %llu %lld %n", sSHA256, &dSize, &dModTime, &dPathOffset) != 3 ||
+                dPathOffset == 0 ||
+                strlen(sSHA256) != SHASHCACHE_SHA256_HEX_SIZE)
+            {
+                continue;
+            }
+
+            dLength = strlen(sLine);
+            if (dLength > 0 && sLine[dLength - 1] == '\n')
+            {
+                sLine[--dLength] = '\0';
+            }
+
+            _SHashCache_Insert(pCache, sLine + dPathOffset, sSHA256,
+                (uint64)dSize, (int64)dModTime, CFALSE);
+        }
+    }
+    fclose(pFile);
+    free(sLine);
+
+    return pCache;
+}
+
+CAPI CBOOL
+SHashCache_Save(SHashCache *pCache)
+{
+    FILE    *pFile;
+    char    *sTmpPath;
+    size_t  dIndex;
+    CBOOL   bResult;
+
+    if (!pCache)
+    {
+        return CFALSE;
+    }
+
+    sTmpPath = (char*)malloc(strlen(pCache->sCachePath) + 5);
+    if (!sTmpPath)
+    {
+        return CFALSE;
+    }
+    sprintf(sTmpPath, "%s.tmp", pCache->sCachePath);
+
+    pFile = fopen(sTmpPath, "w");
+    if (!pFile)
+    {
+        free(sTmpPath);
+        return CFALSE;
+    }
+
+    SMutex_Lock(pCache->pMutex);
+    bResult = fprintf(pFile, "%s\n", SHASHCACHE_HEADER) > 0;
+    for (dIndex = 0; bResult && dIndex < pCache->dNumEntries; ++dIndex)
+    {
+        const SHashCacheEntry *pEntry = &pCache->pEntries[dIndex];
+
+        if (!pEntry->bUsed)
+        {
+            continue;
+        }
+
+        bResult = fprintf(pFile, "%s %llu %lld %s\n",
+            pEntry->sSHA256,
+            (unsigned long long)pEntry->dSize,
+            (long long)pEntry->dModTime,
+            pEntry->sPath) > 0;
+    }
+    SMutex_Unlock(pCache->pMutex);
+
+    bResult = bResult && AmberLauncher_FileSync(pFile);
+    fclose(pFile);
+
+    bResult = bResult && AmberLauncher_FileReplace(sTmpPath, pCache->sCachePath);
+    if (!bResult)
+    {
+        remove(sTmpPath);
+    }
+    free(sTmpPath);
+
+    return bResult;
+}
+
+CAPI CBOOL
+SHashCache_HashFile(
+    SHashCache *pCache,
+    const char *sPath,
+    char *sHexOut,
+    uint64 *dSizeOut)
+{
+    SHashCacheEntry *pEntry;
+    uint64          dSize;
+    int64           dModTime;
+
+    if (!pCache || !sPath || !sHexOut ||
+        !AmberLauncher_FileStat(sPath, &dSize, &dModTime))
+    {
+        return CFALSE;
+    }
+
+    if (dSizeOut)
+    {
+        *dSizeOut = dSize;
+    }
+
+    SMutex_Lock(pCache->pMutex);
+    pEntry = _SHashCache_Find(pCache, sPath);
+    if (pEntry && pEntry->dSize == dSize && pEntry->dModTime == dModTime)
+    {
+        memcpy(sHexOut, pEntry->sSHA256, SHASHCACHE_SHA256_HEX_SIZE + 1);
+        pEntry->bUsed = CTRUE;
+        pCache->dHits++;
+        SMutex_Unlock(pCache->pMutex);
+        return CTRUE;
+    }
+    SMutex_Unlock(pCache->pMutex);
+
+    /* Hashing runs unlocked, so several workers can read files at once */
+    if (!_SHashCache_Digest(sPath, sHexOut))
+    {
+        return CFALSE;
+    }
+
+    SMutex_Lock(pCache->pMutex);
+    pCache->dMisses++;
+    pEntry = _SHashCache_Find(pCache, sPath);
+    if (pEntry)
+    {
+        memcpy(pEntry->sSHA256, sHexOut, SHASHCACHE_SHA256_HEX_SIZE + 1);
+        pEntry->dSize       = dSize;
+        pEntry->dModTime    = dModTime;
+        pEntry->bUsed       = CTRUE;
+    }
+    else if (!strchr(sPath, '\n'))
+    {
+        _SHashCache_Insert(pCache, sPath, sHexOut, dSize, dModTime, CTRUE);
+    }
+    SMutex_Unlock(pCache->pMutex);
+
+    return CTRUE;
+}
+
+CAPI void
+SHashCache_GetStats(SHashCache *pCache, uint32 *dHits, uint32 *dMisses)
+{
+    if (!pCache)
+    {
+        return;
+    }
+
+    SMutex_Lock(pCache->pMutex);
+    if (dHits)
+    {
+        *dHits = pCache->dHits;
+    }
+    if (dMisses)
+    {
+        *dMisses = pCache->dMisses;
+    }
+    SMutex_Unlock(pCache->pMutex);
+}
+
+CAPI void
+SHashCache_delete(SHashCache **pCache)
+{
+    size_t dIndex;
+
+    if (!pCache || !*pCache)
+    {
+        return;
+    }
+
+    for (dIndex = 0; dIndex < (*pCache)->dNumEntries; ++dIndex)
+    {
+        free((*pCache)->pEntries[dIndex].sPath);
+    }
+    free((*pCache)->pEntries);
+    free((*pCache)->pBuckets);
+    free((*pCache)->sCachePath);
+    SMutex_Destroy(&(*pCache)->pMutex);
+    free(*pCache);
+
+    *pCache = NULL;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static uint32
+_SHashCache_HashString(const char *sString)
+{
+    /* FNV-1a */
+    uint32 dHash = 2166136261u;
+
+    while (*sString)
+    {
+        dHash ^= (unsigned char)*sString++;
+        dHash *= 16777619u;
+    }
+
+    return dHash;
+}
+
+static SHashCacheEntry*
+_SHashCache_Find(SHashCache *pCache, const char *sPath)
+{
+    const size_t    dMask = pCache->dNumBuckets - 1;
+    size_t          dBucket = _SHashCache_HashString(sPath) & dMask;
+
+    while (pCache->pBuckets[dBucket] != 0)
+    {
+        SHashCacheEntry *pEntry = &pCache->pEntries[pCache->pBuckets[dBucket] - 1];
+
+        if (strcmp(pEntry->sPath, sPath) == 0)
+        {
+            return pEntry;
+        }
+        dBucket = (dBucket + 1) & dMask;
+    }
+
+    return NULL;
+}
+
+static CBOOL
+_SHashCache_Insert(
+    SHashCache *pCache,
+    const char *sPath,
+    const char *sSHA256,
+    uint64 dSize,
+    int64 dModTime,
+    CBOOL bUsed)
+{
+    SHashCacheEntry *pEntry;
+    size_t          dMask;
+    size_t          dBucket;
+
+    /* Duplicate lines in cache file: last one wins */
+    pEntry = _SHashCache_Find(pCache, sPath);
+    if (!pEntry)
+    {
+        if (pCache->dNumEntries == pCache->dMaxEntries)
+        {
+            const size_t    dNewMax = pCache->dMaxEntries ? pCache->dMaxEntries * 2 : 256;
+            SHashCacheEntry *pNew   = (SHashCacheEntry*)realloc(
+                pCache->pEntries, dNewMax * sizeof(SHashCacheEntry));
+
+            if (!pNew)
+            {
+                return CFALSE;
+            }
+            pCache->pEntries    = pNew;
+            pCache->dMaxEntries = dNewMax;
+        }
+
+        /* Keep load factor under 1/2 */
+        if ((pCache->dNumEntries + 1) * 2 > pCache->dNumBuckets &&
+            !_SHashCache_Rehash(pCache, pCache->dNumBuckets * 2))
+        {
+            return CFALSE;
+        }
+
+        pEntry          = &pCache->pEntries[pCache->dNumEntries];
+        pEntry->sPath   = (char*)malloc(strlen(sPath) + 1);
+        if (!pEntry->sPath)
+        {
+            return CFALSE;
+        }
+        strcpy(pEntry->sPath, sPath);
+
+        dMask   = pCache->dNumBuckets - 1;
+        dBucket = _SHashCache_HashString(sPath) & dMask;
+        while (pCache->pBuckets[dBucket] != 0)
+        {
+            dBucket = (dBucket + 1) & dMask;
+        }
+        pCache->pBuckets[dBucket] = ++pCache->dNumEntries;
+    }
+
+    memcpy(pEntry->sSHA256, sSHA256, SHASHCACHE_SHA256_HEX_SIZE);
+    pEntry->sSHA256[SHASHCACHE_SHA256_HEX_SIZE] = '\0';
+    pEntry->dSize       = dSize;
+    pEntry->dModTime    = dModTime;
+    pEntry->bUsed       = bUsed;
+
+    return CTRUE;
+}
+
+static CBOOL
+_SHashCache_Rehash(SHashCache *pCache, size_t dNumBuckets)
+{
+    size_t  *pBuckets = (size_t*)calloc(dNumBuckets, sizeof(size_t));
+    size_t  dIndex;
+
+    if (!pBuckets)
+    {
+        return CFALSE;
+    }
+
+    for (dIndex = 0; dIndex < pCache->dNumEntries; ++dIndex)
+    {
+        size_t dBucket = _SHashCache_HashString(pCache->pEntries[dIndex].sPath) & (dNumBuckets - 1);
+
+        while (pBuckets[dBucket] != 0)
+        {
+            dBucket = (dBucket + 1) & (dNumBuckets - 1);
+        }
+        pBuckets[dBucket] = dIndex + 1;
+    }
+
+    free(pCache->pBuckets);
+    pCache->pBuckets    = pBuckets;
+    pCache->dNumBuckets = dNumBuckets;
+
+    return CTRUE;
+}
+
+static CBOOL
+_SHashCache_Digest(const char *sPath, char *sHexOut)
+{
+    static const char   tbl[] = "0123456789abcdef";
+    SHA256_Context      tCtx;
+    unsigned char       sDigest[SHA256_HASH_SIZE];
+    unsigned char       *pBuffer;
+    FILE                *pFile;
+    size_t              dRead;
+    size_t              i;
+    CBOOL               bResult;
+
+    pFile = fopen(sPath, "rb");
+    if (!pFile)
+    {
+        return CFALSE;
+    }
+
+    pBuffer = (unsigned char*)malloc(SHASHCACHE_BUFFER_SIZE);
+    if (!pBuffer)
+    {
+        fclose(pFile);
+        return CFALSE;
+    }
+
+    sha256_initialize(&tCtx);
+    while ((dRead = fread(pBuffer, 1, SHASHCACHE_BUFFER_SIZE, pFile)) > 0)
+    {
+        sha256_add_bytes(&tCtx, pBuffer, dRead);
+    }
+    bResult = ferror(pFile) ? CFALSE : CTRUE;
+
+    free(pBuffer);
+    fclose(pFile);
+
+    if (!bResult)
+    {
+        return CFALSE;
+    }
+
+    sha256_calculate(&tCtx, sDigest);
+    for (i = 0; i < SHA256_HASH_SIZE; ++i)
+    {
+        sHexOut[i * 2]     = tbl[sDigest[i] >> 4];
+        sHexOut[i * 2 + 1] = tbl[sDigest[i] & 0x0F];
+    }
+    sHexOut[SHA256_HASH_SIZE * 2] = '\0';
+
+    return CTRUE;
+}
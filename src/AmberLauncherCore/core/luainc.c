@@ -52,3 +52,17 @@ luaL_traceback(lua_State *L, lua_State *L1, const char *msg, int level)
     lua_pop(L1, 1);
 }
 #endif
+
+int
+luainc_resume(lua_State *L, lua_State *from, int narg)
+{
+#if LUA_VERSION_NUM == 501
+    (void)from;
+    return lua_resume(L, narg);
+#elif LUA_VERSION_NUM < 504
+    return lua_resume(L, from, narg);
+#else
+    int nres;
+    return lua_resume(L, from, narg, &nres);
+#endif
+}
@@ -0,0 +1,350 @@
+#include <core/manifest.h>
+
+#include <ext/miniz.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SManifestReader
+{
+    const unsigned char *pData;
+    size_t              dSize;
+    size_t              dOffset;
+    CBOOL               bError;
+} SManifestReader;
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static uint32
+_SManifestReader_U32(SManifestReader *pReader);
+
+static uint16
+_SManifestReader_U16(SManifestReader *pReader);
+
+static char*
+_SManifestReader_String(SManifestReader *pReader);
+
+static const unsigned char*
+_SManifestReader_Bytes(SManifestReader *pReader, size_t dCount);
+
+static char*
+_SManifest_StrDup(const char *sString);
+
+static CBOOL
+_SManifest_ParseBody(SManifest *pManifest, SManifestReader *pReader);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SManifest*
+SManifest_new(void)
+{
+    SManifest *pManifest = (SManifest*)calloc(1, sizeof(SManifest));
+
+    if (!IS_VALID(pManifest))
+    {
+        fprintf(stderr, "SManifest_new() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    SVector_Init(&pManifest->tFiles, sizeof(SManifestFile));
+
+    return pManifest;
+}
+
+CAPI void
+SManifest_delete(SManifest **pManifest)
+{
+    SManifest *pSelf;
+
+    if (!pManifest || !*pManifest)
+    {
+        return;
+    }
+
+    pSelf = *pManifest;
+
+    SVector_ForEach(&pSelf->tFiles)
+    {
+        SVector_InitIterator(SManifestFile, &pSelf->tFiles);
+        free(SVECTOR_ITERATOR->sPath);
+    }
+    SVector_Cleanup(&pSelf->tFiles);
+
+    free(pSelf->sSchema);
+    free(pSelf->sGenerated);
+    free(pSelf);
+
+    *pManifest = NULL;
+}
+
+CAPI CBOOL
+SManifest_AddFile(
+    SManifest *pManifest,
+    const char *sPath,
+    const char *sSHA256,
+    uint32 dSize,
+    uint32 dPackedSize)
+{
+    SManifestFile tFile;
+
+    if (!pManifest || !sPath || !sSHA256)
+    {
+        return CFALSE;
+    }
+
+    tFile.sPath = _SManifest_StrDup(sPath);
+    if (!tFile.sPath)
+    {
+        return CFALSE;
+    }
+
+    strncpy(tFile.sSHA256, sSHA256, SMANIFEST_SHA256_HEX_SIZE);
+    tFile.sSHA256[SMANIFEST_SHA256_HEX_SIZE] = '\0';
+    tFile.dSize         = dSize;
+    tFile.dPackedSize   = dPackedSize;
+
+    SVector_PushBack(&pManifest->tFiles, &tFile);
+
+    return CTRUE;
+}
+
+CAPI size_t
+SManifest_GetFileCount(const SManifest *pManifest)
+{
+    return pManifest ? SVector_GetSize(&pManifest->tFiles) : 0;
+}
+
+CAPI const SManifestFile*
+SManifest_GetFile(SManifest *pManifest, size_t dIndex)
+{
+    if (!pManifest || dIndex >= SVector_GetSize(&pManifest->tFiles))
+    {
+        return NULL;
+    }
+
+    return (const SManifestFile*)SVector_Get(&pManifest->tFiles, dIndex);
+}
+
+CAPI SManifest*
+SManifest_ReadBinary(const void *pData, size_t dSize)
+{
+    SManifestReader     tReader;
+    SManifest           *pManifest;
+    const unsigned char *pMagic;
+    uint16              dVersion;
+    uint16              dFlags;
+    uint32              dBodySize;
+    void                *pInflated = NULL;
+    size_t              dInflatedSize = 0;
+    CBOOL               bResult;
+
+    if (!pData || dSize < SMANIFEST_HEADER_SIZE)
+    {
+        return NULL;
+    }
+
+    tReader.pData   = (const unsigned char*)pData;
+    tReader.dSize   = dSize;
+    tReader.dOffset = 0;
+    tReader.bError  = CFALSE;
+
+    pMagic      = _SManifestReader_Bytes(&tReader, 4);
+    dVersion    = _SManifestReader_U16(&tReader);
+    dFlags      = _SManifestReader_U16(&tReader);
+    dBodySize   = _SManifestReader_U32(&tReader);
+
+    if (tReader.bError ||
+        memcmp(pMagic, SMANIFEST_MAGIC, 4) != 0 ||
+        dVersion != SMANIFEST_VERSION)
+    {
+        fprintf(stderr, "SManifest_ReadBinary() -> Unknown manifest format\n");
+        return NULL;
+    }
+
+    /* Compressed body gets inflated into its own buffer, then parsed as usual */
+    if (FLAG_HAS(dFlags, SMANIFEST_FLAG_DEFLATE))
+    {
+        pInflated = tinfl_decompress_mem_to_heap(
+            tReader.pData + tReader.dOffset,
+            tReader.dSize - tReader.dOffset,
+            &dInflatedSize,
+            TINFL_FLAG_PARSE_ZLIB_HEADER);
+
+        if (!pInflated || dInflatedSize != dBodySize)
+        {
+            fprintf(stderr, "SManifest_ReadBinary() -> Failed to inflate body\n");
+            mz_free(pInflated);
+            return NULL;
+        }
+
+        tReader.pData   = (const unsigned char*)pInflated;
+        tReader.dSize   = dInflatedSize;
+        tReader.dOffset = 0;
+    }
+    else if (tReader.dSize - tReader.dOffset != dBodySize)
+    {
+        fprintf(stderr, "SManifest_ReadBinary() -> Truncated body\n");
+        return NULL;
+    }
+
+    pManifest = SManifest_new();
+    bResult = pManifest && _SManifest_ParseBody(pManifest, &tReader);
+    mz_free(pInflated);
+
+    if (!bResult)
+    {
+        fprintf(stderr, "SManifest_ReadBinary() -> Malformed body\n");
+        SManifest_delete(&pManifest);
+        return NULL;
+    }
+
+    return pManifest;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static const unsigned char*
+_SManifestReader_Bytes(SManifestReader *pReader, size_t dCount)
+{
+    const unsigned char *pResult;
+
+    if (pReader->bError || pReader->dSize - pReader->dOffset < dCount)
+    {
+        pReader->bError = CTRUE;
+        return NULL;
+    }
+
+    pResult = pReader->pData + pReader->dOffset;
+    pReader->dOffset += dCount;
+
+    return pResult;
+}
+
+static uint32
+_SManifestReader_U32(SManifestReader *pReader)
+{
+    const unsigned char *p = _SManifestReader_Bytes(pReader, 4);
+
+    if (!p)
+    {
+        return 0;
+    }
+
+    return (uint32)p[0]         | ((uint32)p[1] << 8) |
+           ((uint32)p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+static uint16
+_SManifestReader_U16(SManifestReader *pReader)
+{
+    const unsigned char *p = _SManifestReader_Bytes(pReader, 2);
+
+    if (!p)
+    {
+        return 0;
+    }
+
+    return (uint16)(p[0] | (p[1] << 8));
+}
+
+static char*
+_SManifestReader_String(SManifestReader *pReader)
+{
+    const uint16        dLength = _SManifestReader_U16(pReader);
+    const unsigned char *pBytes = _SManifestReader_Bytes(pReader, dLength);
+    char                *sResult;
+
+    if (!pBytes)
+    {
+        return NULL;
+    }
+
+    sResult = (char*)malloc((size_t)dLength + 1);
+    if (sResult)
+    {
+        memcpy(sResult, pBytes, dLength);
+        sResult[dLength] = '\0';
+    }
+
+    return sResult;
+}
+
+static char*
+_SManifest_StrDup(const char *sString)
+{
+    const size_t    dLength = strlen(sString);
+    char            *sResult = (char*)malloc(dLength + 1);
+
+    if (sResult)
+    {
+        memcpy(sResult, sString, dLength + 1);
+    }
+
+    return sResult;
+}
+
+static CBOOL
+_SManifest_ParseBody(SManifest *pManifest, SManifestReader *pReader)
+{
+    static const char   tbl[] = "0123456789abcdef";
+    uint32              dCount;
+    uint32              i;
+    size_t              j;
+
+    pManifest->sSchema      = _SManifestReader_String(pReader);
+    pManifest->sGenerated   = _SManifestReader_String(pReader);
+    pManifest->dVersion     = (int32)_SManifestReader_U32(pReader);
+    pManifest->dBuild       = (int32)_SManifestReader_U32(pReader);
+    dCount                  = _SManifestReader_U32(pReader);
+
+    if (pReader->bError || !pManifest->sSchema || !pManifest->sGenerated)
+    {
+        return CFALSE;
+    }
+
+    /* Each entry takes at least 42 bytes, don't trust count blindly */
+    if ((size_t)dCount > (pReader->dSize - pReader->dOffset) / 42)
+    {
+        return CFALSE;
+    }
+    SVector_Reserve(&pManifest->tFiles, dCount);
+
+    for (i = 0; i < dCount; ++i)
+    {
+        SManifestFile       tFile;
+        const unsigned char *pDigest;
+
+        tFile.sPath         = _SManifestReader_String(pReader);
+        pDigest             = _SManifestReader_Bytes(pReader, SMANIFEST_SHA256_HEX_SIZE / 2);
+        tFile.dSize         = _SManifestReader_U32(pReader);
+        tFile.dPackedSize   = _SManifestReader_U32(pReader);
+
+        if (pReader->bError || !tFile.sPath)
+        {
+            free(tFile.sPath);
+            return CFALSE;
+        }
+
+        for (j = 0; j < SMANIFEST_SHA256_HEX_SIZE / 2; ++j)
+        {
+            tFile.sSHA256[j * 2]     = tbl[pDigest[j] >> 4];
+            tFile.sSHA256[j * 2 + 1] = tbl[pDigest[j] & 0x0F];
+        }
+        tFile.sSHA256[SMANIFEST_SHA256_HEX_SIZE] = '\0';
+
+        SVector_PushBack(&pManifest->tFiles, &tFile);
+    }
+
+    return CTRUE;
+}
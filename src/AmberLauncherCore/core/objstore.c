@@ -0,0 +1,795 @@
+#include <core/objstore.h>
+#include <core/hashcache.h>
+#include <core/opsys.h>
+#include <core/thread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SOBJSTORE_ARCHIVES_HEADER       "ALAI 1"
+#define SOBJSTORE_LINE_SIZE             4096
+#define SOBJSTORE_MIN_BUCKETS           64
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SObjectArchiveEntry
+{
+    char            *sKey;
+    char            sSHA256[SOBJSTORE_SHA256_HEX_SIZE + 1];
+} SObjectArchiveEntry;
+
+typedef struct SObjectCollect
+{
+    const char      *sRoot;
+    const char      **pKeep;        /* sorted */
+    size_t          dNumKeep;
+    char            *sDir;          /* fan-out directory being swept */
+    uint32          dNumRemoved;
+} SObjectCollect;
+
+struct SObjectStore
+{
+    char                *sRoot;
+    SHashCache          *pHashCache;
+    SMutex              *pMutex;
+    uint32              dTmpCounter;
+
+    SObjectArchiveEntry *pArchive;
+    size_t              dNumArchive;
+    size_t              dMaxArchive;
+    size_t              *pBuckets;      /* entry index + 1, 0 is empty */
+    size_t              dNumBuckets;
+    CBOOL               bArchiveDirty;
+};
+
+const char* ESObjectLinkStrings[] = {
+    "none",
+    "reflink",
+    "hardlink",
+    "copy",
+    NULL
+};
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static char*
+_SObjectStore_Join(const char *sA, const char *sB);
+
+static uint32
+_SObjectStore_HashString(const char *sString);
+
+static CBOOL
+_SObjectStore_IsValidSHA256(const char *sSHA256);
+
+static CBOOL
+_SObjectStore_ObjectPath(const SObjectStore *pStore, const char *sSHA256, char **sPathOut);
+
+static CBOOL
+_SObjectStore_EnsureParent(const char *sPath);
+
+static char*
+_SObjectStore_TmpPath(SObjectStore *pStore, const char *sPath);
+
+static ESObjectLink
+_SObjectStore_Materialize(const char *sSrcPath, const char *sDstPath, CBOOL bAllowLink);
+
+static CBOOL
+_SObjectStore_ImportEx(
+    SObjectStore *pStore,
+    const char *sPath,
+    const char *sKnownSHA256,
+    char *sSHA256Out,
+    CBOOL bAllowLink);
+
+static int
+_SObjectStore_CompareKeys(const void *pA, const void *pB);
+
+static CBOOL
+_SObjectStore_CollectDir(const char *sName, EDirEntryType eType, void *pUserData);
+
+static CBOOL
+_SObjectStore_CollectObject(const char *sName, EDirEntryType eType, void *pUserData);
+
+static SObjectArchiveEntry*
+_SObjectStore_ArchiveFind(SObjectStore *pStore, const char *sKey);
+
+static CBOOL
+_SObjectStore_ArchiveInsert(SObjectStore *pStore, const char *sKey, const char *sSHA256);
+
+static CBOOL
+_SObjectStore_ArchiveRehash(SObjectStore *pStore, size_t dNumBuckets);
+
+static void
+_SObjectStore_ArchiveLoad(SObjectStore *pStore);
+
+static CBOOL
+_SObjectStore_ArchiveSave(SObjectStore *pStore);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SObjectStore*
+SObjectStore_Open(const char *sRoot)
+{
+    SObjectStore    *pStore;
+    char            *sCachePath;
+
+    if (!sRoot)
+    {
+        return NULL;
+    }
+
+    if (!AmberLauncher_DirCreate(sRoot))
+    {
+        fprintf(stderr, "SObjectStore_Open() -> Can't create %s\n", sRoot);
+        return NULL;
+    }
+
+    pStore = (SObjectStore*)calloc(1, sizeof(SObjectStore));
+    if (!IS_VALID(pStore))
+    {
+        fprintf(stderr, "SObjectStore_Open() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    sCachePath          = _SObjectStore_Join(sRoot, SOBJSTORE_HASHCACHE_NAME);
+    pStore->sRoot       = (char*)malloc(strlen(sRoot) + 1);
+    pStore->pMutex      = SMutex_Create();
+    pStore->pHashCache  = sCachePath ? SHashCache_Load(sCachePath) : NULL;
+    free(sCachePath);
+
+    if (!pStore->sRoot || !pStore->pMutex || !pStore->pHashCache ||
+        !_SObjectStore_ArchiveRehash(pStore, SOBJSTORE_MIN_BUCKETS))
+    {
+        SObjectStore_Close(&pStore);
+        return NULL;
+    }
+
+    strcpy(pStore->sRoot, sRoot);
+    _SObjectStore_ArchiveLoad(pStore);
+
+    return pStore;
+}
+
+CAPI void
+SObjectStore_Close(SObjectStore **pStore)
+{
+    SObjectStore    *pSelf;
+    size_t          dIndex;
+
+    if (!pStore || !*pStore)
+    {
+        return;
+    }
+    pSelf = *pStore;
+
+    if (pSelf->pHashCache)
+    {
+        SHashCache_Save(pSelf->pHashCache);
+        SHashCache_delete(&pSelf->pHashCache);
+    }
+    if (pSelf->bArchiveDirty)
+    {
+        _SObjectStore_ArchiveSave(pSelf);
+    }
+
+    for (dIndex = 0; dIndex < pSelf->dNumArchive; ++dIndex)
+    {
+        free(pSelf->pArchive[dIndex].sKey);
+    }
+    free(pSelf->pArchive);
+    free(pSelf->pBuckets);
+    free(pSelf->sRoot);
+    SMutex_Destroy(&pSelf->pMutex);
+    free(pSelf);
+
+    *pStore = NULL;
+}
+
+CAPI CBOOL
+SObjectStore_Has(SObjectStore *pStore, const char *sSHA256)
+{
+    char    sActual[SOBJSTORE_SHA256_HEX_SIZE + 1];
+    char    *sObjectPath;
+    CBOOL   bResult = CFALSE;
+
+    if (!pStore || !_SObjectStore_ObjectPath(pStore, sSHA256, &sObjectPath))
+    {
+        return CFALSE;
+    }
+
+    /* Cheap when object is unchanged (size/mtime), rehash otherwise */
+    if (AmberLauncher_FileStat(sObjectPath, NULL, NULL) &&
+        SHashCache_HashFile(pStore->pHashCache, sObjectPath, sActual, NULL))
+    {
+        bResult = strcmp(sActual, sSHA256) == 0;
+        if (!bResult)
+        {
+            fprintf(stderr, "SObjectStore_Has() -> Dropping modified object %s\n", sSHA256);
+            remove(sObjectPath);
+        }
+    }
+    free(sObjectPath);
+
+    return bResult;
+}
+
+CAPI CBOOL
+SObjectStore_Import(
+    SObjectStore *pStore,
+    const char *sPath,
+    const char *sKnownSHA256,
+    char *sSHA256Out)
+{
+    /* Never hardlinked: source (mod file, game file) would share inode with
+     * object and everything installed from it, writing one changes all */
+    return _SObjectStore_ImportEx(pStore, sPath, sKnownSHA256, sSHA256Out, CFALSE);
+}
+
+CAPI CBOOL
+SObjectStore_ImportLinked(
+    SObjectStore *pStore,
+    const char *sPath,
+    const char *sKnownSHA256,
+    char *sSHA256Out)
+{
+    return _SObjectStore_ImportEx(pStore, sPath, sKnownSHA256, sSHA256Out, CTRUE);
+}
+
+CAPI uint32
+SObjectStore_Collect(SObjectStore *pStore, const char * const *pKeep, size_t dNumKeep)
+{
+    SObjectCollect  tCollect;
+    size_t          dIndex;
+
+    if (!pStore || (dNumKeep > 0 && !pKeep))
+    {
+        return 0;
+    }
+
+    memset(&tCollect, 0, sizeof(SObjectCollect));
+    tCollect.sRoot = pStore->sRoot;
+
+    SMutex_Lock(pStore->pMutex);
+    tCollect.pKeep = (const char**)malloc((dNumKeep + pStore->dNumArchive + 1) * sizeof(const char*));
+    if (tCollect.pKeep)
+    {
+        for (dIndex = 0; dIndex < dNumKeep; ++dIndex)
+        {
+            if (pKeep[dIndex])
+            {
+                tCollect.pKeep[tCollect.dNumKeep++] = pKeep[dIndex];
+            }
+        }
+        for (dIndex = 0; dIndex < pStore->dNumArchive; ++dIndex)
+        {
+            tCollect.pKeep[tCollect.dNumKeep++] = pStore->pArchive[dIndex].sSHA256;
+        }
+        qsort((void*)tCollect.pKeep, tCollect.dNumKeep, sizeof(const char*), _SObjectStore_CompareKeys);
+
+        AmberLauncher_DirIterate(pStore->sRoot, _SObjectStore_CollectDir, &tCollect);
+        free((void*)tCollect.pKeep);
+    }
+    SMutex_Unlock(pStore->pMutex);
+
+    return tCollect.dNumRemoved;
+}
+
+CAPI ESObjectLink
+SObjectStore_Install(SObjectStore *pStore, const char *sSHA256, const char *sDstPath)
+{
+    ESObjectLink    eLink = SOBJSTORE_LINK_NONE;
+    char            *sObjectPath;
+    char            *sTmpPath;
+
+    if (!pStore || !sDstPath || !SObjectStore_Has(pStore, sSHA256) ||
+        !_SObjectStore_ObjectPath(pStore, sSHA256, &sObjectPath))
+    {
+        return SOBJSTORE_LINK_NONE;
+    }
+
+    sTmpPath = _SObjectStore_TmpPath(pStore, sDstPath);
+    if (sTmpPath && _SObjectStore_EnsureParent(sDstPath))
+    {
+        eLink = _SObjectStore_Materialize(sObjectPath, sTmpPath, CTRUE);
+        if (eLink != SOBJSTORE_LINK_NONE && !AmberLauncher_FileReplace(sTmpPath, sDstPath))
+        {
+            eLink = SOBJSTORE_LINK_NONE;
+        }
+    }
+
+    if (sTmpPath)
+    {
+        remove(sTmpPath);
+    }
+    free(sTmpPath);
+    free(sObjectPath);
+
+    return eLink;
+}
+
+CAPI CBOOL
+SObjectStore_ArchiveLookup(SObjectStore *pStore, const char *sKey, char *sSHA256Out)
+{
+    SObjectArchiveEntry *pEntry;
+
+    if (!pStore || !sKey || !sSHA256Out)
+    {
+        return CFALSE;
+    }
+
+    SMutex_Lock(pStore->pMutex);
+    pEntry = _SObjectStore_ArchiveFind(pStore, sKey);
+    if (pEntry)
+    {
+        memcpy(sSHA256Out, pEntry->sSHA256, SOBJSTORE_SHA256_HEX_SIZE + 1);
+    }
+    SMutex_Unlock(pStore->pMutex);
+
+    return pEntry ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+SObjectStore_ArchiveRemember(SObjectStore *pStore, const char *sKey, const char *sSHA256)
+{
+    CBOOL bResult;
+
+    if (!pStore || !sKey || strchr(sKey, '\n') || !_SObjectStore_IsValidSHA256(sSHA256))
+    {
+        return CFALSE;
+    }
+
+    SMutex_Lock(pStore->pMutex);
+    bResult = _SObjectStore_ArchiveInsert(pStore, sKey, sSHA256);
+    pStore->bArchiveDirty = pStore->bArchiveDirty || bResult;
+    SMutex_Unlock(pStore->pMutex);
+
+    return bResult;
+}
+
+CAPI const char*
+SObjectStore_GetRoot(const SObjectStore *pStore)
+{
+    return pStore ? pStore->sRoot : NULL;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static char*
+_SObjectStore_Join(const char *sA, const char *sB)
+{
+    char *sResult = (char*)malloc(strlen(sA) + strlen(sB) + 2);
+
+    if (sResult)
+    {
+        sprintf(sResult, "%s/%s", sA, sB);
+    }
+
+    return sResult;
+}
+
+static CBOOL
+_SObjectStore_IsValidSHA256(const char *sSHA256)
+{
+    size_t i;
+
+    if (!sSHA256)
+    {
+        return CFALSE;
+    }
+
+    for (i = 0; i < SOBJSTORE_SHA256_HEX_SIZE; ++i)
+    {
+        if (!((sSHA256[i] >= '0' && sSHA256[i] <= '9') ||
+              (sSHA256[i] >= 'a' && sSHA256[i] <= 'f')))
+        {
+            return CFALSE;
+        }
+    }
+
+    return sSHA256[SOBJSTORE_SHA256_HEX_SIZE] == '\0';
+}
+
+/* "<root>/ab/abcdef..." */
+static CBOOL
+_SObjectStore_ObjectPath(const SObjectStore *pStore, const char *sSHA256, char **sPathOut)
+{
+    if (!_SObjectStore_IsValidSHA256(sSHA256))
+    {
+        return CFALSE;
+    }
+
+    *sPathOut = (char*)malloc(strlen(pStore->sRoot) + SOBJSTORE_SHA256_HEX_SIZE + 5);
+    if (!*sPathOut)
+    {
+        return CFALSE;
+    }
+    sprintf(*sPathOut, "%s/%.2s/%s", pStore->sRoot, sSHA256, sSHA256);
+
+    return CTRUE;
+}
+
+static CBOOL
+_SObjectStore_EnsureParent(const char *sPath)
+{
+    const char  *sSlash = strrchr(sPath, '/');
+    const char  *sBackslash = strrchr(sPath, '\\');
+    char        *sParent;
+    CBOOL       bResult;
+
+    if (sBackslash > sSlash)
+    {
+        sSlash = sBackslash;
+    }
+    if (!sSlash || sSlash == sPath)
+    {
+        return CTRUE;
+    }
+
+    sParent = (char*)malloc((size_t)(sSlash - sPath) + 1);
+    if (!sParent)
+    {
+        return CFALSE;
+    }
+    memcpy(sParent, sPath, (size_t)(sSlash - sPath));
+    sParent[sSlash - sPath] = '\0';
+
+    bResult = AmberLauncher_DirCreate(sParent);
+    free(sParent);
+
+    return bResult;
+}
+
+/* Unique per store, so concurrent imports of same object don't collide */
+static char*
+_SObjectStore_TmpPath(SObjectStore *pStore, const char *sPath)
+{
+    char    *sResult = (char*)malloc(strlen(sPath) + 24);
+    uint32  dCounter;
+
+    if (!sResult)
+    {
+        return NULL;
+    }
+
+    SMutex_Lock(pStore->pMutex);
+    dCounter = ++pStore->dTmpCounter;
+    SMutex_Unlock(pStore->pMutex);
+
+    sprintf(sResult, "%s.objtmp%u", sPath, dCounter);
+    remove(sResult);
+
+    return sResult;
+}
+
+/* Cheapest first: reflink shares blocks copy-on-write, hardlink shares inode */
+static ESObjectLink
+_SObjectStore_Materialize(const char *sSrcPath, const char *sDstPath, CBOOL bAllowLink)
+{
+    if (AmberLauncher_FileClone(sSrcPath, sDstPath))
+    {
+        return SOBJSTORE_LINK_REFLINK;
+    }
+    if (bAllowLink && AmberLauncher_FileLink(sSrcPath, sDstPath))
+    {
+        return SOBJSTORE_LINK_HARDLINK;
+    }
+    if (AmberLauncher_FileCopy(sSrcPath, sDstPath))
+    {
+        return SOBJSTORE_LINK_COPY;
+    }
+
+    return SOBJSTORE_LINK_NONE;
+}
+
+static CBOOL
+_SObjectStore_ImportEx(
+    SObjectStore *pStore,
+    const char *sPath,
+    const char *sKnownSHA256,
+    char *sSHA256Out,
+    CBOOL bAllowLink)
+{
+    char    sSHA256[SOBJSTORE_SHA256_HEX_SIZE + 1];
+    char    *sObjectPath;
+    char    *sTmpPath;
+    CBOOL   bResult;
+
+    if (!pStore || !sPath)
+    {
+        return CFALSE;
+    }
+
+    if (sKnownSHA256)
+    {
+        strncpy(sSHA256, sKnownSHA256, SOBJSTORE_SHA256_HEX_SIZE);
+        sSHA256[SOBJSTORE_SHA256_HEX_SIZE] = '\0';
+    }
+    else if (!SHashCache_HashFile(pStore->pHashCache, sPath, sSHA256, NULL))
+    {
+        return CFALSE;
+    }
+
+    if (sSHA256Out)
+    {
+        memcpy(sSHA256Out, sSHA256, SOBJSTORE_SHA256_HEX_SIZE + 1);
+    }
+
+    if (SObjectStore_Has(pStore, sSHA256))
+    {
+        return CTRUE;
+    }
+
+    if (!_SObjectStore_ObjectPath(pStore, sSHA256, &sObjectPath))
+    {
+        return CFALSE;
+    }
+
+    sTmpPath = _SObjectStore_TmpPath(pStore, sObjectPath);
+    bResult  = sTmpPath &&
+        _SObjectStore_EnsureParent(sObjectPath) &&
+        _SObjectStore_Materialize(sPath, sTmpPath, bAllowLink) != SOBJSTORE_LINK_NONE &&
+        AmberLauncher_FileReplace(sTmpPath, sObjectPath);
+
+    if (sTmpPath)
+    {
+        remove(sTmpPath);
+    }
+    free(sTmpPath);
+    free(sObjectPath);
+
+    return bResult;
+}
+
+static int
+_SObjectStore_CompareKeys(const void *pA, const void *pB)
+{
+    return strcmp(*(const char* const*)pA, *(const char* const*)pB);
+}
+
+/* Fan-out directories are the first two hex digits of sha256 */
+static CBOOL
+_SObjectStore_CollectDir(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    SObjectCollect *pCollect = (SObjectCollect*)pUserData;
+
+    if (eType != DIRENTRY_DIRECTORY || strlen(sName) != 2 ||
+        !strchr("0123456789abcdef", sName[0]) || !strchr("0123456789abcdef", sName[1]))
+    {
+        return CTRUE;
+    }
+
+    pCollect->sDir = _SObjectStore_Join(pCollect->sRoot, sName);
+    if (pCollect->sDir)
+    {
+        AmberLauncher_DirIterate(pCollect->sDir, _SObjectStore_CollectObject, pCollect);
+        free(pCollect->sDir);
+        pCollect->sDir = NULL;
+    }
+
+    return CTRUE;
+}
+
+static CBOOL
+_SObjectStore_CollectObject(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    SObjectCollect  *pCollect = (SObjectCollect*)pUserData;
+    char            *sPath;
+
+    if (eType != DIRENTRY_FILE || !_SObjectStore_IsValidSHA256(sName) ||
+        bsearch(&sName, pCollect->pKeep, pCollect->dNumKeep, sizeof(const char*),
+            _SObjectStore_CompareKeys))
+    {
+        return CTRUE;
+    }
+
+    sPath = _SObjectStore_Join(pCollect->sDir, sName);
+    if (sPath && remove(sPath) == 0)
+    {
+        ++pCollect->dNumRemoved;
+    }
+    free(sPath);
+
+    return CTRUE;
+}
+
+static uint32
+_SObjectStore_HashString(const char *sString)
+{
+    /* FNV-1a */
+    uint32 dHash = 2166136261u;
+
+    while (*sString)
+    {
+        dHash ^= (unsigned char)*sString++;
+        dHash *= 16777619u;
+    }
+
+    return dHash;
+}
+
+static SObjectArchiveEntry*
+_SObjectStore_ArchiveFind(SObjectStore *pStore, const char *sKey)
+{
+    const size_t    dMask = pStore->dNumBuckets - 1;
+    size_t          dBucket = _SObjectStore_HashString(sKey) & dMask;
+
+    while (pStore->pBuckets[dBucket] != 0)
+    {
+        SObjectArchiveEntry *pEntry = &pStore->pArchive[pStore->pBuckets[dBucket] - 1];
+
+        if (strcmp(pEntry->sKey, sKey) == 0)
+        {
+            return pEntry;
+        }
+        dBucket = (dBucket + 1) & dMask;
+    }
+
+    return NULL;
+}
+
+static CBOOL
+_SObjectStore_ArchiveInsert(SObjectStore *pStore, const char *sKey, const char *sSHA256)
+{
+    SObjectArchiveEntry *pEntry = _SObjectStore_ArchiveFind(pStore, sKey);
+    size_t              dBucket;
+
+    if (!pEntry)
+    {
+        if (pStore->dNumArchive == pStore->dMaxArchive)
+        {
+            const size_t        dNewMax = pStore->dMaxArchive ? pStore->dMaxArchive * 2 : 256;
+            SObjectArchiveEntry *pNew   = (SObjectArchiveEntry*)realloc(
+                pStore->pArchive, dNewMax * sizeof(SObjectArchiveEntry));
+
+            if (!pNew)
+            {
+                return CFALSE;
+            }
+            pStore->pArchive    = pNew;
+            pStore->dMaxArchive = dNewMax;
+        }
+
+        if ((pStore->dNumArchive + 1) * 2 > pStore->dNumBuckets &&
+            !_SObjectStore_ArchiveRehash(pStore, pStore->dNumBuckets * 2))
+        {
+            return CFALSE;
+        }
+
+        pEntry          = &pStore->pArchive[pStore->dNumArchive];
+        pEntry->sKey    = (char*)malloc(strlen(sKey) + 1);
+        if (!pEntry->sKey)
+        {
+            return CFALSE;
+        }
+        strcpy(pEntry->sKey, sKey);
+
+        dBucket = _SObjectStore_HashString(sKey) & (pStore->dNumBuckets - 1);
+        while (pStore->pBuckets[dBucket] != 0)
+        {
+            dBucket = (dBucket + 1) & (pStore->dNumBuckets - 1);
+        }
+        pStore->pBuckets[dBucket] = ++pStore->dNumArchive;
+    }
+
+    memcpy(pEntry->sSHA256, sSHA256, SOBJSTORE_SHA256_HEX_SIZE);
+    pEntry->sSHA256[SOBJSTORE_SHA256_HEX_SIZE] = '\0';
+
+    return CTRUE;
+}
+
+static CBOOL
+_SObjectStore_ArchiveRehash(SObjectStore *pStore, size_t dNumBuckets)
+{
+    size_t  *pBuckets = (size_t*)calloc(dNumBuckets, sizeof(size_t));
+    size_t  dIndex;
+
+    if (!pBuckets)
+    {
+        return CFALSE;
+    }
+
+    for (dIndex = 0; dIndex < pStore->dNumArchive; ++dIndex)
+    {
+        size_t dBucket = _SObjectStore_HashString(pStore->pArchive[dIndex].sKey) & (dNumBuckets - 1);
+
+        while (pBuckets[dBucket] != 0)
+        {
+            dBucket = (dBucket + 1) & (dNumBuckets - 1);
+        }
+        pBuckets[dBucket] = dIndex + 1;
+    }
+
+    free(pStore->pBuckets);
+    pStore->pBuckets    = pBuckets;
+    pStore->dNumBuckets = dNumBuckets;
+
+    return CTRUE;
+}
+
+/* "<sha256> <key>" per line */
+static void
+_SObjectStore_ArchiveLoad(SObjectStore *pStore)
+{
+    char    *sPath = _SObjectStore_Join(pStore->sRoot, SOBJSTORE_ARCHIVES_NAME);
+    char    *sLine = (char*)malloc(SOBJSTORE_LINE_SIZE);
+    FILE    *pFile = sPath ? fopen(sPath, "r") : NULL;
+
+    if (pFile && sLine &&
+        fgets(sLine, SOBJSTORE_LINE_SIZE, pFile) &&
+        strncmp(sLine, SOBJSTORE_ARCHIVES_HEADER, strlen(SOBJSTORE_ARCHIVES_HEADER)) == 0)
+    {
+        while (fgets(sLine, SOBJSTORE_LINE_SIZE, pFile))
+        {
+            size_t dLength = strlen(sLine);
+
+            if (dLength > 0 && sLine[dLength - 1] == '\n')
+            {
+                sLine[--dLength] = '\0';
+            }
+            if (dLength <= SOBJSTORE_SHA256_HEX_SIZE + 1 ||
+                sLine[SOBJSTORE_SHA256_HEX_SIZE] != ' ')
+            {
+                continue;
+            }
+
+            sLine[SOBJSTORE_SHA256_HEX_SIZE] = '\0';
+            if (_SObjectStore_IsValidSHA256(sLine))
+            {
+                _SObjectStore_ArchiveInsert(pStore, sLine + SOBJSTORE_SHA256_HEX_SIZE + 1, sLine);
+            }
+        }
+    }
+
+    if (pFile)
+    {
+        fclose(pFile);
+    }
+    free(sLine);
+    free(sPath);
+}
+
+static CBOOL
+_SObjectStore_ArchiveSave(SObjectStore *pStore)
+{
+    char    *sPath = _SObjectStore_Join(pStore->sRoot, SOBJSTORE_ARCHIVES_NAME);
+    char    *sTmpPath = sPath ? _SObjectStore_TmpPath(pStore, sPath) : NULL;
+    FILE    *pFile = sTmpPath ? fopen(sTmpPath, "w") : NULL;
+    size_t  dIndex;
+    CBOOL   bResult;
+
+    bResult = pFile && fprintf(pFile, "%s\n", SOBJSTORE_ARCHIVES_HEADER) > 0;
+    for (dIndex = 0; bResult && dIndex < pStore->dNumArchive; ++dIndex)
+    {
+        bResult = fprintf(pFile, "%s %s\n",
+            pStore->pArchive[dIndex].sSHA256,
+            pStore->pArchive[dIndex].sKey) > 0;
+    }
+
+    if (pFile)
+    {
+        bResult = AmberLauncher_FileSync(pFile) && bResult;
+        fclose(pFile);
+        bResult = bResult && AmberLauncher_FileReplace(sTmpPath, sPath);
+        if (!bResult)
+        {
+            remove(sTmpPath);
+        }
+    }
+    free(sTmpPath);
+    free(sPath);
+
+    return bResult;
+}
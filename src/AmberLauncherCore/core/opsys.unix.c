@@ -1,5 +1,7 @@
 #define _GNU_SOURCE /* temp: fix this bs and remove nappgui.h from common.h*/
+#define _FILE_OFFSET_BITS 64
 #include <core/opsys.h>
+#include <core/filecopy.h>
 
 #if defined(__unix__)
 
@@ -9,10 +11,19 @@
 #include <sys/wait.h>
 #include <sys/syscall.h>
 #include <sys/utsname.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <linux/fs.h>
 #endif
 
 #include <pthread.h>
 #include <unistd.h>
+#include <dirent.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <fcntl.h>
+#include <time.h>
 
 #include <stdio.h> 
 #include <stdlib.h>
@@ -47,6 +58,21 @@ _AmberLauncher_ConcatCharArray(
 static int 
 _AmberLauncher_IsWinePrefix64bit(const char* winePrefix);
 
+static void
+_AmberLauncher_FileCopyTimes(int dDst, const struct stat *pSrcStat);
+
+static int
+_AmberLauncher_DirEntryMode(int dDirFd, const struct dirent *pEntry);
+
+static CBOOL
+_AmberLauncher_TreeRemoveAt(int dDirFd, const char *sName, int dMode);
+
+static CBOOL
+_AmberLauncher_TreeMoveAt(
+    int dSrcDirFd, const char *sSrcName, const char *sSrcPath,
+    int dDstDirFd, const char *sDstName, const char *sDstPath
+);
+
 /******************************************************************************
  * HEADER FUNCTION DEFINITIONS
  ******************************************************************************/
@@ -126,6 +152,39 @@ AmberLauncher_GetThreadID(void)
     return (unsigned long)pthread_self();
 }
 
+CAPI uint64
+AmberLauncher_GetMonotonicTime(void)
+{
+    struct timespec tTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &tTime);
+
+    return (uint64)tTime.tv_sec * 1000000000 + (uint64)tTime.tv_nsec;
+}
+
+CAPI CBOOL
+AmberLauncher_DiskSpace(const char *sPath, uint64 *dFree, uint64 *dTotal)
+{
+    struct statvfs tStat;
+
+    if (!sPath || statvfs(sPath, &tStat) != 0)
+    {
+        return CFALSE;
+    }
+
+    /* f_bavail: what's left after blocks reserved for root */
+    if (dFree)
+    {
+        *dFree = (uint64)tStat.f_bavail * (uint64)tStat.f_frsize;
+    }
+    if (dTotal)
+    {
+        *dTotal = (uint64)tStat.f_blocks * (uint64)tStat.f_frsize;
+    }
+
+    return CTRUE;
+}
+
 CAPI void
 AmberLauncher_PrintDefaultSystemInformation(void)
 {
@@ -486,6 +545,204 @@ _AmberLauncher_IsWinePrefix64bit(const char* winePrefix)
     return 0;
 }
 
+/* Copy keeps source's mtime, same as hardlinked/cloned file would */
+static void
+_AmberLauncher_FileCopyTimes(int dDst, const struct stat *pSrcStat)
+{
+    struct timespec tTimes[2];
+
+    tTimes[0] = pSrcStat->st_atim;
+    tTimes[1] = pSrcStat->st_mtim;
+    futimens(dDst, tTimes);
+}
+
+/* File type bits (S_IFMT) without stat call when d_type is there, 0 on error */
+static int
+_AmberLauncher_DirEntryMode(int dDirFd, const struct dirent *pEntry)
+{
+    struct stat tStat;
+
+    switch (pEntry->d_type)
+    {
+        case DT_REG:    return S_IFREG;
+        case DT_DIR:    return S_IFDIR;
+        case DT_LNK:    return S_IFLNK;
+        default:        break;
+    }
+
+    if (fstatat(dDirFd, pEntry->d_name, &tStat, AT_SYMLINK_NOFOLLOW) != 0)
+    {
+        return 0;
+    }
+
+    return (int)(tStat.st_mode & S_IFMT);
+}
+
+/* Everything relative to parent's descriptor: no path building, no lookups
+ * of whole path per entry */
+static CBOOL
+_AmberLauncher_TreeRemoveAt(int dDirFd, const char *sName, int dMode)
+{
+    struct dirent   *pEntry;
+    DIR             *pDir;
+    int             dFd;
+    CBOOL           bResult = CTRUE;
+
+    if (dMode != S_IFDIR)
+    {
+        return (unlinkat(dDirFd, sName, 0) == 0 || errno == ENOENT) ? CTRUE : CFALSE;
+    }
+
+    dFd = openat(dDirFd, sName, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (dFd < 0)
+    {
+        return errno == ENOENT ? CTRUE : CFALSE;
+    }
+
+    pDir = fdopendir(dFd);
+    if (!pDir)
+    {
+        close(dFd);
+        return CFALSE;
+    }
+
+    while ((pEntry = readdir(pDir)) != NULL)
+    {
+        if (strcmp(pEntry->d_name, ".") == 0 || strcmp(pEntry->d_name, "..") == 0)
+        {
+            continue;
+        }
+
+        if (!_AmberLauncher_TreeRemoveAt(dFd, pEntry->d_name,
+            _AmberLauncher_DirEntryMode(dFd, pEntry)))
+        {
+            bResult = CFALSE;
+        }
+    }
+    closedir(pDir);
+
+    if (unlinkat(dDirFd, sName, AT_REMOVEDIR) != 0 && errno != ENOENT)
+    {
+        bResult = CFALSE;
+    }
+
+    return bResult;
+}
+
+/* Paths are only needed when tree crosses filesystems and has to be copied */
+static CBOOL
+_AmberLauncher_TreeMoveAt(
+    int dSrcDirFd, const char *sSrcName, const char *sSrcPath,
+    int dDstDirFd, const char *sDstName, const char *sDstPath)
+{
+    struct stat     tSrcStat;
+    struct stat     tDstStat;
+    struct dirent   *pEntry;
+    DIR             *pDir;
+    int             dSrcFd;
+    int             dDstFd;
+    char            sSrcChild[PATH_MAX];
+    char            sDstChild[PATH_MAX];
+    char            sTmpPath[PATH_MAX];
+    CBOOL           bDstExists;
+    CBOOL           bResult = CTRUE;
+    int             dError;
+
+    if (renameat(dSrcDirFd, sSrcName, dDstDirFd, sDstName) == 0)
+    {
+        return CTRUE;
+    }
+    dError = errno;
+
+    if (fstatat(dSrcDirFd, sSrcName, &tSrcStat, AT_SYMLINK_NOFOLLOW) != 0)
+    {
+        return CFALSE;
+    }
+    bDstExists = fstatat(dDstDirFd, sDstName, &tDstStat, AT_SYMLINK_NOFOLLOW) == 0;
+
+    if (!S_ISDIR(tSrcStat.st_mode))
+    {
+        /* Same filesystem and still failed: nothing else to try */
+        if (dError != EXDEV || !S_ISREG(tSrcStat.st_mode) ||
+            (bDstExists && S_ISDIR(tDstStat.st_mode)))
+        {
+            return CFALSE;
+        }
+
+        /* Destination may be hardlinked, so it's replaced, never truncated */
+        if (snprintf(sTmpPath, sizeof(sTmpPath), "%s%s", sDstPath, SFILECOPY_TMP_SUFFIX) >= (int)sizeof(sTmpPath))
+        {
+            return CFALSE;
+        }
+        if (!AmberLauncher_FileCopy(sSrcPath, sTmpPath) ||
+            !AmberLauncher_FileReplace(sTmpPath, sDstPath))
+        {
+            remove(sTmpPath);
+            return CFALSE;
+        }
+
+        return unlinkat(dSrcDirFd, sSrcName, 0) == 0 ? CTRUE : CFALSE;
+    }
+
+    /* Directory into existing directory (or other filesystem): merge.
+     * Anything else (e.g. moving into itself) is an error. */
+    if ((dError != EXDEV && dError != ENOTEMPTY && dError != EEXIST) ||
+        (bDstExists && !S_ISDIR(tDstStat.st_mode)))
+    {
+        return CFALSE;
+    }
+    if (!bDstExists && mkdirat(dDstDirFd, sDstName, tSrcStat.st_mode & 0777) != 0)
+    {
+        return CFALSE;
+    }
+
+    dSrcFd = openat(dSrcDirFd, sSrcName, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    dDstFd = openat(dDstDirFd, sDstName, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    pDir   = dSrcFd >= 0 ? fdopendir(dSrcFd) : NULL;
+    if (!pDir || dDstFd < 0)
+    {
+        if (pDir)
+        {
+            closedir(pDir);
+        }
+        else if (dSrcFd >= 0)
+        {
+            close(dSrcFd);
+        }
+        if (dDstFd >= 0)
+        {
+            close(dDstFd);
+        }
+        return CFALSE;
+    }
+
+    while ((pEntry = readdir(pDir)) != NULL)
+    {
+        if (strcmp(pEntry->d_name, ".") == 0 || strcmp(pEntry->d_name, "..") == 0)
+        {
+            continue;
+        }
+
+        snprintf(sSrcChild, sizeof(sSrcChild), "%s/%s", sSrcPath, pEntry->d_name);
+        snprintf(sDstChild, sizeof(sDstChild), "%s/%s", sDstPath, pEntry->d_name);
+        if (!_AmberLauncher_TreeMoveAt(dSrcFd, pEntry->d_name, sSrcChild,
+            dDstFd, pEntry->d_name, sDstChild))
+        {
+            bResult = CFALSE;
+        }
+    }
+    closedir(pDir);
+    close(dDstFd);
+
+    /* Fails (and keeps source) if anything was left behind */
+    if (unlinkat(dSrcDirFd, sSrcName, AT_REMOVEDIR) != 0)
+    {
+        bResult = CFALSE;
+    }
+
+    return bResult;
+}
+
 CAPI int
 AmberLauncher_RunSystemCommand(const char* sCmd)
 {
@@ -520,4 +777,480 @@ AmberLauncher_RunSystemCommand(const char* sCmd)
     return -1;
 }
 
+CAPI CBOOL
+AmberLauncher_FileReplace(const char *sSrcPath, const char *sDstPath)
+{
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+    /* rename(2) replaces destination atomically within one filesystem */
+    if (rename(sSrcPath, sDstPath) != 0)
+    {
+        fprintf(stderr, "Failed to replace '%s' with '%s': %s\n",
+            sDstPath, sSrcPath, strerror(errno));
+        return CFALSE;
+    }
+
+    return CTRUE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileRename(const char *sSrcPath, const char *sDstPath)
+{
+    struct stat tSrcStat;
+    struct stat tDstStat;
+
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+#if defined(__linux__) && defined(SYS_renameat2) && defined(RENAME_NOREPLACE)
+    /* Atomic check, no window for something to appear at destination */
+    if (syscall(SYS_renameat2, AT_FDCWD, sSrcPath, AT_FDCWD, sDstPath, RENAME_NOREPLACE) == 0)
+    {
+        return CTRUE;
+    }
+    if (errno != EEXIST && errno != EINVAL && errno != ENOSYS)
+    {
+        return CFALSE;
+    }
+#endif
+
+    /* Unsupported by filesystem, or case-insensitive one sees both names as
+     * the same entry: then plain rename only changes case */
+    if (lstat(sDstPath, &tDstStat) == 0 &&
+        (lstat(sSrcPath, &tSrcStat) != 0 ||
+         tSrcStat.st_dev != tDstStat.st_dev || tSrcStat.st_ino != tDstStat.st_ino))
+    {
+        errno = EEXIST;
+        return CFALSE;
+    }
+
+    return rename(sSrcPath, sDstPath) == 0 ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileSync(FILE *pFile)
+{
+    if (!pFile || fflush(pFile) != 0)
+    {
+        return CFALSE;
+    }
+
+    return fsync(fileno(pFile)) == 0 ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileSeek(FILE *pFile, int64 dOffset, int dOrigin)
+{
+    return pFile && fseeko(pFile, (off_t)dOffset, dOrigin) == 0 ? CTRUE : CFALSE;
+}
+
+CAPI int64
+AmberLauncher_FileTell(FILE *pFile)
+{
+    return pFile ? (int64)ftello(pFile) : -1;
+}
+
+CAPI CBOOL
+AmberLauncher_FileStat(const char *sPath, uint64 *dSize, int64 *dModTime)
+{
+    struct stat tStat;
+
+    if (!sPath || stat(sPath, &tStat) != 0)
+    {
+        return CFALSE;
+    }
+
+    if (dSize)
+    {
+        *dSize = (uint64)tStat.st_size;
+    }
+    if (dModTime)
+    {
+        *dModTime = (int64)tStat.st_mtim.tv_sec * 1000000000 + (int64)tStat.st_mtim.tv_nsec;
+    }
+
+    return CTRUE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileIdentity(const char *sPath, uint64 *dDevice, uint64 *dInode, CBOOL *bDirectory)
+{
+    struct stat tStat;
+
+    if (!sPath || !dDevice || !dInode || stat(sPath, &tStat) != 0)
+    {
+        return CFALSE;
+    }
+
+    *dDevice    = (uint64)tStat.st_dev;
+    *dInode     = (uint64)tStat.st_ino;
+    if (bDirectory)
+    {
+        *bDirectory = S_ISDIR(tStat.st_mode) ? CTRUE : CFALSE;
+    }
+
+    return CTRUE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileSetModTime(const char *sPath, int64 dModTime)
+{
+    struct timespec tTimes[2];
+
+    if (!sPath)
+    {
+        return CFALSE;
+    }
+
+    tTimes[0].tv_sec    = 0;
+    tTimes[0].tv_nsec   = UTIME_OMIT;
+    tTimes[1].tv_sec    = (time_t)(dModTime / 1000000000);
+    tTimes[1].tv_nsec   = (long)(dModTime % 1000000000);
+
+    return utimensat(AT_FDCWD, sPath, tTimes, 0) == 0 ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_DirIterate(const char *sPath, FDirEntryCallback cbEntry, void *pUserData)
+{
+    DIR             *pDir;
+    struct dirent   *pEntry;
+    char            sFullPath[PATH_MAX];
+    struct stat     tStat;
+    EDirEntryType   eType;
+    CBOOL           bResult = CTRUE;
+
+    if (!sPath || !cbEntry)
+    {
+        return CFALSE;
+    }
+
+    pDir = opendir(sPath);
+    if (!pDir)
+    {
+        return CFALSE;
+    }
+
+    while (bResult && (pEntry = readdir(pDir)) != NULL)
+    {
+        if (strcmp(pEntry->d_name, ".") == 0 || strcmp(pEntry->d_name, "..") == 0)
+        {
+            continue;
+        }
+
+        switch (pEntry->d_type)
+        {
+            case DT_REG:
+                eType = DIRENTRY_FILE;
+                break;
+            case DT_DIR:
+                eType = DIRENTRY_DIRECTORY;
+                break;
+            case DT_UNKNOWN:
+                /* Some filesystems don't fill d_type */
+                snprintf(sFullPath, sizeof(sFullPath), "%s/%s", sPath, pEntry->d_name);
+                if (lstat(sFullPath, &tStat) != 0)
+                {
+                    eType = DIRENTRY_OTHER;
+                }
+                else if (S_ISREG(tStat.st_mode))
+                {
+                    eType = DIRENTRY_FILE;
+                }
+                else
+                {
+                    eType = S_ISDIR(tStat.st_mode) ? DIRENTRY_DIRECTORY : DIRENTRY_OTHER;
+                }
+                break;
+            default:
+                eType = DIRENTRY_OTHER;
+                break;
+        }
+
+        bResult = cbEntry(pEntry->d_name, eType, pUserData);
+    }
+    closedir(pDir);
+
+    return bResult;
+}
+
+CAPI CBOOL
+AmberLauncher_DirIterateInfo(
+    const char *sPath, CBOOL bStat, FDirEntryInfoCallback cbEntry, void *pUserData)
+{
+    DIR             *pDir;
+    struct dirent   *pEntry;
+    struct stat     tStat;
+    SDirEntryInfo   tInfo;
+    int             dFd;
+    int             dMode;
+    CBOOL           bResult = CTRUE;
+
+    if (!sPath || !cbEntry)
+    {
+        return CFALSE;
+    }
+
+    pDir = opendir(sPath);
+    if (!pDir)
+    {
+        return CFALSE;
+    }
+    dFd = dirfd(pDir);
+
+    while (bResult && (pEntry = readdir(pDir)) != NULL)
+    {
+        if (strcmp(pEntry->d_name, ".") == 0 || strcmp(pEntry->d_name, "..") == 0)
+        {
+            continue;
+        }
+
+        memset(&tInfo, 0, sizeof(tInfo));
+        tInfo.sName = pEntry->d_name;
+
+        if (!bStat)
+        {
+            dMode = _AmberLauncher_DirEntryMode(dFd, pEntry);
+        }
+        else if (fstatat(dFd, pEntry->d_name, &tStat, AT_SYMLINK_NOFOLLOW) == 0)
+        {
+            dMode           = (int)(tStat.st_mode & S_IFMT);
+            tInfo.dSize     = (uint64)tStat.st_size;
+            tInfo.dModTime  = (int64)tStat.st_mtim.tv_sec * 1000000000 +
+                              (int64)tStat.st_mtim.tv_nsec;
+        }
+        else
+        {
+            dMode = 0;
+        }
+
+        tInfo.eType = dMode == S_IFREG ? DIRENTRY_FILE :
+                      dMode == S_IFDIR ? DIRENTRY_DIRECTORY : DIRENTRY_OTHER;
+
+        bResult = cbEntry(&tInfo, pUserData);
+    }
+    closedir(pDir);
+
+    return bResult;
+}
+
+CAPI CBOOL
+AmberLauncher_DirCreate(const char *sPath)
+{
+    char    sBuffer[PATH_MAX];
+    char    *p;
+    size_t  dLength;
+
+    if (!sPath || (dLength = strlen(sPath)) == 0 || dLength >= sizeof(sBuffer))
+    {
+        return CFALSE;
+    }
+    memcpy(sBuffer, sPath, dLength + 1);
+
+    for (p = sBuffer + 1; *p; ++p)
+    {
+        if (*p == '/')
+        {
+            *p = '\0';
+            if (mkdir(sBuffer, 0755) != 0 && errno != EEXIST)
+            {
+                return CFALSE;
+            }
+            *p = '/';
+        }
+    }
+
+    return (mkdir(sBuffer, 0755) == 0 || errno == EEXIST) ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileLink(const char *sSrcPath, const char *sDstPath)
+{
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+    return link(sSrcPath, sDstPath) == 0 ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileClone(const char *sSrcPath, const char *sDstPath)
+{
+#if defined(FICLONE)
+    struct stat tStat;
+    int         dSrc;
+    int         dDst;
+    CBOOL       bResult;
+
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+    dSrc = open(sSrcPath, O_RDONLY);
+    if (dSrc < 0)
+    {
+        return CFALSE;
+    }
+    if (fstat(dSrc, &tStat) != 0)
+    {
+        close(dSrc);
+        return CFALSE;
+    }
+
+    dDst = open(sDstPath, O_WRONLY | O_CREAT | O_EXCL, tStat.st_mode & 0777);
+    if (dDst < 0)
+    {
+        close(dSrc);
+        return CFALSE;
+    }
+
+    /* Shares extents with source, blocks get copied only when written */
+    bResult = ioctl(dDst, FICLONE, dSrc) == 0 ? CTRUE : CFALSE;
+    close(dDst);
+    close(dSrc);
+
+    if (!bResult)
+    {
+        unlink(sDstPath);
+    }
+
+    return bResult;
+#else
+    UNUSED(sSrcPath);
+    UNUSED(sDstPath);
+    return CFALSE;
+#endif
+}
+
+CAPI CBOOL
+AmberLauncher_FileCopy(const char *sSrcPath, const char *sDstPath)
+{
+    static const size_t BUFFER_SIZE = 64 * 1024;
+    struct stat tStat;
+    char        *pBuffer;
+    ssize_t     dRead = 0;
+    int         dSrc;
+    int         dDst;
+    CBOOL       bResult = CTRUE;
+
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+    dSrc = open(sSrcPath, O_RDONLY);
+    if (dSrc < 0)
+    {
+        return CFALSE;
+    }
+    if (fstat(dSrc, &tStat) != 0)
+    {
+        close(dSrc);
+        return CFALSE;
+    }
+
+    dDst = open(sDstPath, O_WRONLY | O_CREAT | O_TRUNC, tStat.st_mode & 0777);
+    if (dDst < 0)
+    {
+        close(dSrc);
+        return CFALSE;
+    }
+
+#if defined(__linux__)
+    /* In-kernel copy (may reflink on its own), then sendfile (works across
+     * filesystems on older kernels), then read/write */
+    {
+        off_t dLeft = tStat.st_size;
+
+        while (dLeft > 0 && (dRead = copy_file_range(dSrc, NULL, dDst, NULL, (size_t)dLeft, 0)) > 0)
+        {
+            dLeft -= dRead;
+        }
+        while (dLeft > 0 && (dRead = sendfile(dDst, dSrc, NULL, (size_t)dLeft)) > 0)
+        {
+            dLeft -= dRead;
+        }
+        if (dLeft == 0)
+        {
+            _AmberLauncher_FileCopyTimes(dDst, &tStat);
+            close(dDst);
+            close(dSrc);
+            return CTRUE;
+        }
+
+        /* Unsupported (EXDEV, ENOSYS...): file offsets are where kernel stopped */
+        dRead = 0;
+    }
+#endif
+
+    pBuffer = (char*)malloc(BUFFER_SIZE);
+    if (!pBuffer)
+    {
+        bResult = CFALSE;
+    }
+
+    while (bResult && (dRead = read(dSrc, pBuffer, BUFFER_SIZE)) > 0)
+    {
+        const char *p = pBuffer;
+
+        while (dRead > 0)
+        {
+            const ssize_t dWritten = write(dDst, p, (size_t)dRead);
+
+            if (dWritten <= 0)
+            {
+                bResult = CFALSE;
+                break;
+            }
+            p       += dWritten;
+            dRead   -= dWritten;
+        }
+    }
+    if (dRead < 0)
+    {
+        bResult = CFALSE;
+    }
+    if (bResult)
+    {
+        _AmberLauncher_FileCopyTimes(dDst, &tStat);
+    }
+
+    free(pBuffer);
+    close(dDst);
+    close(dSrc);
+
+    return bResult;
+}
+
+CAPI CBOOL
+AmberLauncher_TreeRemove(const char *sPath)
+{
+    struct stat tStat;
+
+    if (!sPath || lstat(sPath, &tStat) != 0)
+    {
+        return CFALSE;
+    }
+
+    return _AmberLauncher_TreeRemoveAt(AT_FDCWD, sPath, (int)(tStat.st_mode & S_IFMT));
+}
+
+CAPI CBOOL
+AmberLauncher_TreeMove(const char *sSrcPath, const char *sDstPath)
+{
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+    return _AmberLauncher_TreeMoveAt(AT_FDCWD, sSrcPath, sSrcPath, AT_FDCWD, sDstPath, sDstPath);
+}
+
 #endif
@@ -1,12 +1,15 @@
 #include <core/opsys.h>
+#include <core/filecopy.h>
 
 #if defined(_WIN32) || defined(_WIN64)
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <windows.h>
 #include <direct.h>
+#include <io.h>
 
 /******************************************************************************
  * HEADER FUNCTION DEFINITIONS
@@ -94,6 +97,43 @@ AmberLauncher_GetThreadID(void)
     return GetCurrentThreadId();
 }
 
+CAPI uint64
+AmberLauncher_GetMonotonicTime(void)
+{
+    LARGE_INTEGER tFrequency;
+    LARGE_INTEGER tCounter;
+
+    QueryPerformanceFrequency(&tFrequency);
+    QueryPerformanceCounter(&tCounter);
+
+    /* Split to avoid overflow of counter * 1e9 */
+    return (uint64)(tCounter.QuadPart / tFrequency.QuadPart) * 1000000000 +
+        (uint64)(tCounter.QuadPart % tFrequency.QuadPart) * 1000000000 / (uint64)tFrequency.QuadPart;
+}
+
+CAPI CBOOL
+AmberLauncher_DiskSpace(const char *sPath, uint64 *dFree, uint64 *dTotal)
+{
+    ULARGE_INTEGER tFree;
+    ULARGE_INTEGER tTotal;
+
+    if (!sPath || !GetDiskFreeSpaceExA(sPath, &tFree, &tTotal, NULL))
+    {
+        return CFALSE;
+    }
+
+    if (dFree)
+    {
+        *dFree = (uint64)tFree.QuadPart;
+    }
+    if (dTotal)
+    {
+        *dTotal = (uint64)tTotal.QuadPart;
+    }
+
+    return CTRUE;
+}
+
 CAPI void
 AmberLauncher_PrintDefaultSystemInformation(void)
 {
@@ -369,4 +409,478 @@ AmberLauncher_RunSystemCommand(const char* sCmd)
     return (int)dExitCode;
 }
 
+CAPI CBOOL
+AmberLauncher_FileReplace(const char *sSrcPath, const char *sDstPath)
+{
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+    if (!MoveFileExA(sSrcPath, sDstPath, 
+        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        fprintf(stderr, "Failed to replace '%s' with '%s' (%lu)\n",
+            sDstPath, sSrcPath, GetLastError());
+        return CFALSE;
+    }
+
+    return CTRUE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileRename(const char *sSrcPath, const char *sDstPath)
+{
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+    /* Without MOVEFILE_REPLACE_EXISTING fails on existing destination,
+     * case-only rename of same entry is allowed */
+    return MoveFileExA(sSrcPath, sDstPath, 0) ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileSync(FILE *pFile)
+{
+    if (!pFile || fflush(pFile) != 0)
+    {
+        return CFALSE;
+    }
+
+    return _commit(_fileno(pFile)) == 0 ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileSeek(FILE *pFile, int64 dOffset, int dOrigin)
+{
+    return pFile && _fseeki64(pFile, (__int64)dOffset, dOrigin) == 0 ? CTRUE : CFALSE;
+}
+
+CAPI int64
+AmberLauncher_FileTell(FILE *pFile)
+{
+    return pFile ? (int64)_ftelli64(pFile) : -1;
+}
+
+CAPI CBOOL
+AmberLauncher_FileStat(const char *sPath, uint64 *dSize, int64 *dModTime)
+{
+    WIN32_FILE_ATTRIBUTE_DATA   tData;
+    ULARGE_INTEGER              tTime;
+
+    if (!sPath || !GetFileAttributesExA(sPath, GetFileExInfoStandard, &tData))
+    {
+        return CFALSE;
+    }
+
+    if (dSize)
+    {
+        *dSize = (uint64)(((unsigned long long)tData.nFileSizeHigh << 32) | tData.nFileSizeLow);
+    }
+    if (dModTime)
+    {
+        /* FILETIME: 100ns ticks since 1601-01-01 */
+        tTime.LowPart   = tData.ftLastWriteTime.dwLowDateTime;
+        tTime.HighPart  = tData.ftLastWriteTime.dwHighDateTime;
+        *dModTime       = (int64)(tTime.QuadPart - 116444736000000000ULL) * 100;
+    }
+
+    return CTRUE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileIdentity(const char *sPath, uint64 *dDevice, uint64 *dInode, CBOOL *bDirectory)
+{
+    BY_HANDLE_FILE_INFORMATION  tInfo;
+    HANDLE                      hFile;
+    BOOL                        bResult;
+
+    if (!sPath || !dDevice || !dInode)
+    {
+        return CFALSE;
+    }
+
+    /* Backup semantics are needed to open directories, reparse points are followed */
+    hFile = CreateFileA(sPath, 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return CFALSE;
+    }
+    bResult = GetFileInformationByHandle(hFile, &tInfo);
+    CloseHandle(hFile);
+    if (!bResult)
+    {
+        return CFALSE;
+    }
+
+    *dDevice    = (uint64)tInfo.dwVolumeSerialNumber;
+    *dInode     = ((uint64)tInfo.nFileIndexHigh << 32) | tInfo.nFileIndexLow;
+    if (bDirectory)
+    {
+        *bDirectory = (tInfo.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? CTRUE : CFALSE;
+    }
+
+    return CTRUE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileSetModTime(const char *sPath, int64 dModTime)
+{
+    HANDLE          hFile;
+    FILETIME        tFileTime;
+    ULARGE_INTEGER  tTime;
+    BOOL            bResult;
+
+    if (!sPath)
+    {
+        return CFALSE;
+    }
+
+    hFile = CreateFileA(sPath, FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return CFALSE;
+    }
+
+    tTime.QuadPart              = (ULONGLONG)(dModTime / 100) + 116444736000000000ULL;
+    tFileTime.dwLowDateTime     = tTime.LowPart;
+    tFileTime.dwHighDateTime    = tTime.HighPart;
+
+    bResult = SetFileTime(hFile, NULL, NULL, &tFileTime);
+    CloseHandle(hFile);
+
+    return bResult ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_DirIterate(const char *sPath, FDirEntryCallback cbEntry, void *pUserData)
+{
+    WIN32_FIND_DATAA    tData;
+    HANDLE              hFind;
+    char                sPattern[MAX_PATH];
+    EDirEntryType       eType;
+    CBOOL               bResult = CTRUE;
+
+    if (!sPath || !cbEntry)
+    {
+        return CFALSE;
+    }
+
+    snprintf(sPattern, sizeof(sPattern), "%s\\*", sPath);
+    hFind = FindFirstFileA(sPattern, &tData);
+    if (hFind == INVALID_HANDLE_VALUE)
+    {
+        return CFALSE;
+    }
+
+    do
+    {
+        if (strcmp(tData.cFileName, ".") == 0 || strcmp(tData.cFileName, "..") == 0)
+        {
+            continue;
+        }
+
+        if (tData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+        {
+            eType = DIRENTRY_OTHER;
+        }
+        else if (tData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            eType = DIRENTRY_DIRECTORY;
+        }
+        else
+        {
+            eType = DIRENTRY_FILE;
+        }
+
+        bResult = cbEntry(tData.cFileName, eType, pUserData);
+    } while (bResult && FindNextFileA(hFind, &tData));
+    FindClose(hFind);
+
+    return bResult;
+}
+
+CAPI CBOOL
+AmberLauncher_DirIterateInfo(
+    const char *sPath, CBOOL bStat, FDirEntryInfoCallback cbEntry, void *pUserData)
+{
+    WIN32_FIND_DATAA    tData;
+    HANDLE              hFind;
+    ULARGE_INTEGER      tTime;
+    char                sPattern[MAX_PATH];
+    SDirEntryInfo       tInfo;
+    CBOOL               bResult = CTRUE;
+
+    /* Size and time come with every entry anyway */
+    UNUSED(bStat);
+
+    if (!sPath || !cbEntry)
+    {
+        return CFALSE;
+    }
+
+    snprintf(sPattern, sizeof(sPattern), "%s\\*", sPath);
+    hFind = FindFirstFileExA(sPattern, FindExInfoBasic, &tData,
+        FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (hFind == INVALID_HANDLE_VALUE)
+    {
+        return CFALSE;
+    }
+
+    do
+    {
+        if (strcmp(tData.cFileName, ".") == 0 || strcmp(tData.cFileName, "..") == 0)
+        {
+            continue;
+        }
+
+        tInfo.sName     = tData.cFileName;
+        tInfo.dSize     = (uint64)(((unsigned long long)tData.nFileSizeHigh << 32) | tData.nFileSizeLow);
+        tTime.LowPart   = tData.ftLastWriteTime.dwLowDateTime;
+        tTime.HighPart  = tData.ftLastWriteTime.dwHighDateTime;
+        tInfo.dModTime  = (int64)(tTime.QuadPart - 116444736000000000ULL) * 100;
+
+        if (tData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+        {
+            tInfo.eType = DIRENTRY_OTHER;
+        }
+        else if (tData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            tInfo.eType = DIRENTRY_DIRECTORY;
+            tInfo.dSize = 0;
+        }
+        else
+        {
+            tInfo.eType = DIRENTRY_FILE;
+        }
+
+        bResult = cbEntry(&tInfo, pUserData);
+    } while (bResult && FindNextFileA(hFind, &tData));
+    FindClose(hFind);
+
+    return bResult;
+}
+
+CAPI CBOOL
+AmberLauncher_DirCreate(const char *sPath)
+{
+    char    sBuffer[MAX_PATH];
+    char    *p;
+    size_t  dLength;
+
+    if (!sPath || (dLength = strlen(sPath)) == 0 || dLength >= sizeof(sBuffer))
+    {
+        return CFALSE;
+    }
+    memcpy(sBuffer, sPath, dLength + 1);
+
+    for (p = sBuffer + 1; *p; ++p)
+    {
+        /* Skip drive root ("C:\") */
+        if ((*p == '/' || *p == '\\') && *(p - 1) != ':')
+        {
+            const char cSeparator = *p;
+
+            *p = '\0';
+            if (!CreateDirectoryA(sBuffer, NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+            {
+                return CFALSE;
+            }
+            *p = cSeparator;
+        }
+    }
+
+    return (CreateDirectoryA(sBuffer, NULL) || GetLastError() == ERROR_ALREADY_EXISTS) ? 
+        CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileLink(const char *sSrcPath, const char *sDstPath)
+{
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+    /* NTFS only; FAT/exFAT volumes fail here and callers fall back to copy */
+    return CreateHardLinkA(sDstPath, sSrcPath, NULL) ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileClone(const char *sSrcPath, const char *sDstPath)
+{
+    /* @todo ReFS block cloning (FSCTL_DUPLICATE_EXTENTS_TO_FILE) */
+    UNUSED(sSrcPath);
+    UNUSED(sDstPath);
+
+    return CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_FileCopy(const char *sSrcPath, const char *sDstPath)
+{
+    if (!sSrcPath || !sDstPath)
+    {
+        return CFALSE;
+    }
+
+    return CopyFileA(sSrcPath, sDstPath, FALSE) ? CTRUE : CFALSE;
+}
+
+CAPI CBOOL
+AmberLauncher_TreeRemove(const char *sPath)
+{
+    WIN32_FIND_DATAA    tData;
+    HANDLE              hFind;
+    DWORD               dAttributes;
+    char                sPattern[MAX_PATH];
+    char                sChild[MAX_PATH];
+    CBOOL               bResult = CTRUE;
+
+    if (!sPath || (dAttributes = GetFileAttributesA(sPath)) == INVALID_FILE_ATTRIBUTES)
+    {
+        return CFALSE;
+    }
+
+    /* Read-only files can't be deleted until attribute is cleared */
+    if (dAttributes & FILE_ATTRIBUTE_READONLY)
+    {
+        SetFileAttributesA(sPath, dAttributes & ~(DWORD)FILE_ATTRIBUTE_READONLY);
+    }
+
+    /* Junctions are removed as directories, their target is left alone */
+    if (!(dAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        return DeleteFileA(sPath) ? CTRUE : CFALSE;
+    }
+    if (dAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+    {
+        return RemoveDirectoryA(sPath) ? CTRUE : CFALSE;
+    }
+
+    snprintf(sPattern, sizeof(sPattern), "%s\\*", sPath);
+    hFind = FindFirstFileA(sPattern, &tData);
+    if (hFind != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (strcmp(tData.cFileName, ".") == 0 || strcmp(tData.cFileName, "..") == 0)
+            {
+                continue;
+            }
+
+            snprintf(sChild, sizeof(sChild), "%s\\%s", sPath, tData.cFileName);
+            if (!AmberLauncher_TreeRemove(sChild))
+            {
+                bResult = CFALSE;
+            }
+        } while (FindNextFileA(hFind, &tData));
+        FindClose(hFind);
+    }
+
+    if (!RemoveDirectoryA(sPath))
+    {
+        bResult = CFALSE;
+    }
+
+    return bResult;
+}
+
+CAPI CBOOL
+AmberLauncher_TreeMove(const char *sSrcPath, const char *sDstPath)
+{
+    WIN32_FIND_DATAA    tData;
+    HANDLE              hFind;
+    DWORD               dSrcAttributes;
+    DWORD               dDstAttributes;
+    char                sPattern[MAX_PATH];
+    char                sSrcChild[MAX_PATH];
+    char                sDstChild[MAX_PATH];
+    char                sTmpPath[MAX_PATH];
+    CBOOL               bResult = CTRUE;
+
+    if (!sSrcPath || !sDstPath ||
+        (dSrcAttributes = GetFileAttributesA(sSrcPath)) == INVALID_FILE_ATTRIBUTES)
+    {
+        return CFALSE;
+    }
+    dDstAttributes = GetFileAttributesA(sDstPath);
+
+    /* Files: rename, or copy and delete when on another volume */
+    if (!(dSrcAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        if (dDstAttributes != INVALID_FILE_ATTRIBUTES && (dDstAttributes & FILE_ATTRIBUTE_DIRECTORY))
+        {
+            return CFALSE;
+        }
+        if (MoveFileExA(sSrcPath, sDstPath, MOVEFILE_REPLACE_EXISTING))
+        {
+            return CTRUE;
+        }
+
+        /* Destination may be hardlinked, so it's replaced, never overwritten */
+        if (GetLastError() != ERROR_NOT_SAME_DEVICE ||
+            snprintf(sTmpPath, sizeof(sTmpPath), "%s%s", sDstPath, SFILECOPY_TMP_SUFFIX) >= (int)sizeof(sTmpPath))
+        {
+            return CFALSE;
+        }
+        if (!CopyFileA(sSrcPath, sTmpPath, FALSE) ||
+            !MoveFileExA(sTmpPath, sDstPath, MOVEFILE_REPLACE_EXISTING))
+        {
+            DeleteFileA(sTmpPath);
+            return CFALSE;
+        }
+        return DeleteFileA(sSrcPath) ? CTRUE : CFALSE;
+    }
+
+    if (dDstAttributes == INVALID_FILE_ATTRIBUTES)
+    {
+        /* Whole tree at once, works only within same volume */
+        if (MoveFileExA(sSrcPath, sDstPath, 0))
+        {
+            return CTRUE;
+        }
+        if (!CreateDirectoryA(sDstPath, NULL))
+        {
+            return CFALSE;
+        }
+    }
+    else if (!(dDstAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        return CFALSE;
+    }
+
+    snprintf(sPattern, sizeof(sPattern), "%s\\*", sSrcPath);
+    hFind = FindFirstFileA(sPattern, &tData);
+    if (hFind != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (strcmp(tData.cFileName, ".") == 0 || strcmp(tData.cFileName, "..") == 0)
+            {
+                continue;
+            }
+
+            snprintf(sSrcChild, sizeof(sSrcChild), "%s\\%s", sSrcPath, tData.cFileName);
+            snprintf(sDstChild, sizeof(sDstChild), "%s\\%s", sDstPath, tData.cFileName);
+            if (!AmberLauncher_TreeMove(sSrcChild, sDstChild))
+            {
+                bResult = CFALSE;
+            }
+        } while (FindNextFileA(hFind, &tData));
+        FindClose(hFind);
+    }
+
+    if (!RemoveDirectoryA(sSrcPath))
+    {
+        bResult = CFALSE;
+    }
+
+    return bResult;
+}
+
 #endif
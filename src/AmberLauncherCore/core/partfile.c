@@ -0,0 +1,786 @@
+#include <core/partfile.h>
+#include <core/filecopy.h>
+#include <core/opsys.h>
+
+#include <ext/miniz.h>
+#include <ext/sha256.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SPARTFILE_BUFFER_SIZE           65536
+#define SPARTFILE_JOURNAL_MAGIC         "ALPJ"
+#define SPARTFILE_JOURNAL_VERSION       2
+#define SPARTFILE_INFLATE_FLAGS         (TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT)
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+/*
+ * On-disk journal layout (native endianness, same machine only):
+ * header | path | SHA256_Context | [tinfl_decompressor | dictionary]
+ * Inflater state is only present for packed downloads.
+ */
+typedef struct SPartJournalHeader
+{
+    char            sMagic[4];
+    uint32          dVersion;
+    uint32          dPathLength;
+    uint32          dHashCtxSize;
+    uint32          dInflaterSize;
+    uint32          dDictOffset;
+    uint64          dExpectedSize;
+    uint64          dOffset;
+    uint64          dPackedSize;
+    uint64          dPackedOffset;
+    char            sExpectedSHA256[SPARTFILE_SHA256_HEX_SIZE + 1];
+} SPartJournalHeader;
+
+/* Streaming inflater for packed (.deflate) downloads */
+typedef struct SPartInflater
+{
+    tinfl_decompressor  tState;
+    mz_uint8            pDict[TINFL_LZ_DICT_SIZE];
+    size_t              dDictOffset;
+    CBOOL               bDone;
+} SPartInflater;
+
+struct SPartFile
+{
+    FILE            *pFile;
+    char            *sPath;
+    char            *sPartPath;
+    char            *sSpoolPath;
+    char            *sJournalPath;
+    char            sExpectedSHA256[SPARTFILE_SHA256_HEX_SIZE + 1];
+    uint64          dExpectedSize;
+    uint64          dOffset;
+    uint64          dPackedSize;
+    uint64          dPackedOffset;
+    SPartInflater   *pInflater;     /**< NULL for plain downloads */
+    SHA256_Context  tHashCtx;
+};
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static void
+_SPartFile_DigestToHex(const unsigned char *sDigest, char *sHexOut);
+
+static char*
+_SPartFile_MakePath(const char *sPath, const char *sSuffix);
+
+static char*
+_SPartFile_MakeStatePath(const char *sPath, const char *sSuffix);
+
+static CBOOL
+_SPartFile_IsStateDirUsable(const char *sPath);
+
+static CBOOL
+_SPartFile_Resume(SPartFile *pPart);
+
+static CBOOL
+_SPartFile_Store(SPartFile *pPart, const void *pData, size_t dSize);
+
+static CBOOL
+_SPartFile_Inflate(SPartFile *pPart, const void *pData, size_t dSize);
+
+static void
+_SPartFile_Reset(SPartFile *pPart);
+
+static CBOOL
+_SPartFile_Verify(SPartFile *pPart);
+
+static void
+_SPartFile_Free(SPartFile *pPart);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SPartFile*
+SPartFile_Open(
+    const char *sPath,
+    const char *sSHA256,
+    uint64 dExpectedSize,
+    uint64 dPackedSize)
+{
+    SPartFile   *pPart;
+    char        *(*fnMakePath)(const char*, const char*);
+
+    if (!sPath || !sSHA256)
+    {
+        return NULL;
+    }
+
+    pPart = (SPartFile*)calloc(1, sizeof(SPartFile));
+    if (!IS_VALID(pPart))
+    {
+        fprintf(stderr, "SPartFile_Open() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    /* Commit has to stay a single rename */
+    fnMakePath = _SPartFile_IsStateDirUsable(sPath) ?
+        _SPartFile_MakeStatePath : _SPartFile_MakePath;
+
+    pPart->sPath        = _SPartFile_MakePath(sPath, "");
+    pPart->sPartPath    = fnMakePath(sPath, SPARTFILE_SUFFIX);
+    pPart->sSpoolPath   = fnMakePath(sPath,
+        dPackedSize > 0 ? SPARTFILE_SPOOL_SUFFIX : SPARTFILE_SUFFIX);
+    pPart->sJournalPath = fnMakePath(sPath, SPARTFILE_JOURNAL_SUFFIX);
+    if (dPackedSize > 0)
+    {
+        pPart->pInflater = (SPartInflater*)malloc(sizeof(SPartInflater));
+    }
+    if (!pPart->sPath || !pPart->sPartPath || !pPart->sSpoolPath ||
+        !pPart->sJournalPath || (dPackedSize > 0 && !pPart->pInflater))
+    {
+        _SPartFile_Free(pPart);
+        return NULL;
+    }
+
+    strncpy(pPart->sExpectedSHA256, sSHA256, SPARTFILE_SHA256_HEX_SIZE);
+    pPart->sExpectedSHA256[SPARTFILE_SHA256_HEX_SIZE] = '\0';
+    pPart->dExpectedSize    = dExpectedSize;
+    pPart->dPackedSize      = dPackedSize;
+
+    if (_SPartFile_Resume(pPart))
+    {
+        return pPart;
+    }
+
+    /* Nothing to resume (or journal is stale): start from scratch */
+    remove(pPart->sJournalPath);
+    _SPartFile_Reset(pPart);
+    pPart->pFile = fopen(pPart->sPartPath, "wb");
+    if (!pPart->pFile)
+    {
+        fprintf(stderr, "SPartFile_Open() -> Can't create %s\n", pPart->sPartPath);
+        _SPartFile_Free(pPart);
+        return NULL;
+    }
+
+    return pPart;
+}
+
+CAPI CBOOL
+SPartFile_Write(SPartFile *pPart, const void *pData, size_t dSize)
+{
+    if (!pPart || !pPart->pFile)
+    {
+        return CFALSE;
+    }
+
+    if (dSize == 0)
+    {
+        return CTRUE;
+    }
+
+    if (pPart->pInflater)
+    {
+        return _SPartFile_Inflate(pPart, pData, dSize);
+    }
+
+    return _SPartFile_Store(pPart, pData, dSize);
+}
+
+CAPI CBOOL
+SPartFile_Checkpoint(SPartFile *pPart)
+{
+    SPartJournalHeader  tHeader;
+    FILE                *pJournal;
+    char                *sTmpPath;
+    CBOOL               bResult;
+
+    if (!pPart || !pPart->pFile)
+    {
+        return CFALSE;
+    }
+
+    /* Data must hit the disk before the journal claims it */
+    if (!AmberLauncher_FileSync(pPart->pFile))
+    {
+        return CFALSE;
+    }
+
+    memset(&tHeader, 0, sizeof(tHeader));
+    memcpy(tHeader.sMagic, SPARTFILE_JOURNAL_MAGIC, sizeof(tHeader.sMagic));
+    tHeader.dVersion        = SPARTFILE_JOURNAL_VERSION;
+    tHeader.dPathLength     = (uint32)strlen(pPart->sPath);
+    tHeader.dHashCtxSize    = (uint32)sizeof(SHA256_Context);
+    tHeader.dInflaterSize   = pPart->pInflater ? (uint32)sizeof(tinfl_decompressor) : 0;
+    tHeader.dDictOffset     = pPart->pInflater ? (uint32)pPart->pInflater->dDictOffset : 0;
+    tHeader.dExpectedSize   = pPart->dExpectedSize;
+    tHeader.dOffset         = pPart->dOffset;
+    tHeader.dPackedSize     = pPart->dPackedSize;
+    tHeader.dPackedOffset   = pPart->dPackedOffset;
+    memcpy(tHeader.sExpectedSHA256, pPart->sExpectedSHA256, sizeof(tHeader.sExpectedSHA256));
+
+    sTmpPath = _SPartFile_MakePath(pPart->sJournalPath, ".tmp");
+    if (!sTmpPath)
+    {
+        return CFALSE;
+    }
+
+    pJournal = fopen(sTmpPath, "wb");
+    if (!pJournal)
+    {
+        free(sTmpPath);
+        return CFALSE;
+    }
+
+    bResult = fwrite(&tHeader, sizeof(tHeader), 1, pJournal) == 1 &&
+              fwrite(pPart->sPath, 1, tHeader.dPathLength, pJournal) == tHeader.dPathLength &&
+              fwrite(&pPart->tHashCtx, sizeof(SHA256_Context), 1, pJournal) == 1 &&
+              (!pPart->pInflater ||
+               (fwrite(&pPart->pInflater->tState, sizeof(tinfl_decompressor), 1, pJournal) == 1 &&
+                fwrite(pPart->pInflater->pDict, TINFL_LZ_DICT_SIZE, 1, pJournal) == 1)) &&
+              AmberLauncher_FileSync(pJournal);
+    fclose(pJournal);
+
+    /* Journal is swapped in atomically: either old or new state survives */
+    bResult = bResult && AmberLauncher_FileReplace(sTmpPath, pPart->sJournalPath);
+    if (!bResult)
+    {
+        remove(sTmpPath);
+    }
+    free(sTmpPath);
+
+    return bResult;
+}
+
+CAPI uint64
+SPartFile_GetOffset(const SPartFile *pPart)
+{
+    if (!pPart)
+    {
+        return 0;
+    }
+
+    return pPart->pInflater ? pPart->dPackedOffset : pPart->dOffset;
+}
+
+CAPI const char*
+SPartFile_GetSpoolPath(const SPartFile *pPart)
+{
+    return pPart ? pPart->sSpoolPath : NULL;
+}
+
+CAPI void
+SPartFile_Release(SPartFile *pPart)
+{
+    if (!pPart)
+    {
+        return;
+    }
+
+    if (pPart->pFile)
+    {
+        fclose(pPart->pFile);
+        pPart->pFile = NULL;
+    }
+    remove(pPart->sPartPath);
+    remove(pPart->sSpoolPath);
+    remove(pPart->sJournalPath);
+
+    _SPartFile_Reset(pPart);
+}
+
+CAPI CBOOL
+SPartFile_Reload(SPartFile *pPart)
+{
+    unsigned char   *pBuffer;
+    FILE            *pSpool;
+    size_t          dRead;
+    CBOOL           bResult = CTRUE;
+
+    if (!pPart || pPart->pFile)
+    {
+        return CFALSE;
+    }
+
+    pBuffer = (unsigned char*)malloc(SPARTFILE_BUFFER_SIZE);
+    if (!pBuffer)
+    {
+        return CFALSE;
+    }
+
+    _SPartFile_Reset(pPart);
+
+    if (!pPart->pInflater)
+    {
+        /* Plain download: spool is the .part itself, just hash it */
+        pPart->pFile = fopen(pPart->sPartPath, "r+b");
+        if (!pPart->pFile)
+        {
+            free(pBuffer);
+            return CFALSE;
+        }
+
+        while ((dRead = fread(pBuffer, 1, SPARTFILE_BUFFER_SIZE, pPart->pFile)) > 0)
+        {
+            sha256_add_bytes(&pPart->tHashCtx, pBuffer, dRead);
+            pPart->dOffset += dRead;
+        }
+        bResult = ferror(pPart->pFile) ? CFALSE : CTRUE;
+        free(pBuffer);
+
+        return bResult;
+    }
+
+    /* Packed download: inflate spool into .part, then drop the spool */
+    pSpool          = fopen(pPart->sSpoolPath, "rb");
+    pPart->pFile    = fopen(pPart->sPartPath, "wb");
+    if (!pSpool || !pPart->pFile)
+    {
+        bResult = CFALSE;
+    }
+
+    while (bResult && (dRead = fread(pBuffer, 1, SPARTFILE_BUFFER_SIZE, pSpool)) > 0)
+    {
+        bResult = SPartFile_Write(pPart, pBuffer, dRead);
+    }
+    if (pSpool)
+    {
+        bResult = bResult && !ferror(pSpool);
+        fclose(pSpool);
+    }
+    remove(pPart->sSpoolPath);
+    free(pBuffer);
+
+    return bResult;
+}
+
+CAPI CBOOL
+SPartFile_Commit(SPartFile **pPart)
+{
+    SPartFile   *pSelf;
+    CBOOL       bResult;
+
+    if (!pPart || !*pPart)
+    {
+        return CFALSE;
+    }
+
+    pSelf   = *pPart;
+    *pPart  = NULL;
+
+    /* Part file is on destination's filesystem, copy is a last resort
+     * (e.g. destination directory was remounted meanwhile) */
+    bResult = _SPartFile_Verify(pSelf) &&
+              (AmberLauncher_FileReplace(pSelf->sPartPath, pSelf->sPath) ||
+               SFileCopy_File(pSelf->sPartPath, pSelf->sPath) != SFILECOPY_NONE);
+
+    /* Gone already after rename; copied or corrupted data isn't needed either */
+    remove(pSelf->sPartPath);
+    remove(pSelf->sJournalPath);
+    _SPartFile_Free(pSelf);
+
+    return bResult;
+}
+
+CAPI void
+SPartFile_Close(SPartFile **pPart)
+{
+    if (!pPart || !*pPart)
+    {
+        return;
+    }
+
+    if ((*pPart)->pFile && (*pPart)->dOffset > 0)
+    {
+        SPartFile_Checkpoint(*pPart);
+    }
+
+    _SPartFile_Free(*pPart);
+    *pPart = NULL;
+}
+
+CAPI void
+SPartFile_Discard(const char *sPath)
+{
+    /* Both places: filesystem layout may have changed since download began */
+    static char *(*const fnMakePath[])(const char*, const char*) =
+    {
+        _SPartFile_MakeStatePath,
+        _SPartFile_MakePath
+    };
+    static const char *sSuffixes[] =
+    {
+        SPARTFILE_SUFFIX,
+        SPARTFILE_SPOOL_SUFFIX,
+        SPARTFILE_JOURNAL_SUFFIX
+    };
+    size_t i, j;
+
+    for (i = 0; i < sizeof(fnMakePath) / sizeof(fnMakePath[0]); ++i)
+    {
+        for (j = 0; j < sizeof(sSuffixes) / sizeof(sSuffixes[0]); ++j)
+        {
+            char *sLeftover = fnMakePath[i](sPath, sSuffixes[j]);
+
+            if (sLeftover)
+            {
+                remove(sLeftover);
+                free(sLeftover);
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static void
+_SPartFile_DigestToHex(const unsigned char *sDigest, char *sHexOut)
+{
+    static const char tbl[] = "0123456789abcdef";
+    size_t i;
+
+    for (i = 0; i < SHA256_HASH_SIZE; ++i)
+    {
+        sHexOut[i * 2]     = tbl[sDigest[i] >> 4];
+        sHexOut[i * 2 + 1] = tbl[sDigest[i] & 0x0F];
+    }
+    sHexOut[SHA256_HASH_SIZE * 2] = '\0';
+}
+
+static char*
+_SPartFile_MakePath(const char *sPath, const char *sSuffix)
+{
+    size_t  dPathLen;
+    size_t  dSuffixLen;
+    char    *sResult;
+
+    if (!sPath)
+    {
+        return NULL;
+    }
+
+    dPathLen    = strlen(sPath);
+    dSuffixLen  = strlen(sSuffix);
+    sResult     = (char*)malloc(dPathLen + dSuffixLen + 1);
+    if (sResult)
+    {
+        memcpy(sResult, sPath, dPathLen);
+        memcpy(sResult + dPathLen, sSuffix, dSuffixLen + 1);
+    }
+
+    return sResult;
+}
+
+/* "<SPARTFILE_DIR>/<FNV-1a 64 of path><suffix>": flat and short, whatever
+ * the path looks like */
+static char*
+_SPartFile_MakeStatePath(const char *sPath, const char *sSuffix)
+{
+    uint64      dHash = 14695981039346656037ULL;
+    const char  *sChar;
+    char        *sResult;
+
+    if (!sPath)
+    {
+        return NULL;
+    }
+
+    for (sChar = sPath; *sChar; ++sChar)
+    {
+        dHash ^= (unsigned char)*sChar;
+        dHash *= 1099511628211ULL;
+    }
+
+    sResult = (char*)malloc(sizeof(SPARTFILE_DIR) + 1 + 16 + strlen(sSuffix) + 1);
+    if (sResult)
+    {
+        sprintf(sResult, "%s/%08lx%08lx%s", SPARTFILE_DIR,
+            (unsigned long)(dHash >> 32), (unsigned long)(dHash & 0xFFFFFFFFu), sSuffix);
+    }
+
+    return sResult;
+}
+
+/* State directory is used when it's on the same device as destination
+ * directory (or its nearest existing parent), else part files go next to
+ * destination */
+static CBOOL
+_SPartFile_IsStateDirUsable(const char *sPath)
+{
+    uint64  dStateDevice, dDevice, dInode;
+    char    *sDir;
+    char    *sSlash;
+    char    *sChar;
+    CBOOL   bResult = CFALSE;
+
+    if (!AmberLauncher_DirCreate(SPARTFILE_DIR) ||
+        !AmberLauncher_FileIdentity(SPARTFILE_DIR, &dStateDevice, &dInode, NULL))
+    {
+        return CFALSE;
+    }
+
+    sDir = _SPartFile_MakePath(sPath, "");
+    if (!sDir)
+    {
+        return CFALSE;
+    }
+
+    for (;;)
+    {
+        sSlash = NULL;
+        for (sChar = sDir; *sChar; ++sChar)
+        {
+            if (*sChar == '/' || *sChar == '\\')
+            {
+                sSlash = sChar;
+            }
+        }
+        if (!sSlash)
+        {
+            bResult = AmberLauncher_FileIdentity(".", &dDevice, &dInode, NULL) &&
+                      dDevice == dStateDevice;
+            break;
+        }
+
+        *sSlash = '\0';
+        if (AmberLauncher_FileIdentity(sSlash == sDir ? "/" : sDir, &dDevice, &dInode, NULL))
+        {
+            bResult = dDevice == dStateDevice;
+            break;
+        }
+        if (sSlash == sDir)
+        {
+            break;
+        }
+    }
+
+    free(sDir);
+    return bResult;
+}
+
+static CBOOL
+_SPartFile_Resume(SPartFile *pPart)
+{
+    SPartJournalHeader  tHeader;
+    SHA256_Context      tHashCtx;
+    FILE                *pJournal;
+    char                *sJournaledPath;
+    CBOOL               bValid;
+    int64               dPartSize;
+
+    pJournal = fopen(pPart->sJournalPath, "rb");
+    if (!pJournal)
+    {
+        return CFALSE;
+    }
+
+    bValid = fread(&tHeader, sizeof(tHeader), 1, pJournal) == 1 &&
+             memcmp(tHeader.sMagic, SPARTFILE_JOURNAL_MAGIC, sizeof(tHeader.sMagic)) == 0 &&
+             tHeader.dVersion == SPARTFILE_JOURNAL_VERSION &&
+             tHeader.dHashCtxSize == sizeof(SHA256_Context) &&
+             tHeader.dInflaterSize == (pPart->pInflater ? sizeof(tinfl_decompressor) : 0) &&
+             tHeader.dDictOffset < TINFL_LZ_DICT_SIZE &&
+             tHeader.dPathLength == strlen(pPart->sPath) &&
+             tHeader.dExpectedSize == pPart->dExpectedSize &&
+             tHeader.dOffset <= pPart->dExpectedSize &&
+             tHeader.dPackedSize == pPart->dPackedSize &&
+             tHeader.dPackedOffset <= pPart->dPackedSize &&
+             strncmp(tHeader.sExpectedSHA256, pPart->sExpectedSHA256, SPARTFILE_SHA256_HEX_SIZE) == 0;
+
+    if (bValid)
+    {
+        sJournaledPath = (char*)malloc(tHeader.dPathLength + 1);
+        bValid = sJournaledPath &&
+                 fread(sJournaledPath, 1, tHeader.dPathLength, pJournal) == tHeader.dPathLength;
+        if (bValid)
+        {
+            sJournaledPath[tHeader.dPathLength] = '\0';
+            bValid = strcmp(sJournaledPath, pPart->sPath) == 0 &&
+                     fread(&tHashCtx, sizeof(SHA256_Context), 1, pJournal) == 1 &&
+                     (!pPart->pInflater ||
+                      (fread(&pPart->pInflater->tState, sizeof(tinfl_decompressor), 1, pJournal) == 1 &&
+                       fread(pPart->pInflater->pDict, TINFL_LZ_DICT_SIZE, 1, pJournal) == 1));
+        }
+        free(sJournaledPath);
+    }
+    fclose(pJournal);
+
+    if (!bValid)
+    {
+        return CFALSE;
+    }
+
+    /* .part must hold at least the journaled bytes; anything past is unverified */
+    pPart->pFile = fopen(pPart->sPartPath, "r+b");
+    if (!pPart->pFile)
+    {
+        return CFALSE;
+    }
+
+    dPartSize = AmberLauncher_FileSeek(pPart->pFile, 0, SEEK_END) ? AmberLauncher_FileTell(pPart->pFile) : -1;
+    if (dPartSize < 0 || (uint64)dPartSize < tHeader.dOffset ||
+        !AmberLauncher_FileSeek(pPart->pFile, (int64)tHeader.dOffset, SEEK_SET))
+    {
+        fclose(pPart->pFile);
+        pPart->pFile = NULL;
+        return CFALSE;
+    }
+
+    pPart->dOffset          = tHeader.dOffset;
+    pPart->dPackedOffset    = tHeader.dPackedOffset;
+    pPart->tHashCtx         = tHashCtx;
+    if (pPart->pInflater)
+    {
+        pPart->pInflater->dDictOffset   = tHeader.dDictOffset;
+        pPart->pInflater->bDone         = tHeader.dPackedOffset == tHeader.dPackedSize &&
+                                          tHeader.dOffset == tHeader.dExpectedSize;
+    }
+
+    return CTRUE;
+}
+
+static CBOOL
+_SPartFile_Store(SPartFile *pPart, const void *pData, size_t dSize)
+{
+    if (fwrite(pData, 1, dSize, pPart->pFile) != dSize)
+    {
+        return CFALSE;
+    }
+
+    sha256_add_bytes(&pPart->tHashCtx, pData, dSize);
+    pPart->dOffset += dSize;
+
+    return CTRUE;
+}
+
+static CBOOL
+_SPartFile_Inflate(SPartFile *pPart, const void *pData, size_t dSize)
+{
+    SPartInflater       *pInf   = pPart->pInflater;
+    const mz_uint8      *pIn    = (const mz_uint8*)pData;
+    size_t              dInOfs  = 0;
+    size_t              dInSize;
+    size_t              dOutSize;
+    tinfl_status        eStatus;
+
+    if (pInf->bDone)
+    {
+        /* Trailing garbage after end of stream */
+        return CFALSE;
+    }
+
+    pPart->dPackedOffset += dSize;
+
+    /* Dictionary doubles as output ring buffer, flushed after every step */
+    for (;;)
+    {
+        dInSize     = dSize - dInOfs;
+        dOutSize    = TINFL_LZ_DICT_SIZE - pInf->dDictOffset;
+        eStatus     = tinfl_decompress(
+            &pInf->tState,
+            pIn + dInOfs, &dInSize,
+            pInf->pDict, pInf->pDict + pInf->dDictOffset, &dOutSize,
+            SPARTFILE_INFLATE_FLAGS);
+        dInOfs += dInSize;
+
+        if (dOutSize > 0 &&
+            !_SPartFile_Store(pPart, pInf->pDict + pInf->dDictOffset, dOutSize))
+        {
+            return CFALSE;
+        }
+        pInf->dDictOffset = (pInf->dDictOffset + dOutSize) & (TINFL_LZ_DICT_SIZE - 1);
+
+        if (eStatus == TINFL_STATUS_DONE)
+        {
+            pInf->bDone = CTRUE;
+            return dInOfs == dSize ? CTRUE : CFALSE;
+        }
+        if (eStatus < 0)
+        {
+            fprintf(stderr, "SPartFile_Write() -> %s: corrupted deflate stream\n", pPart->sPath);
+            return CFALSE;
+        }
+        if (eStatus == TINFL_STATUS_NEEDS_MORE_INPUT && dInOfs == dSize)
+        {
+            return CTRUE;
+        }
+    }
+}
+
+static void
+_SPartFile_Reset(SPartFile *pPart)
+{
+    pPart->dOffset          = 0;
+    pPart->dPackedOffset    = 0;
+    sha256_initialize(&pPart->tHashCtx);
+
+    if (pPart->pInflater)
+    {
+        tinfl_init(&pPart->pInflater->tState);
+        pPart->pInflater->dDictOffset   = 0;
+        pPart->pInflater->bDone         = CFALSE;
+    }
+}
+
+static CBOOL
+_SPartFile_Verify(SPartFile *pPart)
+{
+    unsigned char   sDigest[SHA256_HASH_SIZE];
+    char            sHex[SPARTFILE_SHA256_HEX_SIZE + 1];
+
+    if (!pPart->pFile || !AmberLauncher_FileSync(pPart->pFile))
+    {
+        fprintf(stderr, "SPartFile_Commit() -> Failed to flush %s\n", pPart->sPartPath);
+        return CFALSE;
+    }
+    fclose(pPart->pFile);
+    pPart->pFile = NULL;
+
+    if (pPart->pInflater && !pPart->pInflater->bDone)
+    {
+        fprintf(stderr, "SPartFile_Commit() -> %s: truncated deflate stream\n", pPart->sPath);
+        return CFALSE;
+    }
+
+    if (pPart->dOffset != pPart->dExpectedSize)
+    {
+        fprintf(stderr, "SPartFile_Commit() -> %s: size mismatch (%lu/%lu)\n",
+            pPart->sPath,
+            (unsigned long)pPart->dOffset,
+            (unsigned long)pPart->dExpectedSize);
+        return CFALSE;
+    }
+
+    sha256_calculate(&pPart->tHashCtx, sDigest);
+    _SPartFile_DigestToHex(sDigest, sHex);
+
+    if (strcmp(sHex, pPart->sExpectedSHA256) != 0)
+    {
+        fprintf(stderr, "SPartFile_Commit() -> %s: sha256 mismatch\n", pPart->sPath);
+        return CFALSE;
+    }
+
+    return CTRUE;
+}
+
+static void
+_SPartFile_Free(SPartFile *pPart)
+{
+    if (pPart->pFile)
+    {
+        fclose(pPart->pFile);
+    }
+    free(pPart->sPath);
+    free(pPart->sPartPath);
+    free(pPart->sSpoolPath);
+    free(pPart->sJournalPath);
+    free(pPart->pInflater);
+    free(pPart);
+}
@@ -0,0 +1,512 @@
+#include <core/pathindex.h>
+#include <core/opsys.h>
+#include <core/vector.h>
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SPATHINDEX_MIN_BUCKETS          256
+#define SPATHINDEX_KEY_SIZE             4096
+#define SPATHINDEX_NONE                 ((size_t)-1)
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SPathIndexEntry
+{
+    char            *sKey;          /**< lowercase, '/' separated */
+    char            *sPath;         /**< as on disk, native separators */
+} SPathIndexEntry;
+
+struct SPathIndex
+{
+    char            *sRoot;
+
+    SPathIndexEntry *pEntries;
+    size_t          dNumEntries;
+    size_t          dMaxEntries;
+
+    /* Open addressing index: entry index + 1, 0 marks empty bucket */
+    size_t          *pBuckets;
+    size_t          dNumBuckets;
+};
+
+/* Directory waiting to be scanned (breadth-first) */
+typedef struct SPathIndexDir
+{
+    size_t          dEntry;
+    uint32          dDepth;
+    size_t          dParent;        /**< in tPending, SPATHINDEX_NONE for root */
+
+    /* Device and inode, looked up only once symlinked directory shows up */
+    CBOOL           bIdentity;
+    uint64          dDevice;
+    uint64          dInode;
+} SPathIndexDir;
+
+typedef struct SPathIndexScan
+{
+    SPathIndex      *pIndex;
+    const char      *sDir;          /**< relative, "" for root */
+    const char      *sFullDir;      /**< sDir including root */
+    uint32          dDepth;
+    size_t          dCurrent;       /**< sDir in tPending, SPATHINDEX_NONE for root */
+    SVector         tPending;       /**< SPathIndexDir */
+    SPathIndexDir   tRoot;          /**< identity of root only */
+    CBOOL           bFailed;
+} SPathIndexScan;
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static uint32
+_SPathIndex_HashString(const char *sString);
+
+static size_t
+_SPathIndex_MakeKey(const char *sRelPath, char *sKeyOut, size_t dSize);
+
+static size_t
+_SPathIndex_Find(const SPathIndex *pIndex, const char *sKey);
+
+static CBOOL
+_SPathIndex_Insert(SPathIndex *pIndex, const char *sDir, const char *sName, size_t *dEntryOut);
+
+static CBOOL
+_SPathIndex_Rehash(SPathIndex *pIndex, size_t dNumBuckets);
+
+static CBOOL
+_SPathIndex_OnDirEntry(const char *sName, EDirEntryType eType, void *pUserData);
+
+static CBOOL
+_SPathIndex_IsAncestor(SPathIndexScan *pScan, uint64 dDevice, uint64 dInode);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SPathIndex*
+SPathIndex_Build(const char *sRoot)
+{
+    SPathIndex      *pIndex;
+    SPathIndexScan  tScan;
+    SPathIndexDir   tDir;
+    char            *sFullPath = NULL;
+    size_t          dNext = 0;
+    CBOOL           bRootRead;
+
+    if (!sRoot)
+    {
+        return NULL;
+    }
+
+    pIndex = (SPathIndex*)calloc(1, sizeof(SPathIndex));
+    if (!IS_VALID(pIndex))
+    {
+        fprintf(stderr, "SPathIndex_Build() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    pIndex->sRoot = (char*)malloc(strlen(sRoot) + 1);
+    if (!pIndex->sRoot || !_SPathIndex_Rehash(pIndex, SPATHINDEX_MIN_BUCKETS))
+    {
+        SPathIndex_delete(&pIndex);
+        return NULL;
+    }
+    strcpy(pIndex->sRoot, sRoot);
+
+    memset(&tScan, 0, sizeof(tScan));
+    tScan.pIndex    = pIndex;
+    tScan.sDir      = "";
+    tScan.sFullDir  = sRoot;
+    tScan.dCurrent  = SPATHINDEX_NONE;
+    SVector_Init(&tScan.tPending, sizeof(SPathIndexDir));
+
+    bRootRead = AmberLauncher_DirIterate(sRoot, _SPathIndex_OnDirEntry, &tScan);
+
+    /* Breadth-first, so shallow entries win over deep ones on allocation failure */
+    while (bRootRead && !tScan.bFailed && dNext < SVector_GetSize(&tScan.tPending))
+    {
+        const char  *sDir;
+        char        *sNewPath;
+
+        tDir        = *(SPathIndexDir*)SVector_Get(&tScan.tPending, dNext++);
+        sDir        = pIndex->pEntries[tDir.dEntry].sPath;
+        sNewPath    = (char*)realloc(sFullPath, strlen(sRoot) + strlen(sDir) + 2);
+        if (!sNewPath)
+        {
+            tScan.bFailed = CTRUE;
+            break;
+        }
+        sFullPath = sNewPath;
+        sprintf(sFullPath, "%s%c%s", sRoot, SPATHINDEX_SEPARATOR, sDir);
+
+        tScan.sDir      = sDir;
+        tScan.sFullDir  = sFullPath;
+        tScan.dDepth    = tDir.dDepth;
+        tScan.dCurrent  = dNext - 1;
+
+        /* Unreadable subdirectory is just left out */
+        AmberLauncher_DirIterate(sFullPath, _SPathIndex_OnDirEntry, &tScan);
+    }
+
+    free(sFullPath);
+    SVector_Cleanup(&tScan.tPending);
+
+    if (!bRootRead || tScan.bFailed)
+    {
+        SPathIndex_delete(&pIndex);
+        return NULL;
+    }
+
+    return pIndex;
+}
+
+CAPI const char*
+SPathIndex_Resolve(const SPathIndex *pIndex, const char *sRelPath)
+{
+    char    sKey[SPATHINDEX_KEY_SIZE];
+    size_t  dEntry;
+
+    if (!pIndex || !sRelPath || _SPathIndex_MakeKey(sRelPath, sKey, sizeof(sKey)) == 0)
+    {
+        return NULL;
+    }
+
+    dEntry = _SPathIndex_Find(pIndex, sKey);
+
+    return dEntry != SPATHINDEX_NONE ? pIndex->pEntries[dEntry].sPath : NULL;
+}
+
+CAPI const char*
+SPathIndex_GetRoot(const SPathIndex *pIndex)
+{
+    return pIndex ? pIndex->sRoot : NULL;
+}
+
+CAPI size_t
+SPathIndex_GetCount(const SPathIndex *pIndex)
+{
+    return pIndex ? pIndex->dNumEntries : 0;
+}
+
+CAPI void
+SPathIndex_delete(SPathIndex **pIndex)
+{
+    size_t dIndex;
+
+    if (!pIndex || !*pIndex)
+    {
+        return;
+    }
+
+    /* Key and path share one allocation */
+    for (dIndex = 0; dIndex < (*pIndex)->dNumEntries; ++dIndex)
+    {
+        free((*pIndex)->pEntries[dIndex].sKey);
+    }
+    free((*pIndex)->pEntries);
+    free((*pIndex)->pBuckets);
+    free((*pIndex)->sRoot);
+    free(*pIndex);
+
+    *pIndex = NULL;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static uint32
+_SPathIndex_HashString(const char *sString)
+{
+    /* FNV-1a */
+    uint32 dHash = 2166136261u;
+
+    while (*sString)
+    {
+        dHash ^= (unsigned char)*sString++;
+        dHash *= 16777619u;
+    }
+
+    return dHash;
+}
+
+/* "Data\\BITMAPS.LOD", "./data//bitmaps.lod" -> "data/bitmaps.lod" */
+static size_t
+_SPathIndex_MakeKey(const char *sRelPath, char *sKeyOut, size_t dSize)
+{
+    size_t      dLength = 0;
+    const char  *pChar  = sRelPath;
+
+    while (*pChar)
+    {
+        const char  *pEnd = pChar;
+        size_t      dPart;
+
+        while (*pEnd && *pEnd != '/' && *pEnd != '\\')
+        {
+            pEnd++;
+        }
+        dPart = (size_t)(pEnd - pChar);
+
+        if (dPart > 0 && !(dPart == 1 && *pChar == '.'))
+        {
+            if (dLength + dPart + 2 > dSize)
+            {
+                return 0;
+            }
+            if (dLength > 0)
+            {
+                sKeyOut[dLength++] = '/';
+            }
+            while (pChar < pEnd)
+            {
+                sKeyOut[dLength++] = (char)tolower((unsigned char)*pChar++);
+            }
+        }
+
+        pChar = *pEnd ? pEnd + 1 : pEnd;
+    }
+    sKeyOut[dLength] = '\0';
+
+    return dLength;
+}
+
+static size_t
+_SPathIndex_Find(const SPathIndex *pIndex, const char *sKey)
+{
+    const size_t    dMask = pIndex->dNumBuckets - 1;
+    size_t          dBucket = _SPathIndex_HashString(sKey) & dMask;
+
+    while (pIndex->pBuckets[dBucket] != 0)
+    {
+        const size_t dEntry = pIndex->pBuckets[dBucket] - 1;
+
+        if (strcmp(pIndex->pEntries[dEntry].sKey, sKey) == 0)
+        {
+            return dEntry;
+        }
+        dBucket = (dBucket + 1) & dMask;
+    }
+
+    return SPATHINDEX_NONE;
+}
+
+static CBOOL
+_SPathIndex_Insert(SPathIndex *pIndex, const char *sDir, const char *sName, size_t *dEntryOut)
+{
+    SPathIndexEntry *pEntry;
+    const size_t    dDirLength  = strlen(sDir);
+    const size_t    dLength     = dDirLength + (dDirLength > 0 ? 1 : 0) + strlen(sName);
+    size_t          dMask;
+    size_t          dBucket;
+    size_t          i;
+    char            *sBlock;
+
+    *dEntryOut = SPATHINDEX_NONE;
+
+    /* Key and path in one block: "<key>\0<path>\0" */
+    sBlock = (char*)malloc(dLength * 2 + 2);
+    if (!sBlock)
+    {
+        return CFALSE;
+    }
+    if (dDirLength > 0)
+    {
+        sprintf(sBlock + dLength + 1, "%s%c%s", sDir, SPATHINDEX_SEPARATOR, sName);
+    }
+    else
+    {
+        strcpy(sBlock + dLength + 1, sName);
+    }
+    for (i = 0; i < dLength; ++i)
+    {
+        const char c = sBlock[dLength + 1 + i];
+
+        sBlock[i] = c == SPATHINDEX_SEPARATOR ? '/' : (char)tolower((unsigned char)c);
+    }
+    sBlock[dLength] = '\0';
+
+    /* Names differing only in case: first one listed wins, as in FS.DirectoryFindCaseInsensitive */
+    if (_SPathIndex_Find(pIndex, sBlock) != SPATHINDEX_NONE)
+    {
+        free(sBlock);
+        return CTRUE;
+    }
+
+    if (pIndex->dNumEntries == pIndex->dMaxEntries)
+    {
+        const size_t    dNewMax = pIndex->dMaxEntries ? pIndex->dMaxEntries * 2 : 256;
+        SPathIndexEntry *pNew   = (SPathIndexEntry*)realloc(
+            pIndex->pEntries, dNewMax * sizeof(SPathIndexEntry));
+
+        if (!pNew)
+        {
+            free(sBlock);
+            return CFALSE;
+        }
+        pIndex->pEntries    = pNew;
+        pIndex->dMaxEntries = dNewMax;
+    }
+
+    /* Keep load factor under 1/2 */
+    if ((pIndex->dNumEntries + 1) * 2 > pIndex->dNumBuckets &&
+        !_SPathIndex_Rehash(pIndex, pIndex->dNumBuckets * 2))
+    {
+        free(sBlock);
+        return CFALSE;
+    }
+
+    pEntry          = &pIndex->pEntries[pIndex->dNumEntries];
+    pEntry->sKey    = sBlock;
+    pEntry->sPath   = sBlock + dLength + 1;
+
+    dMask   = pIndex->dNumBuckets - 1;
+    dBucket = _SPathIndex_HashString(sBlock) & dMask;
+    while (pIndex->pBuckets[dBucket] != 0)
+    {
+        dBucket = (dBucket + 1) & dMask;
+    }
+    *dEntryOut = pIndex->dNumEntries;
+    pIndex->pBuckets[dBucket] = ++pIndex->dNumEntries;
+
+    return CTRUE;
+}
+
+static CBOOL
+_SPathIndex_Rehash(SPathIndex *pIndex, size_t dNumBuckets)
+{
+    size_t  *pBuckets = (size_t*)calloc(dNumBuckets, sizeof(size_t));
+    size_t  dIndex;
+
+    if (!pBuckets)
+    {
+        return CFALSE;
+    }
+
+    for (dIndex = 0; dIndex < pIndex->dNumEntries; ++dIndex)
+    {
+        size_t dBucket = _SPathIndex_HashString(pIndex->pEntries[dIndex].sKey) & (dNumBuckets - 1);
+
+        while (pBuckets[dBucket] != 0)
+        {
+            dBucket = (dBucket + 1) & (dNumBuckets - 1);
+        }
+        pBuckets[dBucket] = dIndex + 1;
+    }
+
+    free(pIndex->pBuckets);
+    pIndex->pBuckets    = pBuckets;
+    pIndex->dNumBuckets = dNumBuckets;
+
+    return CTRUE;
+}
+
+static CBOOL
+_SPathIndex_OnDirEntry(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    SPathIndexScan  *pScan = (SPathIndexScan*)pUserData;
+    SPathIndexDir   tDir;
+    CBOOL           bDirectory = CFALSE;
+    char            *sFullPath;
+
+    memset(&tDir, 0, sizeof(tDir));
+    if (!_SPathIndex_Insert(pScan->pIndex, pScan->sDir, sName, &tDir.dEntry))
+    {
+        pScan->bFailed = CTRUE;
+        return CFALSE;
+    }
+
+    if (tDir.dEntry == SPATHINDEX_NONE || pScan->dDepth + 1 >= SPATHINDEX_MAX_DEPTH)
+    {
+        return CTRUE;
+    }
+
+    /* Symlink (junction) to directory is entered unless it leads back to
+     * directory it's in, files below it are indexed under link's path */
+    if (eType == DIRENTRY_OTHER)
+    {
+        sFullPath = (char*)malloc(strlen(pScan->sFullDir) + strlen(sName) + 2);
+        if (!sFullPath)
+        {
+            pScan->bFailed = CTRUE;
+            return CFALSE;
+        }
+        sprintf(sFullPath, "%s%c%s", pScan->sFullDir, SPATHINDEX_SEPARATOR, sName);
+        tDir.bIdentity = AmberLauncher_FileIdentity(sFullPath, &tDir.dDevice, &tDir.dInode, &bDirectory);
+        free(sFullPath);
+
+        if (!tDir.bIdentity || !bDirectory ||
+            _SPathIndex_IsAncestor(pScan, tDir.dDevice, tDir.dInode))
+        {
+            return CTRUE;
+        }
+    }
+    else if (eType != DIRENTRY_DIRECTORY)
+    {
+        return CTRUE;
+    }
+
+    tDir.dDepth     = pScan->dDepth + 1;
+    tDir.dParent    = pScan->dCurrent;
+    SVector_PushBack(&pScan->tPending, &tDir);
+
+    return CTRUE;
+}
+
+/* Walks parents of directory being listed up to root, inodes of plain
+ * directories are only looked up here, so trees without symlinks cost nothing */
+static CBOOL
+_SPathIndex_IsAncestor(SPathIndexScan *pScan, uint64 dDevice, uint64 dInode)
+{
+    const SPathIndex    *pIndex = pScan->pIndex;
+    size_t              dCurrent = pScan->dCurrent;
+    SPathIndexDir       *pDir;
+    char                *sFullPath;
+
+    for (;;)
+    {
+        pDir = dCurrent == SPATHINDEX_NONE ? &pScan->tRoot :
+            (SPathIndexDir*)SVector_Get(&pScan->tPending, dCurrent);
+
+        if (!pDir->bIdentity)
+        {
+            if (dCurrent == SPATHINDEX_NONE)
+            {
+                pDir->bIdentity = AmberLauncher_FileIdentity(
+                    pIndex->sRoot, &pDir->dDevice, &pDir->dInode, NULL);
+            }
+            else
+            {
+                sFullPath = (char*)malloc(strlen(pIndex->sRoot) +
+                    strlen(pIndex->pEntries[pDir->dEntry].sPath) + 2);
+                if (sFullPath)
+                {
+                    sprintf(sFullPath, "%s%c%s", pIndex->sRoot, SPATHINDEX_SEPARATOR,
+                        pIndex->pEntries[pDir->dEntry].sPath);
+                    pDir->bIdentity = AmberLauncher_FileIdentity(
+                        sFullPath, &pDir->dDevice, &pDir->dInode, NULL);
+                    free(sFullPath);
+                }
+            }
+        }
+
+        if (pDir->bIdentity && pDir->dDevice == dDevice && pDir->dInode == dInode)
+        {
+            return CTRUE;
+        }
+        if (dCurrent == SPATHINDEX_NONE)
+        {
+            return CFALSE;
+        }
+        dCurrent = pDir->dParent;
+    }
+}
@@ -0,0 +1,675 @@
+#include <core/snapshot.h>
+#include <core/objstore.h>
+#include <core/opsys.h>
+#include <core/thread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define SSNAPSHOT_HEADER                "ALSS 1"
+#define SSNAPSHOT_MISSING               "-"
+#define SSNAPSHOT_LINE_SIZE             4096
+#define SSNAPSHOT_NAME_SIZE             32
+#define SSNAPSHOT_MAX_PER_SECOND        100
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef struct SSnapshotEntry
+{
+    char            *sPath;
+    char            sSHA256[SOBJSTORE_SHA256_HEX_SIZE + 1];  /* empty if missing */
+    size_t          dOrder;
+} SSnapshotEntry;
+
+struct SSnapshot
+{
+    SObjectStore    *pStore;
+    char            *sRoot;
+    SMutex          *pMutex;
+
+    SSnapshotEntry  *pEntries;
+    size_t          dNumEntries;
+    size_t          dMaxEntries;
+};
+
+typedef struct SSnapshotList
+{
+    char            **pNames;
+    size_t          dNumNames;
+    size_t          dMaxNames;
+    CBOOL           bFailed;
+} SSnapshotList;
+
+typedef struct SSnapshotKeep
+{
+    const char      **pSHA256;
+    size_t          dNumSHA256;
+    size_t          dMaxSHA256;
+} SSnapshotKeep;
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static void
+_SSnapshot_Free(SSnapshot *pSnapshot);
+
+static int
+_SSnapshot_CompareEntries(const void *pA, const void *pB);
+
+static int
+_SSnapshot_CompareNames(const void *pA, const void *pB);
+
+static CBOOL
+_SSnapshot_ListCallback(const char *sName, EDirEntryType eType, void *pUserData);
+
+static void
+_SSnapshot_List(const char *sRoot, SSnapshotList *pList);
+
+static void
+_SSnapshot_ListFree(SSnapshotList *pList);
+
+static char*
+_SSnapshot_NewPath(const char *sRoot);
+
+static CBOOL
+_SSnapshot_Write(SSnapshot *pSnapshot, uint32 *dNumFilesOut);
+
+static void
+_SSnapshot_Prune(const char *sRoot);
+
+static CBOOL
+_SSnapshot_KeepAdd(SSnapshotKeep *pKeep, const char *sSHA256);
+
+static CBOOL
+_SSnapshot_KeepRead(SSnapshotKeep *pKeep, const char *sPath);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SSnapshot*
+SSnapshot_Begin(struct SObjectStore *pStore, const char *sRoot)
+{
+    SSnapshot *pSnapshot;
+
+    if (!pStore || !sRoot)
+    {
+        return NULL;
+    }
+
+    pSnapshot = (SSnapshot*)calloc(1, sizeof(SSnapshot));
+    if (!IS_VALID(pSnapshot))
+    {
+        fprintf(stderr, "SSnapshot_Begin() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    pSnapshot->pStore   = pStore;
+    pSnapshot->sRoot    = (char*)malloc(strlen(sRoot) + 1);
+    pSnapshot->pMutex   = SMutex_Create();
+
+    if (!pSnapshot->sRoot || !pSnapshot->pMutex)
+    {
+        _SSnapshot_Free(pSnapshot);
+        return NULL;
+    }
+    strcpy(pSnapshot->sRoot, sRoot);
+
+    return pSnapshot;
+}
+
+CAPI CBOOL
+SSnapshot_AddFile(SSnapshot *pSnapshot, const char *sPath, const char *sKnownSHA256)
+{
+    SSnapshotEntry  tEntry;
+    CBOOL           bResult = CTRUE;
+
+    if (!pSnapshot || !sPath || strchr(sPath, '\n'))
+    {
+        return CFALSE;
+    }
+
+    memset(&tEntry, 0, sizeof(SSnapshotEntry));
+
+    /* Reflink/hardlink/copy of current contents, the file itself is left alone.
+     * Linking is fine since update only ever replaces it by rename */
+    if (AmberLauncher_FileStat(sPath, NULL, NULL) &&
+        !SObjectStore_ImportLinked(pSnapshot->pStore, sPath, sKnownSHA256, tEntry.sSHA256))
+    {
+        fprintf(stderr, "SSnapshot_AddFile() -> Can't snapshot %s\n", sPath);
+        return CFALSE;
+    }
+
+    tEntry.sPath = (char*)malloc(strlen(sPath) + 1);
+    if (!tEntry.sPath)
+    {
+        return CFALSE;
+    }
+    strcpy(tEntry.sPath, sPath);
+
+    SMutex_Lock(pSnapshot->pMutex);
+    if (pSnapshot->dNumEntries == pSnapshot->dMaxEntries)
+    {
+        const size_t    dNewMax = pSnapshot->dMaxEntries ? pSnapshot->dMaxEntries * 2 : 64;
+        SSnapshotEntry  *pNew   = (SSnapshotEntry*)realloc(
+            pSnapshot->pEntries, dNewMax * sizeof(SSnapshotEntry));
+
+        if (pNew)
+        {
+            pSnapshot->pEntries     = pNew;
+            pSnapshot->dMaxEntries  = dNewMax;
+        }
+        else
+        {
+            bResult = CFALSE;
+        }
+    }
+    if (bResult)
+    {
+        tEntry.dOrder = pSnapshot->dNumEntries;
+        pSnapshot->pEntries[pSnapshot->dNumEntries++] = tEntry;
+    }
+    SMutex_Unlock(pSnapshot->pMutex);
+
+    if (!bResult)
+    {
+        free(tEntry.sPath);
+    }
+
+    return bResult;
+}
+
+CAPI CBOOL
+SSnapshot_End(SSnapshot **pSnapshot, uint32 *dNumFilesOut)
+{
+    CBOOL bResult = CTRUE;
+
+    if (dNumFilesOut)
+    {
+        *dNumFilesOut = 0;
+    }
+    if (!pSnapshot || !*pSnapshot)
+    {
+        return CFALSE;
+    }
+
+    if ((*pSnapshot)->dNumEntries > 0)
+    {
+        bResult = _SSnapshot_Write(*pSnapshot, dNumFilesOut);
+        _SSnapshot_Prune((*pSnapshot)->sRoot);
+    }
+
+    _SSnapshot_Free(*pSnapshot);
+    *pSnapshot = NULL;
+
+    return bResult;
+}
+
+CAPI CBOOL
+SSnapshot_Collect(
+    struct SObjectStore *pStore,
+    const char *sRoot,
+    const char * const *pKeep,
+    size_t dNumKeep,
+    uint32 *dNumRemovedOut)
+{
+    SSnapshotList   tList;
+    SSnapshotKeep   tKeep;
+    size_t          dIndex;
+    CBOOL           bResult;
+
+    if (dNumRemovedOut)
+    {
+        *dNumRemovedOut = 0;
+    }
+    if (!pStore || !sRoot || (dNumKeep > 0 && !pKeep))
+    {
+        return CFALSE;
+    }
+
+    memset(&tKeep, 0, sizeof(SSnapshotKeep));
+    _SSnapshot_List(sRoot, &tList);
+
+    bResult = !tList.bFailed;
+    for (dIndex = 0; bResult && dIndex < dNumKeep; ++dIndex)
+    {
+        bResult = !pKeep[dIndex] || _SSnapshot_KeepAdd(&tKeep, pKeep[dIndex]);
+    }
+    for (dIndex = 0; bResult && dIndex < tList.dNumNames; ++dIndex)
+    {
+        char *sPath = (char*)malloc(strlen(sRoot) + strlen(tList.pNames[dIndex]) + 2);
+
+        if (sPath)
+        {
+            sprintf(sPath, "%s/%s", sRoot, tList.pNames[dIndex]);
+        }
+        bResult = sPath && _SSnapshot_KeepRead(&tKeep, sPath);
+        if (!bResult)
+        {
+            fprintf(stderr, "SSnapshot_Collect() -> Can't read %s, skipping\n",
+                sPath ? sPath : sRoot);
+        }
+        free(sPath);
+    }
+    _SSnapshot_ListFree(&tList);
+
+    /* Collecting with partial keep list would drop objects of unread snapshot */
+    if (bResult)
+    {
+        const uint32 dNumRemoved = SObjectStore_Collect(pStore, tKeep.pSHA256, tKeep.dNumSHA256);
+
+        if (dNumRemovedOut)
+        {
+            *dNumRemovedOut = dNumRemoved;
+        }
+    }
+
+    for (dIndex = 0; dIndex < tKeep.dNumSHA256; ++dIndex)
+    {
+        free((void*)tKeep.pSHA256[dIndex]);
+    }
+    free((void*)tKeep.pSHA256);
+
+    return bResult;
+}
+
+CAPI CBOOL
+SSnapshot_RollbackLatest(struct SObjectStore *pStore, const char *sRoot, uint32 *dNumFilesOut)
+{
+    SSnapshotList   tList;
+    char            *sPath;
+    char            *sLine;
+    FILE            *pFile;
+    uint32          dNumFiles = 0;
+    CBOOL           bResult = CFALSE;
+
+    if (dNumFilesOut)
+    {
+        *dNumFilesOut = 0;
+    }
+    if (!pStore || !sRoot)
+    {
+        return CFALSE;
+    }
+
+    _SSnapshot_List(sRoot, &tList);
+    if (tList.dNumNames == 0)
+    {
+        _SSnapshot_ListFree(&tList);
+        return CFALSE;
+    }
+
+    sPath = (char*)malloc(strlen(sRoot) + strlen(tList.pNames[tList.dNumNames - 1]) + 2);
+    sLine = (char*)malloc(SSNAPSHOT_LINE_SIZE);
+    if (sPath)
+    {
+        sprintf(sPath, "%s/%s", sRoot, tList.pNames[tList.dNumNames - 1]);
+    }
+    _SSnapshot_ListFree(&tList);
+
+    pFile = sPath && sLine ? fopen(sPath, "r") : NULL;
+    if (pFile && fgets(sLine, SSNAPSHOT_LINE_SIZE, pFile) &&
+        strncmp(sLine, SSNAPSHOT_HEADER, strlen(SSNAPSHOT_HEADER)) == 0)
+    {
+        bResult = CTRUE;
+        while (fgets(sLine, SSNAPSHOT_LINE_SIZE, pFile))
+        {
+            size_t  dLength = strlen(sLine);
+            char    *sTarget = strchr(sLine, ' ');
+
+            if (dLength > 0 && sLine[dLength - 1] == '\n')
+            {
+                sLine[--dLength] = '\0';
+            }
+            if (!sTarget || sTarget[1] == '\0')
+            {
+                continue;
+            }
+            *sTarget++ = '\0';
+
+            if (strcmp(sLine, SSNAPSHOT_MISSING) == 0)
+            {
+                /* Added by update */
+                if (AmberLauncher_FileStat(sTarget, NULL, NULL) && remove(sTarget) != 0)
+                {
+                    fprintf(stderr, "SSnapshot_RollbackLatest() -> Can't remove %s\n", sTarget);
+                    bResult = CFALSE;
+                    continue;
+                }
+            }
+            else if (SObjectStore_Install(pStore, sLine, sTarget) == SOBJSTORE_LINK_NONE)
+            {
+                fprintf(stderr, "SSnapshot_RollbackLatest() -> Can't restore %s\n", sTarget);
+                bResult = CFALSE;
+                continue;
+            }
+            ++dNumFiles;
+        }
+    }
+    else
+    {
+        fprintf(stderr, "SSnapshot_RollbackLatest() -> Can't read %s\n", sPath ? sPath : sRoot);
+    }
+
+    if (pFile)
+    {
+        fclose(pFile);
+    }
+
+    /* Keep snapshot around so failed files can be retried */
+    if (bResult)
+    {
+        remove(sPath);
+    }
+    free(sLine);
+    free(sPath);
+
+    if (dNumFilesOut)
+    {
+        *dNumFilesOut = dNumFiles;
+    }
+
+    return bResult;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static void
+_SSnapshot_Free(SSnapshot *pSnapshot)
+{
+    size_t dIndex;
+
+    for (dIndex = 0; dIndex < pSnapshot->dNumEntries; ++dIndex)
+    {
+        free(pSnapshot->pEntries[dIndex].sPath);
+    }
+    free(pSnapshot->pEntries);
+    free(pSnapshot->sRoot);
+    SMutex_Destroy(&pSnapshot->pMutex);
+    free(pSnapshot);
+}
+
+/* By path, then by order of recording so first (pre-update) state wins */
+static int
+_SSnapshot_CompareEntries(const void *pA, const void *pB)
+{
+    const SSnapshotEntry    *pEntryA = (const SSnapshotEntry*)pA;
+    const SSnapshotEntry    *pEntryB = (const SSnapshotEntry*)pB;
+    const int               dResult  = strcmp(pEntryA->sPath, pEntryB->sPath);
+
+    if (dResult != 0)
+    {
+        return dResult;
+    }
+
+    return pEntryA->dOrder < pEntryB->dOrder ? -1 : (pEntryA->dOrder > pEntryB->dOrder);
+}
+
+static int
+_SSnapshot_CompareNames(const void *pA, const void *pB)
+{
+    return strcmp(*(char* const*)pA, *(char* const*)pB);
+}
+
+static CBOOL
+_SSnapshot_ListCallback(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    SSnapshotList   *pList      = (SSnapshotList*)pUserData;
+    const size_t    dLength     = strlen(sName);
+    const size_t    dSuffixLen  = strlen(SSNAPSHOT_SUFFIX);
+
+    if (eType != DIRENTRY_FILE || dLength <= dSuffixLen ||
+        strcmp(sName + dLength - dSuffixLen, SSNAPSHOT_SUFFIX) != 0)
+    {
+        return CTRUE;
+    }
+
+    if (pList->dNumNames == pList->dMaxNames)
+    {
+        const size_t    dNewMax = pList->dMaxNames ? pList->dMaxNames * 2 : 8;
+        char            **pNew  = (char**)realloc(pList->pNames, dNewMax * sizeof(char*));
+
+        if (!pNew)
+        {
+            pList->bFailed = CTRUE;
+            return CFALSE;
+        }
+        pList->pNames       = pNew;
+        pList->dMaxNames    = dNewMax;
+    }
+
+    pList->pNames[pList->dNumNames] = (char*)malloc(dLength + 1);
+    if (!pList->pNames[pList->dNumNames])
+    {
+        pList->bFailed = CTRUE;
+        return CFALSE;
+    }
+    strcpy(pList->pNames[pList->dNumNames++], sName);
+
+    return CTRUE;
+}
+
+/* Names are timestamps, so sorted list is oldest to newest */
+static void
+_SSnapshot_List(const char *sRoot, SSnapshotList *pList)
+{
+    memset(pList, 0, sizeof(SSnapshotList));
+
+    AmberLauncher_DirIterate(sRoot, _SSnapshot_ListCallback, pList);
+    if (pList->dNumNames > 1)
+    {
+        qsort(pList->pNames, pList->dNumNames, sizeof(char*), _SSnapshot_CompareNames);
+    }
+}
+
+static void
+_SSnapshot_ListFree(SSnapshotList *pList)
+{
+    size_t dIndex;
+
+    for (dIndex = 0; dIndex < pList->dNumNames; ++dIndex)
+    {
+        free(pList->pNames[dIndex]);
+    }
+    free(pList->pNames);
+    memset(pList, 0, sizeof(SSnapshotList));
+}
+
+/* "<root>/yyyymmdd-hhmmss-nn.snap", nn keeps same-second updates ordered */
+static char*
+_SSnapshot_NewPath(const char *sRoot)
+{
+    char        sStamp[SSNAPSHOT_NAME_SIZE];
+    char        *sResult = (char*)malloc(strlen(sRoot) + SSNAPSHOT_NAME_SIZE + 2);
+    time_t      tNow = time(NULL);
+    struct tm   *pTime = localtime(&tNow);
+    unsigned    dIndex;
+
+    if (!sResult)
+    {
+        return NULL;
+    }
+    if (!pTime || strftime(sStamp, sizeof(sStamp), "%Y%m%d-%H%M%S", pTime) == 0)
+    {
+        strcpy(sStamp, "00000000-000000");
+    }
+
+    for (dIndex = 0; dIndex < SSNAPSHOT_MAX_PER_SECOND; ++dIndex)
+    {
+        sprintf(sResult, "%s/%s-%02u%s", sRoot, sStamp, dIndex, SSNAPSHOT_SUFFIX);
+        if (!AmberLauncher_FileStat(sResult, NULL, NULL))
+        {
+            return sResult;
+        }
+    }
+
+    free(sResult);
+    return NULL;
+}
+
+static CBOOL
+_SSnapshot_Write(SSnapshot *pSnapshot, uint32 *dNumFilesOut)
+{
+    char    *sPath;
+    char    *sTmpPath;
+    FILE    *pFile;
+    size_t  dIndex;
+    uint32  dNumFiles = 0;
+    CBOOL   bResult;
+
+    if (!AmberLauncher_DirCreate(pSnapshot->sRoot))
+    {
+        fprintf(stderr, "SSnapshot_End() -> Can't create %s\n", pSnapshot->sRoot);
+        return CFALSE;
+    }
+
+    sPath    = _SSnapshot_NewPath(pSnapshot->sRoot);
+    sTmpPath = sPath ? (char*)malloc(strlen(sPath) + 5) : NULL;
+    if (sTmpPath)
+    {
+        sprintf(sTmpPath, "%s.tmp", sPath);
+    }
+    pFile = sTmpPath ? fopen(sTmpPath, "w") : NULL;
+
+    qsort(pSnapshot->pEntries, pSnapshot->dNumEntries, sizeof(SSnapshotEntry),
+        _SSnapshot_CompareEntries);
+
+    bResult = pFile && fprintf(pFile, "%s\n", SSNAPSHOT_HEADER) > 0;
+    for (dIndex = 0; bResult && dIndex < pSnapshot->dNumEntries; ++dIndex)
+    {
+        const SSnapshotEntry *pEntry = &pSnapshot->pEntries[dIndex];
+
+        if (dIndex > 0 && strcmp(pEntry->sPath, pSnapshot->pEntries[dIndex - 1].sPath) == 0)
+        {
+            continue;
+        }
+
+        bResult = fprintf(pFile, "%s %s\n",
+            pEntry->sSHA256[0] ? pEntry->sSHA256 : SSNAPSHOT_MISSING,
+            pEntry->sPath) > 0;
+        ++dNumFiles;
+    }
+
+    if (pFile)
+    {
+        bResult = AmberLauncher_FileSync(pFile) && bResult;
+        fclose(pFile);
+        bResult = bResult && AmberLauncher_FileReplace(sTmpPath, sPath);
+        if (!bResult)
+        {
+            remove(sTmpPath);
+        }
+    }
+    if (!bResult)
+    {
+        fprintf(stderr, "SSnapshot_End() -> Can't write %s\n", sPath ? sPath : pSnapshot->sRoot);
+    }
+    else if (dNumFilesOut)
+    {
+        *dNumFilesOut = dNumFiles;
+    }
+    free(sTmpPath);
+    free(sPath);
+
+    return bResult;
+}
+
+static void
+_SSnapshot_Prune(const char *sRoot)
+{
+    SSnapshotList   tList;
+    size_t          dIndex;
+
+    _SSnapshot_List(sRoot, &tList);
+    for (dIndex = 0; !tList.bFailed && dIndex + SSNAPSHOT_MAX_KEPT < tList.dNumNames; ++dIndex)
+    {
+        char *sPath = (char*)malloc(strlen(sRoot) + strlen(tList.pNames[dIndex]) + 2);
+
+        if (sPath)
+        {
+            sprintf(sPath, "%s/%s", sRoot, tList.pNames[dIndex]);
+            remove(sPath);
+            free(sPath);
+        }
+    }
+    _SSnapshot_ListFree(&tList);
+}
+
+static CBOOL
+_SSnapshot_KeepAdd(SSnapshotKeep *pKeep, const char *sSHA256)
+{
+    char *sCopy;
+
+    if (pKeep->dNumSHA256 == pKeep->dMaxSHA256)
+    {
+        const size_t    dNewMax = pKeep->dMaxSHA256 ? pKeep->dMaxSHA256 * 2 : 256;
+        const char      **pNew  = (const char**)realloc(
+            (void*)pKeep->pSHA256, dNewMax * sizeof(const char*));
+
+        if (!pNew)
+        {
+            return CFALSE;
+        }
+        pKeep->pSHA256      = pNew;
+        pKeep->dMaxSHA256   = dNewMax;
+    }
+
+    sCopy = (char*)malloc(strlen(sSHA256) + 1);
+    if (!sCopy)
+    {
+        return CFALSE;
+    }
+    strcpy(sCopy, sSHA256);
+    pKeep->pSHA256[pKeep->dNumSHA256++] = sCopy;
+
+    return CTRUE;
+}
+
+/* Same line format RollbackLatest reads, "-" entries refer to no object */
+static CBOOL
+_SSnapshot_KeepRead(SSnapshotKeep *pKeep, const char *sPath)
+{
+    char    *sLine  = (char*)malloc(SSNAPSHOT_LINE_SIZE);
+    FILE    *pFile  = sLine ? fopen(sPath, "r") : NULL;
+    CBOOL   bResult = CFALSE;
+
+    if (pFile && fgets(sLine, SSNAPSHOT_LINE_SIZE, pFile) &&
+        strncmp(sLine, SSNAPSHOT_HEADER, strlen(SSNAPSHOT_HEADER)) == 0)
+    {
+        bResult = CTRUE;
+        while (bResult && fgets(sLine, SSNAPSHOT_LINE_SIZE, pFile))
+        {
+            char *sTarget = strchr(sLine, ' ');
+
+            if (!sTarget)
+            {
+                continue;
+            }
+            *sTarget = '\0';
+
+            if (strcmp(sLine, SSNAPSHOT_MISSING) != 0)
+            {
+                bResult = _SSnapshot_KeepAdd(pKeep, sLine);
+            }
+        }
+    }
+
+    if (pFile)
+    {
+        fclose(pFile);
+    }
+    free(sLine);
+
+    return bResult;
+}
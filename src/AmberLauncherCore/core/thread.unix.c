@@ -0,0 +1,172 @@
+#define _GNU_SOURCE
+#include <core/thread.h>
+
+#if defined(__unix__)
+
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+struct SThread
+{
+    pthread_t       tHandle;
+    SThreadFunc     cbFunc;
+    void            *pData;
+    uint32          dResult;
+};
+
+struct SMutex
+{
+    pthread_mutex_t tHandle;
+};
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static void*
+_SThread_Main(void *pData);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SThread*
+SThread_Create(SThreadFunc cbFunc, void *pData)
+{
+    SThread *pThread;
+
+    if (!cbFunc)
+    {
+        return NULL;
+    }
+
+    pThread = (SThread*)calloc(1, sizeof(SThread));
+    if (!IS_VALID(pThread))
+    {
+        fprintf(stderr, "SThread_Create() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    pThread->cbFunc = cbFunc;
+    pThread->pData  = pData;
+
+    if (pthread_create(&pThread->tHandle, NULL, _SThread_Main, pThread) != 0)
+    {
+        fprintf(stderr, "SThread_Create() -> pthread_create failed.\n");
+        free(pThread);
+        return NULL;
+    }
+
+    return pThread;
+}
+
+CAPI uint32
+SThread_Join(SThread **pThread)
+{
+    uint32 dResult;
+
+    if (!pThread || !*pThread)
+    {
+        return 0;
+    }
+
+    pthread_join((*pThread)->tHandle, NULL);
+    dResult = (*pThread)->dResult;
+
+    free(*pThread);
+    *pThread = NULL;
+
+    return dResult;
+}
+
+CAPI uint32
+SThread_GetProcessorCount(void)
+{
+    const long dCount = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return dCount > 0 ? (uint32)dCount : 1;
+}
+
+CAPI void
+SThread_Sleep(uint32 dMilliseconds)
+{
+    struct timespec tTime;
+
+    tTime.tv_sec    = (time_t)(dMilliseconds / 1000);
+    tTime.tv_nsec   = (long)(dMilliseconds % 1000) * 1000000L;
+
+    /* Resumes with remaining time when interrupted by signal */
+    while (nanosleep(&tTime, &tTime) != 0 && errno == EINTR)
+    {
+    }
+}
+
+CAPI SMutex*
+SMutex_Create(void)
+{
+    SMutex *pMutex = (SMutex*)calloc(1, sizeof(SMutex));
+
+    if (!IS_VALID(pMutex))
+    {
+        fprintf(stderr, "SMutex_Create() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&pMutex->tHandle, NULL) != 0)
+    {
+        free(pMutex);
+        return NULL;
+    }
+
+    return pMutex;
+}
+
+CAPI void
+SMutex_Lock(SMutex *pMutex)
+{
+    pthread_mutex_lock(&pMutex->tHandle);
+}
+
+CAPI void
+SMutex_Unlock(SMutex *pMutex)
+{
+    pthread_mutex_unlock(&pMutex->tHandle);
+}
+
+CAPI void
+SMutex_Destroy(SMutex **pMutex)
+{
+    if (!pMutex || !*pMutex)
+    {
+        return;
+    }
+
+    pthread_mutex_destroy(&(*pMutex)->tHandle);
+    free(*pMutex);
+    *pMutex = NULL;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static void*
+_SThread_Main(void *pData)
+{
+    SThread *pThread = (SThread*)pData;
+
+    pThread->dResult = pThread->cbFunc(pThread->pData);
+
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,160 @@
+#include <core/thread.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <windows.h>
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+struct SThread
+{
+    HANDLE          hHandle;
+    SThreadFunc     cbFunc;
+    void            *pData;
+    uint32          dResult;
+};
+
+struct SMutex
+{
+    CRITICAL_SECTION tHandle;
+};
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static DWORD WINAPI
+_SThread_Main(LPVOID pData);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SThread*
+SThread_Create(SThreadFunc cbFunc, void *pData)
+{
+    SThread *pThread;
+
+    if (!cbFunc)
+    {
+        return NULL;
+    }
+
+    pThread = (SThread*)calloc(1, sizeof(SThread));
+    if (!IS_VALID(pThread))
+    {
+        fprintf(stderr, "SThread_Create() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    pThread->cbFunc     = cbFunc;
+    pThread->pData      = pData;
+    pThread->hHandle    = CreateThread(NULL, 0, _SThread_Main, pThread, 0, NULL);
+
+    if (pThread->hHandle == NULL)
+    {
+        fprintf(stderr, "SThread_Create() -> CreateThread failed (%lu).\n", GetLastError());
+        free(pThread);
+        return NULL;
+    }
+
+    return pThread;
+}
+
+CAPI uint32
+SThread_Join(SThread **pThread)
+{
+    uint32 dResult;
+
+    if (!pThread || !*pThread)
+    {
+        return 0;
+    }
+
+    WaitForSingleObject((*pThread)->hHandle, INFINITE);
+    CloseHandle((*pThread)->hHandle);
+    dResult = (*pThread)->dResult;
+
+    free(*pThread);
+    *pThread = NULL;
+
+    return dResult;
+}
+
+CAPI uint32
+SThread_GetProcessorCount(void)
+{
+    SYSTEM_INFO tInfo;
+
+    GetSystemInfo(&tInfo);
+
+    return tInfo.dwNumberOfProcessors > 0 ? (uint32)tInfo.dwNumberOfProcessors : 1;
+}
+
+CAPI void
+SThread_Sleep(uint32 dMilliseconds)
+{
+    Sleep(dMilliseconds);
+}
+
+CAPI SMutex*
+SMutex_Create(void)
+{
+    SMutex *pMutex = (SMutex*)calloc(1, sizeof(SMutex));
+
+    if (!IS_VALID(pMutex))
+    {
+        fprintf(stderr, "SMutex_Create() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    InitializeCriticalSection(&pMutex->tHandle);
+
+    return pMutex;
+}
+
+CAPI void
+SMutex_Lock(SMutex *pMutex)
+{
+    EnterCriticalSection(&pMutex->tHandle);
+}
+
+CAPI void
+SMutex_Unlock(SMutex *pMutex)
+{
+    LeaveCriticalSection(&pMutex->tHandle);
+}
+
+CAPI void
+SMutex_Destroy(SMutex **pMutex)
+{
+    if (!pMutex || !*pMutex)
+    {
+        return;
+    }
+
+    DeleteCriticalSection(&(*pMutex)->tHandle);
+    free(*pMutex);
+    *pMutex = NULL;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static DWORD WINAPI
+_SThread_Main(LPVOID pData)
+{
+    SThread *pThread = (SThread*)pData;
+
+    pThread->dResult = pThread->cbFunc(pThread->pData);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,276 @@
+#include <core/updmetrics.h>
+#include <core/opsys.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static void
+_SUpdaterMetrics_ClearFiles(SUpdaterMetrics *pMetrics);
+
+static void
+_SUpdaterMetrics_WriteString(FILE *pFile, const char *sString);
+
+static void
+_SUpdaterMetrics_RotateLog(const char *sLogPath);
+
+/******************************************************************************
+ * HEADER FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+CAPI SUpdaterMetrics*
+SUpdaterMetrics_new(void)
+{
+    SUpdaterMetrics *pMetrics = (SUpdaterMetrics*)calloc(1, sizeof(SUpdaterMetrics));
+
+    if (!IS_VALID(pMetrics))
+    {
+        fprintf(stderr, "SUpdaterMetrics_new() -> Failed to allocate memory.\n");
+        return NULL;
+    }
+
+    SVector_Init(&pMetrics->tFiles, sizeof(SUpdaterFileMetrics));
+
+    return pMetrics;
+}
+
+CAPI void
+SUpdaterMetrics_delete(SUpdaterMetrics **pMetrics)
+{
+    if (!pMetrics || !*pMetrics)
+    {
+        return;
+    }
+
+    _SUpdaterMetrics_ClearFiles(*pMetrics);
+    SVector_Cleanup(&(*pMetrics)->tFiles);
+    free(*pMetrics);
+
+    *pMetrics = NULL;
+}
+
+CAPI void
+SUpdaterMetrics_Reset(SUpdaterMetrics *pMetrics, const char *sOperation)
+{
+    SVector tFiles;
+
+    if (!pMetrics)
+    {
+        return;
+    }
+
+    _SUpdaterMetrics_ClearFiles(pMetrics);
+
+    /* Keeps file vector's storage for the next session */
+    tFiles = pMetrics->tFiles;
+    memset(pMetrics, 0, sizeof(SUpdaterMetrics));
+    pMetrics->tFiles = tFiles;
+
+    strncpy(pMetrics->sOperation, sOperation ? sOperation : "",
+        SUPDMETRICS_OPERATION_SIZE - 1);
+    pMetrics->dStartTime = (int64)time(NULL);
+}
+
+CAPI CBOOL
+SUpdaterMetrics_AddFile(SUpdaterMetrics *pMetrics, const SUpdaterFileMetrics *pFile)
+{
+    SUpdaterFileMetrics tFile;
+
+    if (!pMetrics || !pFile || !pFile->sPath)
+    {
+        return CFALSE;
+    }
+
+    tFile       = *pFile;
+    tFile.sPath = (char*)malloc(strlen(pFile->sPath) + 1);
+    if (!tFile.sPath)
+    {
+        return CFALSE;
+    }
+    strcpy(tFile.sPath, pFile->sPath);
+
+    SVector_PushBack(&pMetrics->tFiles, &tFile);
+
+    pMetrics->dBytes       += pFile->dBytes;
+    pMetrics->dHashUs      += pFile->dHashUs;
+    pMetrics->dDownloadUs  += pFile->dDownloadUs;
+    pMetrics->dWriteUs     += pFile->dWriteUs;
+    pMetrics->dRetries     += pFile->dAttempts > 1 ? pFile->dAttempts - 1 : 0;
+
+    return CTRUE;
+}
+
+CAPI size_t
+SUpdaterMetrics_GetFileCount(const SUpdaterMetrics *pMetrics)
+{
+    return pMetrics ? SVector_GetSize(&pMetrics->tFiles) : 0;
+}
+
+CAPI const SUpdaterFileMetrics*
+SUpdaterMetrics_GetFile(SUpdaterMetrics *pMetrics, size_t dIndex)
+{
+    if (!pMetrics || dIndex >= SVector_GetSize(&pMetrics->tFiles))
+    {
+        return NULL;
+    }
+
+    return (const SUpdaterFileMetrics*)SVector_Get(&pMetrics->tFiles, dIndex);
+}
+
+CAPI double
+SUpdaterMetrics_Rate(uint64 dBytes, uint64 dMicroseconds)
+{
+    return dMicroseconds > 0 ?
+        (double)dBytes * 1000000.0 / (double)dMicroseconds : 0.0;
+}
+
+CAPI CBOOL
+SUpdaterMetrics_AppendLog(SUpdaterMetrics *pMetrics, const char *sLogPath)
+{
+    FILE    *pFile;
+    CBOOL   bFirst = CTRUE;
+    CBOOL   bResult;
+
+    if (!pMetrics || !sLogPath)
+    {
+        return CFALSE;
+    }
+
+    _SUpdaterMetrics_RotateLog(sLogPath);
+
+    pFile = fopen(sLogPath, "a");
+    if (!pFile)
+    {
+        return CFALSE;
+    }
+
+    fprintf(pFile, "{\"operation\":");
+    _SUpdaterMetrics_WriteString(pFile, pMetrics->sOperation);
+    fprintf(pFile,
+        ",\"start\":%lld,\"wall_us\":%llu,\"connections\":%u"
+        ",\"bytes\":%llu,\"bps\":%.0f"
+        ",\"hash_us\":%llu,\"download_us\":%llu,\"write_us\":%llu,\"retries\":%u"
+        ",\"hashcache_hits\":%u,\"hashcache_misses\":%u,\"objstore_hits\":%u"
+        ",\"manifest_fetches\":%u,\"manifest_cache_hits\":%u,\"files\":[",
+        (long long)pMetrics->dStartTime,
+        (unsigned long long)pMetrics->dWallUs,
+        pMetrics->dConnections,
+        (unsigned long long)pMetrics->dBytes,
+        SUpdaterMetrics_Rate(pMetrics->dBytes, pMetrics->dWallUs),
+        (unsigned long long)pMetrics->dHashUs,
+        (unsigned long long)pMetrics->dDownloadUs,
+        (unsigned long long)pMetrics->dWriteUs,
+        pMetrics->dRetries,
+        pMetrics->dHashCacheHits,
+        pMetrics->dHashCacheMisses,
+        pMetrics->dObjectStoreHits,
+        pMetrics->dManifestFetches,
+        pMetrics->dManifestCacheHits);
+
+    /* Intact files only bloat the log, their hashing is in the totals */
+    SVector_ForEach(&pMetrics->tFiles)
+    {
+        SVector_InitIterator(SUpdaterFileMetrics, &pMetrics->tFiles);
+
+        if (strcmp(SVECTOR_ITERATOR->sResult, "skipped") == 0 ||
+            strcmp(SVECTOR_ITERATOR->sResult, "verified") == 0)
+        {
+            continue;
+        }
+
+        fprintf(pFile, bFirst ? "{\"path\":" : ",{\"path\":");
+        _SUpdaterMetrics_WriteString(pFile, SVECTOR_ITERATOR->sPath);
+        fprintf(pFile, ",\"result\":");
+        _SUpdaterMetrics_WriteString(pFile, SVECTOR_ITERATOR->sResult);
+        fprintf(pFile,
+            ",\"size\":%llu,\"bytes\":%llu,\"attempts\":%u,\"bps\":%.0f"
+            ",\"hash_us\":%llu,\"download_us\":%llu,\"write_us\":%llu,\"total_us\":%llu}",
+            (unsigned long long)SVECTOR_ITERATOR->dSize,
+            (unsigned long long)SVECTOR_ITERATOR->dBytes,
+            SVECTOR_ITERATOR->dAttempts,
+            SUpdaterMetrics_Rate(SVECTOR_ITERATOR->dBytes, SVECTOR_ITERATOR->dDownloadUs),
+            (unsigned long long)SVECTOR_ITERATOR->dHashUs,
+            (unsigned long long)SVECTOR_ITERATOR->dDownloadUs,
+            (unsigned long long)SVECTOR_ITERATOR->dWriteUs,
+            (unsigned long long)SVECTOR_ITERATOR->dTotalUs);
+        bFirst = CFALSE;
+    }
+    fprintf(pFile, "]}\n");
+
+    bResult = ferror(pFile) == 0 ? CTRUE : CFALSE;
+    if (fclose(pFile) != 0)
+    {
+        bResult = CFALSE;
+    }
+
+    return bResult;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+static void
+_SUpdaterMetrics_ClearFiles(SUpdaterMetrics *pMetrics)
+{
+    SVector_ForEach(&pMetrics->tFiles)
+    {
+        SVector_InitIterator(SUpdaterFileMetrics, &pMetrics->tFiles);
+        free(SVECTOR_ITERATOR->sPath);
+    }
+    SVector_Clear(&pMetrics->tFiles);
+}
+
+static void
+_SUpdaterMetrics_WriteString(FILE *pFile, const char *sString)
+{
+    const unsigned char *pChar;
+
+    fputc('"', pFile);
+    for (pChar = (const unsigned char*)sString; pChar && *pChar; ++pChar)
+    {
+        if (*pChar == '"' || *pChar == '\\')
+        {
+            fputc('\\', pFile);
+            fputc(*pChar, pFile);
+        }
+        else if (*pChar < 0x20)
+        {
+            fprintf(pFile, "\\u%04x", *pChar);
+        }
+        else
+        {
+            fputc(*pChar, pFile);
+        }
+    }
+    fputc('"', pFile);
+}
+
+static void
+_SUpdaterMetrics_RotateLog(const char *sLogPath)
+{
+    uint64  dSize;
+    char    *sOldPath;
+
+    if (!AmberLauncher_FileStat(sLogPath, &dSize, NULL) ||
+        dSize < SUPDMETRICS_LOG_MAX_SIZE)
+    {
+        return;
+    }
+
+    sOldPath = (char*)malloc(strlen(sLogPath) + strlen(SUPDMETRICS_OLD_SUFFIX) + 1);
+    if (!sOldPath)
+    {
+        return;
+    }
+    strcpy(sOldPath, sLogPath);
+    strcat(sOldPath, SUPDMETRICS_OLD_SUFFIX);
+
+    AmberLauncher_FileReplace(sLogPath, sOldPath);
+    free(sOldPath);
+}
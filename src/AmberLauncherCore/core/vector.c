@@ -190,7 +190,7 @@ SVector_Insert(SVector* pVec, size_t dIndex, const void* pValue)
             (pVec->dSize - dIndex) * pVec->dElemSize);
 
     /* Insert the new element */
-    memcpy((char*)pVec->pData + dIndex * pVec->dElemSize, &pValue, pVec->dElemSize);
+    memcpy((char*)pVec->pData + dIndex * pVec->dElemSize, pValue, pVec->dElemSize);
     pVec->dSize++;
 
     return 0;
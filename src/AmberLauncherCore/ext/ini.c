@@ -333,6 +333,107 @@ int ini_set(ini_t *ini, const char *section, const char *key, const char *value)
   return 1;
 }
 
+/* Inserts raw '\0'-separated tokens at offset */
+static int _ini_insert(ini_t *ini, size_t off, const char *tokens, size_t len)
+{
+  size_t tail_sz = (size_t)(ini->end - ini->data) - off;
+
+  if (!_ini_grow(ini, len))
+  {
+    return 0;
+  }
+
+  memmove(ini->data + off + len, ini->data + off, tail_sz);
+  memcpy(ini->data + off, tokens, len);
+  *ini->end = '\0';
+
+  return 1;
+}
+
+ini_t* ini_create(void)
+{
+  ini_t *ini = malloc(sizeof(*ini));
+
+  if (!ini)
+  {
+    return NULL;
+  }
+
+  ini->data = calloc(1, 1);
+  if (!ini->data)
+  {
+    free(ini);
+    return NULL;
+  }
+  ini->end = ini->data;
+
+  return ini;
+}
+
+int ini_put(ini_t *ini, const char *section, const char *key, const char *value)
+{
+  char   *current_section = NULL;
+  char   *p;
+  char   *tokens;
+  size_t  off;
+  size_t  len;
+  int     found = 0;
+  int     result;
+
+  if (ini_get(ini, section, key))
+  {
+    return ini_set(ini, section, key, value);
+  }
+
+  /* New key goes to the end of its section, missing section to the end */
+  off = (size_t)(ini->end - ini->data);
+  p   = ini->data;
+  if (*p == '\0')
+  {
+    p = next(ini, p);
+  }
+  while (p < ini->end)
+  {
+    if (*p == '[')
+    {
+      if (found)
+      {
+        off = (size_t)(p - ini->data);
+        break;
+      }
+      current_section = p + 1;
+      found = !strcmpci(section, current_section);
+    }
+    else
+    {
+      p = next(ini, p);
+    }
+    p = next(ini, p);
+  }
+
+  len    = strlen(section) + strlen(key) + strlen(value) + 6;
+  tokens = malloc(len);
+  if (!tokens)
+  {
+    return 0;
+  }
+
+  /* "\0[section\0key\0value\0" or "\0key\0value\0" */
+  if (found)
+  {
+    len = (size_t)sprintf(tokens, "%c%s%c%s%c", '\0', key, '\0', value, '\0');
+  }
+  else
+  {
+    len = (size_t)sprintf(tokens, "%c[%s%c%s%c%s%c", '\0', section, '\0', key, '\0', value, '\0');
+  }
+
+  result = _ini_insert(ini, off, tokens, len);
+  free(tokens);
+
+  return result;
+}
+
 static void fput_escaped_value(FILE *fp, const char *val)
 {
   int needs_quote = 0;
@@ -381,18 +482,14 @@ int ini_save(ini_t *ini, const char *filename)
     return 0;
   }
 
-  if (*(ini->data) == '\0')
+  /* First token may be empty (file started with blank line), data pointer
+   * itself has to stay as allocated */
+  p = ini->data;
+  while (p < ini->end && *p == '\0')
   {
-    /* First token may be empty (file started with blank line) */
-    char *tmp = ini->data;
-    while (tmp < ini->end && *tmp == '\0')
-    {
-      tmp++;
-    }
-    ini->data = tmp;
+    p++;
   }
 
-  p = ini->data;
   while (p < ini->end)
   {
     if (*p == '[')
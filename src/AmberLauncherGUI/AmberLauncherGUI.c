@@ -4,6 +4,7 @@
 #include "draw2d/draw2d.hxx"
 #include "draw2d/guictx.hxx"
 #include <ext/miniz.h>
+#include <ext/ini.h>
 #include "gui/gui.hxx"
 #include "osbs/osbs.hxx"
 #include "sewer/types.hxx"
@@ -16,6 +17,13 @@
 #include <encode/json.h>
 #include <core/common.h>
 #include <core/appcore.h>
+#include <core/partfile.h>
+#include <core/manifest.h>
+#include <core/objstore.h>
+#include <core/snapshot.h>
+#include <core/hashcache.h>
+#include <core/opsys.h>
+#include <core/updmetrics.h>
 
 #include <nappgui.h>
 #include <res_app.h>
@@ -26,6 +34,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <time.h>
 
 /******************************************************************************
  * WINDOWS
@@ -75,6 +84,14 @@ static const char *_sLua_LAUNCHER_VERSION =
     "LAUNCHER_VERSION";
 static const char *_sLua_MOD_VERSION =
     "GAME_MOD_VERSION";
+static const char *_sLua_UPDATER_CONNECTIONS =
+    "UPDATER_CONNECTIONS";
+static const char *_sLua_UPDATER_RETRIES =
+    "UPDATER_RETRIES";
+static const char *_sLua_UPDATER_CHECK_INTERVAL =
+    "UPDATER_CHECK_INTERVAL";
+static const char *_sLua_INI_PATH_MOD =
+    "INI_PATH_MOD";
 
 const char* EUIEventTypeStrings[] = {
     "NULL",
@@ -93,10 +110,41 @@ const char* EUIEventTypeStrings[] = {
     "MODAL_MODS",
     "MODAL_TOOLS",
     "MODAL_UPDATER",
+    "MODAL_VERIFY",
     NULL
 };
 
+/* EUpdaterJobState, as reported in updater metrics */
+static const char *_sUpdaterJobStateStrings[] = {
+    "queued",
+    "running",
+    "skipped",
+    "restored",
+    "downloaded",
+    "failed",
+    "verified",
+    "missing",
+    "corrupt"
+};
+
 #define AL_PRINTF_BUFFER_SIZE               2048
+#define APP_UPDATE_INTERVAL                 0.5     /* seconds, file watcher events */
+#define APP_ARG_UPDATE                      "--update"
+#define APP_ARG_SIZE                        64
+
+#define UPDATER_DEFAULT_CONNECTIONS         4
+#define UPDATER_MAX_CONNECTIONS             16
+#define UPDATER_DEFAULT_RETRIES             3
+#define UPDATER_MAX_RETRIES                 8
+#define UPDATER_RETRY_DELAY_MS              500
+#define UPDATER_MAX_RETRY_DELAY_MS          8000
+#define UPDATER_POLL_INTERVAL_MS            50
+#define UPDATER_SEGMENT_SIZE                (4u << 20)
+#define UPDATER_HASHCACHE_PATH              AMBERLAUNCHER_STATE_DIR "/files.hashcache"
+#define UPDATER_CHECK_INI_SECTION           "Updater"
+#define UPDATER_CHECK_MIN_INTERVAL          300     /* seconds */
+#define UPDATER_CHECK_JITTER_DIV            10      /* up to +10% of interval */
+#define UPDATER_CHECK_RETRY_DIV             4       /* failed check: 1/4 interval */
 
 #define PANEL_DEFAULT_W                     640.f
 #define PANEL_DEFAULT_H                     480.f
@@ -122,6 +170,8 @@ static const real32_t _fMinBtnWidth         = 128.f;
 #define MODAL_PREVIOUS                      1034
 #define MODAL_NEXT                          1035
 #define MODAL_UPDATE_APP                    1036
+#define MODAL_VERIFY                        1037
+#define MODAL_REPAIR                        1038
 
 /******************************************************************************
  * STATIC DECLARATIONS
@@ -174,6 +224,17 @@ _Nappgui_Start(void);
 static void 
 _Nappgui_End(AppGUI **pApp);
 
+/**
+ * @relatedalso GUI
+ * @brief       Runs on main thread every APP_UPDATE_INTERVAL
+ *
+ * @param       pApp
+ * @param       fPrevTime
+ * @param       fCurrTime
+ */
+static void
+_Nappgui_Update(AppGUI *pApp, const real64_t fPrevTime, const real64_t fCurrTime);
+
 /**
  * @relatedalso GUI
  * @brief       Shows modal window
@@ -185,6 +246,16 @@ _Nappgui_End(AppGUI **pApp);
 static uint32_t
 _Nappgui_ShowModal( AppGUI *pApp, Panel *pPanel, const char* sTitle);
 
+/**
+ * @relatedalso GUI
+ * @brief       Looks for command line argument
+ *
+ * @param       sArg
+ * @return      bool_t TRUE if launcher was started with sArg
+ */
+static bool_t
+_Nappgui_HasArg(const char_t *sArg);
+
 static unsigned int
 _RowForPage(unsigned int dPage, unsigned int dPageMax);
 
@@ -206,6 +277,9 @@ _GUIThread_Main_Null(GUIAsyncTaskData *pThreadData);
 static void
 _GUIThread_End_PanelSetMain(GUIAsyncTaskData *pThreadData, const uint32_t dRValue);
 
+static void
+_GUIThread_End_Update(GUIAsyncTaskData *pThreadData, const uint32_t dRValue);
+
 /******************************************************************************
  * STATIC CALLBACK DECLARATIONS
  ******************************************************************************/
@@ -1737,7 +1811,7 @@ Panel_GetModalTools(AppGUI *pApp)
 }
 
 static Panel*
-_Panel_GetModalUpdaterSubpanel(AppGUI *pApp)
+_Panel_GetModalUpdaterSubpanel(AppGUI *pApp, const char_t *sTitle, const char_t *sInfo)
 {
     Panel    *pPanelMain           = panel_create();
     Layout   *pLayoutMain          = layout_create(1,3);
@@ -1752,8 +1826,8 @@ _Panel_GetModalUpdaterSubpanel(AppGUI *pApp)
     pApp->pWidgets->pProgressbar   = pProgressbar;
 
     /* Labels */
-    label_text(pLabelTitle, TXT_LABEL_UPDATER_TITLE);
-    label_text(pLabelInfo, TXT_UPDATERINFO);
+    label_text(pLabelTitle, sTitle);
+    label_text(pLabelInfo, sInfo);
 
     /* Text View: Log */
     pApp->pWidgets->pTextView = pTextView;
@@ -1792,7 +1866,8 @@ Panel*
 Panel_GetModalUpdater(AppGUI* pApp)
 {
     Panel       *pPanelMain         = panel_create();
-    Panel       *pPanelExt          = _Panel_GetModalUpdaterSubpanel(pApp);
+    Panel       *pPanelExt          = _Panel_GetModalUpdaterSubpanel(pApp,
+                                        TXT_LABEL_UPDATER_TITLE, TXT_UPDATERINFO);
     Layout      *pLayoutMain        = layout_create(1,3);
     Layout      *pLayoutExt         = layout_create(1,1);
     Layout      *pLayoutHeader      = layout_create(1,1);
@@ -1844,12 +1919,79 @@ Panel_GetModalUpdater(AppGUI* pApp)
     return pPanelMain;
 }
 
+Panel*
+Panel_GetModalVerify(AppGUI* pApp)
+{
+    Panel       *pPanelMain         = panel_create();
+    Panel       *pPanelExt          = _Panel_GetModalUpdaterSubpanel(pApp,
+                                        TXT_LABEL_VERIFY_TITLE, TXT_VERIFYINFO);
+    Layout      *pLayoutMain        = layout_create(1,3);
+    Layout      *pLayoutExt         = layout_create(1,1);
+    Layout      *pLayoutHeader      = layout_create(1,1);
+    Layout      *pLayoutButtons     = layout_create(4,1);
+    Button      *pButtonCancel      = button_push();
+    Button      *pButtonVerify      = button_push();
+    Button      *pButtonRepair      = button_push();
+    ImageView   *pImageViewHeader   = imageview_create();
+
+    /* Image View: Header Image */
+    imageview_scale(pImageViewHeader, ekGUI_SCALE_ADJUST);
+    imageview_size(pImageViewHeader, s2df(480,240));
+    imageview_image(pImageViewHeader, (const Image*)UPDATE_HEADER_JPG);
+
+    /* Button: Cancel */
+    button_text(pButtonCancel, TXT_BTN_CANCEL);
+    button_tag(pButtonCancel, MODAL_CANCEL);
+    button_OnClick(pButtonCancel, listener(pApp, Callback_OnButtonModalVerify, AppGUI));
+    button_min_width(pButtonCancel, 128.f);
+
+    /* Button: Verify */
+    button_text(pButtonVerify, TXT_BTN_VERIFY);
+    button_tag(pButtonVerify, MODAL_VERIFY);
+    button_OnClick(pButtonVerify, listener(pApp, Callback_OnButtonModalVerify, AppGUI));
+    button_min_width(pButtonVerify, 128.f);
+
+    /* Button: Repair */
+    button_text(pButtonRepair, TXT_BTN_REPAIR);
+    button_tag(pButtonRepair, MODAL_REPAIR);
+    button_OnClick(pButtonRepair, listener(pApp, Callback_OnButtonModalVerify, AppGUI));
+    button_min_width(pButtonRepair, 128.f);
+
+    /* Layout: External */
+    layout_panel(pLayoutExt, pPanelExt, 0, 0);
+
+    /* Layout: Header */
+    layout_margin4(pLayoutHeader, LAYOUT_DEFAULT_MARGIN, 0.f, 0.f, 0.f);
+    layout_imageview(pLayoutHeader, pImageViewHeader, 0, 0);
+
+    /* Layout: Buttons */
+    layout_margin4(pLayoutButtons, _fDefMarg * 2.f, _fDefMarg, _fDefMarg, _fDefMarg);
+    layout_halign(pLayoutButtons, 0, 0, ekLEFT);
+    layout_halign(pLayoutButtons, 2, 0, ekRIGHT);
+    layout_halign(pLayoutButtons, 3, 0, ekRIGHT);
+    layout_button(pLayoutButtons, pButtonCancel, 0, 0);
+    layout_button(pLayoutButtons, pButtonVerify, 2, 0);
+    layout_button(pLayoutButtons, pButtonRepair, 3, 0);
+
+    /* Layout: Main */
+    layout_layout(pLayoutMain, pLayoutHeader, 0, 0);
+    layout_layout(pLayoutMain, pLayoutExt, 0, 1);
+    layout_layout(pLayoutMain, pLayoutButtons, 0, 2);
+
+    panel_layout(pPanelMain, pLayoutMain);
+
+    unref(pApp);
+
+    return pPanelMain;
+}
+
 void
 AutoUpdate_Init(void)
 {
     dbind(InetUpdaterFile, String*, path);
     dbind(InetUpdaterFile, String*, sha256);
     dbind(InetUpdaterFile, uint32_t, size);
+    dbind(InetUpdaterFile, uint32_t, packed);
 
     dbind(InetUpdaterLauncherData, int32_t, version);
     dbind(InetUpdaterLauncherData, int32_t, build);
@@ -1858,340 +2000,1894 @@ AutoUpdate_Init(void)
     dbind(InetUpdaterJSONData, String*, generated);
     dbind(InetUpdaterJSONData, InetUpdaterLauncherData*, launcher);
     dbind(InetUpdaterJSONData, ArrSt(InetUpdaterFile)*, files);
+
+    /* Jitter of background update checks */
+    srand((unsigned int)time(NULL));
 }
 
-bool_t
-AutoUpdate_CheckForUpdates(AppGUI *pApp)
+/* Splits "scheme://host[:port]/path" into parts understood by Http */
+static bool_t
+_AutoUpdate_SplitURL(
+    const char_t *sURL,
+    String **sHost,
+    uint16_t *dPort,
+    String **sPath,
+    bool_t *bSecure)
 {
-    uint32_t            dResult;
-    ierror_t            eInetError;
-    bool_t              bUpdateRequired;
-    Stream              *pJsonLauncherStream;
-    Stream              *pJsonModStream;
-    InetUpdaterJSONData *pJsonLauncher;
-    InetUpdaterJSONData *pJsonMod;
+    const char_t *sSchemeEnd = strstr(sURL, "://");
+    const char_t *sHostBegin;
+    const char_t *sHostEnd;
+    const char_t *sPathBegin;
+    const char_t *sPortBegin;
+
+    if (!sSchemeEnd)
+    {
+        return FALSE;
+    }
+
+    *bSecure    = (sSchemeEnd - sURL == 5 && strncmp(sURL, "https", 5) == 0);
+    *dPort      = UINT16_MAX;
+    sHostBegin  = sSchemeEnd + 3;
+    sPathBegin  = strchr(sHostBegin, '/');
+    sHostEnd    = sPathBegin ? sPathBegin : sHostBegin + strlen(sHostBegin);
+    sPortBegin  = (const char_t*)memchr(sHostBegin, ':', (size_t)(sHostEnd - sHostBegin));
+
+    if (sPortBegin)
+    {
+        *dPort      = (uint16_t)atoi(sPortBegin + 1);
+        sHostEnd    = sPortBegin;
+    }
+
+    *sHost = str_cn(sHostBegin, (uint32_t)(sHostEnd - sHostBegin));
+    *sPath = str_c(sPathBegin ? sPathBegin : "/");
+
+    return TRUE;
+}
+
+static InetUpdaterJSONData*
+_AutoUpdate_ManifestToJSONData(SManifest *pManifest)
+{
+    InetUpdaterJSONData *pJson = dbind_create(InetUpdaterJSONData);
+    size_t              dIndex;
+
+    str_destroy(&pJson->schema);
+    str_destroy(&pJson->generated);
+    pJson->schema       = str_c(pManifest->sSchema);
+    pJson->generated    = str_c(pManifest->sGenerated);
+
+    if (!pJson->launcher)
+    {
+        pJson->launcher = dbind_create(InetUpdaterLauncherData);
+    }
+    pJson->launcher->version    = pManifest->dVersion;
+    pJson->launcher->build      = pManifest->dBuild;
+
+    if (!pJson->files)
+    {
+        pJson->files = arrst_create(InetUpdaterFile);
+    }
+
+    for (dIndex = 0; dIndex < SManifest_GetFileCount(pManifest); ++dIndex)
+    {
+        const SManifestFile *pSrc = SManifest_GetFile(pManifest, dIndex);
+        InetUpdaterFile     *pDst = arrst_new0(pJson->files, InetUpdaterFile);
+
+        pDst->path      = str_c(pSrc->sPath);
+        pDst->sha256    = str_c(pSrc->sSHA256);
+        pDst->size      = pSrc->dSize;
+        pDst->packed    = pSrc->dPackedSize;
+    }
+
+    return pJson;
+}
+
+/* GET revalidated against cached validators; body only on 200 */
+static Stream*
+_AutoUpdate_HttpGet(
+    const char_t *sURL,
+    const InetUpdaterManifestCache *pCache,
+    uint32_t *dStatus,
+    String **sETag,
+    String **sLastModified)
+{
+    String      *sHost;
+    String      *sPath;
+    uint16_t    dPort;
+    bool_t      bSecure;
+    Http        *pHttp;
+    Stream      *pBody = NULL;
+
+    *dStatus = 0;
+    if (!_AutoUpdate_SplitURL(sURL, &sHost, &dPort, &sPath, &bSecure))
+    {
+        return NULL;
+    }
+
+    pHttp = bSecure ?
+        http_secure(tc(sHost), dPort) :
+        http_create(tc(sHost), dPort);
+
+    if (pHttp)
+    {
+        http_clear_headers(pHttp);
+        if (pCache && pCache->sETag && !str_empty(pCache->sETag))
+        {
+            http_add_header(pHttp, "If-None-Match", tc(pCache->sETag));
+        }
+        if (pCache && pCache->sLastModified && !str_empty(pCache->sLastModified))
+        {
+            http_add_header(pHttp, "If-Modified-Since", tc(pCache->sLastModified));
+        }
+
+        if (http_get(pHttp, tc(sPath), NULL, 0, NULL))
+        {
+            *dStatus = http_response_status(pHttp);
+        }
+
+        if (*dStatus == 200)
+        {
+            pBody = stm_memory(4096);
+            if (http_response_body(pHttp, pBody, NULL))
+            {
+                *sETag          = str_c(http_response_header(pHttp, "ETag"));
+                *sLastModified  = str_c(http_response_header(pHttp, "Last-Modified"));
+            }
+            else
+            {
+                stm_close(&pBody);
+            }
+        }
+        http_destroy(&pHttp);
+    }
+
+    str_destroy(&sHost);
+    str_destroy(&sPath);
+
+    return pBody;
+}
+
+static InetUpdaterJSONData*
+_AutoUpdate_ParseManifest(Stream *pStream, bool_t bBinary)
+{
+    SManifest           *pManifest;
+    InetUpdaterJSONData *pJson;
+
+    if (!bBinary)
+    {
+        return json_read(pStream, NULL, InetUpdaterJSONData);
+    }
+
+    pManifest = SManifest_ReadBinary(stm_buffer(pStream), stm_buffer_size(pStream));
+    if (!pManifest)
+    {
+        return NULL;
+    }
+
+    pJson = _AutoUpdate_ManifestToJSONData(pManifest);
+    SManifest_delete(&pManifest);
+
+    return pJson;
+}
+
+static void
+_AutoUpdate_Cache_Clear(InetUpdaterManifestCache *pCache)
+{
+    str_destopt(&pCache->sManifestURL);
+    str_destopt(&pCache->sSourceURL);
+    str_destopt(&pCache->sETag);
+    str_destopt(&pCache->sLastModified);
+    if (pCache->pData)
+    {
+        json_destroy(&pCache->pData, InetUpdaterJSONData);
+    }
+}
+
+/*
+ * Returns manifest owned by the session cache. Compact binary twin
+ * ("*.bin" next to "*.json") is preferred, JSON is kept as fallback.
+ * Cached manifest is revalidated with ETag/Last-Modified, so repeated
+ * checks cost a 304 and no parsing.
+ */
+static InetUpdaterJSONData*
+_AutoUpdate_Session_Fetch(
+    AppGUI *pApp,
+    InetUpdaterManifestCache *pCache,
+    const char_t *sURL,
+    const char_t *sName)
+{
+    String          *sCandidates[2];
+    uint32_t        dCandidates = 0;
+    uint32_t        dIndex;
+    uint32_t        dStatus = 0;
+    const uint32_t  dLength = str_len_c(sURL);
+
+    _al_printf( pApp,
+        "[Updater] Fetching %s manifest at \n\t%s\n", sName, sURL);
+
+    /* Lua may have pointed updater elsewhere since last fetch */
+    if (pCache->sManifestURL && !str_equ(pCache->sManifestURL, sURL))
+    {
+        _AutoUpdate_Cache_Clear(pCache);
+    }
+    pCache->bNotModified = FALSE;
+
+    if (dLength > 5 && str_equ_c(sURL + dLength - 5, ".json"))
+    {
+        sCandidates[dCandidates] = str_cn(sURL, dLength - 5);
+        str_cat(&sCandidates[dCandidates++], ".bin");
+    }
+    sCandidates[dCandidates++] = str_c(sURL);
+
+    for (dIndex = 0; dIndex < dCandidates; ++dIndex)
+    {
+        const bool_t        bBinary = dCandidates > 1 && dIndex == 0;
+        const bool_t        bCached = pCache->pData && pCache->sSourceURL &&
+                                      str_equ(pCache->sSourceURL, tc(sCandidates[dIndex]));
+        String              *sETag = NULL;
+        String              *sLastModified = NULL;
+        Stream              *pStream;
+        InetUpdaterJSONData *pJson;
+
+        pStream = _AutoUpdate_HttpGet(
+            tc(sCandidates[dIndex]),
+            bCached ? pCache : NULL,
+            &dStatus,
+            &sETag,
+            &sLastModified);
+
+        if (dStatus == 304 && bCached)
+        {
+            pCache->bNotModified = TRUE;
+            _al_printf(pApp, "[Updater] %s manifest not modified (cached)\n", sName);
+            break;
+        }
+
+        if (!pStream)
+        {
+            continue;
+        }
+
+        pJson = _AutoUpdate_ParseManifest(pStream, bBinary);
+        stm_close(&pStream);
+
+        if (!pJson)
+        {
+            str_destopt(&sETag);
+            str_destopt(&sLastModified);
+            continue;
+        }
+
+        _AutoUpdate_Cache_Clear(pCache);
+        pCache->sManifestURL    = str_c(sURL);
+        pCache->sSourceURL      = str_copy(sCandidates[dIndex]);
+        pCache->sETag           = sETag;
+        pCache->sLastModified   = sLastModified;
+        pCache->pData           = pJson;
+
+        _al_printf(pApp, "[Updater] %s manifest retrieved from %s\n",
+            sName, tc(sCandidates[dIndex]));
+        break;
+    }
+
+    if (dIndex == dCandidates)
+    {
+        _al_printf( pApp,
+                    "[Updater] Couldn't fetch %s manifest"
+                    "\n\tdResult: %d\n",
+                    sName,
+                    dStatus);
+        _AutoUpdate_Cache_Clear(pCache);
+    }
+
+    for (dIndex = 0; dIndex < dCandidates; ++dIndex)
+    {
+        str_destroy(&sCandidates[dIndex]);
+    }
+
+    return pCache->pData;
+}
+
+void
+AutoUpdate_Finish(AppGUI *pApp)
+{
+    /* Background check may still be running, it must not come back to us */
+    if (pApp->pUpdaterCheck)
+    {
+        pApp->pUpdaterCheck->pApp = NULL;
+        pApp->pUpdaterCheck = NULL;
+    }
+
+    /* Running update keeps no more jobs and is waited for, workers use object
+     * store and snapshot which go away with AppCore */
+    if (pApp->pUpdaterRun)
+    {
+        InetUpdaterRunTask  *pTask = pApp->pUpdaterRun;
+        bool_t              bFinished;
+
+        bmutex_lock(pTask->tScheduler.pMutex);
+        pTask->tScheduler.bCancelled = TRUE;
+        bmutex_unlock(pTask->tScheduler.pMutex);
+
+        for (;;)
+        {
+            bmutex_lock(pTask->tScheduler.pMutex);
+            bFinished = pTask->bFinished;
+            bmutex_unlock(pTask->tScheduler.pMutex);
+
+            if (bFinished)
+            {
+                break;
+            }
+            bthread_sleep(UPDATER_POLL_INTERVAL_MS);
+        }
+
+        /* Files replaced so far stay restorable */
+        if (pTask->tScheduler.pSnapshot)
+        {
+            SSnapshot_End(&pTask->tScheduler.pSnapshot, NULL);
+        }
+        pTask->pApp = NULL;
+        pApp->pUpdaterRun = NULL;
+    }
+
+    if (IS_VALID(pApp->pUpdaterSession))
+    {
+        _AutoUpdate_Cache_Clear(&pApp->pUpdaterSession->tLauncher);
+        _AutoUpdate_Cache_Clear(&pApp->pUpdaterSession->tMod);
+        heap_delete(&pApp->pUpdaterSession, InetUpdaterSession);
+    }
+}
+
+static bool_t
+_AutoUpdate_IsUpdateRequired(
+    const InetUpdaterJSONData *pJsonLauncher,
+    const int32_t dLauncherVersion,
+    const int32_t dModVersion)
+{
+    const int32_t dLauncherBuild = str_to_i32(BUILD_NUMBER, 10, NULL);
+
+    return (dLauncherBuild < pJsonLauncher->launcher->build ||
+            dLauncherVersion < pJsonLauncher->launcher->version ||
+            dModVersion < pJsonLauncher->launcher->version);
+}
+
+/* Seconds between background checks, 0 if they're disabled */
+static uint32_t
+_AutoUpdate_Check_Interval(AppGUI *pApp)
+{
+    const SVar tLuaInterval = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_UPDATER_CHECK_INTERVAL);
+    const real64_t dInterval = SVAR_IS_DOUBLE(tLuaInterval) ? SVAR_GET_DOUBLE(tLuaInterval) : 0.0;
+
+    if (dInterval <= 0.0)
+    {
+        return 0;
+    }
+
+    return dInterval < UPDATER_CHECK_MIN_INTERVAL ?
+        UPDATER_CHECK_MIN_INTERVAL : (uint32_t)dInterval;
+}
+
+static String*
+_AutoUpdate_Check_IniPath(AppGUI *pApp)
+{
+    const SVar tLuaIniPath = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_INI_PATH_MOD);
+
+    return SVAR_IS_CONSTCHAR(tLuaIniPath) ? str_c(SVAR_GET_CONSTCHAR(tLuaIniPath)) : NULL;
+}
+
+/*
+ * mod.ini [Updater]
+ *  UpdateAvailable = 0|1   result of last successful check
+ *  LastCheck       = unix time of last successful check
+ *  NextCheck       = unix time background check is due
+ */
+static void
+_AutoUpdate_Check_Read(
+    const String *sIniPath,
+    bool_t *bUpdateAvailable,
+    uint32_t *dNextCheck)
+{
+    ini_t       *pIni;
+    const char  *sValue;
+
+    *bUpdateAvailable   = FALSE;
+    *dNextCheck         = 0;
+
+    pIni = sIniPath ? ini_load(tc(sIniPath)) : NULL;
+    if (!pIni)
+    {
+        return;
+    }
+
+    sValue = ini_get(pIni, UPDATER_CHECK_INI_SECTION, "UpdateAvailable");
+    *bUpdateAvailable = sValue && str_to_u32(sValue, 10, NULL) != 0;
+
+    sValue = ini_get(pIni, UPDATER_CHECK_INI_SECTION, "NextCheck");
+    *dNextCheck = sValue ? str_to_u32(sValue, 10, NULL) : 0;
+
+    ini_free(pIni);
+}
+
+/* Failed check is retried sooner, successful one is spread out by jitter */
+static void
+_AutoUpdate_Check_Write(
+    const String *sIniPath,
+    bool_t bSuccess,
+    bool_t bUpdateAvailable,
+    uint32_t dInterval)
+{
+    ini_t           *pIni;
+    char            sBuffer[16];
+    const uint32_t  dNow = (uint32_t)time(NULL);
+    uint32_t        dNextCheck;
+
+    if (!sIniPath)
+    {
+        return;
+    }
+
+    pIni = ini_load(tc(sIniPath));
+    if (!pIni)
+    {
+        pIni = ini_create();
+    }
+    if (!pIni)
+    {
+        return;
+    }
+
+    if (bSuccess)
+    {
+        dNextCheck = dNow + dInterval +
+            (uint32_t)rand() % (dInterval / UPDATER_CHECK_JITTER_DIV + 1);
+
+        ini_put(pIni, UPDATER_CHECK_INI_SECTION, "UpdateAvailable", bUpdateAvailable ? "1" : "0");
+        bstd_sprintf(sBuffer, sizeof(sBuffer), "%u", dNow);
+        ini_put(pIni, UPDATER_CHECK_INI_SECTION, "LastCheck", sBuffer);
+    }
+    else
+    {
+        dNextCheck = dNow + dInterval / UPDATER_CHECK_RETRY_DIV;
+    }
+
+    bstd_sprintf(sBuffer, sizeof(sBuffer), "%u", dNextCheck);
+    ini_put(pIni, UPDATER_CHECK_INI_SECTION, "NextCheck", sBuffer);
+
+    ini_save(pIni, tc(sIniPath));
+    ini_free(pIni);
+}
+
+static void
+_AutoUpdate_Check_SetBadge(AppGUI *pApp, bool_t bUpdateAvailable)
+{
+    Button *pButton = pApp->pWidgets->pButtonUpdate;
+
+    if (!pButton)
+    {
+        return;
+    }
+
+    if (gui_dark_mode())
+    {
+        button_image(pButton, bUpdateAvailable ?
+            (const Image*)ICO_UPDATE_AVAILABLE_DARK_PNG :
+            (const Image*)ICO_UPDATE_DARK_PNG);
+    }
+    else
+    {
+        button_image(pButton, bUpdateAvailable ?
+            (const Image*)ICO_UPDATE_AVAILABLE_PNG :
+            (const Image*)ICO_UPDATE_PNG);
+    }
+}
+
+/* GUI thread: refreshes sidebar badge and caches check result, unless
+ * background checks are off (nothing would ever read it) */
+static void
+_AutoUpdate_Check_Store(AppGUI *pApp, bool_t bSuccess, bool_t bUpdateAvailable)
+{
+    const uint32_t  dInterval = _AutoUpdate_Check_Interval(pApp);
+    String          *sIniPath;
+
+    if (bSuccess)
+    {
+        _AutoUpdate_Check_SetBadge(pApp, bUpdateAvailable);
+    }
+
+    if (dInterval == 0)
+    {
+        return;
+    }
+
+    sIniPath = _AutoUpdate_Check_IniPath(pApp);
+    _AutoUpdate_Check_Write(sIniPath, bSuccess, bUpdateAvailable, dInterval);
+    str_destopt(&sIniPath);
+}
+
+/* Takes over manifest fetched by background check, unless pDst has one */
+static void
+_AutoUpdate_Cache_Adopt(InetUpdaterManifestCache *pDst, InetUpdaterManifestCache *pSrc)
+{
+    if (pDst->pData || !pSrc->pData)
+    {
+        return;
+    }
+
+    _AutoUpdate_Cache_Clear(pDst);
+    *pDst = *pSrc;
+    memset(pSrc, 0, sizeof(InetUpdaterManifestCache));
+}
+
+/* Worker thread, must not touch pTask->pApp */
+static uint32_t
+_AutoUpdate_Check_Main(InetUpdaterCheckTask *pTask)
+{
+    InetUpdaterJSONData *pJsonLauncher;
+
+    pJsonLauncher = _AutoUpdate_Session_Fetch(NULL,
+        &pTask->pSession->tLauncher,
+        tc(pTask->sLauncherURL),
+        "Launcher");
+    if (!pJsonLauncher)
+    {
+        return 0;
+    }
+
+    if (!_AutoUpdate_Session_Fetch(NULL,
+            &pTask->pSession->tMod,
+            tc(pTask->sModURL),
+            "Mod"))
+    {
+        return 0;
+    }
+
+    pTask->bUpdateAvailable = _AutoUpdate_IsUpdateRequired(
+        pJsonLauncher, pTask->dLauncherVersion, pTask->dModVersion);
+
+    return 1;
+}
+
+/* GUI thread */
+static void
+_AutoUpdate_Check_End(InetUpdaterCheckTask *pTask, const uint32_t dRValue)
+{
+    AppGUI *pApp = pTask->pApp;
+
+    if (pApp)
+    {
+        pApp->pUpdaterCheck = NULL;
+
+        _AutoUpdate_Check_Write(pTask->sIniPath, dRValue != 0,
+            pTask->bUpdateAvailable, pTask->dInterval);
+
+        if (dRValue != 0)
+        {
+            _AutoUpdate_Check_SetBadge(pApp, pTask->bUpdateAvailable);
+
+            /* Updater modal then only has to revalidate them */
+            _AutoUpdate_Cache_Adopt(&pApp->pUpdaterSession->tLauncher,
+                &pTask->pSession->tLauncher);
+            _AutoUpdate_Cache_Adopt(&pApp->pUpdaterSession->tMod,
+                &pTask->pSession->tMod);
+        }
+    }
+
+    _AutoUpdate_Cache_Clear(&pTask->pSession->tLauncher);
+    _AutoUpdate_Cache_Clear(&pTask->pSession->tMod);
+    heap_delete(&pTask->pSession, InetUpdaterSession);
+    str_destroy(&pTask->sLauncherURL);
+    str_destroy(&pTask->sModURL);
+    str_destopt(&pTask->sIniPath);
+    heap_delete(&pTask, InetUpdaterCheckTask);
+}
+
+bool_t
+AutoUpdate_ScheduleCheck(AppGUI *pApp)
+{
+    InetUpdaterCheckTask *pTask;
+    bool_t          bUpdateAvailable;
+    uint32_t        dNextCheck;
+
+    const uint32_t  dInterval   = _AutoUpdate_Check_Interval(pApp);
+    const uint32_t  dNow        = (uint32_t)time(NULL);
+    String          *sIniPath;
+
+    const SVar tLuaLauncherVersion      = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_LAUNCHER_VERSION);
+    const SVar tLuaModVersion           = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_MOD_VERSION);
+    const SVar tLuaLauncherManifestURL  = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_LAUNCHER_MANIFEST);
+    const SVar tLuaModManifestURL       = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_MOD_MANIFEST);
+
+    /* Background checks are off, check right away as before */
+    if (dInterval == 0)
+    {
+        return AutoUpdate_CheckForUpdates(pApp);
+    }
+
+    sIniPath = _AutoUpdate_Check_IniPath(pApp);
+    _AutoUpdate_Check_Read(sIniPath, &bUpdateAvailable, &dNextCheck);
+
+    /* One check at a time and none before it's due (clock set back counts as due) */
+    if (pApp->pUpdaterCheck ||
+        (dNow < dNextCheck && dNextCheck - dNow <= dInterval * 2))
+    {
+        str_destopt(&sIniPath);
+        return bUpdateAvailable;
+    }
+
+    pTask = heap_new0(InetUpdaterCheckTask);
+    if (!IS_VALID(pTask))
+    {
+        str_destopt(&sIniPath);
+        return bUpdateAvailable;
+    }
+
+    pTask->pApp             = pApp;
+    pTask->pSession         = heap_new0(InetUpdaterSession);
+    pTask->sLauncherURL     = str_c(SVAR_IS_CONSTCHAR(tLuaLauncherManifestURL) ?
+        SVAR_GET_CONSTCHAR(tLuaLauncherManifestURL) :
+        _sDefaultUpdaterLauncherManifestURL);
+    pTask->sModURL          = str_c(SVAR_IS_CONSTCHAR(tLuaModManifestURL) ?
+        SVAR_GET_CONSTCHAR(tLuaModManifestURL) :
+        _sDefaultUpdaterModManifestURL);
+    pTask->sIniPath         = sIniPath;
+    pTask->dLauncherVersion = SVAR_IS_DOUBLE(tLuaLauncherVersion) ? (int32_t)SVAR_GET_DOUBLE(tLuaLauncherVersion) : 0;
+    pTask->dModVersion      = SVAR_IS_DOUBLE(tLuaModVersion)      ? (int32_t)SVAR_GET_DOUBLE(tLuaModVersion) : 0;
+    pTask->dInterval        = dInterval;
+    pTask->bUpdateAvailable = FALSE;
+
+    pApp->pUpdaterCheck     = pTask;
+
+    osapp_task(
+        pTask,
+        0.0,
+        _AutoUpdate_Check_Main,
+        NULL,
+        _AutoUpdate_Check_End,
+        InetUpdaterCheckTask
+    );
+
+    return bUpdateAvailable;
+}
+
+bool_t
+AutoUpdate_CheckForUpdates(AppGUI *pApp)
+{
+    bool_t              bUpdateRequired;
+    InetUpdaterJSONData *pJsonLauncher;
+    InetUpdaterJSONData *pJsonMod;
+
+    const SVar tLuaLauncherVersion      = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_LAUNCHER_VERSION);
+    const SVar tLuaModVersion           = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_MOD_VERSION);
+    const SVar tLuaLauncherManifestURL  = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_LAUNCHER_MANIFEST);
+    const SVar tLuaModManifestURL       = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_MOD_MANIFEST);
+    const int32_t dLauncherBuild        = str_to_i32(BUILD_NUMBER, 10, NULL);
+    const int32_t dLauncherVersion      = SVAR_IS_DOUBLE(tLuaLauncherVersion) ? (int32_t)SVAR_GET_DOUBLE(tLuaLauncherVersion) : 0;
+    const int32_t dModVersion           = SVAR_IS_DOUBLE(tLuaModVersion)      ? (int32_t)SVAR_GET_DOUBLE(tLuaModVersion) : 0;
+
+    static const char *sSchemaFmt       = "• Schema: \t\t%s\n";
+    static const char *sGeneratedFmt    = "• Generated: \t\t%s\n";
+    static const char *sAppVersionFmt   = "• App version: \t\t%d\n";
+    static const char *sNetVersionFmt   = "• Net version: \t\t%d\n";
+    static const char *sAppBuildFmt     = "• App build: \t\t%d\n";
+    static const char *sNetBuildFmt     = "• Net build: \t\t%d\n";
+    static const char *sModVersionFmt   = "• Mod version: \t\t%d\n";
+    static const char *sModNetVersionFmt= "• Mod Net version: \t%d\n";
+
+    pJsonLauncher = _AutoUpdate_Session_Fetch(pApp,
+        &pApp->pUpdaterSession->tLauncher,
+        SVAR_IS_CONSTCHAR(tLuaLauncherManifestURL) ?
+            SVAR_GET_CONSTCHAR(tLuaLauncherManifestURL) :
+            _sDefaultUpdaterLauncherManifestURL,
+        "Launcher");
+    if (!pJsonLauncher)
+    {
+        _AutoUpdate_Check_Store(pApp, FALSE, FALSE);
+        return FALSE;
+    }
+
+    pJsonMod = _AutoUpdate_Session_Fetch(pApp,
+        &pApp->pUpdaterSession->tMod,
+        SVAR_IS_CONSTCHAR(tLuaModManifestURL) ?
+            SVAR_GET_CONSTCHAR(tLuaModManifestURL) :
+            _sDefaultUpdaterModManifestURL,
+        "Mod");
+    if (!pJsonMod)
+    {
+        _AutoUpdate_Check_Store(pApp, FALSE, FALSE);
+        return FALSE;
+    }
+
+    /* Check for update and report */
+    bUpdateRequired = _AutoUpdate_IsUpdateRequired(
+        pJsonLauncher, dLauncherVersion, dModVersion);
+    _AutoUpdate_Check_Store(pApp, TRUE, bUpdateRequired);
+
+    _al_printf(pApp,
+        "[Updater] Manifests retrieved successfuly:\n"
+        "• Update required: \t%s\n",
+        bUpdateRequired ? "true" : "false"
+    );
+    _al_printf(pApp, sSchemaFmt, tc(pJsonLauncher->schema));
+    _al_printf(pApp, sGeneratedFmt, tc(pJsonLauncher->generated));
+    _al_printf(pApp, sAppVersionFmt, dLauncherVersion);
+    _al_printf(pApp, sNetVersionFmt, pJsonLauncher->launcher->version);
+    _al_printf(pApp, sAppBuildFmt, dLauncherBuild);
+    _al_printf(pApp, sNetBuildFmt, pJsonLauncher->launcher->build);
+    _al_printf(pApp, sModVersionFmt, dModVersion);
+    _al_printf(pApp, sModNetVersionFmt, pJsonMod->launcher->version);
+
+
+    return bUpdateRequired;
+}
+
+static void
+_AutoUpdate_Scheduler_AddJobs(
+    InetUpdaterScheduler *pScheduler,
+    InetUpdaterJSONData *pJson,
+    const char *sRootURL,
+    bool_t bForceDownload)
+{
+    arrst_foreach(elem, pJson->files, InetUpdaterFile)
+        InetUpdaterJob *pJob;
+
+        cassert(pScheduler->dNumJobs < pScheduler->dMaxJobs);
+        pJob = &pScheduler->pJobs[pScheduler->dNumJobs++];
+
+        pJob->sPath             = tc(elem->path);
+        pJob->sSHA256           = tc(elem->sha256);
+        pJob->sURL              = elem->packed > 0 ?
+            str_printf("%s%s%s", sRootURL, tc(elem->path), SMANIFEST_PACKED_SUFFIX) :
+            str_printf("%s%s", sRootURL, tc(elem->path));
+        pJob->dSize             = elem->size;
+        pJob->dPackedSize       = elem->packed;
+        pJob->dTransferSize     = elem->packed > 0 ? elem->packed : elem->size;
+        pJob->dBytesDone        = 0;
+        pJob->dResumedAt        = 0;
+        pJob->dAttempts         = 0;
+        pJob->eLink             = SOBJSTORE_LINK_NONE;
+        pJob->dHashUs           = 0;
+        pJob->dDownloadUs       = 0;
+        pJob->dWriteUs          = 0;
+        pJob->dTotalUs          = 0;
+        pJob->eState            = UPDATER_JOB_QUEUED;
+        pJob->bForceDownload    = bForceDownload;
+        pJob->bReported         = FALSE;
+
+        pScheduler->dBytesTotal += pJob->dTransferSize;
+    arrst_end()
+}
+
+static int
+_AutoUpdate_Job_CompareBySize(const void *pA, const void *pB)
+{
+    const InetUpdaterJob *pJobA = (const InetUpdaterJob*)pA;
+    const InetUpdaterJob *pJobB = (const InetUpdaterJob*)pB;
+
+    /* Largest first, so the long transfers don't end up as the tail */
+    if (pJobA->dTransferSize == pJobB->dTransferSize)
+    {
+        return 0;
+    }
+    return pJobA->dTransferSize > pJobB->dTransferSize ? -1 : 1;
+}
+
+/* Worker thread: hashes through scheduler's hash cache when available */
+static bool_t
+_AutoUpdate_HashFile(
+    InetUpdaterScheduler *pScheduler,
+    const char *sPath,
+    char *sSHA256Out)
+{
+    char *sSHA256Hash;
+
+    if (pScheduler->pHashCache)
+    {
+        return SHashCache_HashFile(pScheduler->pHashCache, sPath, sSHA256Out, NULL) ?
+            TRUE : FALSE;
+    }
+
+    sSHA256Hash = AmberLauncher_SHA256_HashFile(sPath);
+    if (!sSHA256Hash || strlen(sSHA256Hash) != SHASHCACHE_SHA256_HEX_SIZE)
+    {
+        free(sSHA256Hash);
+        return FALSE;
+    }
+    strcpy(sSHA256Out, sSHA256Hash);
+    free(sSHA256Hash);
+
+    return TRUE;
+}
+
+/* Worker thread: must not touch Lua or widgets. sSHA256Out gets hash of
+ * current file, empty if it wasn't computed */
+static bool_t
+_AutoUpdate_Job_IsUpToDate(
+    InetUpdaterScheduler *pScheduler,
+    InetUpdaterJob *pJob,
+    char *sSHA256Out)
+{
+    uint64_t    dStart;
+    bool_t      bHashed;
+
+    sSHA256Out[0] = '\0';
+    if (pJob->bForceDownload || !hfile_exists(pJob->sPath, 0))
+    {
+        return FALSE;
+    }
+
+    dStart          = btime_now();
+    bHashed         = _AutoUpdate_HashFile(pScheduler, pJob->sPath, sSHA256Out);
+    pJob->dHashUs  += btime_now() - dStart;
+    if (!bHashed)
+    {
+        sSHA256Out[0] = '\0';
+        return FALSE;
+    }
+
+    return strcmp(pJob->sSHA256, sSHA256Out) == 0;
+}
+
+static void
+_AutoUpdate_Scheduler_AddBytes(
+    InetUpdaterScheduler *pScheduler,
+    InetUpdaterJob *pJob,
+    uint32_t dBytes)
+{
+    bmutex_lock(pScheduler->pMutex);
+    pJob->dBytesDone        += dBytes;
+    pScheduler->dBytesDone  += dBytes;
+    bmutex_unlock(pScheduler->pMutex);
+}
+
+/* 
+ * Worker thread: must not touch Lua or widgets.
+ * Fetches file in bounded Range segments straight into the .part file,
+ * so memory usage doesn't depend on file size. Packed payloads are
+ * inflated by SPartFile while segments arrive.
+ */
+static bool_t
+_AutoUpdate_Job_Transfer(
+    InetUpdaterScheduler *pScheduler,
+    InetUpdaterJob *pJob,
+    Http *pHttp,
+    const char_t *sPath,
+    SPartFile *pPart)
+{
+    char_t      sRange[64];
+    uint32_t    dBegin;
+    uint32_t    dEnd;
+    uint32_t    dStatus;
+    uint64_t    dStart;
+    Stream      *pBody;
+    bool_t      bResult;
+
+    while (SPartFile_GetOffset(pPart) < pJob->dTransferSize)
+    {
+        dBegin  = (uint32_t)SPartFile_GetOffset(pPart);
+        dEnd    = pJob->dTransferSize - dBegin > UPDATER_SEGMENT_SIZE ?
+                    dBegin + UPDATER_SEGMENT_SIZE - 1 : pJob->dTransferSize - 1;
+
+        bstd_sprintf(sRange, sizeof(sRange), "bytes=%u-%u", dBegin, dEnd);
+        http_clear_headers(pHttp);
+        http_add_header(pHttp, "Range", sRange);
+
+        dStart = btime_now();
+        if (!http_get(pHttp, sPath, NULL, 0, NULL))
+        {
+            pJob->dDownloadUs += btime_now() - dStart;
+            return FALSE;
+        }
+
+        dStatus = http_response_status(pHttp);
+        if (dStatus == 206)
+        {
+            pBody   = stm_memory(dEnd - dBegin + 1);
+            bResult = http_response_body(pHttp, pBody, NULL) &&
+                      stm_buffer_size(pBody) == dEnd - dBegin + 1;
+            pJob->dDownloadUs += btime_now() - dStart;
+
+            dStart  = btime_now();
+            bResult = bResult &&
+                      SPartFile_Write(pPart, stm_buffer(pBody), stm_buffer_size(pBody));
+            stm_close(&pBody);
+
+            if (!bResult)
+            {
+                pJob->dWriteUs += btime_now() - dStart;
+                return FALSE;
+            }
+
+            /* Survives launcher shutdown: next run resumes from here */
+            SPartFile_Checkpoint(pPart);
+            pJob->dWriteUs += btime_now() - dStart;
+            _AutoUpdate_Scheduler_AddBytes(pScheduler, pJob, dEnd - dBegin + 1);
+        }
+        else if (dStatus == 200)
+        {
+            /* Server ignores Range: stream whole body to disk, then hash it */
+            SPartFile_Release(pPart);
+
+            pBody = stm_to_file(SPartFile_GetSpoolPath(pPart), NULL);
+            if (!pBody)
+            {
+                return FALSE;
+            }
+            bResult = http_response_body(pHttp, pBody, NULL);
+            stm_close(&pBody);
+            pJob->dDownloadUs += btime_now() - dStart;
+
+            return bResult && SPartFile_Reload(pPart);
+        }
+        else
+        {
+            pJob->dDownloadUs += btime_now() - dStart;
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* Worker thread: must not touch Lua or widgets */
+static bool_t
+_AutoUpdate_Job_Download(InetUpdaterScheduler *pScheduler, InetUpdaterJob *pJob)
+{
+    String      *sHost;
+    String      *sPath;
+    uint16_t    dPort;
+    bool_t      bSecure;
+    bool_t      bResult = FALSE;
+    uint32_t    dAttempt;
+    uint64_t    dStart;
+    SPartFile   *pPart;
+
+    if (!_AutoUpdate_SplitURL(tc(pJob->sURL), &sHost, &dPort, &sPath, &bSecure))
+    {
+        return FALSE;
+    }
+
+    pPart = SPartFile_Open(pJob->sPath, pJob->sSHA256, pJob->dSize, pJob->dPackedSize);
+    if (pPart)
+    {
+        pJob->dResumedAt = (uint32_t)SPartFile_GetOffset(pPart);
+        _AutoUpdate_Scheduler_AddBytes(pScheduler, pJob, pJob->dResumedAt);
+
+        /* Per-file retry with exponential backoff, continuing from last segment */
+        for (dAttempt = 0; dAttempt <= pScheduler->dMaxRetries && !bResult; ++dAttempt)
+        {
+            Http *pHttp;
+
+            if (dAttempt > 0)
+            {
+                const uint32_t dShift = dAttempt - 1 < 16 ? dAttempt - 1 : 16;
+                const uint32_t dDelay = UPDATER_RETRY_DELAY_MS << dShift;
+
+                bthread_sleep(dDelay < UPDATER_MAX_RETRY_DELAY_MS ? dDelay : UPDATER_MAX_RETRY_DELAY_MS);
+            }
+
+            pJob->dAttempts = dAttempt + 1;
+            pHttp = bSecure ? 
+                http_secure(tc(sHost), dPort) : 
+                http_create(tc(sHost), dPort);
+
+            if (pHttp)
+            {
+                bResult = _AutoUpdate_Job_Transfer(pScheduler, pJob, pHttp, tc(sPath), pPart);
+                http_destroy(&pHttp);
+            }
+        }
+
+        /* Verified file replaces the old one in a single rename */
+        dStart = btime_now();
+        if (bResult)
+        {
+            bResult = SPartFile_Commit(&pPart);
+        }
+
+        /* Keep a copy (link) around, so reinstall or rollback won't download it again */
+        if (bResult && pScheduler->pObjectStore)
+        {
+            SObjectStore_Import(pScheduler->pObjectStore, pJob->sPath, pJob->sSHA256, NULL);
+        }
+        else
+        {
+            /* Keeps .part and journal for the next session */
+            SPartFile_Close(&pPart);
+        }
+        pJob->dWriteUs += btime_now() - dStart;
+    }
+
+    str_destroy(&sHost);
+    str_destroy(&sPath);
+
+    return bResult;
+}
+
+static uint32_t
+_AutoUpdate_Worker_Main(InetUpdaterScheduler *pScheduler)
+{
+    for (;;)
+    {
+        InetUpdaterJob      *pJob;
+        EUpdaterJobState    eState;
+        bool_t              bUpToDate;
+        uint64_t            dStart;
+        char                sOldSHA256[SOBJSTORE_SHA256_HEX_SIZE + 1];
+
+        bmutex_lock(pScheduler->pMutex);
+        if (pScheduler->bCancelled || pScheduler->dNextJob >= pScheduler->dNumJobs)
+        {
+            bmutex_unlock(pScheduler->pMutex);
+            break;
+        }
+        pJob            = &pScheduler->pJobs[pScheduler->dNextJob++];
+        pJob->eState    = UPDATER_JOB_RUNNING;
+        bmutex_unlock(pScheduler->pMutex);
+
+        dStart    = btime_now();
+        bUpToDate = _AutoUpdate_Job_IsUpToDate(pScheduler, pJob, sOldSHA256);
+        if (!bUpToDate && pScheduler->pSnapshot)
+        {
+            /* Old contents go to object store (reflink/copy) for rollback */
+            SSnapshot_AddFile(pScheduler->pSnapshot, pJob->sPath,
+                sOldSHA256[0] ? sOldSHA256 : NULL);
+        }
+
+        if (bUpToDate)
+        {
+            SPartFile_Discard(pJob->sPath);
+            eState = UPDATER_JOB_SKIPPED;
+        }
+        else if (!pJob->bForceDownload && pScheduler->pObjectStore &&
+                 (pJob->eLink = SObjectStore_Install(
+                     pScheduler->pObjectStore, pJob->sSHA256, pJob->sPath)) != SOBJSTORE_LINK_NONE)
+        {
+            SPartFile_Discard(pJob->sPath);
+            eState = UPDATER_JOB_RESTORED;
+        }
+        else
+        {
+            eState = _AutoUpdate_Job_Download(pScheduler, pJob) ?
+                UPDATER_JOB_DONE : UPDATER_JOB_FAILED;
+        }
+        pJob->dTotalUs = btime_now() - dStart;
+
+        bmutex_lock(pScheduler->pMutex);
+        pJob->eState                = eState;
+        pScheduler->dBytesDone     += pJob->dTransferSize - pJob->dBytesDone;
+        pScheduler->dFinishedJobs  += 1;
+        bmutex_unlock(pScheduler->pMutex);
+    }
+
+    return 0;
+}
+
+/* Verify worker: size first, sha256 only for files of right size */
+static uint32_t
+_AutoUpdate_Worker_Verify(InetUpdaterScheduler *pScheduler)
+{
+    for (;;)
+    {
+        InetUpdaterJob      *pJob;
+        EUpdaterJobState    eState;
+        uint64              dSize;
+        uint64_t            dStart;
+        bool_t              bHashed;
+        char                sSHA256[SHASHCACHE_SHA256_HEX_SIZE + 1];
+
+        bmutex_lock(pScheduler->pMutex);
+        if (pScheduler->bCancelled || pScheduler->dNextJob >= pScheduler->dNumJobs)
+        {
+            bmutex_unlock(pScheduler->pMutex);
+            break;
+        }
+        pJob            = &pScheduler->pJobs[pScheduler->dNextJob++];
+        pJob->eState    = UPDATER_JOB_RUNNING;
+        bmutex_unlock(pScheduler->pMutex);
+
+        dStart = btime_now();
+        if (!AmberLauncher_FileStat(pJob->sPath, &dSize, NULL))
+        {
+            eState = UPDATER_JOB_MISSING;
+        }
+        else if (dSize != pJob->dSize)
+        {
+            eState = UPDATER_JOB_CORRUPT;
+        }
+        else
+        {
+            bHashed         = _AutoUpdate_HashFile(pScheduler, pJob->sPath, sSHA256);
+            pJob->dHashUs  += btime_now() - dStart;
+            eState          = bHashed && strcmp(sSHA256, pJob->sSHA256) == 0 ?
+                UPDATER_JOB_VERIFIED : UPDATER_JOB_CORRUPT;
+        }
+        pJob->dTotalUs = btime_now() - dStart;
+
+        bmutex_lock(pScheduler->pMutex);
+        pJob->eState                = eState;
+        pScheduler->dBytesDone     += pJob->dSize;
+        pScheduler->dFinishedJobs  += 1;
+        bmutex_unlock(pScheduler->pMutex);
+    }
+
+    return 0;
+}
+
+/* Reports finished jobs, returns number of failed ones (GUI thread) */
+static uint32_t
+_AutoUpdate_Scheduler_Report(AppGUI *pApp, InetUpdaterScheduler *pScheduler)
+{
+    uint32_t dIndex;
+    uint32_t dFailed = 0;
+
+    for (dIndex = 0; dIndex < pScheduler->dNumJobs; ++dIndex)
+    {
+        InetUpdaterJob *pJob = &pScheduler->pJobs[dIndex];
+
+        if (pJob->eState == UPDATER_JOB_FAILED)
+        {
+            dFailed++;
+        }
+
+        if (pJob->bReported ||
+            pJob->eState == UPDATER_JOB_QUEUED ||
+            pJob->eState == UPDATER_JOB_RUNNING)
+        {
+            continue;
+        }
+
+        switch (pJob->eState)
+        {
+            case UPDATER_JOB_SKIPPED:
+                _al_printf(pApp, "[Updater] Up to date: %s\n", pJob->sPath);
+                break;
+            case UPDATER_JOB_RESTORED:
+                _al_printf(pApp, "[Updater] Restored from object store (%s): %s\n",
+                    ESObjectLinkStrings[pJob->eLink], pJob->sPath);
+                break;
+            case UPDATER_JOB_DONE:
+                if (pJob->dResumedAt > 0)
+                {
+                    _al_printf(pApp, "[Updater] Downloaded %s (%u/%u bytes, resumed at %u, attempt %u)\n",
+                        pJob->sPath, pJob->dTransferSize, pJob->dSize, pJob->dResumedAt, pJob->dAttempts);
+                    break;
+                }
+                _al_printf(pApp, "[Updater] Downloaded %s (%u/%u bytes, attempt %u)\n",
+                    pJob->sPath, pJob->dTransferSize, pJob->dSize, pJob->dAttempts);
+                break;
+            case UPDATER_JOB_VERIFIED:
+                break;
+            case UPDATER_JOB_MISSING:
+                _al_printf(pApp, "[Verify] Missing: %s\n", pJob->sPath);
+                break;
+            case UPDATER_JOB_CORRUPT:
+                _al_printf(pApp, "[Verify] Corrupt: %s\n", pJob->sPath);
+                break;
+            case UPDATER_JOB_FAILED:
+            default:
+                _al_printf(pApp, "[Updater] Failed to download %s after %u attempts\n",
+                    tc(pJob->sURL), pJob->dAttempts);
+                break;
+        }
+        pJob->bReported = TRUE;
+    }
+
+    if (pApp->pWidgets->pProgressbar && pScheduler->dBytesTotal > 0)
+    {
+        progress_value(pApp->pWidgets->pProgressbar,
+            (real32_t)((real64_t)pScheduler->dBytesDone /
+                       (real64_t)pScheduler->dBytesTotal));
+    }
+
+    return dFailed;
+}
+
+/* Adds finished run to session metrics (GUI thread, workers are joined) */
+static void
+_AutoUpdate_Metrics_Collect(
+    AppGUI *pApp,
+    InetUpdaterScheduler *pScheduler,
+    uint32_t dConnections,
+    uint64_t dWallUs)
+{
+    SUpdaterMetrics *pMetrics = pApp->pAppCore->pUpdaterMetrics;
+    uint32_t        dIndex;
+
+    if (!pMetrics)
+    {
+        return;
+    }
+
+    pMetrics->dWallUs       += dWallUs;
+    pMetrics->dConnections   = dConnections > pMetrics->dConnections ?
+        dConnections : pMetrics->dConnections;
+
+    for (dIndex = 0; dIndex < pScheduler->dNumJobs; ++dIndex)
+    {
+        const InetUpdaterJob    *pJob = &pScheduler->pJobs[dIndex];
+        SUpdaterFileMetrics     tFile;
+
+        /* Body of a 200 response isn't counted while it streams */
+        tFile.sPath         = (char*)pJob->sPath;
+        tFile.sResult       = _sUpdaterJobStateStrings[pJob->eState];
+        tFile.dSize         = pJob->dSize;
+        tFile.dBytes        = pJob->eState == UPDATER_JOB_DONE ?
+            pJob->dTransferSize - pJob->dResumedAt :
+            pJob->dBytesDone - pJob->dResumedAt;
+        tFile.dAttempts     = pJob->dAttempts;
+        tFile.dHashUs       = pJob->dHashUs;
+        tFile.dDownloadUs   = pJob->dDownloadUs;
+        tFile.dWriteUs      = pJob->dWriteUs;
+        tFile.dTotalUs      = pJob->dTotalUs;
+
+        if (pJob->eState == UPDATER_JOB_RESTORED)
+        {
+            pMetrics->dObjectStoreHits++;
+        }
+        SUpdaterMetrics_AddFile(pMetrics, &tFile);
+    }
+}
+
+static void
+_AutoUpdate_Metrics_AddManifest(AppGUI *pApp, const InetUpdaterManifestCache *pCache)
+{
+    SUpdaterMetrics *pMetrics = pApp->pAppCore->pUpdaterMetrics;
+
+    if (pMetrics)
+    {
+        pMetrics->dManifestFetches++;
+        pMetrics->dManifestCacheHits += pCache->bNotModified ? 1 : 0;
+    }
+}
+
+/* Closes session: hash cache stats, summary line and JSON log */
+static void
+_AutoUpdate_Metrics_Finish(AppGUI *pApp, InetUpdaterScheduler *pScheduler)
+{
+    SUpdaterMetrics *pMetrics = pApp->pAppCore->pUpdaterMetrics;
+
+    if (!pMetrics)
+    {
+        return;
+    }
+
+    if (pScheduler->pHashCache)
+    {
+        SHashCache_GetStats(pScheduler->pHashCache,
+            &pMetrics->dHashCacheHits, &pMetrics->dHashCacheMisses);
+    }
+
+    _al_printf(pApp,
+        "[Updater] %.1fs, %u KB at %.0f KB/s (download %.1fs, hash %.1fs, write %.1fs "
+        "over all connections), %u retries, %u hash cache hits, %u object store hits\n",
+        (real64_t)pMetrics->dWallUs / 1000000.0,
+        (uint32_t)(pMetrics->dBytes >> 10),
+        SUpdaterMetrics_Rate(pMetrics->dBytes, pMetrics->dWallUs) / 1024.0,
+        (real64_t)pMetrics->dDownloadUs / 1000000.0,
+        (real64_t)pMetrics->dHashUs / 1000000.0,
+        (real64_t)pMetrics->dWriteUs / 1000000.0,
+        pMetrics->dRetries,
+        pMetrics->dHashCacheHits,
+        pMetrics->dObjectStoreHits);
+
+    SUpdaterMetrics_AppendLog(pMetrics, SUPDMETRICS_DEFAULT_LOG);
+}
+
+/* Lua number clamped to [dMin, dMax] before conversion, NaN gives default */
+static uint32_t
+_AutoUpdate_GetCount(
+    AppGUI *pApp,
+    const char *sVarName,
+    uint32_t dDefault,
+    uint32_t dMin,
+    uint32_t dMax)
+{
+    const SVar tLuaValue = AmberLauncher_GetGlobalVariable(pApp->pAppCore, sVarName);
+    real64_t   dValue;
+
+    if (!SVAR_IS_DOUBLE(tLuaValue) || SVAR_GET_DOUBLE(tLuaValue) != SVAR_GET_DOUBLE(tLuaValue))
+    {
+        return dDefault;
+    }
+
+    dValue = SVAR_GET_DOUBLE(tLuaValue);
+    dValue = dValue < (real64_t)dMin ? (real64_t)dMin : dValue;
+    dValue = dValue > (real64_t)dMax ? (real64_t)dMax : dValue;
+
+    return (uint32_t)dValue;
+}
+
+/* Jobs, mutex and hash cache; snapshot is up to the caller (GUI thread) */
+static void
+_AutoUpdate_Scheduler_Create(
+    AppGUI *pApp,
+    InetUpdaterScheduler *pScheduler,
+    uint32_t dMaxJobs)
+{
+    pScheduler->dNumJobs         = 0;
+    pScheduler->dNextJob         = 0;
+    pScheduler->dFinishedJobs    = 0;
+    pScheduler->dBytesTotal      = 0;
+    pScheduler->dBytesDone       = 0;
+    pScheduler->bCancelled       = FALSE;
+    pScheduler->dMaxRetries      = _AutoUpdate_GetCount(pApp, _sLua_UPDATER_RETRIES,
+        UPDATER_DEFAULT_RETRIES, 0, UPDATER_MAX_RETRIES);
+    pScheduler->dMaxJobs         = dMaxJobs > 0 ? dMaxJobs : 1;
+    pScheduler->pJobs            = heap_new_n(pScheduler->dMaxJobs, InetUpdaterJob);
+    pScheduler->pMutex           = bmutex_create();
+    pScheduler->pObjectStore     = pApp->pAppCore->pObjectStore;
+    pScheduler->pSnapshot        = NULL;
+    pScheduler->pHashCache       = SHashCache_Load(UPDATER_HASHCACHE_PATH);
+}
+
+static void
+_AutoUpdate_Scheduler_Destroy(InetUpdaterScheduler *pScheduler)
+{
+    uint32_t dIndex;
+
+    for (dIndex = 0; dIndex < pScheduler->dNumJobs; ++dIndex)
+    {
+        str_destroy(&pScheduler->pJobs[dIndex].sURL);
+    }
+    heap_delete_n(&pScheduler->pJobs, pScheduler->dMaxJobs, InetUpdaterJob);
+    bmutex_close(&pScheduler->pMutex);
+
+    if (pScheduler->pHashCache)
+    {
+        SHashCache_Save(pScheduler->pHashCache);
+        SHashCache_delete(&pScheduler->pHashCache);
+    }
+}
+
+static void
+_AutoUpdate_Run_Free(InetUpdaterRunTask **pTask)
+{
+    _AutoUpdate_Scheduler_Destroy(&(*pTask)->tScheduler);
+    heap_delete(pTask, InetUpdaterRunTask);
+}
+
+/* Worker thread, drains queue over worker pool. Must not touch pTask->pApp */
+static uint32_t
+_AutoUpdate_Run_Main(InetUpdaterRunTask *pTask)
+{
+    InetUpdaterScheduler    *pScheduler = &pTask->tScheduler;
+    Thread                  *pWorkers[UPDATER_MAX_CONNECTIONS];
+    uint32_t                dIndex;
+    const uint64_t          dStart = btime_now();
+
+    for (dIndex = 0; dIndex < pTask->dConnections; ++dIndex)
+    {
+        pWorkers[dIndex] = bthread_create(pTask->cbWorker, pScheduler, InetUpdaterScheduler);
+    }
+
+    for (dIndex = 0; dIndex < pTask->dConnections; ++dIndex)
+    {
+        bthread_wait(pWorkers[dIndex]);
+        bthread_close(&pWorkers[dIndex]);
+    }
+
+    bmutex_lock(pScheduler->pMutex);
+    pTask->dWallUs   = btime_now() - dStart;
+    pTask->bFinished = TRUE;
+    bmutex_unlock(pScheduler->pMutex);
+
+    return 0;
+}
+
+/* GUI thread, aggregates progress while workers drain the queue */
+static void
+_AutoUpdate_Run_Update(InetUpdaterRunTask *pTask)
+{
+    if (!pTask->pApp)
+    {
+        return;
+    }
+
+    bmutex_lock(pTask->tScheduler.pMutex);
+    _AutoUpdate_Scheduler_Report(pTask->pApp, &pTask->tScheduler);
+    bmutex_unlock(pTask->tScheduler.pMutex);
+}
+
+/* GUI thread, workers are joined. cbEnd takes over pTask */
+static void
+_AutoUpdate_Run_End(InetUpdaterRunTask *pTask, const uint32_t dRValue)
+{
+    AppGUI      *pApp = pTask->pApp;
+    uint32_t    dFailed;
+
+    if (!pApp)
+    {
+        _AutoUpdate_Run_Free(&pTask);
+        return;
+    }
+
+    pApp->pUpdaterRun = NULL;
+
+    dFailed = _AutoUpdate_Scheduler_Report(pApp, &pTask->tScheduler);
+    _AutoUpdate_Metrics_Collect(pApp, &pTask->tScheduler, pTask->dConnections, pTask->dWallUs);
+    pTask->cbEnd(pTask, dFailed);
+
+    unref(dRValue);
+}
+
+/* Queues largest files first and hands them to worker pool (GUI thread) */
+static void
+_AutoUpdate_Run_Start(AppGUI *pApp, InetUpdaterRunTask *pTask, uint32_t dConnections)
+{
+    InetUpdaterScheduler *pScheduler = &pTask->tScheduler;
+
+    qsort(pScheduler->pJobs, pScheduler->dNumJobs,
+        sizeof(InetUpdaterJob), _AutoUpdate_Job_CompareBySize);
+
+    dConnections = dConnections < 1 ? 1 : dConnections;
+    dConnections = dConnections > UPDATER_MAX_CONNECTIONS ? UPDATER_MAX_CONNECTIONS : dConnections;
+    dConnections = dConnections > pScheduler->dNumJobs ? pScheduler->dNumJobs : dConnections;
+
+    _al_printf(pApp, "[Updater] Processing %u files (%u bytes) over %u connections\n",
+        pScheduler->dNumJobs, (uint32_t)pScheduler->dBytesTotal, dConnections);
+
+    pTask->pApp         = pApp;
+    pTask->dConnections = dConnections;
+    pTask->dWallUs      = 0;
+    pTask->bFinished    = FALSE;
+
+    pApp->pUpdaterRun   = pTask;
+
+    osapp_task(
+        pTask,
+        (real64_t)UPDATER_POLL_INTERVAL_MS / 1000.0,
+        _AutoUpdate_Run_Main,
+        _AutoUpdate_Run_Update,
+        _AutoUpdate_Run_End,
+        InetUpdaterRunTask
+    );
+}
+
+/* Writes snapshot, then drops objects no kept snapshot needs anymore; files
+ * of current manifests stay so repair can install them from store */
+static void
+_AutoUpdate_Snapshot_Finish(AppGUI *pApp, InetUpdaterScheduler *pScheduler)
+{
+    const char_t    **pKeep;
+    uint32_t        dIndex;
+    uint32          dSnapshotFiles;
+    uint32          dRemoved;
+
+    if (!pScheduler->pSnapshot)
+    {
+        return;
+    }
+
+    if (SSnapshot_End(&pScheduler->pSnapshot, &dSnapshotFiles) && dSnapshotFiles > 0)
+    {
+        _al_printf(pApp, "[Updater] Snapshot of %u replaced files saved (AL.UpdateRollback() restores it)\n",
+            dSnapshotFiles);
+    }
+
+    pKeep = heap_new_n(pScheduler->dNumJobs + 1, const char_t*);
+    for (dIndex = 0; dIndex < pScheduler->dNumJobs; ++dIndex)
+    {
+        pKeep[dIndex] = pScheduler->pJobs[dIndex].sSHA256;
+    }
+    if (SSnapshot_Collect(pScheduler->pObjectStore, SSNAPSHOT_DEFAULT_ROOT,
+            pKeep, pScheduler->dNumJobs, &dRemoved) && dRemoved > 0)
+    {
+        _al_printf(pApp, "[Updater] Removed %u objects no snapshot refers to\n", dRemoved);
+    }
+    heap_delete_n(&pKeep, pScheduler->dNumJobs + 1, const char_t*);
+}
+
+/* GUI thread, end of update run */
+static void
+_AutoUpdate_Update_End(InetUpdaterRunTask *pTask, uint32_t dFailed)
+{
+    AppGUI *pApp = pTask->pApp;
+
+    _AutoUpdate_Metrics_Finish(pApp, &pTask->tScheduler);
+    _AutoUpdate_Snapshot_Finish(pApp, &pTask->tScheduler);
+    _AutoUpdate_Run_Free(&pTask);
+
+    if (dFailed > 0)
+    {
+        _al_printf(pApp, "[Updater] Update incomplete: %u files failed\n", dFailed);
+        if (pApp->bUnattended)
+        {
+            osapp_finish();
+        }
+        return;
+    }
+
+    _al_printf( pApp,"[Updater] Update done!\n");
+    _AutoUpdate_Check_Store(pApp, TRUE, FALSE);
+
+    /* Fire end event */
+    AmberLauncher_Update(pApp->pAppCore, CTRUE);
+
+    if (pApp->bUnattended)
+    {
+        osapp_finish();
+    }
+    else if (pApp->pWindows->pWindowModal)
+    {
+        pApp->pWidgets->pTextView = NULL;
+        window_stop_modal(pApp->pWindows->pWindowModal, MODAL_UPDATE_APP);
+    }
+}
+
+bool_t
+AutoUpdate_Update(AppGUI *pApp, bool_t bForceDownload)
+{
+    InetUpdaterJSONData *pJsonLauncher;
+    InetUpdaterJSONData *pJsonMod;
+    InetUpdaterRunTask  *pTask;
+
+    static const char *sFileArrayFmt = "• File: %s\n• • sha256: \n%s\n• • size: %u (packed: %u)\n";
+
+    const SVar tLuaLauncherManifestURL  = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_LAUNCHER_MANIFEST);
+    const SVar tLuaModManifestURL       = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_MOD_MANIFEST);
+    const SVar tLuaRootURL              = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_ROOT);
+
+    if (pApp->pUpdaterRun)
+    {
+        return FALSE;
+    }
+
+    /* Fire start event */
+    AmberLauncher_Update(pApp->pAppCore, CFALSE);
+    SUpdaterMetrics_Reset(pApp->pAppCore->pUpdaterMetrics, "update");
+
+    /* Manifests */
+    pJsonLauncher = _AutoUpdate_Session_Fetch(pApp,
+        &pApp->pUpdaterSession->tLauncher,
+        SVAR_IS_CONSTCHAR(tLuaLauncherManifestURL) ?
+            SVAR_GET_CONSTCHAR(tLuaLauncherManifestURL) :
+            _sDefaultUpdaterLauncherManifestURL,
+        "Launcher");
+    if (!pJsonLauncher)
+    {
+        return FALSE;
+    }
+
+    pJsonMod = _AutoUpdate_Session_Fetch(pApp,
+        &pApp->pUpdaterSession->tMod,
+        SVAR_IS_CONSTCHAR(tLuaModManifestURL) ?
+            SVAR_GET_CONSTCHAR(tLuaModManifestURL) :
+            _sDefaultUpdaterModManifestURL,
+        "Mod");
+    if (!pJsonMod)
+    {
+        return FALSE;
+    }
+    _AutoUpdate_Metrics_AddManifest(pApp, &pApp->pUpdaterSession->tLauncher);
+    _AutoUpdate_Metrics_AddManifest(pApp, &pApp->pUpdaterSession->tMod);
+
+    /* Print files */
+    _al_printf(pApp, "Launcher files: \n");
+    arrst_foreach(elem, pJsonLauncher->files, InetUpdaterFile)
+        _al_printf(pApp, sFileArrayFmt, tc(elem->path), tc(elem->sha256), elem->size, elem->packed);
+    arrst_end()
+    _al_printf(pApp, "\n");
+    _al_printf(pApp, "Mod files: \n");
+    arrst_foreach(elem, pJsonMod->files, InetUpdaterFile)
+        _al_printf(pApp, sFileArrayFmt, tc(elem->path), tc(elem->sha256), elem->size, elem->packed);
+    arrst_end()
+    _al_printf(pApp, "\n");
+
+    /* Download files */
+    if (pApp->pWidgets->pProgressbar)
+    {
+        progress_value(pApp->pWidgets->pProgressbar, 
+            0.0f);
+    }
+    
+    _al_printf(pApp, "[Updater] Remote Updater Server: %s\n",
+        SVAR_IS_CONSTCHAR(tLuaRootURL) ?
+            SVAR_GET_CONSTCHAR(tLuaRootURL) :
+            _sDefaultUpdaterRemoteRootURL);
+
+    pTask = heap_new0(InetUpdaterRunTask);
+    if (!IS_VALID(pTask))
+    {
+        return FALSE;
+    }
+
+    _AutoUpdate_Scheduler_Create(pApp, &pTask->tScheduler,
+        arrst_size(pJsonLauncher->files, InetUpdaterFile) +
+        arrst_size(pJsonMod->files, InetUpdaterFile));
+    pTask->tScheduler.pSnapshot = pTask->tScheduler.pObjectStore ?
+        SSnapshot_Begin(pTask->tScheduler.pObjectStore, SSNAPSHOT_DEFAULT_ROOT) : NULL;
+
+    _AutoUpdate_Scheduler_AddJobs(
+        &pTask->tScheduler,
+        pJsonLauncher,
+        SVAR_IS_CONSTCHAR(tLuaRootURL) ?
+            SVAR_GET_CONSTCHAR(tLuaRootURL) :
+            _sDefaultUpdaterRemoteRootURL,
+        bForceDownload);
+    _AutoUpdate_Scheduler_AddJobs(
+        &pTask->tScheduler,
+        pJsonMod,
+        SVAR_IS_CONSTCHAR(tLuaRootURL) ?
+            SVAR_GET_CONSTCHAR(tLuaRootURL) :
+            _sDefaultUpdaterRemoteRootURL,
+        bForceDownload);
+
+    pTask->cbWorker = _AutoUpdate_Worker_Main;
+    pTask->cbEnd    = _AutoUpdate_Update_End;
+    _AutoUpdate_Run_Start(pApp, pTask,
+        _AutoUpdate_GetCount(pApp, _sLua_UPDATER_CONNECTIONS,
+            UPDATER_DEFAULT_CONNECTIONS, 1, UPDATER_MAX_CONNECTIONS));
+
+    return TRUE;
+}
+
+static int
+_AutoUpdate_ComparePaths(const void *pA, const void *pB)
+{
+    return strcmp(*(const char_t* const*)pA, *(const char_t* const*)pB);
+}
+
+static CBOOL
+_AutoUpdate_Verify_OnDirEntry(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    InetUpdaterExtraScan    *pScan = (InetUpdaterExtraScan*)pUserData;
+    String                  *sPath;
+    const char_t            *sKey;
+
+    /* Part files of an interrupted download to another device than state
+     * folder are kept next to destination, they're the updater's business */
+    if (eType != DIRENTRY_FILE ||
+        str_is_suffix(sName, SPARTFILE_SUFFIX) ||
+        str_is_suffix(sName, SPARTFILE_SPOOL_SUFFIX) ||
+        str_is_suffix(sName, SPARTFILE_JOURNAL_SUFFIX))
+    {
+        return CTRUE;
+    }
 
-    const SVar tLuaLauncherVersion      = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_LAUNCHER_VERSION);
-    const SVar tLuaModVersion           = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_MOD_VERSION);
-    const SVar tLuaLauncherManifestURL  = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_LAUNCHER_MANIFEST);
-    const SVar tLuaModManifestURL       = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_MOD_MANIFEST);
-    const int32_t dLauncherBuild        = str_to_i32(BUILD_NUMBER, 10, NULL);
-    const int32_t dLauncherVersion      = SVAR_IS_DOUBLE(tLuaLauncherVersion) ? (int32_t)SVAR_GET_DOUBLE(tLuaLauncherVersion) : 0;
-    const int32_t dModVersion           = SVAR_IS_DOUBLE(tLuaModVersion)      ? (int32_t)SVAR_GET_DOUBLE(tLuaModVersion) : 0;
+    sPath   = str_printf("%s/%s", pScan->sDir, sName);
+    sKey    = tc(sPath);
+    if (!bsearch(&sKey, pScan->pPaths, pScan->dNumPaths, sizeof(const char_t*), _AutoUpdate_ComparePaths))
+    {
+        _al_printf(pScan->pApp, "[Verify] Extra: %s\n", sKey);
+        pScan->dExtra++;
+    }
+    str_destroy(&sPath);
 
-    static const char *sSchemaFmt       = "• Schema: \t\t%s\n";
-    static const char *sGeneratedFmt    = "• Generated: \t\t%s\n";
-    static const char *sAppVersionFmt   = "• App version: \t\t%d\n";
-    static const char *sNetVersionFmt   = "• Net version: \t\t%d\n";
-    static const char *sAppBuildFmt     = "• App build: \t\t%d\n";
-    static const char *sNetBuildFmt     = "• Net build: \t\t%d\n";
-    static const char *sModVersionFmt   = "• Mod version: \t\t%d\n";
-    static const char *sModNetVersionFmt= "• Mod Net version: \t%d\n";
+    return CTRUE;
+}
 
-    /* Launcher manifest */
-    _al_printf( pApp,
-        "[Updater] Fetching Launcher manifest at \n\t%s\n",
-            SVAR_IS_CONSTCHAR(tLuaLauncherManifestURL) ?
-            SVAR_GET_CONSTCHAR(tLuaLauncherManifestURL) :
-            _sDefaultUpdaterLauncherManifestURL
-        );
+static int
+_AutoUpdate_CompareStrings(const void *pA, const void *pB)
+{
+    return strcmp(tc(*(String* const*)pA), tc(*(String* const*)pB));
+}
 
-    pJsonLauncherStream = http_dget(
-        SVAR_IS_CONSTCHAR(tLuaLauncherManifestURL) ?
-            SVAR_GET_CONSTCHAR(tLuaLauncherManifestURL) :
-            _sDefaultUpdaterLauncherManifestURL,
-        &dResult,
-        &eInetError);
+/* Lists files in manifest's folders (root excluded) that manifest doesn't know */
+static uint32_t
+_AutoUpdate_Verify_FindExtra(AppGUI *pApp, InetUpdaterScheduler *pScheduler)
+{
+    InetUpdaterExtraScan    tScan;
+    String                  **pDirs;
+    uint32_t                dNumDirs = 0;
+    uint32_t                dIndex;
 
-    if (!pJsonLauncherStream)
+    if (pScheduler->dNumJobs == 0)
     {
-        _al_printf(pApp,
-            "[Updater] Couldn't fetch al_manifest.json"
-            "\n\tdResult: %d\n\teInetError: %d\n",
-            dResult,
-            eInetError);
-        return FALSE;
+        return 0;
     }
-    pJsonLauncher = json_read(pJsonLauncherStream, NULL, InetUpdaterJSONData);
 
-    /* Mod manifest */
-    _al_printf( pApp,
-        "[Updater] Fetching Mod manifest at \n\t%s\n",
-            SVAR_IS_CONSTCHAR(tLuaModManifestURL) ?
-            SVAR_GET_CONSTCHAR(tLuaModManifestURL) :
-            _sDefaultUpdaterModManifestURL
-        );
+    tScan.pApp      = pApp;
+    tScan.pPaths    = (const char_t**)malloc(pScheduler->dNumJobs * sizeof(const char_t*));
+    tScan.dNumPaths = pScheduler->dNumJobs;
+    tScan.sDir      = NULL;
+    tScan.dExtra    = 0;
+    pDirs           = (String**)malloc(pScheduler->dNumJobs * sizeof(String*));
+    if (!tScan.pPaths || !pDirs)
+    {
+        free((void*)tScan.pPaths);
+        free(pDirs);
+        return 0;
+    }
 
-    pJsonModStream = http_dget(
-        SVAR_IS_CONSTCHAR(tLuaModManifestURL) ?
-            SVAR_GET_CONSTCHAR(tLuaModManifestURL) :
-            _sDefaultUpdaterModManifestURL,
-        &dResult,
-        &eInetError);
+    for (dIndex = 0; dIndex < pScheduler->dNumJobs; ++dIndex)
+    {
+        const char_t *sPath  = pScheduler->pJobs[dIndex].sPath;
+        const char_t *sSlash = strrchr(sPath, '/');
+
+        tScan.pPaths[dIndex] = sPath;
+        if (sSlash)
+        {
+            pDirs[dNumDirs++] = str_cn(sPath, (uint32_t)(sSlash - sPath));
+        }
+    }
+    qsort((void*)tScan.pPaths, tScan.dNumPaths, sizeof(const char_t*), _AutoUpdate_ComparePaths);
+    qsort(pDirs, dNumDirs, sizeof(String*), _AutoUpdate_CompareStrings);
 
-    if (!pJsonModStream)
+    /* Each parent folder once */
+    for (dIndex = 0; dIndex < dNumDirs; ++dIndex)
     {
-        _al_printf( pApp,
-                    "[Updater] Couldn't fetch mod_manifest.json"
-                    "\n\tdResult: %d\n\teInetError: %d\n",
-                    dResult,
-                    eInetError);
-        return FALSE;
+        if (dIndex == 0 || strcmp(tc(pDirs[dIndex - 1]), tc(pDirs[dIndex])) != 0)
+        {
+            tScan.sDir = tc(pDirs[dIndex]);
+            AmberLauncher_DirIterate(tScan.sDir, _AutoUpdate_Verify_OnDirEntry, &tScan);
+        }
     }
-    pJsonMod        = json_read(pJsonModStream, NULL, InetUpdaterJSONData);
 
-    /* Check for update and report */
-    bUpdateRequired = (dLauncherBuild < pJsonLauncher->launcher->build ||
-                        dLauncherVersion < pJsonLauncher->launcher->version ||
-                        dModVersion < pJsonLauncher->launcher->version);
+    for (dIndex = 0; dIndex < dNumDirs; ++dIndex)
+    {
+        str_destroy(&pDirs[dIndex]);
+    }
+    free(pDirs);
+    free((void*)tScan.pPaths);
 
-    _al_printf(pApp,
-        "[Updater] Manifests retrieved successfuly:\n"
-        "• Update required: \t%s\n",
-        bUpdateRequired ? "true" : "false"
-    );
-    _al_printf(pApp, sSchemaFmt, tc(pJsonLauncher->schema));
-    _al_printf(pApp, sGeneratedFmt, tc(pJsonLauncher->generated));
-    _al_printf(pApp, sAppVersionFmt, dLauncherVersion);
-    _al_printf(pApp, sNetVersionFmt, pJsonLauncher->launcher->version);
-    _al_printf(pApp, sAppBuildFmt, dLauncherBuild);
-    _al_printf(pApp, sNetBuildFmt, pJsonLauncher->launcher->build);
-    _al_printf(pApp, sModVersionFmt, dModVersion);
-    _al_printf(pApp, sModNetVersionFmt, pJsonMod->launcher->version);
+    return tScan.dExtra;
+}
 
-    stm_close(&pJsonLauncherStream);
-    stm_close(&pJsonModStream);
+/* GUI thread, end of repair run */
+static void
+_AutoUpdate_Repair_End(InetUpdaterRunTask *pTask, uint32_t dFailed)
+{
+    AppGUI          *pApp   = pTask->pApp;
+    const uint32_t  dNumBad = pTask->tScheduler.dNumJobs;
 
-    json_destroy(&pJsonLauncher, InetUpdaterJSONData);
-    json_destroy(&pJsonMod, InetUpdaterJSONData);
+    if (dFailed > 0)
+    {
+        _al_printf(pApp, "[Verify] Repair incomplete: %u files failed\n", dFailed);
+    }
+    else
+    {
+        _al_printf(pApp, "[Verify] Repaired %u files\n", dNumBad);
+    }
 
-    return bUpdateRequired;
+    _AutoUpdate_Metrics_Finish(pApp, &pTask->tScheduler);
+    _AutoUpdate_Run_Free(&pTask);
 }
 
+/* GUI thread, end of verify run. Damaged files go to repair run if asked */
 static void
-_AutoUpdate_Update_DownloadFiles(
-    AppGUI *pApp,
-    InetUpdaterJSONData *pJson,
-    const char *sRootURL,
-    real32_t *fProgressIndex,
-    real32_t fProgressMax,
-    bool_t bForceDownload)
+_AutoUpdate_Verify_End(InetUpdaterRunTask *pTask, uint32_t dFailed)
 {
-    arrst_foreach(elem, pJson->files, InetUpdaterFile)
-        bool_t bFileExists    = hfile_exists(tc(elem->path),0);
-        char *sSHA256Hash     = AmberLauncher_SHA256_HashFile(tc(elem->path));
-        String *sDownloadLink = str_printf("%s%s", sRootURL, tc(elem->path));
+    AppGUI                  *pApp       = pTask->pApp;
+    InetUpdaterScheduler    *pScheduler = &pTask->tScheduler;
+    uint32_t                dIndex;
+    uint32_t                dMissing    = 0;
+    uint32_t                dCorrupt    = 0;
+    uint32_t                dExtra;
+    uint32                  dHits       = 0;
+    uint32                  dMisses     = 0;
+
+    for (dIndex = 0; dIndex < pScheduler->dNumJobs; ++dIndex)
+    {
+        dMissing += pScheduler->pJobs[dIndex].eState == UPDATER_JOB_MISSING;
+        dCorrupt += pScheduler->pJobs[dIndex].eState == UPDATER_JOB_CORRUPT;
+    }
+    dExtra = _AutoUpdate_Verify_FindExtra(pApp, pScheduler);
 
-        Stream *pDownloadFile;
+    if (pScheduler->pHashCache)
+    {
+        SHashCache_GetStats(pScheduler->pHashCache, &dHits, &dMisses);
+    }
+    _al_printf(pApp, "[Verify] %u files checked (%u hashed, %u from cache): %u missing, %u corrupt, %u extra\n",
+        pScheduler->dNumJobs, dMisses, dHits, dMissing, dCorrupt, dExtra);
 
-        _al_printf(pApp, "[Updater] Downloading %s...\n", tc(elem->path));
+    if (dMissing + dCorrupt > 0 && pTask->bRepair)
+    {
+        uint32_t dNumBad = 0;
 
-        if (!bFileExists)
+        /* Keep only damaged files, the rest of the queue is dropped */
+        for (dIndex = 0; dIndex < pScheduler->dNumJobs; ++dIndex)
         {
-            _al_printf(pApp, "[Updater] Local file %s doesn't exist!\n",
-                sDownloadLink);
+            InetUpdaterJob *pJob = &pScheduler->pJobs[dIndex];
 
-            pDownloadFile = http_dget(tc(sDownloadLink), NULL, NULL);
-            if (pDownloadFile)
+            if (pJob->eState != UPDATER_JOB_MISSING && pJob->eState != UPDATER_JOB_CORRUPT)
             {
-                /* download file */
-                Stream *pOutputFile = stm_to_file(tc(elem->path), NULL);
-                stm_write(pOutputFile, 
-                    stm_buffer(pDownloadFile),
-                    stm_buffer_size (pDownloadFile));
-                stm_close(&pOutputFile);
+                str_destroy(&pJob->sURL);
+                continue;
             }
-        }
-        else if (sSHA256Hash || bForceDownload)
-        {
-            _al_printf(pApp, "[Updater] sha256 %s:\n\t%s\n", 
-                sDownloadLink, sSHA256Hash);
-
-            if (str_cmp(elem->sha256, sSHA256Hash) != 0 || bForceDownload)
-            {
-                _al_printf(pApp, "[Updater] Remote file is different!\n");
-
-                pDownloadFile = http_dget(tc(sDownloadLink), 
-                    NULL,
-                    NULL);
-                if (pDownloadFile)
-                {
-                    Stream *pOutputFile;
-
-                    /* stm_to_file doesn't overwrite as it promises to do, so, delete file.. */
-                    bfile_delete(tc(elem->path), NULL);
 
-                    pOutputFile = stm_to_file(tc(elem->path), NULL);
-                    stm_write(pOutputFile, 
-                        stm_buffer(pDownloadFile), 
-                        stm_buffer_size (pDownloadFile));
-                    stm_close(&pOutputFile);
-                }
-            }
+            pJob->eState        = UPDATER_JOB_QUEUED;
+            pJob->bReported     = FALSE;
+            pJob->dHashUs       = 0;
+            pJob->dTotalUs      = 0;
+            pScheduler->pJobs[dNumBad++] = *pJob;
         }
-        else
+
+        pScheduler->dNumJobs        = dNumBad;
+        pScheduler->dNextJob        = 0;
+        pScheduler->dFinishedJobs   = 0;
+        pScheduler->dBytesDone      = 0;
+        pScheduler->dBytesTotal     = 0;
+        for (dIndex = 0; dIndex < pScheduler->dNumJobs; ++dIndex)
         {
-            _al_printf(pApp, "[Updater] unknown file error:\n\t%s(%s)\n", 
-                sDownloadLink, sSHA256Hash);
+            pScheduler->dBytesTotal += pScheduler->pJobs[dIndex].dTransferSize;
         }
-        str_destroy(&sDownloadLink);
-        stm_close(&pDownloadFile);
 
-        /* Track progress */
-        *fProgressIndex += 1.0f;
         if (pApp->pWidgets->pProgressbar)
         {
-            progress_value(pApp->pWidgets->pProgressbar, 
-                *fProgressIndex / fProgressMax);
+            progress_value(pApp->pWidgets->pProgressbar, 0.0f);
         }
 
-        free(sSHA256Hash);
-    arrst_end()
+        pTask->cbWorker = _AutoUpdate_Worker_Main;
+        pTask->cbEnd    = _AutoUpdate_Repair_End;
+        _AutoUpdate_Run_Start(pApp, pTask,
+            _AutoUpdate_GetCount(pApp, _sLua_UPDATER_CONNECTIONS,
+                UPDATER_DEFAULT_CONNECTIONS, 1, UPDATER_MAX_CONNECTIONS));
+        return;
+    }
+
+    if (dMissing + dCorrupt > 0)
+    {
+        _al_printf(pApp, "[Verify] Press Repair to download damaged files only\n");
+    }
+
+    _AutoUpdate_Metrics_Finish(pApp, pScheduler);
+    _AutoUpdate_Run_Free(&pTask);
+
+    unref(dFailed);
 }
 
 bool_t
-AutoUpdate_Update(AppGUI *pApp, bool_t bForceDownload)
+AutoUpdate_Verify(AppGUI *pApp, bool_t bRepair)
 {
-    uint32_t            dResult;
-    ierror_t            eInetError;
-    Stream              *pJsonLauncherStream;
-    Stream              *pJsonModStream;
-    InetUpdaterJSONData *pJsonLauncher;
     InetUpdaterJSONData *pJsonMod;
-    real32_t            fProgressIndex;
-    real32_t            fProgressMax;
-
-    static const char *sFileArrayFmt = "• File: %s\n• • sha256: \n%s\n• • size: %u\n";
+    InetUpdaterRunTask  *pTask;
+    uint32_t            dIndex;
 
-    const SVar tLuaLauncherManifestURL  = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_LAUNCHER_MANIFEST);
     const SVar tLuaModManifestURL       = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_MOD_MANIFEST);
     const SVar tLuaRootURL              = AmberLauncher_GetGlobalVariable(pApp->pAppCore, _sLua_URL_UPDATER_ROOT);
 
-    /* Fire start event */
-    AmberLauncher_Update(pApp->pAppCore, CFALSE);
-
-    /* Launcher Manifest */
-    _al_printf( pApp,
-        "[Updater] Fetching Launcher manifest at \n\t%s\n",
-            SVAR_IS_CONSTCHAR(tLuaLauncherManifestURL) ?
-            SVAR_GET_CONSTCHAR(tLuaLauncherManifestURL) :
-            _sDefaultUpdaterLauncherManifestURL
-        );
-
-    pJsonLauncherStream = http_dget(
-        SVAR_IS_CONSTCHAR(tLuaLauncherManifestURL) ?
-            SVAR_GET_CONSTCHAR(tLuaLauncherManifestURL) :
-            _sDefaultUpdaterLauncherManifestURL,
-        &dResult,
-        &eInetError);
-
-    if (!pJsonLauncherStream)
+    if (pApp->pUpdaterRun)
     {
-        _al_printf( pApp,
-                    "[Updater] Couldn't fetch al_manifest.json"
-                    "\n\tdResult: %d\n\teInetError: %d\n",
-                    dResult,
-                    eInetError);
         return FALSE;
     }
 
-    _al_printf( pApp,
-                "[Updater] Launcher Manifest retrieved successfuly:\n"
-                "• dResult: \t\t%d\n• eInetError: \t\t%d\n",
-                dResult,
-                eInetError);
-
-    pJsonLauncher = json_read(pJsonLauncherStream, NULL, InetUpdaterJSONData);
-    stm_close(&pJsonLauncherStream);
-
-    /* Mod Manifest */
-    _al_printf( pApp,
-        "[Updater] Fetching Mod manifest at \n\t%s\n",
-            SVAR_IS_CONSTCHAR(tLuaModManifestURL) ?
-            SVAR_GET_CONSTCHAR(tLuaModManifestURL) :
-            _sDefaultUpdaterModManifestURL
-        );
+    SUpdaterMetrics_Reset(pApp->pAppCore->pUpdaterMetrics, bRepair ? "repair" : "verify");
 
-    pJsonModStream = http_dget(
+    pJsonMod = _AutoUpdate_Session_Fetch(pApp,
+        &pApp->pUpdaterSession->tMod,
         SVAR_IS_CONSTCHAR(tLuaModManifestURL) ?
             SVAR_GET_CONSTCHAR(tLuaModManifestURL) :
             _sDefaultUpdaterModManifestURL,
-        &dResult,
-        &eInetError);
-
-    if (!pJsonModStream)
+        "Mod");
+    if (!pJsonMod)
     {
-        _al_printf( pApp,
-                    "[Updater] Couldn't fetch mod_manifest.json"
-                    "\n\tdResult: %d\n\teInetError: %d\n",
-                    dResult,
-                    eInetError);
         return FALSE;
     }
-
-    _al_printf( pApp,
-                "[Updater] Mod Manifest retrieved successfuly:\n"
-                "• dResult: \t\t%d\n• eInetError: \t\t%d\n",
-                dResult,
-                eInetError);
-
-    pJsonMod = json_read(pJsonModStream, NULL, InetUpdaterJSONData);
-    stm_close(&pJsonModStream);
-
-    /* Print files */
-    _al_printf(pApp, "Launcher files: \n");
-    arrst_foreach(elem, pJsonLauncher->files, InetUpdaterFile)
-        _al_printf(pApp, sFileArrayFmt, tc(elem->path), tc(elem->sha256), elem->size);
-    arrst_end()
-    _al_printf(pApp, "\n");
-    _al_printf(pApp, "Mod files: \n");
-    arrst_foreach(elem, pJsonMod->files, InetUpdaterFile)
-        _al_printf(pApp, sFileArrayFmt, tc(elem->path), tc(elem->sha256), elem->size);
-    arrst_end()
-    _al_printf(pApp, "\n");
-
-    /* Download files */
-    fProgressIndex  = 0.0f;
-    fProgressMax    = (real32_t)arrst_size(pJsonLauncher->files, InetUpdaterFile) + 
-                        (real32_t)arrst_size(pJsonMod->files, InetUpdaterFile);
+    _AutoUpdate_Metrics_AddManifest(pApp, &pApp->pUpdaterSession->tMod);
 
     if (pApp->pWidgets->pProgressbar)
     {
-        progress_value(pApp->pWidgets->pProgressbar, 
-            0.0f);
+        progress_value(pApp->pWidgets->pProgressbar, 0.0f);
     }
-    
-    _al_printf(pApp, "[Updater] Remote Updater Server: %s\n",
-        SVAR_IS_CONSTCHAR(tLuaRootURL) ?
-            SVAR_GET_CONSTCHAR(tLuaRootURL) :
-            _sDefaultUpdaterRemoteRootURL);
 
-    _AutoUpdate_Update_DownloadFiles(
-        pApp, 
-        pJsonLauncher,
-        SVAR_IS_CONSTCHAR(tLuaRootURL) ?
-            SVAR_GET_CONSTCHAR(tLuaRootURL) :
-            _sDefaultUpdaterRemoteRootURL,
-        &fProgressIndex, 
-        fProgressMax,
-        bForceDownload);
-    _AutoUpdate_Update_DownloadFiles(
-        pApp, 
+    pTask = heap_new0(InetUpdaterRunTask);
+    if (!IS_VALID(pTask))
+    {
+        return FALSE;
+    }
+
+    _AutoUpdate_Scheduler_Create(pApp, &pTask->tScheduler, arrst_size(pJsonMod->files, InetUpdaterFile));
+    _AutoUpdate_Scheduler_AddJobs(
+        &pTask->tScheduler,
         pJsonMod,
         SVAR_IS_CONSTCHAR(tLuaRootURL) ?
             SVAR_GET_CONSTCHAR(tLuaRootURL) :
             _sDefaultUpdaterRemoteRootURL,
-        &fProgressIndex, 
-        fProgressMax,
-        bForceDownload);
-
-    json_destroy(&pJsonLauncher, InetUpdaterJSONData);
-    json_destroy(&pJsonMod, InetUpdaterJSONData);
+        FALSE);
 
-    _al_printf( pApp,"[Updater] Update done!\n");
+    /* Hashing is disk bound, progress goes by file size */
+    pTask->tScheduler.dBytesTotal = 0;
+    for (dIndex = 0; dIndex < pTask->tScheduler.dNumJobs; ++dIndex)
+    {
+        pTask->tScheduler.dBytesTotal += pTask->tScheduler.pJobs[dIndex].dSize;
+    }
 
-    /* Fire end event */
-    AmberLauncher_Update(pApp->pAppCore, CTRUE);
+    pTask->bRepair  = bRepair;
+    pTask->cbWorker = _AutoUpdate_Worker_Verify;
+    pTask->cbEnd    = _AutoUpdate_Verify_End;
+    _AutoUpdate_Run_Start(pApp, pTask,
+        _AutoUpdate_GetCount(pApp, _sLua_UPDATER_CONNECTIONS,
+            UPDATER_DEFAULT_CONNECTIONS, 1, UPDATER_MAX_CONNECTIONS));
 
     return TRUE;
 }
@@ -2465,6 +4161,13 @@ Callback_OnButtonModalUpdater(AppGUI* pApp, Event *e)
     Button *pButton     = event_sender(e, Button);
     uint32_t dButtonTag = button_get_tag(pButton);
 
+    /* Modal stays until running update is over, it closes itself on success */
+    if (pApp->pUpdaterRun)
+    {
+        unref(e);
+        return;
+    }
+
     switch(dButtonTag)
     {
         case MODAL_UPDATE_APP:
@@ -2475,11 +4178,7 @@ Callback_OnButtonModalUpdater(AppGUI* pApp, Event *e)
                     break;
                 }
 
-                if (AutoUpdate_Update(pApp, FALSE))
-                {
-                    pApp->pWidgets->pTextView = NULL;
-                    window_stop_modal(pApp->pWindows->pWindowModal, dButtonTag);
-                }
+                AutoUpdate_Update(pApp, FALSE);
             }
             break;
 
@@ -2493,6 +4192,38 @@ Callback_OnButtonModalUpdater(AppGUI* pApp, Event *e)
     unref(e);
 }
 
+void
+Callback_OnButtonModalVerify(AppGUI* pApp, Event *e)
+{
+    Button *pButton     = event_sender(e, Button);
+    uint32_t dButtonTag = button_get_tag(pButton);
+
+    if (pApp->pUpdaterRun)
+    {
+        unref(e);
+        return;
+    }
+
+    switch(dButtonTag)
+    {
+        case MODAL_VERIFY:
+            AutoUpdate_Verify(pApp, FALSE);
+            break;
+
+        case MODAL_REPAIR:
+            AutoUpdate_Verify(pApp, TRUE);
+            break;
+
+        default:
+            pApp->pWidgets->pTextView = NULL;
+            window_stop_modal(pApp->pWindows->pWindowModal, dButtonTag);
+            break;
+    }
+
+    unref(pButton);
+    unref(e);
+}
+
 void
 Callback_OnButtonModalTools(AppGUI *pApp, Event *e)
 {
@@ -2570,6 +4301,18 @@ _GUIThread_End_PanelSetMain(GUIAsyncTaskData *pThreadData, const uint32_t dRValu
     unref(dRValue);
 }
 
+static void
+_GUIThread_End_Update(GUIAsyncTaskData *pThreadData, const uint32_t dRValue)
+{
+    if (!AutoUpdate_Update(pThreadData->pApp, FALSE))
+    {
+        osapp_finish();
+    }
+    heap_delete(&pThreadData, GUIAsyncTaskData);
+
+    unref(dRValue);
+}
+
 bool_t
 GUIThread_SchedulePanelSet(AppGUI *pApp, EPanelType eType, FPanelFlags dFlags)
 {
@@ -2612,7 +4355,12 @@ _al_printf(AppGUI *pApp, const char* fmt, ...)
 
     bstd_printf("%s", buffer);
 
-    cassert_no_null(pApp);
+    /* NULL: console only (worker threads) */
+    if (pApp == NULL)
+    {
+        return;
+    }
+
     cassert_no_null(pApp->pWidgets);
 
     if (pApp->pWidgets->pTextView)
@@ -2664,7 +4412,7 @@ _Panel_GetRoot(AppGUI *pApp)
     Button      *pButtonWebDiscord  = button_flat();
     Button      *pButtonUpdate      = button_flat();
 
-    bool_t bUpdateAvailable = AutoUpdate_CheckForUpdates(pApp);
+    bool_t bUpdateAvailable = AutoUpdate_ScheduleCheck(pApp);
 
     static const real32_t dButtonIconWidth   = ICO_PNG_W + (ICO_PNG_W / 2);
     static const real32_t dButtonIconHeight  = ICO_PNG_H + (ICO_PNG_H / 2);
@@ -2703,18 +4451,9 @@ _Panel_GetRoot(AppGUI *pApp)
     button_tooltip(pButtonWebDiscord, TXT_TOOLTIP_DISCORD);
     button_OnClick(pButtonWebDiscord, listener(pApp, _Callback_OnButtonMainWindow, AppGUI) );
 
-    if (gui_dark_mode())
-    {
-        button_image(pButtonUpdate, bUpdateAvailable ?
-            (const Image*)ICO_UPDATE_AVAILABLE_DARK_PNG :
-            (const Image*)ICO_UPDATE_DARK_PNG);
-    }
-    else
-    {
-        button_image(pButtonUpdate, bUpdateAvailable ?
-            (const Image*)ICO_UPDATE_AVAILABLE_PNG :
-            (const Image*)ICO_UPDATE_PNG);
-    }
+    /* Background update check refreshes it later */
+    pApp->pWidgets->pButtonUpdate = pButtonUpdate;
+    _AutoUpdate_Check_SetBadge(pApp, bUpdateAvailable);
 
     button_tag(pButtonUpdate, CSIDEBUTTON_UPDATE);
     button_tooltip(pButtonUpdate, TXT_TOOLTIP_UPDATE);
@@ -2825,6 +4564,9 @@ _Nappgui_Start(void)
     pApp->pLocalizations = heap_new0(AppGUILocalization);
     cassert_no_null(pApp->pLocalizations);
 
+    pApp->pUpdaterSession = heap_new0(InetUpdaterSession);
+    cassert_no_null(pApp->pUpdaterSession);
+
     /* AppGUI > AppGUIElementDB */
     pApp->pElementSets->pOptElementArray    = heap_new_n0(MAX_OPT_ELEMS, GUIOptElement);
     cassert_no_null(pApp->pElementSets->pOptElementArray);
@@ -2864,9 +4606,60 @@ _Nappgui_Start(void)
     window_show(pApp->pWindows->pWindow);
     _window_center(pApp->pWindows->pWindow);
 
+    /* Scripted update (tools/test_updater.py): runs once main loop is up */
+    if (_Nappgui_HasArg(APP_ARG_UPDATE))
+    {
+        GUIAsyncTaskData *pData = heap_new0(GUIAsyncTaskData);
+        cassert_no_null(pData);
+
+        pApp->bUnattended   = TRUE;
+        pData->pApp         = pApp;
+
+        osapp_task(
+            pData,
+            0.0,
+            _GUIThread_Main_Null,
+            NULL,
+            _GUIThread_End_Update,
+            GUIAsyncTaskData
+        );
+    }
+
     return pApp;
 }
 
+static bool_t
+_Nappgui_HasArg(const char_t *sArg)
+{
+    char_t      sBuffer[APP_ARG_SIZE];
+    uint32_t    dIndex;
+
+    for (dIndex = 1; dIndex < osapp_argc(); ++dIndex)
+    {
+        osapp_argv(dIndex, sBuffer, sizeof(sBuffer));
+        if (str_equ_c(sBuffer, sArg))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static void
+_Nappgui_Update(AppGUI *pApp, const real64_t fPrevTime, const real64_t fCurrTime)
+{
+    /* Not while UI event (and Lua behind it) is in progress: modals spin
+     * their own loop */
+    if (pApp->eCurrentUIEvent == UIEVENT_NULL)
+    {
+        AmberLauncher_ProcessFileChanges(pApp->pAppCore);
+    }
+
+    unref(fPrevTime);
+    unref(fCurrTime);
+}
+
 static void 
 _Nappgui_End(AppGUI **pApp)
 {
@@ -2887,6 +4680,9 @@ _Nappgui_End(AppGUI **pApp)
         }
     }
 
+    /* Updater session */
+    AutoUpdate_Finish(*pApp);
+
     /* NappGUI ... */
     inet_finish();
 
@@ -3074,7 +4870,15 @@ _Callback_OnCloseModalWindow(AppGUI *pApp, Event *e)
         case ekGUI_CLOSE_ESC:
         case ekGUI_CLOSE_BUTTON:
 
-            if (pApp->eCurrentUIEvent == UIEVENT_MODAL_UPDATER)
+            /* Update/verify reports into this modal until it's over */
+            if (pApp->pUpdaterRun)
+            {
+                *pResult = FALSE; /* prevents from closing window */
+                return;
+            }
+
+            if (pApp->eCurrentUIEvent == UIEVENT_MODAL_UPDATER ||
+                pApp->eCurrentUIEvent == UIEVENT_MODAL_VERIFY)
             {
                 pApp->pWidgets->pTextView = NULL;
             }
@@ -4197,6 +6001,18 @@ _Callback_UIEvent(
             }
             break;
 
+        case UIEVENT_MODAL_VERIFY:
+            {
+                dModalRetVal = _Nappgui_ShowModal(
+                    pApp,
+                    Panel_GetModalVerify(pApp),
+                    TXT_TITLE_VERIFY
+                );
+
+                SVARKEYB_BOOL(tRetVal, sStatusKey, CTRUE);
+            }
+            break;
+
         case UIEVENT_MAX:
         default:
             SVARKEYB_NULL(tRetVal, sStatusKey);
@@ -4220,7 +6036,7 @@ _Callback_UIEvent(
  ******************************************************************************/
 
 #include <osapp/osmain.h>
-osmain(_Nappgui_Start, _Nappgui_End, "", AppGUI)
+osmain_sync(APP_UPDATE_INTERVAL, _Nappgui_Start, _Nappgui_End, _Nappgui_Update, "", AppGUI)
 
 /* #include <osmain.h> */
 /* osmain(_Nappgui_Start, _Nappgui_End, "", AppGUI) */
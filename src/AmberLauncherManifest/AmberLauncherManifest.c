@@ -0,0 +1,1147 @@
+/*
+ * al-manifest: native replacement for the jq loop of
+ * tools/generate_al_manifest.sh and tools/generate_mod_manifest.sh
+ *
+ * Walks target globs (relative to manifest folder), hashes files in parallel
+ * through the core hash cache and rewrites manifest in one pass. Output is
+ * byte-identical to what jq produces for the same input.
+ */
+#include <core/common.h>
+#include <core/hashcache.h>
+#include <core/opsys.h>
+#include <core/thread.h>
+#include <core/vector.h>
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#define ALM_SCHEMA                  "com.example.launcher/manifest-v2"
+#define ALM_HASHCACHE_SUFFIX        ".hashcache"
+#define ALM_PACKED_SUFFIX           ".deflate"
+#define ALM_MAX_JOBS                64
+
+/******************************************************************************
+ * STRUCTS
+ ******************************************************************************/
+
+typedef enum EJsonType
+{
+    JSON_NULL,
+    JSON_BOOL,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT
+} EJsonType;
+
+/* Minimal DOM: keeps key order and number literals, like jq does */
+typedef struct SJson
+{
+    EJsonType       eType;
+    char            *sValue;        /* bool/number literal, decoded string */
+    char            **sKeys;        /* object only */
+    struct SJson    **pItems;
+    size_t          dCount;
+    size_t          dMax;
+} SJson;
+
+typedef struct SJsonParser
+{
+    const char      *sText;
+    size_t          dOffset;
+    CBOOL           bError;
+} SJsonParser;
+
+typedef struct SManifestEntry
+{
+    char            *sPath;         /* relative to manifest folder */
+    char            sSHA256[SHASHCACHE_SHA256_HEX_SIZE + 1];
+    uint64          dSize;
+    CBOOL           bHashed;
+} SManifestEntry;
+
+typedef struct SManifestScan
+{
+    const char      *sRoot;
+    const char      *sManifestName;
+    char            *sBinaryName;
+    char            *sCacheName;
+    SVector         tEntries;       /* SManifestEntry */
+} SManifestScan;
+
+typedef struct SManifestWork
+{
+    SManifestScan   *pScan;
+    SHashCache      *pCache;
+    SMutex          *pMutex;
+    size_t          dNext;
+} SManifestWork;
+
+/******************************************************************************
+ * STATIC FUNCTION DECLARATIONS
+ ******************************************************************************/
+
+static SJson*
+_Json_New(EJsonType eType, const char *sValue);
+
+static void
+_Json_Delete(SJson *pJson);
+
+static CBOOL
+_Json_Append(SJson *pJson, const char *sKey, SJson *pItem);
+
+static SJson*
+_Json_Get(SJson *pObject, const char *sKey);
+
+static void
+_Json_Set(SJson *pObject, const char *sKey, SJson *pItem);
+
+static SJson*
+_Json_Parse(const char *sText);
+
+static SJson*
+_Json_ParseValue(SJsonParser *pParser);
+
+static char*
+_Json_ParseString(SJsonParser *pParser);
+
+static void
+_Json_Write(FILE *pFile, const SJson *pJson, int dIndent);
+
+static void
+_Json_WriteString(FILE *pFile, const char *sString);
+
+static char*
+_Str_Dup(const char *sString);
+
+static char*
+_Str_Join(const char *sA, const char *sSep, const char *sB);
+
+static char*
+_File_ReadAll(const char *sPath);
+
+static CBOOL
+_Glob_Match(const char *sPattern, const char *sName);
+
+static int
+_Glob_Compare(const void *pA, const void *pB);
+
+static void
+_Scan_Target(SManifestScan *pScan, const char *sRelPath);
+
+static void
+_Scan_Pattern(SManifestScan *pScan, const char *sPattern);
+
+static uint32
+_Worker_Main(void *pData);
+
+/******************************************************************************
+ * MAIN
+ ******************************************************************************/
+
+static void
+_PrintUsage(const char *sExe)
+{
+    fprintf(stderr,
+        "Usage: %s [-j jobs] <launcher|mod> path/to/manifest.json <target>...\n"
+        "  target   path or glob (\"Data/*\") relative to manifest folder\n",
+        sExe);
+}
+
+int
+main(int argc, char **argv)
+{
+    const char      *sKind;
+    const char      *sManifestPath;
+    char            *sRoot;
+    char            *sText;
+    char            *sCachePath;
+    char            *sTmpPath;
+    char            sGenerated[32];
+    char            sNumber[32];
+    const char      *sSlash;
+    SJson           *pManifest;
+    SJson           *pLauncher;
+    SJson           *pVersion;
+    SJson           *pFiles;
+    SManifestScan   tScan;
+    SManifestWork   tWork;
+    SThread         *pWorkers[ALM_MAX_JOBS];
+    uint32          dJobs = SThread_GetProcessorCount();
+    uint32          dHits = 0;
+    uint32          dMisses = 0;
+    uint32          i;
+    long long       dNextVersion;
+    CBOOL           bLauncher;
+    CBOOL           bResult = CTRUE;
+    time_t          tNow;
+    FILE            *pFile;
+    int             dArg = 1;
+
+    /* Glob results are sorted like bash sorts them (LC_COLLATE) */
+    setlocale(LC_COLLATE, "");
+
+    if (dArg + 1 < argc && strcmp(argv[dArg], "-j") == 0)
+    {
+        dJobs = (uint32)atoi(argv[dArg + 1]);
+        dArg += 2;
+    }
+    dJobs = dJobs < 1 ? 1 : (dJobs > ALM_MAX_JOBS ? ALM_MAX_JOBS : dJobs);
+
+    if (argc - dArg < 3 ||
+        (strcmp(argv[dArg], "launcher") != 0 && strcmp(argv[dArg], "mod") != 0))
+    {
+        _PrintUsage(argv[0]);
+        return 1;
+    }
+
+    sKind           = argv[dArg++];
+    sManifestPath   = argv[dArg++];
+    bLauncher       = strcmp(sKind, "launcher") == 0;
+
+    sSlash  = strrchr(sManifestPath, '/');
+    sRoot   = sSlash ? (char*)malloc((size_t)(sSlash - sManifestPath) + 1) : _Str_Dup(".");
+    if (sSlash && sRoot)
+    {
+        memcpy(sRoot, sManifestPath, (size_t)(sSlash - sManifestPath));
+        sRoot[sSlash - sManifestPath] = '\0';
+    }
+
+    /* If manifest doesn't exist -> create a skeleton (same as scripts) */
+    if (!AmberLauncher_FileStat(sManifestPath, NULL, NULL))
+    {
+        pFile = fopen(sManifestPath, "w");
+        if (!pFile)
+        {
+            fprintf(stderr, "Can't create %s\n", sManifestPath);
+            return 1;
+        }
+        fprintf(pFile,
+            "{\n"
+            "  \"schema\": \"" ALM_SCHEMA "\",\n"
+            "  \"generated\": null,\n"
+            "  \"launcher\": %s,\n"
+            "  \"files\": []\n"
+            "}\n",
+            bLauncher ? "{ \"version\": 0 }" : "{ \"version\": 16777216, \"build\": 0 }");
+        fclose(pFile);
+        printf("Created new manifest: %s\n", sManifestPath);
+    }
+
+    sText       = _File_ReadAll(sManifestPath);
+    pManifest   = sText ? _Json_Parse(sText) : NULL;
+    free(sText);
+
+    pLauncher   = pManifest && pManifest->eType == JSON_OBJECT ? _Json_Get(pManifest, "launcher") : NULL;
+    pVersion    = pLauncher && pLauncher->eType == JSON_OBJECT ? _Json_Get(pLauncher, "version") : NULL;
+    if (!pVersion || pVersion->eType != JSON_NUMBER)
+    {
+        fprintf(stderr, "%s: malformed manifest (no .launcher.version)\n", sManifestPath);
+        _Json_Delete(pManifest);
+        free(sRoot);
+        return 1;
+    }
+    dNextVersion = strtoll(pVersion->sValue, NULL, 10) + 1;
+
+    /* Collect files in the same order the scripts do */
+    tScan.sRoot         = sRoot;
+    tScan.sManifestName = sSlash ? sSlash + 1 : sManifestPath;
+    tScan.sBinaryName   = _Str_Dup(tScan.sManifestName);
+    if (tScan.sBinaryName && strlen(tScan.sBinaryName) > 5 &&
+        strcmp(tScan.sBinaryName + strlen(tScan.sBinaryName) - 5, ".json") == 0)
+    {
+        strcpy(tScan.sBinaryName + strlen(tScan.sBinaryName) - 5, ".bin");
+    }
+    tScan.sCacheName    = _Str_Join(tScan.sManifestName, "", ALM_HASHCACHE_SUFFIX);
+    SVector_Init(&tScan.tEntries, sizeof(SManifestEntry));
+
+    for (; dArg < argc; ++dArg)
+    {
+        _Scan_Pattern(&tScan, argv[dArg]);
+    }
+
+    /* Hash in parallel, unchanged files come from cache */
+    sCachePath      = _Str_Join(sManifestPath, "", ALM_HASHCACHE_SUFFIX);
+    tWork.pScan     = &tScan;
+    tWork.pCache    = SHashCache_Load(sCachePath);
+    tWork.pMutex    = SMutex_Create();
+    tWork.dNext     = 0;
+
+    if (!tWork.pCache || !tWork.pMutex)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    for (i = 0; i < dJobs; ++i)
+    {
+        pWorkers[i] = SThread_Create(_Worker_Main, &tWork);
+    }
+    for (i = 0; i < dJobs; ++i)
+    {
+        SThread_Join(&pWorkers[i]);
+    }
+
+    /* Workers that failed to start leave work behind: finish it here */
+    _Worker_Main(&tWork);
+
+    pFiles = _Json_New(JSON_ARRAY, NULL);
+    SVector_ForEach(&tScan.tEntries)
+    {
+        SVector_InitIterator(SManifestEntry, &tScan.tEntries);
+        SJson *pEntry = _Json_New(JSON_OBJECT, NULL);
+
+        if (!SVECTOR_ITERATOR->bHashed)
+        {
+            fprintf(stderr, "Can't read %s/%s\n", sRoot, SVECTOR_ITERATOR->sPath);
+            bResult = CFALSE;
+        }
+
+        sprintf(sNumber, "%llu", (unsigned long long)SVECTOR_ITERATOR->dSize);
+        _Json_Append(pEntry, "path", _Json_New(JSON_STRING, SVECTOR_ITERATOR->sPath));
+        _Json_Append(pEntry, "sha256", _Json_New(JSON_STRING, SVECTOR_ITERATOR->sSHA256));
+        _Json_Append(pEntry, "size", _Json_New(JSON_NUMBER, sNumber));
+        _Json_Append(pFiles, NULL, pEntry);
+    }
+
+    tNow = time(NULL);
+    strftime(sGenerated, sizeof(sGenerated), "%Y-%m-%dT%H:%M:%SZ", gmtime(&tNow));
+    sprintf(sNumber, "%lld", dNextVersion);
+
+    if (bLauncher)
+    {
+        _Json_Set(pManifest, "schema", _Json_New(JSON_STRING, ALM_SCHEMA));
+    }
+    _Json_Set(pManifest, "generated", _Json_New(JSON_STRING, sGenerated));
+    _Json_Set(pLauncher, "version", _Json_New(JSON_NUMBER, sNumber));
+    _Json_Set(pManifest, "files", pFiles);
+
+    /* Write in one pass, then swap in */
+    sTmpPath = _Str_Join(sManifestPath, "", ".tmp");
+    pFile = bResult && sTmpPath ? fopen(sTmpPath, "w") : NULL;
+    if (pFile)
+    {
+        _Json_Write(pFile, pManifest, 0);
+        fputc('\n', pFile);
+        bResult = AmberLauncher_FileSync(pFile);
+        fclose(pFile);
+        bResult = bResult && AmberLauncher_FileReplace(sTmpPath, sManifestPath);
+    }
+    else
+    {
+        bResult = CFALSE;
+    }
+
+    if (bResult)
+    {
+        SHashCache_GetStats(tWork.pCache, &dHits, &dMisses);
+        SHashCache_Save(tWork.pCache);
+        printf("%s updated → version %lld\n", tScan.sManifestName, dNextVersion);
+        printf("Hashed %u files (%u from cache) using %u jobs\n", dHits + dMisses, dHits, dJobs);
+    }
+    else if (sTmpPath)
+    {
+        remove(sTmpPath);
+    }
+
+    SVector_ForEach(&tScan.tEntries)
+    {
+        SVector_InitIterator(SManifestEntry, &tScan.tEntries);
+        free(SVECTOR_ITERATOR->sPath);
+    }
+    SVector_Cleanup(&tScan.tEntries);
+    SHashCache_delete(&tWork.pCache);
+    SMutex_Destroy(&tWork.pMutex);
+    _Json_Delete(pManifest);
+    free(tScan.sBinaryName);
+    free(tScan.sCacheName);
+    free(sCachePath);
+    free(sTmpPath);
+    free(sRoot);
+
+    return bResult ? 0 : 1;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS (SCAN)
+ ******************************************************************************/
+
+typedef struct SScanDirContext
+{
+    SManifestScan   *pScan;
+    const char      *sRelPath;
+} SScanDirContext;
+
+typedef struct SGlobContext
+{
+    const char      *sPattern;
+    SVector         *pMatches;      /* char* */
+} SGlobContext;
+
+static CBOOL
+_Scan_AddFile(SManifestScan *pScan, char *sRelPath)
+{
+    const size_t    dLength = strlen(sRelPath);
+    const size_t    dPacked = strlen(ALM_PACKED_SUFFIX);
+    SManifestEntry  tEntry;
+
+    /* Manifest itself, its binary twin, hash cache and packed payloads */
+    if (strcmp(sRelPath, pScan->sManifestName) == 0 ||
+        (pScan->sBinaryName && strcmp(sRelPath, pScan->sBinaryName) == 0) ||
+        (pScan->sCacheName && strcmp(sRelPath, pScan->sCacheName) == 0) ||
+        (dLength >= dPacked && strcmp(sRelPath + dLength - dPacked, ALM_PACKED_SUFFIX) == 0))
+    {
+        free(sRelPath);
+        return CTRUE;
+    }
+    /* Runtime state of a launcher that ran in this folder */
+    if (strncmp(sRelPath, AMBERLAUNCHER_STATE_DIR "/", strlen(AMBERLAUNCHER_STATE_DIR) + 1) == 0)
+    {
+        free(sRelPath);
+        return CTRUE;
+    }
+
+    memset(&tEntry, 0, sizeof(tEntry));
+    tEntry.sPath = sRelPath;
+    SVector_PushBack(&pScan->tEntries, &tEntry);
+
+    return CTRUE;
+}
+
+static CBOOL
+_Scan_DirEntry(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    SScanDirContext *pContext = (SScanDirContext*)pUserData;
+    char            *sRelPath = _Str_Join(pContext->sRelPath, "/", sName);
+
+    if (!sRelPath)
+    {
+        return CFALSE;
+    }
+
+    /* find(1) order: files as they come, directories descended immediately */
+    if (eType == DIRENTRY_FILE)
+    {
+        return _Scan_AddFile(pContext->pScan, sRelPath);
+    }
+
+    if (eType == DIRENTRY_DIRECTORY)
+    {
+        SScanDirContext tChild;
+        char            *sFullPath = _Str_Join(pContext->pScan->sRoot, "/", sRelPath);
+
+        tChild.pScan    = pContext->pScan;
+        tChild.sRelPath = sRelPath;
+        if (sFullPath)
+        {
+            AmberLauncher_DirIterate(sFullPath, _Scan_DirEntry, &tChild);
+        }
+        free(sFullPath);
+    }
+    free(sRelPath);
+
+    return CTRUE;
+}
+
+/* scan(): directories recursively (find -type f), regular files as is */
+static void
+_Scan_Target(SManifestScan *pScan, const char *sRelPath)
+{
+    SScanDirContext tContext;
+    char            *sFullPath = _Str_Join(pScan->sRoot, "/", sRelPath);
+
+    if (!sFullPath)
+    {
+        return;
+    }
+
+    tContext.pScan      = pScan;
+    tContext.sRelPath   = sRelPath;
+
+    if (!AmberLauncher_DirIterate(sFullPath, _Scan_DirEntry, &tContext) &&
+        AmberLauncher_FileStat(sFullPath, NULL, NULL))
+    {
+        _Scan_AddFile(pScan, _Str_Dup(sRelPath));
+    }
+    free(sFullPath);
+}
+
+static CBOOL
+_Scan_GlobEntry(const char *sName, EDirEntryType eType, void *pUserData)
+{
+    SGlobContext    *pContext = (SGlobContext*)pUserData;
+    char            *sMatch;
+
+    UNUSED(eType);
+
+    /* Like bash, "*" doesn't match dot files */
+    if ((sName[0] == '.' && pContext->sPattern[0] != '.') ||
+        !_Glob_Match(pContext->sPattern, sName))
+    {
+        return CTRUE;
+    }
+
+    sMatch = _Str_Dup(sName);
+    if (sMatch)
+    {
+        SVector_PushBack(pContext->pMatches, &sMatch);
+    }
+
+    return CTRUE;
+}
+
+/* Wildcards (* and ?) are supported in last path component only */
+static void
+_Scan_Pattern(SManifestScan *pScan, const char *sPattern)
+{
+    const char      *sSlash = strrchr(sPattern, '/');
+    const char      *sName  = sSlash ? sSlash + 1 : sPattern;
+    char            *sDir;
+    char            *sFullDir;
+    SVector         tMatches;
+    SGlobContext    tContext;
+
+    if (!strpbrk(sName, "*?"))
+    {
+        _Scan_Target(pScan, sPattern);
+        return;
+    }
+
+    sDir = sSlash ? (char*)malloc((size_t)(sSlash - sPattern) + 1) : _Str_Dup(".");
+    if (!sDir)
+    {
+        return;
+    }
+    if (sSlash)
+    {
+        memcpy(sDir, sPattern, (size_t)(sSlash - sPattern));
+        sDir[sSlash - sPattern] = '\0';
+    }
+
+    SVector_Init(&tMatches, sizeof(char*));
+    tContext.sPattern   = sName;
+    tContext.pMatches   = &tMatches;
+
+    sFullDir = _Str_Join(pScan->sRoot, "/", sDir);
+    if (sFullDir)
+    {
+        AmberLauncher_DirIterate(sFullDir, _Scan_GlobEntry, &tContext);
+    }
+    free(sFullDir);
+
+    if (SVector_GetSize(&tMatches) > 1)
+    {
+        qsort(tMatches.pData, SVector_GetSize(&tMatches), sizeof(char*), _Glob_Compare);
+    }
+
+    SVector_ForEach(&tMatches)
+    {
+        SVector_InitIterator(char*, &tMatches);
+        char *sRelPath = sSlash ? _Str_Join(sDir, "/", *SVECTOR_ITERATOR) : _Str_Dup(*SVECTOR_ITERATOR);
+
+        if (sRelPath)
+        {
+            _Scan_Target(pScan, sRelPath);
+        }
+        free(sRelPath);
+        free(*SVECTOR_ITERATOR);
+    }
+    SVector_Cleanup(&tMatches);
+    free(sDir);
+}
+
+static CBOOL
+_Glob_Match(const char *sPattern, const char *sName)
+{
+    if (*sPattern == '\0')
+    {
+        return *sName == '\0';
+    }
+
+    if (*sPattern == '*')
+    {
+        do
+        {
+            if (_Glob_Match(sPattern + 1, sName))
+            {
+                return CTRUE;
+            }
+        } while (*sName++ != '\0');
+
+        return CFALSE;
+    }
+
+    if (*sName != '\0' && (*sPattern == '?' || *sPattern == *sName))
+    {
+        return _Glob_Match(sPattern + 1, sName + 1);
+    }
+
+    return CFALSE;
+}
+
+static int
+_Glob_Compare(const void *pA, const void *pB)
+{
+    return strcoll(*(const char* const*)pA, *(const char* const*)pB);
+}
+
+static uint32
+_Worker_Main(void *pData)
+{
+    SManifestWork *pWork = (SManifestWork*)pData;
+
+    for (;;)
+    {
+        SManifestEntry  *pEntry;
+        char            *sFullPath;
+
+        SMutex_Lock(pWork->pMutex);
+        if (pWork->dNext >= SVector_GetSize(&pWork->pScan->tEntries))
+        {
+            SMutex_Unlock(pWork->pMutex);
+            break;
+        }
+        pEntry = (SManifestEntry*)SVector_Get(&pWork->pScan->tEntries, pWork->dNext++);
+        SMutex_Unlock(pWork->pMutex);
+
+        sFullPath = _Str_Join(pWork->pScan->sRoot, "/", pEntry->sPath);
+        pEntry->bHashed = sFullPath &&
+            SHashCache_HashFile(pWork->pCache, sFullPath, pEntry->sSHA256, &pEntry->dSize);
+        free(sFullPath);
+    }
+
+    return 0;
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS (JSON)
+ ******************************************************************************/
+
+static SJson*
+_Json_New(EJsonType eType, const char *sValue)
+{
+    SJson *pJson = (SJson*)calloc(1, sizeof(SJson));
+
+    if (pJson)
+    {
+        pJson->eType    = eType;
+        pJson->sValue   = sValue ? _Str_Dup(sValue) : NULL;
+    }
+
+    return pJson;
+}
+
+static void
+_Json_Delete(SJson *pJson)
+{
+    size_t i;
+
+    if (!pJson)
+    {
+        return;
+    }
+
+    for (i = 0; i < pJson->dCount; ++i)
+    {
+        if (pJson->sKeys)
+        {
+            free(pJson->sKeys[i]);
+        }
+        _Json_Delete(pJson->pItems[i]);
+    }
+    free(pJson->sKeys);
+    free(pJson->pItems);
+    free(pJson->sValue);
+    free(pJson);
+}
+
+static CBOOL
+_Json_Append(SJson *pJson, const char *sKey, SJson *pItem)
+{
+    if (!pJson || !pItem)
+    {
+        _Json_Delete(pItem);
+        return CFALSE;
+    }
+
+    if (pJson->dCount == pJson->dMax)
+    {
+        const size_t    dNewMax = pJson->dMax ? pJson->dMax * 2 : 8;
+        SJson           **pItems = (SJson**)realloc(pJson->pItems, dNewMax * sizeof(SJson*));
+        char            **sKeys = pJson->sKeys;
+
+        if (pItems)
+        {
+            pJson->pItems = pItems;
+        }
+        if (pJson->eType == JSON_OBJECT)
+        {
+            sKeys = (char**)realloc(pJson->sKeys, dNewMax * sizeof(char*));
+            if (sKeys)
+            {
+                pJson->sKeys = sKeys;
+            }
+        }
+        if (!pItems || (pJson->eType == JSON_OBJECT && !sKeys))
+        {
+            _Json_Delete(pItem);
+            return CFALSE;
+        }
+        pJson->dMax = dNewMax;
+    }
+
+    if (pJson->eType == JSON_OBJECT)
+    {
+        pJson->sKeys[pJson->dCount] = _Str_Dup(sKey ? sKey : "");
+    }
+    pJson->pItems[pJson->dCount++] = pItem;
+
+    return CTRUE;
+}
+
+static SJson*
+_Json_Get(SJson *pObject, const char *sKey)
+{
+    size_t i;
+
+    for (i = 0; i < pObject->dCount; ++i)
+    {
+        if (strcmp(pObject->sKeys[i], sKey) == 0)
+        {
+            return pObject->pItems[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* jq assignment: existing key keeps its position, new one is appended */
+static void
+_Json_Set(SJson *pObject, const char *sKey, SJson *pItem)
+{
+    size_t i;
+
+    for (i = 0; i < pObject->dCount; ++i)
+    {
+        if (strcmp(pObject->sKeys[i], sKey) == 0)
+        {
+            _Json_Delete(pObject->pItems[i]);
+            pObject->pItems[i] = pItem;
+            return;
+        }
+    }
+
+    _Json_Append(pObject, sKey, pItem);
+}
+
+static void
+_Json_SkipSpace(SJsonParser *pParser)
+{
+    while (strchr(" \t\r\n", pParser->sText[pParser->dOffset]) &&
+           pParser->sText[pParser->dOffset] != '\0')
+    {
+        pParser->dOffset++;
+    }
+}
+
+static SJson*
+_Json_Parse(const char *sText)
+{
+    SJsonParser tParser;
+    SJson       *pJson;
+
+    tParser.sText   = sText;
+    tParser.dOffset = 0;
+    tParser.bError  = CFALSE;
+
+    pJson = _Json_ParseValue(&tParser);
+    _Json_SkipSpace(&tParser);
+
+    if (tParser.bError || sText[tParser.dOffset] != '\0')
+    {
+        fprintf(stderr, "JSON parse error at offset %lu\n", (unsigned long)tParser.dOffset);
+        _Json_Delete(pJson);
+        return NULL;
+    }
+
+    return pJson;
+}
+
+static SJson*
+_Json_ParseValue(SJsonParser *pParser)
+{
+    const char  *sText;
+    SJson       *pJson;
+    char        *sKey;
+    size_t      dBegin;
+
+    _Json_SkipSpace(pParser);
+    sText = pParser->sText + pParser->dOffset;
+
+    if (*sText == '{' || *sText == '[')
+    {
+        const char  cClose  = *sText == '{' ? '}' : ']';
+        const CBOOL bObject = *sText == '{';
+
+        pJson = _Json_New(bObject ? JSON_OBJECT : JSON_ARRAY, NULL);
+        pParser->dOffset++;
+        _Json_SkipSpace(pParser);
+
+        if (pParser->sText[pParser->dOffset] == cClose)
+        {
+            pParser->dOffset++;
+            return pJson;
+        }
+
+        while (!pParser->bError)
+        {
+            sKey = NULL;
+            if (bObject)
+            {
+                _Json_SkipSpace(pParser);
+                sKey = _Json_ParseString(pParser);
+                _Json_SkipSpace(pParser);
+                if (!sKey || pParser->sText[pParser->dOffset] != ':')
+                {
+                    free(sKey);
+                    pParser->bError = CTRUE;
+                    break;
+                }
+                pParser->dOffset++;
+            }
+
+            if (!_Json_Append(pJson, sKey, _Json_ParseValue(pParser)))
+            {
+                pParser->bError = CTRUE;
+            }
+            free(sKey);
+
+            _Json_SkipSpace(pParser);
+            if (pParser->sText[pParser->dOffset] == ',')
+            {
+                pParser->dOffset++;
+                continue;
+            }
+            if (pParser->sText[pParser->dOffset] == cClose)
+            {
+                pParser->dOffset++;
+                break;
+            }
+            pParser->bError = CTRUE;
+        }
+
+        return pJson;
+    }
+
+    if (*sText == '"')
+    {
+        char *sValue = _Json_ParseString(pParser);
+
+        if (!sValue)
+        {
+            return NULL;
+        }
+        pJson = _Json_New(JSON_STRING, NULL);
+        if (pJson)
+        {
+            pJson->sValue = sValue;
+        }
+        else
+        {
+            free(sValue);
+        }
+        return pJson;
+    }
+
+    if (strncmp(sText, "null", 4) == 0)
+    {
+        pParser->dOffset += 4;
+        return _Json_New(JSON_NULL, NULL);
+    }
+    if (strncmp(sText, "true", 4) == 0 || strncmp(sText, "false", 5) == 0)
+    {
+        pParser->dOffset += *sText == 't' ? 4 : 5;
+        return _Json_New(JSON_BOOL, *sText == 't' ? "true" : "false");
+    }
+
+    /* Number literal is kept verbatim */
+    dBegin = pParser->dOffset;
+    while (strchr("+-0123456789.eE", pParser->sText[pParser->dOffset]) &&
+           pParser->sText[pParser->dOffset] != '\0')
+    {
+        pParser->dOffset++;
+    }
+    if (pParser->dOffset == dBegin)
+    {
+        pParser->bError = CTRUE;
+        return NULL;
+    }
+
+    pJson = _Json_New(JSON_NUMBER, NULL);
+    if (pJson)
+    {
+        pJson->sValue = (char*)malloc(pParser->dOffset - dBegin + 1);
+        if (pJson->sValue)
+        {
+            memcpy(pJson->sValue, pParser->sText + dBegin, pParser->dOffset - dBegin);
+            pJson->sValue[pParser->dOffset - dBegin] = '\0';
+        }
+    }
+
+    return pJson;
+}
+
+static size_t
+_Json_EncodeUTF8(unsigned long dCode, char *sOut)
+{
+    if (dCode < 0x80)
+    {
+        sOut[0] = (char)dCode;
+        return 1;
+    }
+    if (dCode < 0x800)
+    {
+        sOut[0] = (char)(0xC0 | (dCode >> 6));
+        sOut[1] = (char)(0x80 | (dCode & 0x3F));
+        return 2;
+    }
+    if (dCode < 0x10000)
+    {
+        sOut[0] = (char)(0xE0 | (dCode >> 12));
+        sOut[1] = (char)(0x80 | ((dCode >> 6) & 0x3F));
+        sOut[2] = (char)(0x80 | (dCode & 0x3F));
+        return 3;
+    }
+    sOut[0] = (char)(0xF0 | (dCode >> 18));
+    sOut[1] = (char)(0x80 | ((dCode >> 12) & 0x3F));
+    sOut[2] = (char)(0x80 | ((dCode >> 6) & 0x3F));
+    sOut[3] = (char)(0x80 | (dCode & 0x3F));
+    return 4;
+}
+
+static char*
+_Json_ParseString(SJsonParser *pParser)
+{
+    const char  *sText = pParser->sText;
+    size_t      dOffset = pParser->dOffset;
+    size_t      dLength = 0;
+    char        *sResult;
+
+    if (sText[dOffset] != '"')
+    {
+        pParser->bError = CTRUE;
+        return NULL;
+    }
+
+    /* Decoded string is never longer than its literal */
+    sResult = (char*)malloc(strlen(sText + dOffset) + 1);
+    if (!sResult)
+    {
+        pParser->bError = CTRUE;
+        return NULL;
+    }
+
+    for (++dOffset; sText[dOffset] != '"'; ++dOffset)
+    {
+        unsigned long dCode;
+
+        if (sText[dOffset] == '\0')
+        {
+            free(sResult);
+            pParser->bError = CTRUE;
+            return NULL;
+        }
+
+        if (sText[dOffset] != '\\')
+        {
+            sResult[dLength++] = sText[dOffset];
+            continue;
+        }
+
+        switch (sText[++dOffset])
+        {
+            case 'b':   sResult[dLength++] = '\b'; break;
+            case 'f':   sResult[dLength++] = '\f'; break;
+            case 'n':   sResult[dLength++] = '\n'; break;
+            case 'r':   sResult[dLength++] = '\r'; break;
+            case 't':   sResult[dLength++] = '\t'; break;
+            case 'u':
+                if (sscanf(sText + dOffset + 1, "%4lx", &dCode) != 1)
+                {
+                    free(sResult);
+                    pParser->bError = CTRUE;
+                    return NULL;
+                }
+                dOffset += 4;
+
+                /* Surrogate pair */
+                if (dCode >= 0xD800 && dCode < 0xDC00 &&
+                    sText[dOffset + 1] == '\\' && sText[dOffset + 2] == 'u')
+                {
+                    unsigned long dLow;
+
+                    if (sscanf(sText + dOffset + 3, "%4lx", &dLow) == 1 &&
+                        dLow >= 0xDC00 && dLow < 0xE000)
+                    {
+                        dCode = 0x10000 + ((dCode - 0xD800) << 10) + (dLow - 0xDC00);
+                        dOffset += 6;
+                    }
+                }
+                dLength += _Json_EncodeUTF8(dCode, sResult + dLength);
+                break;
+            case '\0':
+                free(sResult);
+                pParser->bError = CTRUE;
+                return NULL;
+            default:
+                sResult[dLength++] = sText[dOffset];
+                break;
+        }
+    }
+
+    sResult[dLength]    = '\0';
+    pParser->dOffset    = dOffset + 1;
+
+    return sResult;
+}
+
+/* Same escaping as jq: short escapes, \u00XX for other control chars */
+static void
+_Json_WriteString(FILE *pFile, const char *sString)
+{
+    const unsigned char *p;
+
+    fputc('"', pFile);
+    for (p = (const unsigned char*)sString; *p; ++p)
+    {
+        switch (*p)
+        {
+            case '"':   fputs("\\\"", pFile); break;
+            case '\\':  fputs("\\\\", pFile); break;
+            case '\b':  fputs("\\b", pFile); break;
+            case '\f':  fputs("\\f", pFile); break;
+            case '\n':  fputs("\\n", pFile); break;
+            case '\r':  fputs("\\r", pFile); break;
+            case '\t':  fputs("\\t", pFile); break;
+            default:
+                if (*p < 0x20 || *p == 0x7F)
+                {
+                    fprintf(pFile, "\\u%04x", *p);
+                }
+                else
+                {
+                    fputc(*p, pFile);
+                }
+                break;
+        }
+    }
+    fputc('"', pFile);
+}
+
+/* jq default layout: 2 spaces indent, "key": value, empty containers inline */
+static void
+_Json_Write(FILE *pFile, const SJson *pJson, int dIndent)
+{
+    size_t i;
+
+    switch (pJson->eType)
+    {
+        case JSON_NULL:
+            fputs("null", pFile);
+            break;
+        case JSON_BOOL:
+        case JSON_NUMBER:
+            fputs(pJson->sValue, pFile);
+            break;
+        case JSON_STRING:
+            _Json_WriteString(pFile, pJson->sValue);
+            break;
+        case JSON_ARRAY:
+        case JSON_OBJECT:
+            if (pJson->dCount == 0)
+            {
+                fputs(pJson->eType == JSON_ARRAY ? "[]" : "{}", pFile);
+                break;
+            }
+
+            fputc(pJson->eType == JSON_ARRAY ? '[' : '{', pFile);
+            for (i = 0; i < pJson->dCount; ++i)
+            {
+                fprintf(pFile, "%s\n%*s", i > 0 ? "," : "", dIndent + 2, "");
+                if (pJson->eType == JSON_OBJECT)
+                {
+                    _Json_WriteString(pFile, pJson->sKeys[i]);
+                    fputs(": ", pFile);
+                }
+                _Json_Write(pFile, pJson->pItems[i], dIndent + 2);
+            }
+            fprintf(pFile, "\n%*s%c", dIndent, "", pJson->eType == JSON_ARRAY ? ']' : '}');
+            break;
+    }
+}
+
+/******************************************************************************
+ * STATIC FUNCTION DEFINITIONS (MISC)
+ ******************************************************************************/
+
+static char*
+_Str_Dup(const char *sString)
+{
+    return _Str_Join(sString, "", "");
+}
+
+static char*
+_Str_Join(const char *sA, const char *sSep, const char *sB)
+{
+    const size_t    dA = strlen(sA);
+    const size_t    dSep = strlen(sSep);
+    const size_t    dB = strlen(sB);
+    char            *sResult = (char*)malloc(dA + dSep + dB + 1);
+
+    if (sResult)
+    {
+        memcpy(sResult, sA, dA);
+        memcpy(sResult + dA, sSep, dSep);
+        memcpy(sResult + dA + dSep, sB, dB + 1);
+    }
+
+    return sResult;
+}
+
+static char*
+_File_ReadAll(const char *sPath)
+{
+    FILE    *pFile = fopen(sPath, "rb");
+    char    *sResult = NULL;
+    long    dSize;
+
+    if (!pFile)
+    {
+        return NULL;
+    }
+
+    if (fseek(pFile, 0, SEEK_END) == 0 && (dSize = ftell(pFile)) >= 0 &&
+        fseek(pFile, 0, SEEK_SET) == 0)
+    {
+        sResult = (char*)malloc((size_t)dSize + 1);
+        if (sResult && fread(sResult, 1, (size_t)dSize, pFile) == (size_t)dSize)
+        {
+            sResult[dSize] = '\0';
+        }
+        else
+        {
+            free(sResult);
+            sResult = NULL;
+        }
+    }
+    fclose(pFile);
+
+    return sResult;
+}
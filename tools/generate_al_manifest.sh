@@ -2,7 +2,8 @@
 
 # Generates or updates manifest.json for update tool
 # Usage:  ./generate_al_manifest.sh /path/to/manifest.json
-# Needs:  jq, sha256sum, GNU findutils, GNU coreutils (stat)
+# Needs:  al-manifest, or jq, sha256sum, GNU findutils, GNU coreutils (stat), python3
+#         (pack_manifest.py: .deflate payloads and binary manifest)
 
 set -euo pipefail
 
@@ -30,50 +31,73 @@ fi
 # Whitelisted relative paths under $root_dir
 targets=("Data/Launcher" "Scripts/Launcher" "AmberLauncher" "AmberLauncher.exe")
 
-# Current/next launcher version
-current_version=$(jq '.launcher.version' "$manifest")
-next_version=$(( current_version + 1 ))
+# Prefer native al-manifest (parallel hashing + hash cache), jq loop otherwise.
+# AL_MANIFEST may point to the binary if it is not on PATH.
+al_manifest=${AL_MANIFEST:-$(command -v al-manifest || true)}
 
-tmp_files=$(mktemp)
-printf '[]' > "$tmp_files"
+update_with_jq() {
+  # Current/next launcher version
+  current_version=$(jq '.launcher.version' "$manifest")
+  next_version=$(( current_version + 1 ))
 
-scan() {
-  local abs="$1"
-  if [[ -d "$abs" ]]; then
-    find "$abs" -type f -print0
-  elif [[ -f "$abs" ]]; then
-    printf '%s\0' "$abs"
-  fi
+  tmp_files=$(mktemp)
+  printf '[]' > "$tmp_files"
+
+  scan() {
+    local abs="$1"
+    if [[ -d "$abs" ]]; then
+      find "$abs" -type f -print0
+    elif [[ -f "$abs" ]]; then
+      printf '%s\0' "$abs"
+    fi
+  }
+
+  for t in "${targets[@]}"; do
+    scan "$root_dir/$t"
+  done | while IFS= read -r -d '' f; do
+    [[ $(realpath "$f") == "$manifest" ]] && continue
+    [[ $(realpath "$f") == "${manifest%.json}.bin" ]] && continue
+
+    # Packed payloads and launcher runtime state aren't distributed files
+    case "$f" in
+      *.deflate) continue ;;
+      "$root_dir"/LauncherState/*) continue ;;
+    esac
+
+    rel="${f#$root_dir/}"
+    sha256=$(sha256sum "$f" | awk '{print $1}')
+    size=$(stat -c%s "$f")
+
+    jq --arg path "$rel" --arg sha "$sha256" --argjson size "$size" \
+       '. + [{path:$path, sha256:$sha, size:$size}]' \
+       "$tmp_files" > "${tmp_files}.new"
+    mv "${tmp_files}.new" "$tmp_files"
+  done
+
+  jq \
+    --arg schema "com.example.launcher/manifest-v2" \
+    --arg generated "$(date -u +'%Y-%m-%dT%H:%M:%SZ')" \
+    --argjson version "$next_version" \
+    --slurpfile files "$tmp_files" \
+    '.schema          = $schema
+     | .generated        = $generated
+     | .launcher.version = $version
+     | .files           = $files[0]' \
+    "$manifest" > "${manifest}.tmp"
+
+  mv "${manifest}.tmp" "$manifest"
+  rm "$tmp_files"
+
+  echo "$(basename "$manifest") updated → version ${next_version}"
 }
 
-for t in "${targets[@]}"; do
-  scan "$root_dir/$t"
-done | while IFS= read -r -d '' f; do
-  [[ $(realpath "$f") == "$manifest" ]] && continue
-
-  rel="${f#$root_dir/}"
-  sha256=$(sha256sum "$f" | awk '{print $1}')
-  size=$(stat -c%s "$f")
-
-  jq --arg path "$rel" --arg sha "$sha256" --argjson size "$size" \
-     '. + [{path:$path, sha256:$sha, size:$size}]' \
-     "$tmp_files" > "${tmp_files}.new"
-  mv "${tmp_files}.new" "$tmp_files"
-done
-
-jq \
-  --arg schema "com.example.launcher/manifest-v2" \
-  --arg generated "$(date -u +'%Y-%m-%dT%H:%M:%SZ')" \
-  --argjson version "$next_version" \
-  --slurpfile files "$tmp_files" \
-  '.schema          = $schema
-   | .generated        = $generated
-   | .launcher.version = $version
-   | .files           = $files[0]' \
-  "$manifest" > "${manifest}.tmp"
-
-mv "${manifest}.tmp" "$manifest"
-rm "$tmp_files"
-
-echo "$(basename "$manifest") updated → version ${next_version}"
+if [[ -n "$al_manifest" ]]; then
+  "$al_manifest" launcher "$manifest" "${targets[@]}"
+else
+  update_with_jq
+fi
+
+# Compressed payloads + binary manifest
+python3 "$(dirname "$(realpath "$0")")/pack_manifest.py" "$manifest"
+
 echo "Scanned (relative to manifest dir): ${targets[*]}"
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+
+# Packs payloads and emits binary twin of an updater manifest
+# Usage:  ./pack_manifest.py /path/to/manifest.json
+# Needs:  python3 (zlib, json, struct from standard library)
+#
+# For every listed file worth compressing writes "<path>.deflate" (zlib
+# stream) next to it and records its size as "packed" in the manifest.
+# Then writes "<manifest>.bin" (see include/core/manifest.h for layout).
+
+import json
+import os
+import struct
+import sys
+import zlib
+
+MAGIC           = b"ALMB"
+VERSION         = 1
+FLAG_DEFLATE    = 0x0001
+PACKED_SUFFIX   = ".deflate"
+MIN_PACK_SIZE   = 4096      # tiny files aren't worth extra request setup
+MAX_PACK_RATIO  = 0.9       # keep raw file unless it shrinks by 10%+
+
+
+def pack_file(abs_path):
+    packed_path = abs_path + PACKED_SUFFIX
+
+    with open(abs_path, "rb") as f:
+        data = f.read()
+
+    if len(data) >= MIN_PACK_SIZE:
+        packed = zlib.compress(data, 9)
+        if len(packed) < len(data) * MAX_PACK_RATIO:
+            with open(packed_path + ".tmp", "wb") as f:
+                f.write(packed)
+            os.replace(packed_path + ".tmp", packed_path)
+            return len(packed)
+
+    # Stale payload from an earlier run would be served with wrong size
+    if os.path.exists(packed_path):
+        os.remove(packed_path)
+    return 0
+
+
+def pack_str(value):
+    raw = (value or "").encode("utf-8")
+    if len(raw) > 0xFFFF:
+        raise ValueError("string too long for binary manifest: %r" % value)
+    return struct.pack("<H", len(raw)) + raw
+
+
+def build_binary(manifest):
+    launcher = manifest.get("launcher") or {}
+    files    = manifest.get("files") or []
+
+    body  = pack_str(manifest.get("schema"))
+    body += pack_str(manifest.get("generated"))
+    body += struct.pack("<iiI",
+                        int(launcher.get("version", 0)),
+                        int(launcher.get("build", 0)),
+                        len(files))
+    for entry in files:
+        body += pack_str(entry["path"])
+        body += bytes.fromhex(entry["sha256"])
+        body += struct.pack("<II", entry["size"], entry.get("packed", 0))
+
+    flags   = 0
+    payload = body
+    deflated = zlib.compress(body, 9)
+    if len(deflated) < len(body):
+        flags   = FLAG_DEFLATE
+        payload = deflated
+
+    return MAGIC + struct.pack("<HHI", VERSION, flags, len(body)) + payload
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write("Usage: %s path/to/manifest.json\n" % sys.argv[0])
+        return 1
+
+    manifest_path = os.path.realpath(sys.argv[1])
+    root_dir      = os.path.dirname(manifest_path)
+    bin_path      = os.path.splitext(manifest_path)[0] + ".bin"
+
+    with open(manifest_path, "r", encoding="utf-8") as f:
+        manifest = json.load(f)
+
+    raw_total    = 0
+    packed_total = 0
+    for entry in manifest.get("files") or []:
+        entry["packed"] = pack_file(os.path.join(root_dir, entry["path"]))
+        raw_total      += entry["size"]
+        packed_total   += entry["packed"] if entry["packed"] else entry["size"]
+
+    with open(manifest_path + ".tmp", "w", encoding="utf-8") as f:
+        json.dump(manifest, f, indent=2, ensure_ascii=False)
+        f.write("\n")
+    os.replace(manifest_path + ".tmp", manifest_path)
+
+    with open(bin_path + ".tmp", "wb") as f:
+        f.write(build_binary(manifest))
+    os.replace(bin_path + ".tmp", bin_path)
+
+    print("%s written (%d bytes)" % (os.path.basename(bin_path), os.path.getsize(bin_path)))
+    print("Payload: %d bytes raw, %d bytes to transfer" % (raw_total, packed_total))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,350 @@
+#!/usr/bin/env python3
+
+# Checks updater download scheduler against a local HTTP server
+# Usage:  ./test_updater.py path/to/AmberLauncher [--keep]
+# Needs:  python3 (standard library), built launcher; xvfb-run on Linux
+#         without a display
+#
+# Every scenario copies Scripts/ into a scratch game folder, points updater
+# at the server below and runs "AmberLauncher --update" there. Server records
+# every file request; checks look at those records, launcher output and
+# downloaded files:
+#
+#   segmented   206 per segment, at most UPDATER_CONNECTIONS requests in
+#               flight, largest files requested first
+#   uptodate    second run over the same folder requests no file
+#   fallback    server ignores Range, whole files arrive with 200
+#   retry       first requests fail with 503, file arrives on a later attempt
+#               after backoff delay
+#   resume      download interrupted after first segment continues from its
+#               checkpoint on next run
+#
+# Exits with 1 if any check fails.
+
+import hashlib
+import http.server
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+REPO_DIR        = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+SEGMENT_SIZE    = 4 << 20   # UPDATER_SEGMENT_SIZE
+RETRY_DELAY     = 0.5       # UPDATER_RETRY_DELAY_MS, seconds
+REQUEST_DELAY   = 0.2       # per file request, keeps requests overlapping
+RUN_TIMEOUT     = 300
+FILES_DIR       = "UpdaterTest"
+MIB             = 1 << 20
+
+
+class Server(http.server.ThreadingHTTPServer):
+    daemon_threads = True
+
+    def __init__(self):
+        super().__init__(("127.0.0.1", 0), Handler)
+        self.lock       = threading.Lock()
+        self.manifests  = {}
+        self.files      = {}
+        self.ranges     = True
+        self.fail       = None      # fail(path, range_start, nth) -> status or None
+        self.reset()
+
+    def reset(self):
+        with self.lock:
+            self.requests       = []
+            self.in_flight      = 0
+            self.max_in_flight  = 0
+
+    def url(self, path):
+        return "http://127.0.0.1:%d/%s" % (self.server_address[1], path)
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"   # workers keep connection across segments
+
+    def log_message(self, fmt, *args):
+        pass
+
+    def _reply(self, status, body=b"", headers=()):
+        self.send_response(status)
+        for name, value in headers:
+            self.send_header(name, value)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        server  = self.server
+        path    = self.path.split("?", 1)[0].lstrip("/")
+
+        if path in server.manifests:
+            self._reply(200, server.manifests[path], [("Content-Type", "application/json")])
+            return
+        if path not in server.files:
+            self._reply(404)
+            return
+
+        data    = server.files[path]
+        begin   = 0
+        end     = len(data) - 1
+        match   = re.match(r"bytes=(\d+)-(\d*)$", self.headers.get("Range", ""))
+        ranged  = bool(match) and server.ranges
+        if ranged:
+            begin = int(match.group(1))
+            end   = min(int(match.group(2)), end) if match.group(2) else end
+
+        with server.lock:
+            nth = sum(1 for r in server.requests if r["path"] == path)
+            record = {"path": path, "start": time.time(), "begin": begin, "end": end,
+                      "range": self.headers.get("Range"), "status": None}
+            server.requests.append(record)
+            server.in_flight    += 1
+            server.max_in_flight = max(server.max_in_flight, server.in_flight)
+
+        time.sleep(REQUEST_DELAY)
+        status = server.fail(path, begin, nth) if server.fail else None
+        record["status"] = status or (206 if ranged else 200)
+
+        # Client may send next request as soon as this body arrives
+        with server.lock:
+            server.in_flight -= 1
+
+        if status:
+            self._reply(status)
+        elif ranged:
+            self._reply(206, data[begin:end + 1],
+                        [("Content-Range", "bytes %d-%d/%d" % (begin, end, len(data)))])
+        else:
+            self._reply(200, data)
+
+
+class Scenario:
+    def __init__(self, server, launcher, scratch, name):
+        self.server     = server
+        self.launcher   = launcher
+        self.name       = name
+        self.game_dir   = os.path.join(scratch, name)
+        self.failures   = []
+
+    def check(self, condition, message):
+        if not condition:
+            self.failures.append(message)
+        return condition
+
+    def publish(self, sizes):
+        """Puts files of given sizes on server, largest gets 'file0'"""
+        self.server.files.clear()
+        entries = []
+        for index, size in enumerate(sizes):
+            name = "%s/%s/file%d.bin" % (FILES_DIR, self.name, index)
+            data = os.urandom(size)
+            self.server.files["files/" + name] = data
+            entries.append({"path": name, "sha256": hashlib.sha256(data).hexdigest(),
+                            "size": size, "packed": 0})
+
+        def manifest(files):
+            return json.dumps({"schema": "com.example.launcher/manifest-v2",
+                               "generated": "test_updater.py",
+                               "launcher": {"version": 1, "build": 0},
+                               "files": files}).encode("utf-8")
+
+        self.server.manifests = {"al_manifest.json": manifest([]),
+                                 "mod_manifest.json": manifest(entries)}
+        return entries
+
+    def prepare(self, connections, retries):
+        if not os.path.isdir(self.game_dir):
+            os.makedirs(self.game_dir)
+            shutil.copytree(os.path.join(REPO_DIR, "Scripts"),
+                            os.path.join(self.game_dir, "Scripts"))
+            os.symlink(os.path.join(REPO_DIR, "Data"), os.path.join(self.game_dir, "Data"))
+
+        # Later assignment wins, _const.lua itself stays as shipped otherwise
+        const_path = os.path.join(self.game_dir, "Scripts", "Launcher", "_const.lua")
+        with open(os.path.join(REPO_DIR, "Scripts", "Launcher", "_const.lua"), "r",
+                  encoding="utf-8") as f:
+            const = f.read()
+        const += "\n-- test_updater.py\n"
+        const += 'URL_UPDATER_ROOT              = "%s"\n' % self.server.url("files/")
+        const += 'URL_UPDATER_LAUNCHER_MANIFEST = "%s"\n' % self.server.url("al_manifest.json")
+        const += 'URL_UPDATER_MOD_MANIFEST      = "%s"\n' % self.server.url("mod_manifest.json")
+        const += "UPDATER_CONNECTIONS     = %d\n" % connections
+        const += "UPDATER_RETRIES         = %d\n" % retries
+        with open(const_path, "w", encoding="utf-8") as f:
+            f.write(const)
+
+    def run(self, connections=4, retries=3):
+        self.prepare(connections, retries)
+        self.server.reset()
+
+        cmd = [self.launcher, "--update"]
+        if sys.platform.startswith("linux") and not os.environ.get("DISPLAY") and \
+                shutil.which("xvfb-run"):
+            cmd = ["xvfb-run", "-a"] + cmd
+
+        try:
+            result = subprocess.run(cmd, cwd=self.game_dir, stdout=subprocess.PIPE,
+                                    stderr=subprocess.STDOUT, timeout=RUN_TIMEOUT)
+            output = result.stdout.decode("utf-8", "replace")
+        except subprocess.TimeoutExpired as e:
+            output = (e.stdout or b"").decode("utf-8", "replace")
+            self.check(False, "launcher didn't quit within %ds" % RUN_TIMEOUT)
+
+        with open(os.path.join(self.game_dir, "launcher.log"), "a", encoding="utf-8") as f:
+            f.write(output)
+        return output, [r for r in self.server.requests if r["path"] in self.server.files]
+
+    def check_files(self, entries):
+        for entry in entries:
+            path = os.path.join(self.game_dir, entry["path"])
+            if not self.check(os.path.isfile(path), "%s not downloaded" % entry["path"]):
+                continue
+            with open(path, "rb") as f:
+                digest = hashlib.sha256(f.read()).hexdigest()
+            self.check(digest == entry["sha256"], "%s has wrong contents" % entry["path"])
+
+    def check_done(self, output):
+        self.check("[Updater] Update done!" in output, "update didn't report success")
+
+
+def test_segmented(s):
+    connections = 3
+    entries     = s.publish([9 * MIB, 6 * MIB, 3 * MIB, MIB, 256 << 10, 64 << 10, 4096, 100])
+    s.server.ranges = True
+    s.server.fail   = None
+
+    output, requests = s.run(connections=connections)
+    s.check_done(output)
+    s.check_files(entries)
+
+    s.check(all(r["status"] == 206 for r in requests), "some file request wasn't answered 206")
+    s.check(all(r["end"] - r["begin"] + 1 <= SEGMENT_SIZE for r in requests),
+            "request for more than one segment")
+    s.check(s.server.max_in_flight <= connections,
+            "%d requests in flight, UPDATER_CONNECTIONS is %d" % (s.server.max_in_flight, connections))
+    s.check(s.server.max_in_flight >= 2, "requests never overlapped")
+
+    for entry in entries:
+        begins = [r["begin"] for r in requests if r["path"] == "files/" + entry["path"]]
+        s.check(begins == list(range(0, entry["size"], SEGMENT_SIZE)),
+                "%s segments requested as %s" % (entry["path"], begins))
+
+    # Workers take jobs largest first; job taken but not yet requested by the
+    # other workers may still get in between
+    first = []
+    for r in requests:
+        if r["path"] not in first:
+            first.append(r["path"])
+    ranks = [int(re.search(r"file(\d+)\.bin$", path).group(1)) for path in first]
+    for position, rank in enumerate(ranks):
+        s.check(rank <= position + connections - 1,
+                "largest first: file%d requested at position %d (%s)" % (rank, position, ranks))
+
+
+def test_uptodate(s):
+    # Same folder and published files as previous scenario
+    s.game_dir = os.path.join(os.path.dirname(s.game_dir), "segmented")
+
+    output, requests = s.run()
+    s.check_done(output)
+    s.check(len(requests) == 0, "%d file requests for files already up to date" % len(requests))
+
+
+def test_fallback(s):
+    entries = s.publish([6 * MIB, MIB, 4096])
+    s.server.ranges = False
+    s.server.fail   = None
+
+    output, requests = s.run()
+    s.check_done(output)
+    s.check_files(entries)
+    s.check(all(r["status"] == 200 for r in requests), "some file request wasn't answered 200")
+    s.check(len(requests) == len(entries),
+            "%d requests for %d files, whole body expected at once" % (len(requests), len(entries)))
+
+
+def test_retry(s):
+    entries = s.publish([MIB])
+    target  = "files/" + entries[0]["path"]
+    s.server.ranges = True
+    s.server.fail   = lambda path, begin, nth: 503 if path == target and nth < 2 else None
+
+    output, requests = s.run(retries=3)
+    s.check_done(output)
+    s.check_files(entries)
+
+    statuses = [r["status"] for r in requests]
+    s.check(statuses == [503, 503, 206], "responses %s, expected 503, 503, 206" % statuses)
+    if len(requests) == 3:
+        for attempt in (1, 2):
+            gap     = requests[attempt]["start"] - requests[attempt - 1]["start"]
+            backoff = RETRY_DELAY * (1 << (attempt - 1))
+            s.check(gap >= backoff, "attempt %d came %.2fs after previous one, backoff is %.2fs"
+                    % (attempt + 1, gap, backoff))
+    s.check("attempt 3)" in output, "launcher didn't report third attempt")
+
+
+def test_resume(s):
+    entries = s.publish([10 * MIB])
+    target  = "files/" + entries[0]["path"]
+    s.server.ranges = True
+
+    # First session: only first segment gets through, no retries
+    s.server.fail = lambda path, begin, nth: 503 if path == target and begin > 0 else None
+    output, requests = s.run(retries=0)
+    s.check("[Updater] Update incomplete" in output, "interrupted update reported success")
+    s.check([r["status"] for r in requests] == [206, 503],
+            "first session responses %s" % [r["status"] for r in requests])
+
+    # Second session continues where first one stopped
+    s.server.fail = None
+    output, requests = s.run(retries=0)
+    s.check_done(output)
+    s.check_files(entries)
+    begins = [r["begin"] for r in requests]
+    s.check(begins == [SEGMENT_SIZE, 2 * SEGMENT_SIZE],
+            "second session requested %s, expected resume at %d" % (begins, SEGMENT_SIZE))
+    s.check("resumed at %d" % SEGMENT_SIZE in output, "launcher didn't report resume")
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    keep = "--keep" in sys.argv[1:]
+    if len(args) != 1:
+        sys.stderr.write("Usage: %s path/to/AmberLauncher [--keep]\n" % sys.argv[0])
+        return 1
+    launcher = os.path.realpath(args[0])
+
+    server  = Server()
+    thread  = threading.Thread(target=server.serve_forever, daemon=True)
+    thread.start()
+    scratch = tempfile.mkdtemp(prefix="al-updater-test-")
+
+    failed = 0
+    try:
+        for test in (test_segmented, test_uptodate, test_fallback, test_retry, test_resume):
+            name     = test.__name__[len("test_"):]
+            scenario = Scenario(server, launcher, scratch, name)
+            test(scenario)
+
+            print("%-10s %s" % (name, "FAIL" if scenario.failures else "ok"))
+            for failure in scenario.failures:
+                print("    " + failure)
+            failed += 1 if scenario.failures else 0
+    finally:
+        server.shutdown()
+        if keep:
+            print("Scratch folders (launcher.log in each): %s" % scratch)
+        else:
+            shutil.rmtree(scratch, ignore_errors=True)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())